@@ -146,6 +146,7 @@ class AbstractColumn : public AbstractAspect
 		friend class AbstractColumnInsertRowsCmd;
 		friend class AbstractColumnClearMasksCmd;
 		friend class AbstractColumnSetMaskedCmd;
+		friend class ColumnPermuteRowsCmd;
 };
 
 #endif
@@ -39,6 +39,8 @@
 #include "backend/worksheet/plots/cartesian/XYFitCurve.h"
 #include "backend/worksheet/plots/cartesian/XYFourierFilterCurve.h"
 #include "backend/worksheet/plots/cartesian/XYFourierTransformCurve.h"
+#include "backend/worksheet/plots/cartesian/XYConvolutionCurve.h"
+#include "backend/worksheet/plots/cartesian/XYCorrelationCurve.h"
 #include "backend/worksheet/plots/cartesian/Axis.h"
 #include "backend/datapicker/DatapickerCurve.h"
 
@@ -298,6 +300,7 @@ bool Project::load(XmlStreamReader* reader) {
 			QList<AbstractAspect*> dataPickerCurves = children("DatapickerCurve", AbstractAspect::Recursive);
 			if (!curves.isEmpty() || !axes.isEmpty()) {
 				QList<AbstractAspect*> columns = children("Column", AbstractAspect::Recursive);
+				columns << children("FilteredColumn", AbstractAspect::Recursive);
 
 				//XY-curves
 				foreach (AbstractAspect* aspect, curves) {
@@ -315,6 +318,8 @@ bool Project::load(XmlStreamReader* reader) {
 					XYFitCurve* fitCurve = dynamic_cast<XYFitCurve*>(aspect);
 					XYFourierFilterCurve* filterCurve = dynamic_cast<XYFourierFilterCurve*>(aspect);
 					XYFourierTransformCurve* dftCurve = dynamic_cast<XYFourierTransformCurve*>(aspect);
+					XYConvolutionCurve* convolutionCurve = dynamic_cast<XYConvolutionCurve*>(aspect);
+					XYCorrelationCurve* correlationCurve = dynamic_cast<XYCorrelationCurve*>(aspect);
 					if (equationCurve) {
 						//curves defined by a mathematical equations recalculate their own columns on load again.
 						equationCurve->recalculate();
@@ -343,6 +348,14 @@ bool Project::load(XmlStreamReader* reader) {
 					} else if (dftCurve) {
 						RESTORE_COLUMN_POINTER(dftCurve, xDataColumn, XDataColumn);
 						RESTORE_COLUMN_POINTER(dftCurve, yDataColumn, YDataColumn);
+					} else if (convolutionCurve) {
+						RESTORE_COLUMN_POINTER(convolutionCurve, xDataColumn, XDataColumn);
+						RESTORE_COLUMN_POINTER(convolutionCurve, yDataColumn, YDataColumn);
+						RESTORE_COLUMN_POINTER(convolutionCurve, y2DataColumn, Y2DataColumn);
+					} else if (correlationCurve) {
+						RESTORE_COLUMN_POINTER(correlationCurve, xDataColumn, XDataColumn);
+						RESTORE_COLUMN_POINTER(correlationCurve, yDataColumn, YDataColumn);
+						RESTORE_COLUMN_POINTER(correlationCurve, y2DataColumn, Y2DataColumn);
 					} else {
 						RESTORE_COLUMN_POINTER(curve, xColumn, XColumn);
 						RESTORE_COLUMN_POINTER(curve, yColumn, YColumn);
@@ -118,6 +118,7 @@ void Column::init() {
 	addChild(m_column_private->inputFilter());
 	addChild(m_column_private->outputFilter());
 	m_suppressDataChangedSignal = false;
+	m_firstChangedRow = 0;
 }
 
 /**
@@ -197,8 +198,7 @@ bool Column::copy(const AbstractColumn * source, int source_start, int dest_star
 void Column::handleRowInsertion(int before, int count) {
 	AbstractColumn::handleRowInsertion(before, count);
 	exec(new ColumnInsertRowsCmd(m_column_private, before, count));
-	if (!m_suppressDataChangedSignal)
-		emit dataChanged(this);
+	emitDataChanged(before);
 
 	setStatisticsAvailable(false);
 }
@@ -209,8 +209,7 @@ void Column::handleRowInsertion(int before, int count) {
 void Column::handleRowRemoval(int first, int count) {
 	AbstractColumn::handleRowRemoval(first, count);
 	exec(new ColumnRemoveRowsCmd(m_column_private, first, count));
-	if (!m_suppressDataChangedSignal)
-		emit dataChanged(this);
+	emitDataChanged(first);
 
 	setStatisticsAvailable(false);
 }
@@ -244,6 +243,18 @@ void Column::clear() {
 	exec(new ColumnClearCmd(m_column_private));
 }
 
+/**
+ * \brief Reorder the rows of the column
+ *
+ * Row \c i of the column becomes the old row \c permutation[i].
+ * Masks are moved together with the values. The undo command
+ * only stores the permutation and not a copy of the data.
+ */
+void Column::permuteRows(const QVector<int>& permutation) {
+	if (!permutation.isEmpty())
+		exec(new ColumnPermuteRowsCmd(m_column_private, this, permutation));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //@}
 ////////////////////////////////////////////////////////////////////////////////
@@ -408,12 +419,33 @@ const Column::ColumnStatistics& Column::statistics() {
 
 void Column::calculateStatistics() {
 	m_column_private->statistics = ColumnStatistics();
-	ColumnStatistics& statistics = m_column_private->statistics;
 
 	QVector<double>* rowValues = reinterpret_cast<QVector<double>*>(data());
+	QVector<double> rowData;
+	rowData.reserve(rowValues->size());
+	for (int row = 0; row < rowValues->size(); ++row) {
+		const double val = rowValues->value(row);
+		if (std::isnan(val) || isMasked(row))
+			continue;
+		rowData.push_back(val);
+	}
+
+	calculateStatistics(m_column_private->statistics, rowData);
+	setStatisticsAvailable(true);
+}
+
+/*!
+ * calculates the statistics for the values in \c rowData.
+ * \c rowData contains the valid (not NaN and not masked) values only and is sorted in place.
+ * This is also used for views on the column data that don't store the values themselves.
+ */
+void Column::calculateStatistics(ColumnStatistics& statistics, QVector<double>& rowData) {
+	statistics = ColumnStatistics();
+
+	const int notNanCount = rowData.size();
+	if (notNanCount == 0)
+		return;
 
-	int notNanCount = 0;
-	double val;
 	double columnSum = 0.0;
 	double columnProduct = 1.0;
 	double columnSumNeg = 0.0;
@@ -421,13 +453,8 @@ void Column::calculateStatistics() {
 	statistics.minimum = INFINITY;
 	statistics.maximum = -INFINITY;
 	QMap<double, int> frequencyOfValues;
-	QVector<double> rowData;
-	rowData.reserve(rowValues->size());
-	for (int row = 0; row < rowValues->size(); ++row) {
-		val = rowValues->value(row);
-		if (std::isnan(val) || isMasked(row))
-			continue;
-
+	for (int i = 0; i < notNanCount; ++i) {
+		const double val = rowData.at(i);
 		if (val < statistics.minimum)
 			statistics.minimum = val;
 		if (val > statistics.maximum)
@@ -440,18 +467,8 @@ void Column::calculateStatistics() {
 			frequencyOfValues.operator [](val)++;
 		else
 			frequencyOfValues.insert(val, 1);
-		++notNanCount;
-		rowData.push_back(val);
-	}
-
-	if (notNanCount == 0) {
-		setStatisticsAvailable(true);
-		return;
 	}
 
-	if (rowData.size() < rowValues->size())
-		rowData.squeeze();
-
 	statistics.arithmeticMean = columnSum / notNanCount;
 	statistics.geometricMean = pow(columnProduct, 1.0 / notNanCount);
 	statistics.harmonicMean = notNanCount / columnSumNeg;
@@ -470,20 +487,16 @@ void Column::calculateStatistics() {
 	absoluteMedianList.reserve(notNanCount);
 	absoluteMedianList.resize(notNanCount);
 
-	int idx = 0;
-	for(int row = 0; row < rowValues->size(); ++row) {
-		val = rowValues->value(row);
-		if ( std::isnan(val) || isMasked(row) )
-			continue;
+	for (int i = 0; i < notNanCount; ++i) {
+		const double val = rowData.at(i);
 		columnSumVariance+= pow(val - statistics.arithmeticMean, 2.0);
 
 		sumForCentralMoment_r3 += pow(val - statistics.arithmeticMean, 3.0);
 		sumForCentralMoment_r4 += pow(val - statistics.arithmeticMean, 4.0);
 		columnSumMeanDeviation += fabs( val - statistics.arithmeticMean );
 
-		absoluteMedianList[idx] = fabs(val - statistics.median);
-		columnSumMedianDeviation += absoluteMedianList[idx];
-		idx++;
+		absoluteMedianList[i] = fabs(val - statistics.median);
+		columnSumMedianDeviation += absoluteMedianList[i];
 	}
 
 	statistics.meanDeviationAroundMedian = columnSumMedianDeviation / notNanCount;
@@ -507,7 +520,6 @@ void Column::calculateStatistics() {
 	}
 
 	statistics.entropy = -entropy;
-	setStatisticsAvailable(true);
 }
 
 void* Column::data() const {
@@ -568,6 +580,26 @@ void Column::setChanged() {
 	setStatisticsAvailable(false);
 }
 
+/*!
+ * returns the first row changed by the modification that is signaled by dataChanged().
+ * Valid only in the slots connected to dataChanged(), 0 if all rows may have changed.
+ */
+int Column::firstChangedRow() const {
+	return m_firstChangedRow;
+}
+
+/*!
+ * emits dataChanged() unless the signal is suppressed. \c first is the first row changed by the modification.
+ */
+void Column::emitDataChanged(int first) {
+	if (m_suppressDataChangedSignal)
+		return;
+
+	m_firstChangedRow = first;
+	emit dataChanged(this);
+	m_firstChangedRow = 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //@}
 ////////////////////////////////////////////////////////////////////////////////
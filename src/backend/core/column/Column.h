@@ -97,6 +97,7 @@ class Column : public AbstractColumn {
 		int width() const;
 		void setWidth(int value);
 		void clear();
+		void permuteRows(const QVector<int>& permutation);
 		AbstractSimpleFilter *outputFilter() const;
 		ColumnStringIO *asStringColumn() const;
 
@@ -112,6 +113,7 @@ class Column : public AbstractColumn {
 		void clearFormulas();
 
 		const ColumnStatistics& statistics();
+		static void calculateStatistics(ColumnStatistics&, QVector<double>& rowData);
 		void* data() const;
 		QString textAt(int row) const;
 		void setTextAt(int row, const QString& new_value);
@@ -128,6 +130,7 @@ class Column : public AbstractColumn {
 		virtual void replaceValues(int first, const QVector<double>& new_values);
 		void setChanged();
 		void setSuppressDataChangedSignal(bool);
+		int firstChangedRow() const;
 
 		void save(QXmlStreamWriter*) const;
 		bool load(XmlStreamReader*);
@@ -140,6 +143,7 @@ class Column : public AbstractColumn {
 
 		void handleRowInsertion(int before, int count);
 		void handleRowRemoval(int first, int count);
+		void emitDataChanged(int first);
 
 		void calculateStatistics();
 		void setStatisticsAvailable(bool available);
@@ -148,6 +152,7 @@ class Column : public AbstractColumn {
 		ColumnPrivate* m_column_private;
 		ColumnStringIO* m_string_io;
 		bool m_suppressDataChangedSignal;
+		int m_firstChangedRow;
 
 		friend class ColumnStringIO;
 
@@ -129,6 +129,7 @@ ColumnPrivate::ColumnPrivate(Column* owner, AbstractColumn::ColumnMode mode)
 	}
 
 	connect(m_output_filter, SIGNAL(formatChanged()), m_owner, SLOT(handleFormatChange()));
+	connect(m_output_filter, SIGNAL(digitsChanged()), m_owner, SLOT(handleFormatChange()));
 
 	m_input_filter->setName("InputFilter");
 	m_output_filter->setName("OutputFilter");
@@ -146,6 +147,8 @@ ColumnPrivate::ColumnPrivate(Column* owner, AbstractColumn::ColumnMode mode, voi
 		m_output_filter = new Double2StringFilter();
 		connect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
 		        m_owner, SLOT(handleFormatChange()));
+		connect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(digitsChanged()),
+		        m_owner, SLOT(handleFormatChange()));
 		break;
 	case AbstractColumn::Text:
 		m_input_filter = new SimpleCopyThroughFilter();
@@ -238,6 +241,8 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 	case AbstractColumn::Numeric:
 		disconnect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
 		           m_owner, SLOT(handleFormatChange()));
+		disconnect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(digitsChanged()),
+		           m_owner, SLOT(handleFormatChange()));
 		switch(mode) {
 		case AbstractColumn::Numeric:
 			break;
@@ -339,6 +344,8 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 		new_out_filter = new Double2StringFilter();
 		connect(static_cast<Double2StringFilter *>(new_out_filter), SIGNAL(formatChanged()),
 		        m_owner, SLOT(handleFormatChange()));
+		connect(static_cast<Double2StringFilter *>(new_out_filter), SIGNAL(digitsChanged()),
+		        m_owner, SLOT(handleFormatChange()));
 		break;
 	case AbstractColumn::Text:
 		new_in_filter = new SimpleCopyThroughFilter();
@@ -402,6 +409,8 @@ void ColumnPrivate::replaceModeData(AbstractColumn::ColumnMode mode, void * data
 	case AbstractColumn::Numeric:
 		disconnect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
 		           m_owner, SLOT(handleFormatChange()));
+		disconnect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(digitsChanged()),
+		           m_owner, SLOT(handleFormatChange()));
 		break;
 	case AbstractColumn::Text:
 		break;
@@ -428,6 +437,8 @@ void ColumnPrivate::replaceModeData(AbstractColumn::ColumnMode mode, void * data
 	case AbstractColumn::Numeric:
 		connect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
 		        m_owner, SLOT(handleFormatChange()));
+		connect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(digitsChanged()),
+		        m_owner, SLOT(handleFormatChange()));
 		break;
 	case AbstractColumn::Text:
 		break;
@@ -532,8 +543,7 @@ bool ColumnPrivate::copy(const AbstractColumn * source, int source_start, int de
 		break;
 	}
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	m_owner->emitDataChanged(dest_start);
 
 	return true;
 }
@@ -618,8 +628,7 @@ bool ColumnPrivate::copy(const ColumnPrivate * source, int source_start, int des
 		break;
 	}
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	m_owner->emitDataChanged(dest_start);
 
 	return true;
 }
@@ -751,6 +760,73 @@ void ColumnPrivate::removeRows(int first, int count) {
 	}
 }
 
+/**
+ * \brief Reorder the first \c permutation.size() rows
+ *
+ * Row \c i of the result is the row \c permutation[i] of the current data
+ * (gather). With \c inverse=true the operation is reverted, i.e. the current
+ * row \c i is moved to row \c permutation[i] (scatter).
+ * The data is rearranged in one pass without going through the cell-wise API.
+ * If \c newRowCount is not negative, the column is resized to \c newRowCount rows
+ * afterwards, before dataChanged() is emitted.
+ */
+void ColumnPrivate::permuteRows(const QVector<int>& permutation, bool inverse, int newRowCount) {
+	const int rows = permutation.size();
+	if (rows == 0) return;
+
+	emit m_owner->dataAboutToChange(m_owner);
+	if (rows > rowCount())
+		resizeTo(rows);
+
+	switch(m_column_mode) {
+	case AbstractColumn::Numeric: {
+			QVector<double>* data = static_cast< QVector<double>* >(m_data);
+			const QVector<double> source = data->mid(0, rows);
+			const double* src = source.constData();
+			double* dest = data->data();
+			const int* perm = permutation.constData();
+			if (inverse) {
+				for (int i = 0; i < rows; ++i)
+					dest[perm[i]] = src[i];
+			} else {
+				for (int i = 0; i < rows; ++i)
+					dest[i] = src[perm[i]];
+			}
+			break;
+		}
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day: {
+			QList<QDateTime>* data = static_cast< QList<QDateTime>* >(m_data);
+			const QList<QDateTime> source = data->mid(0, rows);
+			for (int i = 0; i < rows; ++i) {
+				if (inverse)
+					(*data)[permutation.at(i)] = source.at(i);
+				else
+					(*data)[i] = source.at(permutation.at(i));
+			}
+			break;
+		}
+	case AbstractColumn::Text: {
+			QStringList* data = static_cast< QStringList* >(m_data);
+			const QStringList source = data->mid(0, rows);
+			for (int i = 0; i < rows; ++i) {
+				if (inverse)
+					(*data)[permutation.at(i)] = source.at(i);
+				else
+					(*data)[i] = source.at(permutation.at(i));
+			}
+			break;
+		}
+	}
+
+	if (newRowCount >= 0)
+		resizeTo(newRowCount);
+
+	if (!m_owner->m_suppressDataChangedSignal)
+		emit m_owner->dataChanged(m_owner);
+}
+
 //! Return the column name
 QString ColumnPrivate::name() const {
 	return m_owner->name();
@@ -953,8 +1029,7 @@ void ColumnPrivate::setTextAt(int row, const QString& new_value) {
 		resizeTo(row+1);
 
 	static_cast< QStringList* >(m_data)->replace(row, new_value);
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	m_owner->emitDataChanged(row);
 }
 
 /**
@@ -973,8 +1048,7 @@ void ColumnPrivate::replaceTexts(int first, const QStringList& new_values) {
 	for(int i=0; i<num_rows; i++)
 		static_cast< QStringList* >(m_data)->replace(first+i, new_values.at(i));
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	m_owner->emitDataChanged(first);
 }
 
 /**
@@ -1021,8 +1095,7 @@ void ColumnPrivate::setDateTimeAt(int row, const QDateTime& new_value) {
 		resizeTo(row+1);
 
 	static_cast< QList<QDateTime>* >(m_data)->replace(row, new_value);
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	m_owner->emitDataChanged(row);
 }
 
 /**
@@ -1044,8 +1117,7 @@ void ColumnPrivate::replaceDateTimes(int first, const QList<QDateTime>& new_valu
 	for(int i=0; i<num_rows; i++)
 		static_cast< QList<QDateTime>* >(m_data)->replace(first+i, new_values.at(i));
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	m_owner->emitDataChanged(first);
 }
 
 /**
@@ -1061,8 +1133,7 @@ void ColumnPrivate::setValueAt(int row, double new_value) {
 		resizeTo(row+1);
 
 	static_cast< QVector<double>* >(m_data)->replace(row, new_value);
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	m_owner->emitDataChanged(row);
 }
 
 /**
@@ -1082,8 +1153,7 @@ void ColumnPrivate::replaceValues(int first, const QVector<double>& new_values)
 	for(int i=0; i<num_rows; i++)
 		ptr[first+i] = new_values.at(i);
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	m_owner->emitDataChanged(first);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -54,6 +54,7 @@ class ColumnPrivate: QObject {
 		void resizeTo(int new_size);
 		void insertRows(int before, int count);
 		void removeRows(int first, int count);
+		void permuteRows(const QVector<int>& permutation, bool inverse = false, int newRowCount = -1);
 		QString name() const;
 		AbstractColumn::PlotDesignation plotDesignation() const;
 		void setPlotDesignation(AbstractColumn::PlotDesignation);
@@ -29,6 +29,7 @@
 
 #include "columncommands.h"
 #include "ColumnPrivate.h"
+#include "backend/core/AbstractColumnPrivate.h"
 #include <KLocale>
 #include <cmath>
 
@@ -470,6 +471,118 @@ void ColumnRemoveRowsCmd::undo() {
 	m_col->replaceFormulas(m_formulas);
 }
 
+/** ***************************************************************************
+ * \class ColumnPermuteRowsCmd
+ * \brief Reorder the rows of a column according to a permutation
+ *
+ * Only the permutation and the masking of the column are stored,
+ * undo applies the inverse permutation instead of restoring a full copy of the data.
+ ** ***************************************************************************/
+
+/**
+ * \var ColumnPermuteRowsCmd::m_col
+ * \brief The private column data to modify
+ */
+
+/**
+ * \var ColumnPermuteRowsCmd::m_owner
+ * \brief The column owning the masking information
+ */
+
+/**
+ * \var ColumnPermuteRowsCmd::m_permutation
+ * \brief Row i of the result is the row m_permutation[i] of the original data
+ */
+
+/**
+ * \var ColumnPermuteRowsCmd::m_masking
+ * \brief Backup of the masking attribute
+ */
+
+/**
+ * \var ColumnPermuteRowsCmd::m_row_count
+ * \brief The old number of rows
+ */
+
+/**
+ * \var ColumnPermuteRowsCmd::m_copied
+ * \brief Status flag
+ */
+
+/**
+ * \brief Ctor
+ */
+ColumnPermuteRowsCmd::ColumnPermuteRowsCmd(ColumnPrivate* col, AbstractColumn* owner, const QVector<int>& permutation, QUndoCommand* parent)
+	: QUndoCommand(parent), m_col(col), m_owner(owner), m_permutation(permutation), m_row_count(0), m_copied(false) {
+	setText(i18n("%1: sort rows", col->name()));
+}
+
+/**
+ * \brief Execute the command
+ */
+void ColumnPermuteRowsCmd::redo() {
+	AbstractColumnPrivate* priv = m_owner->m_abstract_column_private;
+	if (!m_copied) {
+		m_masking = priv->m_masking;
+		m_row_count = m_col->rowCount();
+		m_copied = true;
+	}
+
+	m_col->permuteRows(m_permutation);
+
+	// move the masks together with the values
+	const QList< Interval<int> > masked = m_masking.intervals();
+	if (masked.isEmpty())
+		return;
+
+	const int rows = m_permutation.size();
+	QVector<bool> isMasked(rows, false);
+	foreach (const Interval<int>& iv, masked) {
+		const int end = qMin(iv.end(), rows - 1);
+		for (int i = iv.start(); i <= end; ++i)
+			isMasked[i] = true;
+	}
+
+	QList< Interval<int> > intervals;
+	int start = -1;
+	for (int i = 0; i < rows; ++i) {
+		if (isMasked.at(m_permutation.at(i))) {
+			if (start == -1)
+				start = i;
+		} else if (start != -1) {
+			intervals << Interval<int>(start, i - 1);
+			start = -1;
+		}
+	}
+	if (start != -1)
+		intervals << Interval<int>(start, rows - 1);
+
+	// masked rows beyond the permuted range are not affected
+	foreach (const Interval<int>& iv, masked) {
+		if (iv.end() >= rows)
+			intervals << Interval<int>(qMax(iv.start(), rows), iv.end());
+	}
+
+	emit m_owner->maskingAboutToChange(m_owner);
+	priv->m_masking = IntervalAttribute<bool>(intervals);
+	emit m_owner->maskingChanged(m_owner);
+}
+
+/**
+ * \brief Undo the command
+ */
+void ColumnPermuteRowsCmd::undo() {
+	// restore the old number of rows within the same data change
+	m_col->permuteRows(m_permutation, true, m_row_count);
+
+	AbstractColumnPrivate* priv = m_owner->m_abstract_column_private;
+	if (!m_masking.intervals().isEmpty()) {
+		emit m_owner->maskingAboutToChange(m_owner);
+		priv->m_masking = m_masking;
+		emit m_owner->maskingChanged(m_owner);
+	}
+}
+
 /** ***************************************************************************
  * \class ColumnSetPlotDesignationCmd
  * \brief Sets a column's plot designation
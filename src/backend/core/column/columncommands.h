@@ -36,6 +36,7 @@
 
 #include <QUndoCommand>
 #include <QStringList>
+#include <QVector>
 #include <QDateTime>
 
 class AbstractSimpleFilter;
@@ -128,6 +129,22 @@ private:
 	IntervalAttribute<QString> m_formulas;
 };
 
+class ColumnPermuteRowsCmd : public QUndoCommand {
+public:
+	explicit ColumnPermuteRowsCmd(ColumnPrivate* col, AbstractColumn* owner, const QVector<int>& permutation, QUndoCommand* parent = 0);
+
+	virtual void redo();
+	virtual void undo();
+
+private:
+	ColumnPrivate* m_col;
+	AbstractColumn* m_owner;
+	QVector<int> m_permutation;
+	IntervalAttribute<bool> m_masking;
+	int m_row_count;
+	bool m_copied;
+};
+
 class ColumnSetPlotDesignationCmd : public QUndoCommand {
 public:
 	explicit ColumnSetPlotDesignationCmd(ColumnPrivate* col, AbstractColumn::PlotDesignation pd, QUndoCommand* parent = 0);
@@ -31,6 +31,8 @@
 
 #include <klocale.h>
 #include <QDebug>
+#include <QRunnable>
+#include <QThreadPool>
 
 #include <cmath>
 extern "C" {
@@ -43,10 +45,37 @@ extern "C" {
 
 ExpressionParser* ExpressionParser::instance = NULL;
 
+namespace {
+
+/*!
+ * evaluates a compiled expression for the points from \c first to \c last (exclusive).
+ */
+class EvaluateTask : public QRunnable {
+public:
+	EvaluateTask(const parser_program* prog, const QVector<const double*>& values, const QVector<size_t>& strides,
+			int first, int last, double* result) : m_prog(prog), m_values(values), m_strides(strides),
+			m_first(first), m_last(last), m_result(result) {
+		for (int j = 0; j < m_values.size(); ++j)
+			m_values[j] += m_first*m_strides.at(j);
+	}
+
+	void run() {
+		parser_eval_array(m_prog, m_values.constData(), m_strides.constData(), m_result + m_first, m_last - m_first);
+	}
+
+private:
+	const parser_program* m_prog;
+	QVector<const double*> m_values;
+	const QVector<size_t>& m_strides;
+	int m_first;
+	int m_last;
+	double* m_result;
+};
+
+}
+
 ExpressionParser::ExpressionParser() {
 	init_table();
-	initFunctions();
-	initConstants();
 }
 
 void ExpressionParser::initFunctions() {
@@ -1055,56 +1084,129 @@ ExpressionParser* ExpressionParser::getInstance() {
 	return instance;
 }
 
+/*!
+	the lists of the functions and constants are only needed in the dialogs and are created on first use.
+	the parser itself looks them up in its own tables.
+ */
 const QStringList& ExpressionParser::functions() {
+	if (m_functions.isEmpty())
+		initFunctions();
 	return m_functions;
 }
 
 
 const QStringList& ExpressionParser::functionsGroups() {
+	if (m_functions.isEmpty())
+		initFunctions();
 	return m_functionsGroups;
 }
 
 const QStringList& ExpressionParser::functionsNames() {
+	if (m_functions.isEmpty())
+		initFunctions();
 	return m_functionsNames;
 }
 
 const QVector<int>& ExpressionParser::functionsGroupIndices() {
+	if (m_functions.isEmpty())
+		initFunctions();
 	return m_functionsGroupIndex;
 }
 
 const QStringList& ExpressionParser::constants() {
+	if (m_constants.isEmpty())
+		initConstants();
 	return m_constants;
 }
 
 const QStringList& ExpressionParser::constantsGroups() {
+	if (m_constants.isEmpty())
+		initConstants();
 	return m_constantsGroups;
 }
 
 const QStringList& ExpressionParser::constantsNames() {
+	if (m_constants.isEmpty())
+		initConstants();
 	return m_constantsNames;
 }
 
 const QStringList& ExpressionParser::constantsValues() {
+	if (m_constants.isEmpty())
+		initConstants();
 	return m_constantsValues;
 }
 
 const QStringList& ExpressionParser::constantsUnits() {
+	if (m_constants.isEmpty())
+		initConstants();
 	return m_constantsUnits;
 }
 
 const QVector<int>& ExpressionParser::constantsGroupIndices() {
+	if (m_constants.isEmpty())
+		initConstants();
 	return m_constantsGroupIndex;
 }
 
+/*!
+	compiles \c expr once and evaluates it for \c count points. The variable \c vars[j] is set to
+	\c values[j][i*strides[j]] for the point i, a stride of 0 binds a constant value like a parameter.
+	Non-finite results are stored as NAN.
+ */
+bool ExpressionParser::evaluate(const QString& expr, const QStringList& vars, const QVector<const double*>& values,
+		const QVector<size_t>& strides, int count, double* result) {
+	Q_ASSERT(vars.size() == values.size() && vars.size() == strides.size());
+
+	QList<QByteArray> varsba;
+	QVector<const char*> varNames;
+	for (int i = 0; i < vars.size(); ++i)
+		varsba << vars.at(i).toLocal8Bit();
+	for (int i = 0; i < varsba.size(); ++i)
+		varNames << varsba.at(i).constData();
+
+	gsl_set_error_handler_off();
+	QByteArray funcba = expr.toLocal8Bit();
+	parser_program* prog = parser_compile(funcba.constData(), varNames.data(), varNames.size());
+	if (!prog)
+		return false;
+
+	// evaluate blocks of points on all cores if the expression allows it
+	QThreadPool pool;
+	const int minBlockSize = 10000;
+	const int blocks = qMin(pool.maxThreadCount(), count/minBlockSize);
+	if (blocks > 1 && parser_thread_safe(prog)) {
+		for (int i = 0; i < blocks; ++i) {
+			const int first = (int)((qint64)count*i/blocks);
+			const int last = (int)((qint64)count*(i+1)/blocks);
+			pool.start(new EvaluateTask(prog, values, strides, first, last, result));
+		}
+		pool.waitForDone();
+	} else
+		parser_eval_array(prog, values.constData(), strides.constData(), result, count);
+	parser_free(prog);
+
+	for (int i = 0; i < count; ++i) {
+		if (!std::isfinite(result[i]))
+			result[i] = NAN;
+	}
+
+	return true;
+}
+
 bool ExpressionParser::isValid(const QString& expr, const QStringList& vars) {
+	QList<QByteArray> varsba;
+	QVector<const char*> varNames;
 	for (int i = 0; i < vars.size(); ++i)
-		assign_variable(vars.at(i).toLocal8Bit().data(), 0);
+		varsba << vars.at(i).toLocal8Bit();
+	for (int i = 0; i < varsba.size(); ++i)
+		varNames << varsba.at(i).constData();
 
 	QByteArray funcba = expr.toLocal8Bit();
-	const char* data = funcba.data();
 	gsl_set_error_handler_off();
-	parse(data);
-	return !(parse_errors()>0);
+	parser_program* prog = parser_compile(funcba.constData(), varNames.data(), varNames.size());
+	parser_free(prog);
+	return (prog != 0);
 }
 
 bool ExpressionParser::evaluateCartesian(const QString& expr, const QString& min, const QString& max,
@@ -1113,104 +1215,38 @@ bool ExpressionParser::evaluateCartesian(const QString& expr, const QString& min
 	double xMin = parse(min.toLocal8Bit().data());
 	double xMax = parse(max.toLocal8Bit().data());
 	double step = (xMax - xMin)/(double)(count - 1);
-	const char* func = expr.toLocal8Bit().data();
-	double x, y;
-	gsl_set_error_handler_off();
-
-	for (int i = 0; i < paramNames.size(); ++i)
-		assign_variable(paramNames.at(i).toLocal8Bit().data(), paramValues.at(i));
 
-	for (int i = 0; i < count; i++) {
-		x = xMin + step * i;
-		assign_variable("x", x);
-		y = parse(func);
-
-		if (parse_errors() > 0)
-			return false;
-
-		(*xVector)[i] = x;
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
-	}
+	for (int i = 0; i < count; i++)
+		(*xVector)[i] = xMin + step * i;
 
-	return true;
+	return evaluateCartesian(expr, xVector, yVector, paramNames, paramValues);
 }
 
 bool ExpressionParser::evaluateCartesian(const QString& expr, const QString& min, const QString& max,
 										 int count, QVector<double>* xVector, QVector<double>* yVector) {
-	double xMin = parse(min.toLocal8Bit().data());
-	double xMax = parse(max.toLocal8Bit().data());
-	double step = (xMax - xMin)/(double)(count - 1);
-	const char* func = expr.toLocal8Bit().data();
-	double x, y;
-	gsl_set_error_handler_off();
-
-	for (int i = 0; i < count; i++) {
-		x = xMin + step*i;
-		assign_variable("x", x);
-		y = parse(func);
-
-		if (parse_errors() > 0)
-			return false;
-
-		(*xVector)[i] = x;
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
-	}
-
-	return true;
+	return evaluateCartesian(expr, min, max, count, xVector, yVector, QStringList(), QVector<double>());
 }
 
 bool ExpressionParser::evaluateCartesian(const QString& expr, QVector<double>* xVector, QVector<double>* yVector) {
-	const char* func = expr.toLocal8Bit().data();
-	double x, y;
-	gsl_set_error_handler_off();
-
-	for (int i = 0; i < xVector->count(); i++) {
-		x = xVector->at(i);
-		assign_variable("x", x);
-		y = parse(func);
-
-		if (parse_errors() > 0)
-			return false;
-
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
-	}
-
-	return true;
+	return evaluateCartesian(expr, xVector, yVector, QStringList(), QVector<double>());
 }
 
 bool ExpressionParser::evaluateCartesian(const QString& expr, QVector<double>* xVector, QVector<double>* yVector,
 		const QStringList& paramNames, const QVector<double>& paramValues) {
-	const char* func = expr.toLocal8Bit().data();
-	double x, y;
-	gsl_set_error_handler_off();
-
-	for (int i = 0; i < paramNames.size(); ++i)
-		assign_variable(paramNames.at(i).toLocal8Bit().data(), paramValues.at(i));
-
-	for (int i = 0; i < xVector->count(); i++) {
-		x = xVector->at(i);
-		assign_variable("x", x);
-		y = parse(func);
-
-		if (parse_errors() > 0)
-			return false;
-
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
+	QStringList vars;
+	QVector<const double*> values;
+	QVector<size_t> strides;
+
+	vars << "x";
+	values << xVector->constData();
+	strides << 1;
+	for (int i = 0; i < paramNames.size(); ++i) {
+		vars << paramNames.at(i);
+		values << paramValues.constData() + i;
+		strides << 0;
 	}
 
-	return true;
+	return evaluate(expr, vars, values, strides, xVector->size(), yVector->data());
 }
 
 /*!
@@ -1220,42 +1256,18 @@ bool ExpressionParser::evaluateCartesian(const QString& expr, QVector<double>* x
  */
 bool ExpressionParser::evaluateCartesian(const QString& expr, const QStringList& vars, const QVector<QVector<double>*>& xVectors, QVector<double>* yVector) {
 	Q_ASSERT(vars.size() == xVectors.size());
-	const char* func = expr.toLocal8Bit().data();
-	double y, varValue;
-	QString varName;
-
-	gsl_set_error_handler_off();
 
-	bool stop = false;
-	for (int i = 0; i < yVector->size(); i++) {
-		//stop iterating over i if one of the x-vectors has no elements anymore.
-		for (int n = 0; n < xVectors.size(); ++n) {
-			if (i == xVectors.at(n)->size()) {
-				stop = true;
-				break;
-			}
-		}
-		if (stop)
-			break;
-
-		for (int n = 0; n < vars.size(); ++n) {
-			varName = vars.at(n);
-			varValue = xVectors.at(n)->at(i);
-			assign_variable(varName.toLocal8Bit().data(), varValue);
-		}
-
-		y = parse(func);
-
-		if (parse_errors() > 0)
-			return false;
-
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
+	//stop iterating if one of the x-vectors has no elements anymore.
+	int count = yVector->size();
+	QVector<const double*> values;
+	QVector<size_t> strides;
+	for (int n = 0; n < xVectors.size(); ++n) {
+		count = qMin(count, xVectors.at(n)->size());
+		values << xVectors.at(n)->constData();
+		strides << 1;
 	}
 
-	return true;
+	return evaluate(expr, vars, values, strides, count, yVector->data());
 }
 
 bool ExpressionParser::evaluatePolar(const QString& expr, const QString& min, const QString& max,
@@ -1263,25 +1275,19 @@ bool ExpressionParser::evaluatePolar(const QString& expr, const QString& min, co
 	double minValue = parse(min.toLocal8Bit().data());
 	double maxValue = parse(max.toLocal8Bit().data());
 	double step = (maxValue - minValue)/(double)(count - 1);
-	QByteArray funcba = expr.toLocal8Bit();
-	const char* func = funcba.data();
-	double r, phi;
-	gsl_set_error_handler_off();
+
+	QVector<double> phi(count);
+	for (int i = 0; i < count; i++)
+		phi[i] = minValue + step * i;
+
+	QVector<double> r(count);
+	if (!evaluate(expr, QStringList() << "phi", QVector<const double*>() << phi.constData(),
+			QVector<size_t>() << 1, count, r.data()))
+		return false;
 
 	for (int i = 0; i < count; i++) {
-		phi = minValue + step * i;
-		assign_variable("phi", phi);
-		r = parse(func);
-		if (parse_errors() > 0)
-			return false;
-
-		if (std::isfinite(r)) {
-			(*xVector)[i] = r*cos(phi);
-			(*yVector)[i] = r*sin(phi);
-		} else {
-			(*xVector)[i] = NAN;
-			(*yVector)[i] = NAN;
-		}
+		(*xVector)[i] = r.at(i)*cos(phi.at(i));
+		(*yVector)[i] = r.at(i)*sin(phi.at(i));
 	}
 
 	return true;
@@ -1292,34 +1298,15 @@ bool ExpressionParser::evaluateParametric(const QString& expr1, const QString& e
 	double minValue = parse(min.toLocal8Bit().data());
 	double maxValue = parse(max.toLocal8Bit().data());
 	double step = (maxValue - minValue)/(double)(count - 1);
-	QByteArray xfuncba = expr1.toLocal8Bit();
-	const char* xFunc = xfuncba.data();
-	QByteArray yfuncba = expr2.toLocal8Bit();
-	const char* yFunc = yfuncba.data();
-	double x, y, t;
-	gsl_set_error_handler_off();
 
-	for (int i = 0; i < count; i++) {
-		t = minValue + step*i;
-		assign_variable("t", t);
-		x = parse(xFunc);
-		if (parse_errors() > 0)
-			return false;
-
-		if (std::isfinite(x))
-			(*xVector)[i] = x;
-		else
-			(*xVector)[i] = NAN;
-
-		y = parse(yFunc);
-		if (parse_errors() > 0)
-			return false;
-
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
-	}
+	QVector<double> t(count);
+	for (int i = 0; i < count; i++)
+		t[i] = minValue + step*i;
 
-	return true;
+	const QStringList vars = QStringList() << "t";
+	const QVector<const double*> values = QVector<const double*>() << t.constData();
+	const QVector<size_t> strides = QVector<size_t>() << 1;
+
+	return evaluate(expr1, vars, values, strides, count, xVector->data())
+		&& evaluate(expr2, vars, values, strides, count, yVector->data());
 }
@@ -70,6 +70,8 @@ private:
 
 	void initFunctions();
 	void initConstants();
+	static bool evaluate(const QString& expr, const QStringList& vars, const QVector<const double*>& values,
+					const QVector<size_t>& strides, int count, double* result);
 
 	static ExpressionParser* instance;
 
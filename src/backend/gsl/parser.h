@@ -63,14 +63,46 @@ typedef struct symrec {
 	struct symrec *next;	/* next field */
 } symrec;
 
+/* parser context with its own symbol table. Different contexts can be used in different threads */
+typedef struct parser_context parser_context;
+
+parser_context* parser_context_new(void);	/* create context with all functions and constants */
+void parser_context_free(parser_context *ctx);
+symrec* parser_context_assign_variable(parser_context *ctx, const char* symb_name, double value);
+double parser_context_parse(parser_context *ctx, const char *str);
+int parser_context_errors(const parser_context *ctx);	/* number of errors of the last parse */
+
+/* functions using the default context */
 void init_table();	/* initialize symbol table */
 void delete_table();	/* delete symbol table */
 int parse_errors();
 symrec* assign_variable(const char* symb_name, double value);
-/*new style: symrec* assign_variable(symrec *sym_table, parser_var var);*/
 double parse(const char *str);
 double parse_with_vars(const char[], const parser_var[], int nvars);
 
+/* compiled expressions: parsed once and evaluated for many values of the variables */
+typedef struct parser_program parser_program;
+
+/* compiles str, the variables vars are bound by their index. returns 0 on parse errors.
+ * other variables are read from the symbol table of the context when evaluating */
+parser_program* parser_context_compile(parser_context *ctx, const char *str, const char *vars[], int nvars);
+parser_program* parser_compile(const char *str, const char *vars[], int nvars);
+/* compiles the derivative of str with respect to the bound variable vars[var]. returns 0 on parse errors,
+ * for assignments and for functions without known derivative depending on the variable */
+parser_program* parser_context_compile_derivative(parser_context *ctx, const char *str, const char *vars[], int nvars, int var);
+parser_program* parser_compile_derivative(const char *str, const char *vars[], int nvars, int var);
+void parser_free(parser_program *prog);
+/* returns 1 if prog can be evaluated in several threads at the same time, i.e. if it
+ * doesn't assign variables and doesn't use random numbers */
+int parser_thread_safe(const parser_program *prog);
+/* returns 1 if the bound variable var is used by prog */
+int parser_uses_variable(const parser_program *prog, int var);
+/* evaluates prog with the variable i set to values[i] */
+double parser_eval(const parser_program *prog, const double *values);
+/* evaluates prog for n points with the variable j set to values[j][i*strides[j]] for point i.
+ * a stride of 0 binds a constant value (e.g. a parameter) */
+void parser_eval_array(const parser_program *prog, const double * const values[], const size_t strides[], double *result, size_t n);
+
 extern struct con _constants[];
 extern struct func _functions[];
 
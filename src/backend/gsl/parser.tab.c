@@ -1,21 +1,22 @@
-/* A Bison parser, made by GNU Bison 2.7.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
-   
-      Copyright (C) 1984, 1989-1990, 2000-2012 Free Software Foundation, Inc.
-   
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
    the Free Software Foundation, either version 3 of the License, or
    (at your option) any later version.
-   
+
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
    GNU General Public License for more details.
-   
+
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -26,13 +27,17 @@
    special exception, which will cause the skeleton and the resulting
    Bison output files to be licensed under the GNU General Public
    License without this special exception.
-   
+
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -40,17 +45,17 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "2.7"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
 
 /* Pure parsers.  */
-#define YYPURE 0
+#define YYPURE 2
 
 /* Push parsers.  */
 #define YYPUSH 0
@@ -61,13 +66,17 @@
 
 
 
-/* Copy the first part of user declarations.  */
-/* Line 371 of yacc.c  */
+/* First part of user prologue.  */
 #line 30 "parser.y"
 
 #include <string.h>
 #include <ctype.h>
 #include <locale.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
 #include "parser.h"
 #include "constants.h"
 #include "functions.h"
@@ -80,39 +89,76 @@
 
 #define YYERROR_VERBOSE 1
 
+/* node types of the syntax tree */
+typedef enum {NODE_NUM, NODE_VAR, NODE_SLOT, NODE_ASSIGN, NODE_FNCT,
+	NODE_ADD, NODE_SUB, NODE_MUL, NODE_DIV, NODE_NEG, NODE_POW, NODE_SEQ} node_type;
+
+/* node of the syntax tree */
+typedef struct parser_node {
+	node_type type;
+	double value;		/* value of a NUM */
+	symrec *sym;		/* symbol of a VAR, FNCT or assignment */
+	int slot;		/* index of a bound variable */
+	int nargs;		/* number of arguments */
+	struct parser_node *args[4];
+	struct parser_node *next;	/* list of all nodes of a parse */
+} parser_node;
+
+/* parser context: variables of the user and number of errors of the last parse.
+ * the functions and constants are shared by all contexts */
+struct parser_context {
+	symrec **vars;		/* hash table of the variables, chained by symrec::next */
+	unsigned int nbuckets;	/* size of vars (power of 2) */
+	unsigned int nvars;	/* number of variables */
+	int nerrors;		/* number of errors of the last parse */
+};
+
 /* params passed to yylex (and yyerror) */
 typedef struct param {
 	unsigned int pos;	/* current position in string */
 	char *string;		/* the string to parse */
-/*	symrec *sym_table;	the symbol table (not used) */
+	parser_context *ctx;	/* context with the symbol table */
+	const char **vars;	/* names of the bound variables (compiled expressions only) */
+	int nvars;		/* number of bound variables */
+	parser_node *root;	/* syntax tree of the expression */
+	parser_node *nodes;	/* all allocated nodes */
+	char *symbuf;		/* buffer for identifiers */
+	int symlength;		/* size of symbuf */
 } param;
 
 int yyerror(param *p, const char *err);
-int yylex(param *p);
 
-double res;
+static parser_node* new_node(param *p, node_type type);
+static parser_node* new_num(param *p, double value);
+static parser_node* new_op(param *p, node_type type, parser_node *left, parser_node *right);
+static parser_node* new_fnct(param *p, symrec *sym, int nargs, parser_node *a1, parser_node *a2, parser_node *a3, parser_node *a4);
+static symrec* assignable(param *p, symrec *sym);
 
-/* Line 371 of yacc.c  */
-#line 97 "parser.tab.c"
+#line 138 "parser.tab.c"
 
-# ifndef YY_NULL
-#  if defined __cplusplus && 201103L <= __cplusplus
-#   define YY_NULL nullptr
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
 #  else
-#   define YY_NULL 0
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
 #  endif
 # endif
-
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
-#endif
 
 
-/* Enabling traces.  */
+/* Debug traces.  */
 #ifndef YYDEBUG
 # define YYDEBUG 0
 #endif
@@ -120,90 +166,173 @@ double res;
 extern int yydebug;
 #endif
 
-/* Tokens.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     NUM = 258,
-     VAR = 259,
-     FNCT = 260,
-     NEG = 261
-   };
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    NUM = 258,                     /* NUM  */
+    SLOT = 259,                    /* SLOT  */
+    VAR = 260,                     /* VAR  */
+    FNCT = 261,                    /* FNCT  */
+    NEG = 262                      /* NEG  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
 
-
+/* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
+union YYSTYPE
 {
-/* Line 387 of yacc.c  */
-#line 62 "parser.y"
+#line 101 "parser.y"
 
 double dval;	/* For returning numbers */
+int ival;	/* For returning indices of bound variables */
 symrec *tptr;   /* For returning symbol-table pointers */
+struct parser_node *node;	/* For returning syntax tree nodes */
 
+#line 199 "parser.tab.c"
 
-/* Line 387 of yacc.c  */
-#line 149 "parser.tab.c"
-} YYSTYPE;
+};
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
 # define YYSTYPE_IS_DECLARED 1
 #endif
 
-extern YYSTYPE yylval;
 
-#ifdef YYPARSE_PARAM
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void *YYPARSE_PARAM);
-#else
-int yyparse ();
-#endif
-#else /* ! YYPARSE_PARAM */
-#if defined __STDC__ || defined __cplusplus
+
+
 int yyparse (param *p);
-#else
-int yyparse ();
-#endif
-#endif /* ! YYPARSE_PARAM */
 
 
 
-/* Copy the second part of user declarations.  */
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_NUM = 3,                        /* NUM  */
+  YYSYMBOL_SLOT = 4,                       /* SLOT  */
+  YYSYMBOL_VAR = 5,                        /* VAR  */
+  YYSYMBOL_FNCT = 6,                       /* FNCT  */
+  YYSYMBOL_7_ = 7,                         /* '='  */
+  YYSYMBOL_8_ = 8,                         /* '-'  */
+  YYSYMBOL_9_ = 9,                         /* '+'  */
+  YYSYMBOL_10_ = 10,                       /* '*'  */
+  YYSYMBOL_11_ = 11,                       /* '/'  */
+  YYSYMBOL_NEG = 12,                       /* NEG  */
+  YYSYMBOL_13_ = 13,                       /* '^'  */
+  YYSYMBOL_14_n_ = 14,                     /* '\n'  */
+  YYSYMBOL_15_ = 15,                       /* '('  */
+  YYSYMBOL_16_ = 16,                       /* ')'  */
+  YYSYMBOL_17_ = 17,                       /* ','  */
+  YYSYMBOL_YYACCEPT = 18,                  /* $accept  */
+  YYSYMBOL_input = 19,                     /* input  */
+  YYSYMBOL_line = 20,                      /* line  */
+  YYSYMBOL_expr = 21                       /* expr  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+/* Second part of user prologue.  */
+#line 108 "parser.y"
+
+int yylex(YYSTYPE *lvalp, param *p);
+
+#line 249 "parser.tab.c"
 
-/* Line 390 of yacc.c  */
-#line 177 "parser.tab.c"
 
 #ifdef short
 # undef short
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
-#else
-typedef unsigned char yytype_uint8;
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
-#elif (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
 typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef short int yytype_int8;
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef short int yytype_int16;
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -211,16 +340,28 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
 # if defined YYENABLE_NLS && YYENABLE_NLS
@@ -234,32 +375,71 @@ typedef short int yytype_int16;
 # endif
 #endif
 
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-/* Identity function, used to suppress warnings about constant conditions.  */
-#ifndef lint
-# define YYID(N) (N)
-#else
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static int
-YYID (int yyi)
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
 #else
-static int
-YYID (yyi)
-    int yyi;
+# define YY_INITIAL_VALUE(Value) Value
 #endif
-{
-  return yyi;
-}
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
 #endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -276,8 +456,7 @@ YYID (yyi)
 #    define alloca _alloca
 #   else
 #    define YYSTACK_ALLOC alloca
-#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
 #     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
       /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
 #     ifndef EXIT_SUCCESS
@@ -289,8 +468,8 @@ YYID (yyi)
 # endif
 
 # ifdef YYSTACK_ALLOC
-   /* Pacify GCC's `empty if-body' warning.  */
-#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (YYID (0))
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
     /* The OS might guarantee only one guard page at the bottom of the stack,
        and a page size can be as small as 4096 bytes.  So we cannot safely
@@ -306,7 +485,7 @@ YYID (yyi)
 #  endif
 #  if (defined __cplusplus && ! defined EXIT_SUCCESS \
        && ! ((defined YYMALLOC || defined malloc) \
-	     && (defined YYFREE || defined free)))
+             && (defined YYFREE || defined free)))
 #   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
 #   ifndef EXIT_SUCCESS
 #    define EXIT_SUCCESS 0
@@ -314,40 +493,37 @@ YYID (yyi)
 #  endif
 #  ifndef YYMALLOC
 #   define YYMALLOC malloc
-#   if ! defined malloc && ! defined EXIT_SUCCESS && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined malloc && ! defined EXIT_SUCCESS
 void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 #  ifndef YYFREE
 #   define YYFREE free
-#   if ! defined free && ! defined EXIT_SUCCESS && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined free && ! defined EXIT_SUCCESS
 void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* !defined yyoverflow */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
-	 || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
 
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss_alloc;
+  yy_state_t yyss_alloc;
   YYSTYPE yyvs_alloc;
 };
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE)) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
       + YYSTACK_GAP_MAXIMUM)
 
 # define YYCOPY_NEEDED 1
@@ -357,16 +533,16 @@ union yyalloc
    elements in the stack, and YYPTR gives the new location of the
    stack.  Advance YYPTR to a properly aligned location for the next
    stack.  */
-# define YYSTACK_RELOCATE(Stack_alloc, Stack)				\
-    do									\
-      {									\
-	YYSIZE_T yynewbytes;						\
-	YYCOPY (&yyptr->Stack_alloc, Stack, yysize);			\
-	Stack = &yyptr->Stack_alloc;					\
-	yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-	yyptr += yynewbytes / sizeof (*yyptr);				\
-      }									\
-    while (YYID (0))
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
 
 #endif
 
@@ -376,16 +552,16 @@ union yyalloc
 # ifndef YYCOPY
 #  if defined __GNUC__ && 1 < __GNUC__
 #   define YYCOPY(Dst, Src, Count) \
-      __builtin_memcpy (Dst, Src, (Count) * sizeof (*(Src)))
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
 #  else
 #   define YYCOPY(Dst, Src, Count)              \
       do                                        \
         {                                       \
-          YYSIZE_T yyi;                         \
+          YYPTRDIFF_T yyi;                      \
           for (yyi = 0; yyi < (Count); yyi++)   \
             (Dst)[yyi] = (Src)[yyi];            \
         }                                       \
-      while (YYID (0))
+      while (0)
 #  endif
 # endif
 #endif /* !YYCOPY_NEEDED */
@@ -393,37 +569,42 @@ union yyalloc
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  2
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   114
+#define YYLAST   121
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  17
+#define YYNTOKENS  18
 /* YYNNTS -- Number of nonterminals.  */
 #define YYNNTS  4
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  22
-/* YYNRULES -- Number of states.  */
-#define YYNSTATES  44
+#define YYNRULES  23
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  45
 
-/* YYTRANSLATE(YYLEX) -- Bison symbol number corresponding to YYLEX.  */
-#define YYUNDEFTOK  2
-#define YYMAXUTOK   261
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   262
 
-#define YYTRANSLATE(YYX)						\
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
 
-/* YYTRANSLATE[YYLEX] -- Bison symbol number corresponding to YYLEX.  */
-static const yytype_uint8 yytranslate[] =
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-      13,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+      14,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-      14,    15,     9,     8,    16,     7,     2,    10,     2,     2,
+      15,    16,    10,     9,    17,     8,     2,    11,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     6,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     7,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,    12,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,    13,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -440,230 +621,187 @@ static const yytype_uint8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
-       5,    11
+       5,     6,    12
 };
 
 #if YYDEBUG
-/* YYPRHS[YYN] -- Index of the first RHS symbol of rule number YYN in
-   YYRHS.  */
-static const yytype_uint8 yyprhs[] =
-{
-       0,     0,     3,     4,     7,     9,    12,    15,    17,    19,
-      23,    27,    32,    39,    48,    59,    63,    67,    71,    75,
-      78,    82,    87
-};
-
-/* YYRHS -- A `-1'-separated list of the rules' RHS.  */
-static const yytype_int8 yyrhs[] =
-{
-      18,     0,    -1,    -1,    18,    19,    -1,    13,    -1,    20,
-      13,    -1,     1,    13,    -1,     3,    -1,     4,    -1,     4,
-       6,    20,    -1,     5,    14,    15,    -1,     5,    14,    20,
-      15,    -1,     5,    14,    20,    16,    20,    15,    -1,     5,
-      14,    20,    16,    20,    16,    20,    15,    -1,     5,    14,
-      20,    16,    20,    16,    20,    16,    20,    15,    -1,    20,
-       8,    20,    -1,    20,     7,    20,    -1,    20,     9,    20,
-      -1,    20,    10,    20,    -1,     7,    20,    -1,    20,    12,
-      20,    -1,    20,     9,     9,    20,    -1,    14,    20,    15,
-      -1
-};
-
-/* YYRLINE[YYN] -- source line where rule number YYN was defined.  */
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_uint8 yyrline[] =
 {
-       0,    78,    78,    79,    82,    83,    84,    87,    88,    89,
-      90,    91,    92,    93,    94,    95,    96,    97,    98,    99,
-     100,   101,   102
+       0,   124,   124,   125,   128,   129,   130,   133,   134,   135,
+     136,   137,   138,   139,   140,   141,   142,   143,   144,   145,
+     146,   147,   148,   149
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 0
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "NUM", "VAR", "FNCT", "'='", "'-'",
-  "'+'", "'*'", "'/'", "NEG", "'^'", "'\\n'", "'('", "')'", "','",
-  "$accept", "input", "line", "expr", YY_NULL
+  "\"end of file\"", "error", "\"invalid token\"", "NUM", "SLOT", "VAR",
+  "FNCT", "'='", "'-'", "'+'", "'*'", "'/'", "NEG", "'^'", "'\\n'", "'('",
+  "')'", "','", "$accept", "input", "line", "expr", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[YYLEX-NUM] -- Internal token number corresponding to
-   token YYLEX-NUM.  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,    61,    45,    43,    42,
-      47,   261,    94,    10,    40,    41,    44
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-14)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
 
-/* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
+#define YYTABLE_NINF (-1)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int8 yypact[] =
 {
-       0,    17,    18,    18,    19,    19,    19,    20,    20,    20,
-      20,    20,    20,    20,    20,    20,    20,    20,    20,    20,
-      20,    20,    20
+     -14,    15,   -14,   -13,   -14,   -14,    -4,   -11,    38,   -14,
+      38,   -14,    97,   -14,    38,    32,    -5,    79,    38,    38,
+      46,    38,    38,   -14,   104,   -14,    49,   -14,   108,   108,
+      38,    -5,    -5,    -5,   -14,    38,    -5,    59,   -14,    38,
+      69,   -14,    38,    88,   -14
 };
 
-/* YYR2[YYN] -- Number of symbols composing right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
 {
-       0,     2,     0,     2,     1,     2,     2,     1,     1,     3,
-       3,     4,     6,     8,    10,     3,     3,     3,     3,     2,
-       3,     4,     3
+       2,     0,     1,     0,     7,     9,     8,     0,     0,     4,
+       0,     3,     0,     6,     0,     0,    20,     0,     0,     0,
+       0,     0,     0,     5,    10,    11,     0,    23,    17,    16,
+       0,    18,    19,    21,    12,     0,    22,     0,    13,     0,
+       0,    14,     0,     0,    15
 };
 
-/* YYDEFACT[STATE-NAME] -- Default reduction number in state STATE-NUM.
-   Performed when YYTABLE doesn't specify something else to do.  Zero
-   means the default is an error.  */
-static const yytype_uint8 yydefact[] =
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int8 yypgoto[] =
 {
-       2,     0,     1,     0,     7,     8,     0,     0,     4,     0,
-       3,     0,     6,     0,     0,    19,     0,     0,     0,     0,
-       0,     0,     5,     9,    10,     0,    22,    16,    15,     0,
-      17,    18,    20,    11,     0,    21,     0,    12,     0,     0,
-      13,     0,     0,    14
+     -14,   -14,   -14,    -8
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int8 yydefgoto[] =
 {
-      -1,     1,    10,    11
+       0,     1,    11,    12
 };
 
-/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-   STATE-NUM.  */
-#define YYPACT_NINF -13
-static const yytype_int8 yypact[] =
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int8 yytable[] =
 {
-     -13,    16,   -13,   -12,   -13,    -3,   -10,    42,   -13,    42,
-     -13,    91,   -13,    42,    21,    -4,    73,    42,    42,    34,
-      42,    42,   -13,    98,   -13,    43,   -13,   102,   102,    42,
-      -4,    -4,    -4,   -13,    42,    -4,    53,   -13,    42,    63,
-     -13,    42,    82,   -13
+      16,    13,    17,    14,    15,     0,    24,    26,    22,     0,
+      28,    29,    31,    32,    33,     2,     3,     0,     4,     5,
+       6,     7,    36,     8,     0,     0,     0,    37,     0,     9,
+      10,    40,     0,     0,    43,     4,     5,     6,     7,     0,
+       8,     4,     5,     6,     7,     0,     8,    10,    25,     4,
+       5,     6,     7,    10,     8,     0,    30,    18,    19,    20,
+      21,    10,    22,     0,     0,    34,    35,    18,    19,    20,
+      21,     0,    22,     0,     0,    38,    39,    18,    19,    20,
+      21,     0,    22,     0,     0,    41,    42,    18,    19,    20,
+      21,     0,    22,     0,     0,    27,    18,    19,    20,    21,
+       0,    22,     0,     0,    44,    18,    19,    20,    21,     0,
+      22,    23,    18,    19,    20,    21,     0,    22,    20,    21,
+       0,    22
 };
 
-/* YYPGOTO[NTERM-NUM].  */
-static const yytype_int8 yypgoto[] =
+static const yytype_int8 yycheck[] =
 {
-     -13,   -13,   -13,    -7
+       8,    14,    10,     7,    15,    -1,    14,    15,    13,    -1,
+      18,    19,    20,    21,    22,     0,     1,    -1,     3,     4,
+       5,     6,    30,     8,    -1,    -1,    -1,    35,    -1,    14,
+      15,    39,    -1,    -1,    42,     3,     4,     5,     6,    -1,
+       8,     3,     4,     5,     6,    -1,     8,    15,    16,     3,
+       4,     5,     6,    15,     8,    -1,    10,     8,     9,    10,
+      11,    15,    13,    -1,    -1,    16,    17,     8,     9,    10,
+      11,    -1,    13,    -1,    -1,    16,    17,     8,     9,    10,
+      11,    -1,    13,    -1,    -1,    16,    17,     8,     9,    10,
+      11,    -1,    13,    -1,    -1,    16,     8,     9,    10,    11,
+      -1,    13,    -1,    -1,    16,     8,     9,    10,    11,    -1,
+      13,    14,     8,     9,    10,    11,    -1,    13,    10,    11,
+      -1,    13
 };
 
-/* YYTABLE[YYPACT[STATE-NUM]].  What to do in state STATE-NUM.  If
-   positive, shift that token.  If negative, reduce the rule which
-   number is the opposite.  If YYTABLE_NINF, syntax error.  */
-#define YYTABLE_NINF -1
-static const yytype_uint8 yytable[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
-      15,    12,    16,    13,    14,     0,    23,    25,    21,     0,
-      27,    28,    30,    31,    32,     0,     2,     3,     0,     4,
-       5,     6,    35,     7,     4,     5,     6,    36,     7,     8,
-       9,    39,     0,     0,    42,     9,    24,     4,     5,     6,
-       0,     7,     0,    29,     0,     4,     5,     6,     9,     7,
-      17,    18,    19,    20,     0,    21,     9,     0,    33,    34,
-      17,    18,    19,    20,     0,    21,     0,     0,    37,    38,
-      17,    18,    19,    20,     0,    21,     0,     0,    40,    41,
-      17,    18,    19,    20,     0,    21,     0,     0,    26,    17,
-      18,    19,    20,     0,    21,     0,     0,    43,    17,    18,
-      19,    20,     0,    21,    22,    17,    18,    19,    20,     0,
-      21,    19,    20,     0,    21
+       0,    19,     0,     1,     3,     4,     5,     6,     8,    14,
+      15,    20,    21,    14,     7,    15,    21,    21,     8,     9,
+      10,    11,    13,    14,    21,    16,    21,    16,    21,    21,
+      10,    21,    21,    21,    16,    17,    21,    21,    16,    17,
+      21,    16,    17,    21,    16
 };
 
-#define yypact_value_is_default(Yystate) \
-  (!!((Yystate) == (-13)))
-
-#define yytable_value_is_error(Yytable_value) \
-  YYID (0)
-
-static const yytype_int8 yycheck[] =
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
 {
-       7,    13,     9,     6,    14,    -1,    13,    14,    12,    -1,
-      17,    18,    19,    20,    21,    -1,     0,     1,    -1,     3,
-       4,     5,    29,     7,     3,     4,     5,    34,     7,    13,
-      14,    38,    -1,    -1,    41,    14,    15,     3,     4,     5,
-      -1,     7,    -1,     9,    -1,     3,     4,     5,    14,     7,
-       7,     8,     9,    10,    -1,    12,    14,    -1,    15,    16,
-       7,     8,     9,    10,    -1,    12,    -1,    -1,    15,    16,
-       7,     8,     9,    10,    -1,    12,    -1,    -1,    15,    16,
-       7,     8,     9,    10,    -1,    12,    -1,    -1,    15,     7,
-       8,     9,    10,    -1,    12,    -1,    -1,    15,     7,     8,
-       9,    10,    -1,    12,    13,     7,     8,     9,    10,    -1,
-      12,     9,    10,    -1,    12
+       0,    18,    19,    19,    20,    20,    20,    21,    21,    21,
+      21,    21,    21,    21,    21,    21,    21,    21,    21,    21,
+      21,    21,    21,    21
 };
 
-/* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-   symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
 {
-       0,    18,     0,     1,     3,     4,     5,     7,    13,    14,
-      19,    20,    13,     6,    14,    20,    20,     7,     8,     9,
-      10,    12,    13,    20,    15,    20,    15,    20,    20,     9,
-      20,    20,    20,    15,    16,    20,    20,    15,    16,    20,
-      15,    16,    20,    15
+       0,     2,     0,     2,     1,     2,     2,     1,     1,     1,
+       3,     3,     4,     6,     8,    10,     3,     3,     3,     3,
+       2,     3,     4,     3
 };
 
-#define yyerrok		(yyerrstatus = 0)
-#define yyclearin	(yychar = YYEMPTY)
-#define YYEMPTY		(-2)
-#define YYEOF		0
-
-#define YYACCEPT	goto yyacceptlab
-#define YYABORT		goto yyabortlab
-#define YYERROR		goto yyerrorlab
-
-
-/* Like YYERROR except do call yyerror.  This remains here temporarily
-   to ease the transition to the new meaning of YYERROR, for GCC.
-   Once GCC version 2 has supplanted version 1, this can go.  However,
-   YYFAIL appears to be in use.  Nevertheless, it is formally deprecated
-   in Bison 2.4.2's NEWS entry, where a plan to phase it out is
-   discussed.  */
-
-#define YYFAIL		goto yyerrlab
-#if defined YYFAIL
-  /* This is here to suppress warnings from the GCC cpp's
-     -Wunused-macros.  Normally we don't worry about that warning, but
-     some users do, and we want to make it easy for users to remove
-     YYFAIL uses, which will produce warnings from Bison 2.5.  */
-#endif
 
-#define YYRECOVERING()  (!!yyerrstatus)
+enum { YYENOMEM = -2 };
 
-#define YYBACKUP(Token, Value)                                  \
-do                                                              \
-  if (yychar == YYEMPTY)                                        \
-    {                                                           \
-      yychar = (Token);                                         \
-      yylval = (Value);                                         \
-      YYPOPSTACK (yylen);                                       \
-      yystate = *yyssp;                                         \
-      goto yybackup;                                            \
-    }                                                           \
-  else                                                          \
-    {                                                           \
-      yyerror (p, YY_("syntax error: cannot back up")); \
-      YYERROR;							\
-    }								\
-while (YYID (0))
-
-/* Error token number */
-#define YYTERROR	1
-#define YYERRCODE	256
-
-
-/* This macro is provided for backward compatibility. */
-#ifndef YY_LOCATION_PRINT
-# define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-#endif
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
 
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (p, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
-/* YYLEX -- calling `yylex' with the right arguments.  */
-#ifdef YYLEX_PARAM
-# define YYLEX yylex (YYLEX_PARAM)
-#else
-# define YYLEX yylex (p)
-#endif
 
 /* Enable debugging if requested.  */
 #if YYDEBUG
@@ -673,85 +811,59 @@ while (YYID (0))
 #  define YYFPRINTF fprintf
 # endif
 
-# define YYDPRINTF(Args)			\
-do {						\
-  if (yydebug)					\
-    YYFPRINTF Args;				\
-} while (YYID (0))
-
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)			  \
-do {									  \
-  if (yydebug)								  \
-    {									  \
-      YYFPRINTF (stderr, "%s ", Title);					  \
-      yy_symbol_print (stderr,						  \
-		  Type, Value, p); \
-      YYFPRINTF (stderr, "\n");						  \
-    }									  \
-} while (YYID (0))
-
-
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
-
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, param *p)
-#else
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, p); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
 static void
-yy_symbol_value_print (yyoutput, yytype, yyvaluep, p)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-    param *p;
-#endif
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, param *p)
 {
-  FILE *yyo = yyoutput;
-  YYUSE (yyo);
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (p);
   if (!yyvaluep)
     return;
-  YYUSE (p);
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# else
-  YYUSE (yyoutput);
-# endif
-  switch (yytype)
-    {
-      default:
-        break;
-    }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, param *p)
-#else
 static void
-yy_symbol_print (yyoutput, yytype, yyvaluep, p)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-    param *p;
-#endif
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, param *p)
 {
-  if (yytype < YYNTOKENS)
-    YYFPRINTF (yyoutput, "token %s (", yytname[yytype]);
-  else
-    YYFPRINTF (yyoutput, "nterm %s (", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep, p);
-  YYFPRINTF (yyoutput, ")");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, p);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -759,16 +871,8 @@ yy_symbol_print (yyoutput, yytype, yyvaluep, p)
 | TOP (included).                                                   |
 `------------------------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_stack_print (yytype_int16 *yybottom, yytype_int16 *yytop)
-#else
 static void
-yy_stack_print (yybottom, yytop)
-    yytype_int16 *yybottom;
-    yytype_int16 *yytop;
-#endif
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
   for (; yybottom <= yytop; yybottom++)
@@ -779,64 +883,56 @@ yy_stack_print (yybottom, yytop)
   YYFPRINTF (stderr, "\n");
 }
 
-# define YY_STACK_PRINT(Bottom, Top)				\
-do {								\
-  if (yydebug)							\
-    yy_stack_print ((Bottom), (Top));				\
-} while (YYID (0))
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
 
 
 /*------------------------------------------------.
 | Report that the YYRULE is going to be reduced.  |
 `------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_reduce_print (YYSTYPE *yyvsp, int yyrule, param *p)
-#else
 static void
-yy_reduce_print (yyvsp, yyrule, p)
-    YYSTYPE *yyvsp;
-    int yyrule;
-    param *p;
-#endif
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, param *p)
 {
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  unsigned long int yylno = yyrline[yyrule];
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
-	     yyrule - 1, yylno);
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
-      yy_symbol_print (stderr, yyrhs[yyprhs[yyrule] + yyi],
-		       &(yyvsp[(yyi + 1) - (yynrhs)])
-		       		       , p);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], p);
       YYFPRINTF (stderr, "\n");
     }
 }
 
-# define YY_REDUCE_PRINT(Rule)		\
-do {					\
-  if (yydebug)				\
-    yy_reduce_print (yyvsp, Rule, p); \
-} while (YYID (0))
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule, p); \
+} while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
 
 
 /* YYINITDEPTH -- initial size of the parser's stacks.  */
-#ifndef	YYINITDEPTH
+#ifndef YYINITDEPTH
 # define YYINITDEPTH 200
 #endif
 
@@ -852,365 +948,84 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
-
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
-/* Return the length of YYSTR.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static YYSIZE_T
-yystrlen (const char *yystr)
-#else
-static YYSIZE_T
-yystrlen (yystr)
-    const char *yystr;
-#endif
-{
-  YYSIZE_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
-
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-#else
-static char *
-yystpcpy (yydest, yysrc)
-    char *yydest;
-    const char *yysrc;
-#endif
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
-
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
-
-  return yyd - 1;
-}
-#  endif
-# endif
-
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYSIZE_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
-    {
-      YYSIZE_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-	switch (*++yyp)
-	  {
-	  case '\'':
-	  case ',':
-	    goto do_not_strip_quotes;
-
-	  case '\\':
-	    if (*++yyp != '\\')
-	      goto do_not_strip_quotes;
-	    /* Fall through.  */
-	  default:
-	    if (yyres)
-	      yyres[yyn] = *yyp;
-	    yyn++;
-	    break;
-
-	  case '"':
-	    if (yyres)
-	      yyres[yyn] = '\0';
-	    return yyn;
-	  }
-    do_not_strip_quotes: ;
-    }
-
-  if (! yyres)
-    return yystrlen (yystr);
-
-  return yystpcpy (yyres, yystr) - yyres;
-}
-# endif
-
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
-
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
-static int
-yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
-                yytype_int16 *yyssp, int yytoken)
-{
-  YYSIZE_T yysize0 = yytnamerr (YY_NULL, yytname[yytoken]);
-  YYSIZE_T yysize = yysize0;
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULL;
-  /* Arguments of yyformat. */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-  /* Number of reported tokens (one for the "unexpected", one per
-     "expected"). */
-  int yycount = 0;
-
-  /* There are many possibilities here to consider:
-     - Assume YYFAIL is not used.  It's too flawed to consider.  See
-       <http://lists.gnu.org/archive/html/bison-patches/2009-12/msg00024.html>
-       for details.  YYERROR is fine as it does not invoke this
-       function.
-     - If this state is a consistent state with a default action, then
-       the only way this function was invoked is if the default action
-       is an error action.  In that case, don't check for expected
-       tokens because there are none.
-     - The only way there can be no lookahead present (in yychar) is if
-       this state is a consistent state with a default action.  Thus,
-       detecting the absence of a lookahead is sufficient to determine
-       that there is no unexpected or expected token to report.  In that
-       case, just report a simple "syntax error".
-     - Don't assume there isn't a lookahead just because this state is a
-       consistent state with a default action.  There might have been a
-       previous inconsistent state, consistent state with a non-default
-       action, or user semantic action that manipulated yychar.
-     - Of course, the expected token list depends on states to have
-       correct lookahead information, and it depends on the parser not
-       to perform extra reductions after fetching a lookahead from the
-       scanner and before detecting a syntax error.  Thus, state merging
-       (from LALR or IELR) and default reductions corrupt the expected
-       token list.  However, the list is correct for canonical LR with
-       one exception: it will still contain any token that will not be
-       accepted due to an error action in a later state.
-  */
-  if (yytoken != YYEMPTY)
-    {
-      int yyn = yypact[*yyssp];
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYSIZE_T yysize1 = yysize + yytnamerr (YY_NULL, yytname[yyx]);
-                  if (! (yysize <= yysize1
-                         && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-                    return 2;
-                  yysize = yysize1;
-                }
-              }
-        }
-    }
-
-  switch (yycount)
-    {
-# define YYCASE_(N, S)                      \
-      case N:                               \
-        yyformat = S;                       \
-      break
-      YYCASE_(0, YY_("syntax error"));
-      YYCASE_(1, YY_("syntax error, unexpected %s"));
-      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
-      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
-      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
-      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
-    }
 
-  {
-    YYSIZE_T yysize1 = yysize + yystrlen (yyformat);
-    if (! (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-      return 2;
-    yysize = yysize1;
-  }
 
-  if (*yymsg_alloc < yysize)
-    {
-      *yymsg_alloc = 2 * yysize;
-      if (! (yysize <= *yymsg_alloc
-             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
-        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
-    }
 
-  /* Avoid sprintf, as that infringes on the user's name space.
-     Don't have undefined behavior even if the translation
-     produced a string with the wrong number of "%s"s.  */
-  {
-    char *yyp = *yymsg;
-    int yyi = 0;
-    while ((*yyp = *yyformat) != '\0')
-      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
-        {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
-          yyformat += 2;
-        }
-      else
-        {
-          yyp++;
-          yyformat++;
-        }
-  }
-  return 0;
-}
-#endif /* YYERROR_VERBOSE */
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, param *p)
-#else
 static void
-yydestruct (yymsg, yytype, yyvaluep, p)
-    const char *yymsg;
-    int yytype;
-    YYSTYPE *yyvaluep;
-    param *p;
-#endif
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, param *p)
 {
-  YYUSE (yyvaluep);
-  YYUSE (p);
-
+  YY_USE (yyvaluep);
+  YY_USE (p);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
-
-  switch (yytype)
-    {
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
-      default:
-        break;
-    }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
 
 
-/* The lookahead symbol.  */
-int yychar;
-
-
-#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-# define YY_IGNORE_MAYBE_UNINITIALIZED_END
-#endif
-#ifndef YY_INITIAL_VALUE
-# define YY_INITIAL_VALUE(Value) /* Nothing. */
-#endif
-
-/* The semantic value of the lookahead symbol.  */
-YYSTYPE yylval YY_INITIAL_VALUE(yyval_default);
-
-/* Number of syntax errors so far.  */
-int yynerrs;
 
 
 /*----------.
 | yyparse.  |
 `----------*/
 
-#ifdef YYPARSE_PARAM
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-int
-yyparse (void *YYPARSE_PARAM)
-#else
-int
-yyparse (YYPARSE_PARAM)
-    void *YYPARSE_PARAM;
-#endif
-#else /* ! YYPARSE_PARAM */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 int
 yyparse (param *p)
-#else
-int
-yyparse (p)
-    param *p;
-#endif
-#endif
 {
-    int yystate;
-    /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
+/* Lookahead token kind.  */
+int yychar;
+
+
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
 
-    /* The stacks and their tools:
-       `yyss': related to states.
-       `yyvs': related to semantic values.
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
 
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
-    yytype_int16 yyssa[YYINITDEPTH];
-    yytype_int16 *yyss;
-    yytype_int16 *yyssp;
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
 
-    /* The semantic value stack.  */
-    YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    YYSIZE_T yystacksize;
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
 
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
 
@@ -1218,102 +1033,107 @@ yyparse (p)
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
-	/* Give user a chance to reallocate the stack.  Use copies of
-	   these so that the &'s don't force the real ones into
-	   memory.  */
-	YYSTYPE *yyvs1 = yyvs;
-	yytype_int16 *yyss1 = yyss;
-
-	/* Each stack pointer address is followed by the size of the
-	   data in use in that stack, in bytes.  This used to be a
-	   conditional around just the two extra args, but that might
-	   be undefined if yyoverflow is a macro.  */
-	yyoverflow (YY_("memory exhausted"),
-		    &yyss1, yysize * sizeof (*yyssp),
-		    &yyvs1, yysize * sizeof (*yyvsp),
-		    &yystacksize);
-
-	yyss = yyss1;
-	yyvs = yyvs1;
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-	goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
-	yystacksize = YYMAXDEPTH;
+        yystacksize = YYMAXDEPTH;
 
       {
-	yytype_int16 *yyss1 = yyss;
-	union yyalloc *yyptr =
-	  (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
-	if (! yyptr)
-	  goto yyexhaustedlab;
-	YYSTACK_RELOCATE (yyss_alloc, yyss);
-	YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
 #  undef YYSTACK_RELOCATE
-	if (yyss1 != yyssa)
-	  YYSTACK_FREE (yyss1);
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
 
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-		  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
-	YYABORT;
+        YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
 
   if (yystate == YYFINAL)
     YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
      lookahead token if we need one and don't already have one.  */
 
@@ -1324,18 +1144,29 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
-      yychar = YYLEX;
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, p);
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1363,15 +1194,13 @@ yybackup:
 
   /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token.  */
-  yychar = YYEMPTY;
-
   yystate = yyn;
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1386,14 +1215,14 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
   yylen = yyr2[yyn];
 
   /* If YYLEN is nonzero, implement the default value of the action:
-     `$$ = $1'.
+     '$$ = $1'.
 
      Otherwise, the following line sets YYVAL to garbage.
      This behavior is undocumented and Bison
@@ -1406,117 +1235,123 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 5:
-/* Line 1792 of yacc.c  */
-#line 83 "parser.y"
-    { res=(yyvsp[(1) - (2)].dval); }
+  case 5: /* line: expr '\n'  */
+#line 129 "parser.y"
+                      { p->root = p->root ? new_op(p, NODE_SEQ, p->root, (yyvsp[-1].node)) : (yyvsp[-1].node); }
+#line 1242 "parser.tab.c"
     break;
 
-  case 6:
-/* Line 1792 of yacc.c  */
-#line 84 "parser.y"
-    { yyerrok; }
+  case 6: /* line: error '\n'  */
+#line 130 "parser.y"
+                     { yyerrok; }
+#line 1248 "parser.tab.c"
     break;
 
-  case 7:
-/* Line 1792 of yacc.c  */
-#line 87 "parser.y"
-    { (yyval.dval) = (yyvsp[(1) - (1)].dval);                         }
+  case 7: /* expr: NUM  */
+#line 133 "parser.y"
+                     { (yyval.node) = new_num(p, (yyvsp[0].dval));                     }
+#line 1254 "parser.tab.c"
     break;
 
-  case 8:
-/* Line 1792 of yacc.c  */
-#line 88 "parser.y"
-    { (yyval.dval) = (yyvsp[(1) - (1)].tptr)->value.var;              }
+  case 8: /* expr: VAR  */
+#line 134 "parser.y"
+                     { (yyval.node) = new_node(p, NODE_VAR); (yyval.node)->sym = (yyvsp[0].tptr); }
+#line 1260 "parser.tab.c"
     break;
 
-  case 9:
-/* Line 1792 of yacc.c  */
-#line 89 "parser.y"
-    { (yyval.dval) = (yyvsp[(3) - (3)].dval); (yyvsp[(1) - (3)].tptr)->value.var = (yyvsp[(3) - (3)].dval);     }
+  case 9: /* expr: SLOT  */
+#line 135 "parser.y"
+                     { (yyval.node) = new_node(p, NODE_SLOT); (yyval.node)->slot = (yyvsp[0].ival); }
+#line 1266 "parser.tab.c"
     break;
 
-  case 10:
-/* Line 1792 of yacc.c  */
-#line 90 "parser.y"
-    { (yyval.dval) = (*((yyvsp[(1) - (3)].tptr)->value.fnctptr))();   }
+  case 10: /* expr: VAR '=' expr  */
+#line 136 "parser.y"
+                     { (yyval.node) = new_node(p, NODE_ASSIGN); (yyval.node)->sym = assignable(p, (yyvsp[-2].tptr)); (yyval.node)->nargs = 1; (yyval.node)->args[0] = (yyvsp[0].node); }
+#line 1272 "parser.tab.c"
     break;
 
-  case 11:
-/* Line 1792 of yacc.c  */
-#line 91 "parser.y"
-    { (yyval.dval) = (*((yyvsp[(1) - (4)].tptr)->value.fnctptr))((yyvsp[(3) - (4)].dval)); }
+  case 11: /* expr: FNCT '(' ')'  */
+#line 137 "parser.y"
+                     { (yyval.node) = new_fnct(p, (yyvsp[-2].tptr), 0, 0, 0, 0, 0);     }
+#line 1278 "parser.tab.c"
     break;
 
-  case 12:
-/* Line 1792 of yacc.c  */
-#line 92 "parser.y"
-    { (yyval.dval) = (*((yyvsp[(1) - (6)].tptr)->value.fnctptr))((yyvsp[(3) - (6)].dval),(yyvsp[(5) - (6)].dval)); }
+  case 12: /* expr: FNCT '(' expr ')'  */
+#line 138 "parser.y"
+                     { (yyval.node) = new_fnct(p, (yyvsp[-3].tptr), 1, (yyvsp[-1].node), 0, 0, 0);    }
+#line 1284 "parser.tab.c"
     break;
 
-  case 13:
-/* Line 1792 of yacc.c  */
-#line 93 "parser.y"
-    { (yyval.dval) = (*((yyvsp[(1) - (8)].tptr)->value.fnctptr))((yyvsp[(3) - (8)].dval),(yyvsp[(5) - (8)].dval),(yyvsp[(7) - (8)].dval)); }
+  case 13: /* expr: FNCT '(' expr ',' expr ')'  */
+#line 139 "parser.y"
+                              { (yyval.node) = new_fnct(p, (yyvsp[-5].tptr), 2, (yyvsp[-3].node), (yyvsp[-1].node), 0, 0); }
+#line 1290 "parser.tab.c"
     break;
 
-  case 14:
-/* Line 1792 of yacc.c  */
-#line 94 "parser.y"
-    { (yyval.dval) = (*((yyvsp[(1) - (10)].tptr)->value.fnctptr))((yyvsp[(3) - (10)].dval),(yyvsp[(5) - (10)].dval),(yyvsp[(7) - (10)].dval),(yyvsp[(9) - (10)].dval)); }
+  case 14: /* expr: FNCT '(' expr ',' expr ',' expr ')'  */
+#line 140 "parser.y"
+                                      { (yyval.node) = new_fnct(p, (yyvsp[-7].tptr), 3, (yyvsp[-5].node), (yyvsp[-3].node), (yyvsp[-1].node), 0); }
+#line 1296 "parser.tab.c"
     break;
 
-  case 15:
-/* Line 1792 of yacc.c  */
-#line 95 "parser.y"
-    { (yyval.dval) = (yyvsp[(1) - (3)].dval) + (yyvsp[(3) - (3)].dval);                    }
+  case 15: /* expr: FNCT '(' expr ',' expr ',' expr ',' expr ')'  */
+#line 141 "parser.y"
+                                               { (yyval.node) = new_fnct(p, (yyvsp[-9].tptr), 4, (yyvsp[-7].node), (yyvsp[-5].node), (yyvsp[-3].node), (yyvsp[-1].node)); }
+#line 1302 "parser.tab.c"
     break;
 
-  case 16:
-/* Line 1792 of yacc.c  */
-#line 96 "parser.y"
-    { (yyval.dval) = (yyvsp[(1) - (3)].dval) - (yyvsp[(3) - (3)].dval);                    }
+  case 16: /* expr: expr '+' expr  */
+#line 142 "parser.y"
+                     { (yyval.node) = new_op(p, NODE_ADD, (yyvsp[-2].node), (yyvsp[0].node));        }
+#line 1308 "parser.tab.c"
     break;
 
-  case 17:
-/* Line 1792 of yacc.c  */
-#line 97 "parser.y"
-    { (yyval.dval) = (yyvsp[(1) - (3)].dval) * (yyvsp[(3) - (3)].dval);                    }
+  case 17: /* expr: expr '-' expr  */
+#line 143 "parser.y"
+                     { (yyval.node) = new_op(p, NODE_SUB, (yyvsp[-2].node), (yyvsp[0].node));        }
+#line 1314 "parser.tab.c"
     break;
 
-  case 18:
-/* Line 1792 of yacc.c  */
-#line 98 "parser.y"
-    { (yyval.dval) = (yyvsp[(1) - (3)].dval) / (yyvsp[(3) - (3)].dval);                    }
+  case 18: /* expr: expr '*' expr  */
+#line 144 "parser.y"
+                     { (yyval.node) = new_op(p, NODE_MUL, (yyvsp[-2].node), (yyvsp[0].node));        }
+#line 1320 "parser.tab.c"
     break;
 
-  case 19:
-/* Line 1792 of yacc.c  */
-#line 99 "parser.y"
-    { (yyval.dval) = -(yyvsp[(2) - (2)].dval);                        }
+  case 19: /* expr: expr '/' expr  */
+#line 145 "parser.y"
+                     { (yyval.node) = new_op(p, NODE_DIV, (yyvsp[-2].node), (yyvsp[0].node));        }
+#line 1326 "parser.tab.c"
     break;
 
-  case 20:
-/* Line 1792 of yacc.c  */
-#line 100 "parser.y"
-    { (yyval.dval) = pow ((yyvsp[(1) - (3)].dval), (yyvsp[(3) - (3)].dval));               }
+  case 20: /* expr: '-' expr  */
+#line 146 "parser.y"
+                     { (yyval.node) = new_op(p, NODE_NEG, (yyvsp[0].node), 0);         }
+#line 1332 "parser.tab.c"
     break;
 
-  case 21:
-/* Line 1792 of yacc.c  */
-#line 101 "parser.y"
-    { (yyval.dval) = pow ((yyvsp[(1) - (4)].dval), (yyvsp[(4) - (4)].dval));               }
+  case 21: /* expr: expr '^' expr  */
+#line 147 "parser.y"
+                     { (yyval.node) = new_op(p, NODE_POW, (yyvsp[-2].node), (yyvsp[0].node));        }
+#line 1338 "parser.tab.c"
+    break;
+
+  case 22: /* expr: expr '*' '*' expr  */
+#line 148 "parser.y"
+                     { (yyval.node) = new_op(p, NODE_POW, (yyvsp[-3].node), (yyvsp[0].node));        }
+#line 1344 "parser.tab.c"
     break;
 
-  case 22:
-/* Line 1792 of yacc.c  */
-#line 102 "parser.y"
-    { (yyval.dval) = (yyvsp[(2) - (3)].dval);                         }
+  case 23: /* expr: '(' expr ')'  */
+#line 149 "parser.y"
+                     { (yyval.node) = (yyvsp[-1].node);                                 }
+#line 1350 "parser.tab.c"
     break;
 
 
-/* Line 1792 of yacc.c  */
-#line 1520 "parser.tab.c"
+#line 1354 "parser.tab.c"
+
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -1530,96 +1365,58 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
 
-  /* Now `shift' the result of the reduction.  Determine what state
+  /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
 
-/*------------------------------------.
-| yyerrlab -- here on detecting error |
-`------------------------------------*/
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
       yyerror (p, YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
-      {
-        char const *yymsgp = YY_("syntax error");
-        int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
-        if (yysyntax_error_status == 0)
-          yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
-          {
-            if (yymsg != yymsgbuf)
-              YYSTACK_FREE (yymsg);
-            yymsg = (char *) YYSTACK_ALLOC (yymsg_alloc);
-            if (!yymsg)
-              {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
-              }
-            else
-              {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
-              }
-          }
-        yyerror (p, yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
-      }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
-
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
-	 error, discard it.  */
+         error, discard it.  */
 
       if (yychar <= YYEOF)
-	{
-	  /* Return failure if at end of input.  */
-	  if (yychar == YYEOF)
-	    YYABORT;
-	}
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
       else
-	{
-	  yydestruct ("Error: discarding",
-		      yytoken, &yylval, p);
-	  yychar = YYEMPTY;
-	}
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, p);
+          yychar = YYEMPTY;
+        }
     }
 
   /* Else will try to reuse lookahead token after shifting the error
@@ -1631,14 +1428,13 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ (0))
-     goto yyerrorlab;
-
-  /* Do not reclaim the symbols of the rule which action triggered
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
   YYPOPSTACK (yylen);
   yylen = 0;
@@ -1651,29 +1447,30 @@ yyerrorlab:
 | yyerrlab1 -- common code for both syntax error and YYERROR.  |
 `-------------------------------------------------------------*/
 yyerrlab1:
-  yyerrstatus = 3;	/* Each real token shifted decrements this.  */
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
-	{
-	  yyn += YYTERROR;
-	  if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
-	    {
-	      yyn = yytable[yyn];
-	      if (0 < yyn)
-		break;
-	    }
-	}
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
 
       /* Pop the current state because it cannot handle the error token.  */
       if (yyssp == yyss)
-	YYABORT;
+        YYABORT;
 
 
       yydestruct ("Error: popping",
-		  yystos[yystate], yyvsp, p);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, p);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -1685,7 +1482,7 @@ yyerrlab1:
 
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -1696,26 +1493,30 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (p, YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
+
 
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -1724,125 +1525,333 @@ yyreturn:
       yydestruct ("Cleanup: discarding lookahead",
                   yytoken, &yylval, p);
     }
-  /* Do not reclaim the symbols of the rule which action triggered
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
   YYPOPSTACK (yylen);
   YY_STACK_PRINT (yyss, yyssp);
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-		  yystos[*yyssp], yyvsp, p);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, p);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
-  /* Make sure YYID is used.  */
-  return YYID (yyresult);
-}
 
+  return yyresult;
+}
 
-/* Line 2055 of yacc.c  */
-#line 105 "parser.y"
+#line 152 "parser.y"
 
 
-/* global symbol table */
-symrec *sym_table = 0;
+/* default context used by the functions without context parameter */
+static parser_context *default_context = 0;
 
 int parse_errors() {
-	return yynerrs;
+	return default_context ? default_context->nerrors : 0;
 }
 
 int yyerror(param *p, const char *s) {
+	p->ctx->nerrors++;
 	/* remove trailing newline */
 	p->string[strcspn(p->string, "\n")] = 0;
 	printf("PARSER ERROR: %s @ position %d of string \'%s\'\n", s, p->pos, p->string);
 	return 0;
 }
 
-/* save symbol in symbol table */
-symrec* putsym(const char *sym_name, int sym_type) {
+/* FNV-1a hash of a symbol name. different seeds give independent hash functions */
+static unsigned int sym_hash(unsigned int seed, const char *name) {
+	unsigned int h = 2166136261u ^ (seed * 16777619u);
+	for (; *name; name++)
+		h = (h ^ (unsigned char)*name) * 16777619u;
+	return h;
+}
+
+/* built-in functions and constants.
+ * they are stored at the position given by a minimal perfect hash of their name (hash and displace):
+ * the first hash selects a displacement d. d < 0 is the position -d-1, otherwise the position is
+ * the hash with seed d. the table is build once and is read-only afterwards */
+#define NFUNCTIONS (sizeof(_functions)/sizeof(_functions[0]) - 1)
+#define NCONSTANTS (sizeof(_constants)/sizeof(_constants[0]) - 1)
+#define NBUILTINS (NFUNCTIONS + NCONSTANTS)
+
+static symrec builtins[NBUILTINS];
+static int builtin_displace[NBUILTINS];
+static unsigned int nbuiltins = 0;	/* number of different names */
+/* the digamma function for the derivatives of gamma and lgamma. "psi" is hidden by the constant of the same name */
+static symrec digamma_sym;
+
+static int compare_names(const void *a, const void *b) {
+	const symrec *s1 = *(const symrec **)a, *s2 = *(const symrec **)b;
+	int res = strcmp(s1->name, s2->name);
+	/* keep the order of the tables for equal names */
+	return res ? res : (s1 < s2 ? -1 : (s1 > s2));
+}
+
+static int compare_buckets(const void *a, const void *b) {
+	const unsigned int *b1 = (const unsigned int *)a, *b2 = (const unsigned int *)b;
+	/* largest buckets first */
+	return (b1[0] < b2[0]) - (b1[0] > b2[0]);
+}
+
+static void init_builtins(void) {
+	symrec *entries = (symrec *) malloc(NBUILTINS * sizeof(symrec));
+	symrec **sorted = (symrec **) malloc(NBUILTINS * sizeof(symrec *));
+	unsigned int i, j, n = 0;
+
+	for (i = 0; i < NFUNCTIONS; i++) {
+		entries[i].name = (char *)_functions[i].name;
+		entries[i].type = FNCT;
+		entries[i].value.fnctptr = _functions[i].fnct;
+	}
+	for (i = 0; i < NCONSTANTS; i++) {
+		entries[NFUNCTIONS + i].name = (char *)_constants[i].name;
+		entries[NFUNCTIONS + i].type = VAR;
+		entries[NFUNCTIONS + i].value.var = _constants[i].value;
+	}
+
+	/* remove duplicate names, the last entry wins (constants hide functions) */
+	for (i = 0; i < NBUILTINS; i++)
+		sorted[i] = &entries[i];
+	qsort(sorted, NBUILTINS, sizeof(symrec *), compare_names);
+	for (i = 0; i < NBUILTINS; i++) {
+		if (i + 1 < NBUILTINS && strcmp(sorted[i]->name, sorted[i+1]->name) == 0)
+			continue;
+		sorted[n++] = sorted[i];
+	}
+	nbuiltins = n;
+	digamma_sym.name = (char *)"psi";
+	digamma_sym.type = FNCT;
+	digamma_sym.value.fnctptr = gsl_sf_psi;
+
+	/* sort the names into buckets by the first hash */
+	unsigned int *bucket = (unsigned int *) malloc(n * sizeof(unsigned int));
+	unsigned int *sizes = (unsigned int *) calloc(2 * n, sizeof(unsigned int));	/* pairs (size, bucket) */
+	unsigned int *start = (unsigned int *) calloc(n + 1, sizeof(unsigned int));
+	unsigned int *keys = (unsigned int *) malloc(n * sizeof(unsigned int));
+	for (i = 0; i < n; i++) {
+		bucket[i] = sym_hash(0, sorted[i]->name) % n;
+		start[bucket[i] + 1]++;
+	}
+	for (i = 0; i < n; i++) {
+		sizes[2*i] = start[i + 1];
+		sizes[2*i + 1] = i;
+		start[i + 1] += start[i];
+	}
+	for (i = 0; i < n; i++)
+		keys[start[bucket[i]]++] = i;
+	for (i = n; i > 0; i--)	/* start[] was moved by one bucket */
+		start[i] = start[i - 1];
+	start[0] = 0;
+	qsort(sizes, n, 2 * sizeof(unsigned int), compare_buckets);
+
+	/* find a displacement for every bucket with more than one name, place the single names in free positions */
+	char *used = (char *) calloc(n, 1);
+	unsigned int *pos = (unsigned int *) malloc(n * sizeof(unsigned int));
+	unsigned int free_pos = 0;
+	for (i = 0; i < n; i++) {
+		const unsigned int size = sizes[2*i], b = sizes[2*i + 1];
+		const unsigned int *bkeys = keys + start[b];
+		if (size == 0) {
+			builtin_displace[b] = 0;
+		} else if (size == 1) {
+			while (used[free_pos])
+				free_pos++;
+			used[free_pos] = 1;
+			builtins[free_pos] = *sorted[bkeys[0]];
+			builtin_displace[b] = -(int)free_pos - 1;
+		} else {
+			int d;
+			for (d = 1; ; d++) {
+				for (j = 0; j < size; j++) {
+					pos[j] = sym_hash(d, sorted[bkeys[j]]->name) % n;
+					if (used[pos[j]])
+						break;
+					used[pos[j]] = 1;
+				}
+				if (j == size)
+					break;
+				/* collision: release the positions of this try */
+				while (j-- > 0)
+					used[pos[j]] = 0;
+			}
+			for (j = 0; j < size; j++)
+				builtins[pos[j]] = *sorted[bkeys[j]];
+			builtin_displace[b] = d;
+		}
+	}
+	for (i = 0; i < n; i++)
+		builtins[i].next = 0;
+
+	free(pos);
+	free(used);
+	free(keys);
+	free(start);
+	free(sizes);
+	free(bucket);
+	free(sorted);
+	free(entries);
+	pdebug("PARSER: init_builtins() DONE (%u symbols)\n", n);
+}
+
+#ifdef _WIN32
+static INIT_ONCE builtins_once = INIT_ONCE_STATIC_INIT;
+static BOOL CALLBACK init_builtins_once(PINIT_ONCE once, PVOID param, PVOID *context) {
+	init_builtins();
+	return TRUE;
+}
+#define INIT_BUILTINS() InitOnceExecuteOnce(&builtins_once, init_builtins_once, NULL, NULL)
+#else
+static pthread_once_t builtins_once = PTHREAD_ONCE_INIT;
+#define INIT_BUILTINS() pthread_once(&builtins_once, init_builtins)
+#endif
+
+/* get built-in function or constant. h is the hash of name with seed 0 */
+static symrec* getbuiltin(const char *name, unsigned int h) {
+	if (nbuiltins == 0)
+		return 0;
+	const int d = builtin_displace[h % nbuiltins];
+	symrec *ptr = &builtins[d < 0 ? (unsigned int)(-d - 1) : sym_hash(d, name) % nbuiltins];
+	return strcmp(ptr->name, name) == 0 ? ptr : 0;
+}
+
+static int is_builtin(const symrec *sym) {
+	return sym >= builtins && sym < builtins + NBUILTINS;
+}
+
+/* save variable in the hash table of the context */
+static symrec* putsym(parser_context *ctx, const char *sym_name, int sym_type) {
 	pdebug("PARSER: putsym(): sym_name = %s\n", sym_name);
 
+	unsigned int i;
+	if (ctx->nvars >= ctx->nbuckets) {
+		/* rehash into a table of double size */
+		const unsigned int nbuckets = 2 * ctx->nbuckets;
+		symrec **vars = (symrec **) calloc(nbuckets, sizeof(symrec *));
+		for (i = 0; i < ctx->nbuckets; i++) {
+			while (ctx->vars[i]) {
+				symrec *tmp = ctx->vars[i];
+				ctx->vars[i] = tmp->next;
+				const unsigned int b = sym_hash(0, tmp->name) & (nbuckets - 1);
+				tmp->next = vars[b];
+				vars[b] = tmp;
+			}
+		}
+		free(ctx->vars);
+		ctx->vars = vars;
+		ctx->nbuckets = nbuckets;
+	}
+
 	symrec *ptr = (symrec *) malloc(sizeof (symrec));
 	ptr->name = (char *) malloc(strlen (sym_name) + 1);
 	strcpy(ptr->name, sym_name);
 	ptr->type = sym_type;
 	ptr->value.var = 0;	/* set value to 0 even if fctn */
-	ptr->next = (struct symrec *)sym_table;
-	sym_table = ptr;
-	
+	i = sym_hash(0, sym_name) & (ctx->nbuckets - 1);
+	ptr->next = ctx->vars[i];
+	ctx->vars[i] = ptr;
+	ctx->nvars++;
+
 	pdebug("PARSER: putsym() DONE\n");
 	return ptr;
 }
 
-/* get symbol from symbol table */
-symrec* getsym(const char *sym_name) {
-	pdebug("PARSER: getsym(): sym_name = %s\n", sym_name);
-	
+/* get variable of the context */
+static symrec* getvar(const parser_context *ctx, const char *sym_name, unsigned int h) {
 	symrec *ptr;
-	for (ptr = sym_table; ptr != 0; ptr = (symrec *)ptr->next) {
-		/* pdebug("%s ", ptr->name); */
-		if (strcmp(ptr->name, sym_name) == 0) {
-			pdebug("PARSER: symbol \'%s\' found\n", sym_name);
+	for (ptr = ctx->vars[h & (ctx->nbuckets - 1)]; ptr != 0; ptr = ptr->next) {
+		if (strcmp(ptr->name, sym_name) == 0)
 			return ptr;
-		}
 	}
-
-	pdebug("PARSER: symbol \'%s\' not found\n", sym_name);
 	return 0;
 }
 
-void init_table(void) {
-	pdebug("PARSER: init_table()\n");
+/* get symbol: variables of the context hide the built-in functions and constants */
+static symrec* getsym(const parser_context *ctx, const char *sym_name) {
+	pdebug("PARSER: getsym(): sym_name = %s\n", sym_name);
 
-	symrec *ptr = 0;
-	int i;
-	/* add functions */
-	for (i = 0; _functions[i].name != 0; i++) {
-		ptr = putsym (_functions[i].name, FNCT);
-		ptr->value.fnctptr = _functions[i].fnct;
-	}
-	/* add constants */
-	for (i = 0; _constants[i].name != 0; i++) {
-		ptr = putsym (_constants[i].name, VAR);
-		ptr->value.var = _constants[i].value;
-	}
+	const unsigned int h = sym_hash(0, sym_name);
+	symrec *ptr = getvar(ctx, sym_name, h);
+	if (!ptr)
+		ptr = getbuiltin(sym_name, h);
 
-	pdebug("PARSER: init_table() DONE sym_table = %p\n", ptr);
+	pdebug("PARSER: symbol \'%s\' %s\n", sym_name, ptr ? "found" : "not found");
+	return ptr;
 }
 
-void delete_table(void) {
-	while(sym_table) {
-		symrec *tmp = sym_table;
-		sym_table = sym_table->next;
-		free(tmp->name);
-		free(tmp);
+parser_context* parser_context_new(void) {
+	pdebug("PARSER: parser_context_new()\n");
+	INIT_BUILTINS();
+
+	parser_context *ctx = (parser_context *) malloc(sizeof(parser_context));
+	ctx->nbuckets = 16;
+	ctx->vars = (symrec **) calloc(ctx->nbuckets, sizeof(symrec *));
+	ctx->nvars = 0;
+	ctx->nerrors = 0;
+
+	return ctx;
+}
+
+void parser_context_free(parser_context *ctx) {
+	if (!ctx)
+		return;
+
+	unsigned int i;
+	for (i = 0; i < ctx->nbuckets; i++) {
+		while (ctx->vars[i]) {
+			symrec *tmp = ctx->vars[i];
+			ctx->vars[i] = tmp->next;
+			free(tmp->name);
+			free(tmp);
+		}
 	}
+	free(ctx->vars);
+	free(ctx);
 }
 
-symrec* assign_variable(const char* symb_name, double value) {
-	/* new style: pdebug("PARSER: assign_variable(): symb_name = %s value = %g sym_table = %p\n", var.name, var.value, sym_table);*/
+symrec* parser_context_assign_variable(parser_context *ctx, const char* symb_name, double value) {
 	pdebug("PARSER: assign_variable() : symb_name = %s value=%g\n", symb_name, value);
 
-	/* be sure that the symbol table has been initialized */
-	if (!sym_table)
-		init_table();
-
-	symrec* ptr = getsym(symb_name);
+	symrec* ptr = getvar(ctx, symb_name, sym_hash(0, symb_name));
 	if (!ptr) {
 		pdebug("PARSER: calling putsym(): symb_name = %s\n", symb_name);
-		ptr = putsym(symb_name, VAR);
+		ptr = putsym(ctx, symb_name, VAR);
 	}
 	ptr->value.var = value;
 
 	return ptr;
-};
+}
+
+/* the built-in constants are shared and can't be changed: assignments create a variable hiding them */
+static symrec* assignable(param *p, symrec *sym) {
+	if (!is_builtin(sym))
+		return sym;
+	symrec *var = putsym(p->ctx, sym->name, VAR);
+	var->value.var = sym->value.var;
+	return var;
+}
+
+int parser_context_errors(const parser_context *ctx) {
+	return ctx->nerrors;
+}
+
+void init_table(void) {
+	if (!default_context)
+		default_context = parser_context_new();
+}
+
+void delete_table(void) {
+	parser_context_free(default_context);
+	default_context = 0;
+}
+
+symrec* assign_variable(const char* symb_name, double value) {
+	/* be sure that the symbol table has been initialized */
+	init_table();
+	return parser_context_assign_variable(default_context, symb_name, value);
+}
 
 static int getcharstr(param *p) {
 	pdebug("PARSER: getcharstr() pos = %d\n", p->pos);
@@ -1858,33 +1867,754 @@ static void ungetcstr(unsigned int *pos) {
         (*pos)--;
 }
 
-double parse(const char *str) {
-	pdebug("\nPARSER: parse(\"%s\") len=%zu\n", str, strlen(str));
+/* syntax tree */
 
-	/* be sure that the symbol table has been initialized */
-	if (!sym_table)
-		init_table();
+static parser_node* new_node(param *p, node_type type) {
+	parser_node *node = (parser_node *) calloc(1, sizeof(parser_node));
+	node->type = type;
+	node->next = p->nodes;
+	p->nodes = node;
+	return node;
+}
 
-	param p;
-	p.pos = 0;
+static parser_node* new_num(param *p, double value) {
+	parser_node *node = new_node(p, NODE_NUM);
+	node->value = value;
+	return node;
+}
+
+/* creates an operator node, operations on numbers are evaluated immediately */
+static parser_node* new_op(param *p, node_type type, parser_node *left, parser_node *right) {
+	if (left->type == NODE_NUM && (!right || right->type == NODE_NUM)) {
+		switch (type) {
+		case NODE_ADD:
+			return new_num(p, left->value + right->value);
+		case NODE_SUB:
+			return new_num(p, left->value - right->value);
+		case NODE_MUL:
+			return new_num(p, left->value * right->value);
+		case NODE_DIV:
+			return new_num(p, left->value / right->value);
+		case NODE_NEG:
+			return new_num(p, -left->value);
+		case NODE_POW:
+			return new_num(p, pow(left->value, right->value));
+		default:
+			break;
+		}
+	}
+
+	parser_node *node = new_node(p, type);
+	node->nargs = right ? 2 : 1;
+	node->args[0] = left;
+	node->args[1] = right;
+	return node;
+}
+
+static parser_node* new_fnct(param *p, symrec *sym, int nargs, parser_node *a1, parser_node *a2, parser_node *a3, parser_node *a4) {
+	parser_node *node = new_node(p, NODE_FNCT);
+	node->sym = sym;
+	node->nargs = nargs;
+	node->args[0] = a1;
+	node->args[1] = a2;
+	node->args[2] = a3;
+	node->args[3] = a4;
+	return node;
+}
+
+static void free_nodes(param *p) {
+	while (p->nodes) {
+		parser_node *tmp = p->nodes;
+		p->nodes = p->nodes->next;
+		free(tmp);
+	}
+	p->root = 0;
+}
+
+static double eval_node(const parser_node *node) {
+	switch (node->type) {
+	case NODE_NUM:
+		return node->value;
+	case NODE_VAR:
+		return node->sym->value.var;
+	case NODE_SLOT:	/* not used when parsing */
+		return NAN;
+	case NODE_ASSIGN:
+		return (node->sym->value.var = eval_node(node->args[0]));
+	case NODE_FNCT:
+		switch (node->nargs) {
+		case 0:
+			return (*(node->sym->value.fnctptr))();
+		case 1:
+			return (*(node->sym->value.fnctptr))(eval_node(node->args[0]));
+		case 2:
+			return (*(node->sym->value.fnctptr))(eval_node(node->args[0]), eval_node(node->args[1]));
+		case 3:
+			return (*(node->sym->value.fnctptr))(eval_node(node->args[0]), eval_node(node->args[1]),
+				eval_node(node->args[2]));
+		default:
+			return (*(node->sym->value.fnctptr))(eval_node(node->args[0]), eval_node(node->args[1]),
+				eval_node(node->args[2]), eval_node(node->args[3]));
+		}
+	case NODE_ADD:
+		return eval_node(node->args[0]) + eval_node(node->args[1]);
+	case NODE_SUB:
+		return eval_node(node->args[0]) - eval_node(node->args[1]);
+	case NODE_MUL:
+		return eval_node(node->args[0]) * eval_node(node->args[1]);
+	case NODE_DIV:
+		return eval_node(node->args[0]) / eval_node(node->args[1]);
+	case NODE_NEG:
+		return -eval_node(node->args[0]);
+	case NODE_POW:
+		return pow(eval_node(node->args[0]), eval_node(node->args[1]));
+	case NODE_SEQ:	/* value of the last line */
+		eval_node(node->args[0]);
+		return eval_node(node->args[1]);
+	}
+
+	return NAN;
+}
+
+/* parses str into p->root. vars are the names of the bound variables */
+static void parse_tree(param *p, parser_context *ctx, const char *str, const char *vars[], int nvars) {
+	p->pos = 0;
+	p->ctx = ctx;
+	p->symbuf = 0;
+	p->symlength = 0;
+	p->vars = vars;
+	p->nvars = nvars;
+	p->root = 0;
+	p->nodes = 0;
 	/* leave space to terminate string by "\n\0" */
 	size_t slen = strlen(str) + 2;
-	p.string = (char *) malloc(slen * sizeof(char));
+	p->string = (char *) malloc(slen * sizeof(char));
 
-	strncpy(p.string, str, slen);
-	p.string[strlen(p.string)] = '\n';
-	pdebug("\nPARSER: yyparse(\"%s\") len=%zu\n", p.string, strlen(p.string));
+	strncpy(p->string, str, slen);
+	p->string[strlen(p->string)] = '\n';
+	pdebug("\nPARSER: yyparse(\"%s\") len=%zu\n", p->string, strlen(p->string));
 
+	ctx->nerrors = 0;
 	/* parameter for yylex */
-	yyparse(&p);
+	yyparse(p);
+
+	free(p->string);
+	p->string = 0;
+	free(p->symbuf);
+	p->symbuf = 0;
+}
+
+double parser_context_parse(parser_context *ctx, const char *str) {
+	pdebug("\nPARSER: parse(\"%s\") len=%zu\n", str, strlen(str));
 
-	pdebug("PARSER: parse() DONE (res = %g, parse errors = %d)\n", res, parse_errors());
-	free(p.string);
-	p.string = 0;
+	param p;
+	parse_tree(&p, ctx, str, 0, 0);
+
+	double res = NAN;
+	if (p.root && ctx->nerrors == 0)
+		res = eval_node(p.root);
+	free_nodes(&p);
+
+	pdebug("PARSER: parse() DONE (res = %g, parse errors = %d)\n", res, ctx->nerrors);
+	return res;
+}
+
+double parse(const char *str) {
+	/* be sure that the symbol table has been initialized */
+	init_table();
+	return parser_context_parse(default_context, str);
+}
+
+/* compiled expressions */
+
+typedef enum {OP_NUM, OP_VAR, OP_SLOT, OP_ASSIGN, OP_FNCT, OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_NEG, OP_POW, OP_SEQ} opcode;
+
+/* instruction of the stack machine evaluating a compiled expression */
+typedef struct parser_instr {
+	opcode op;
+	int arg;		/* index of a bound variable or number of function arguments */
+	double value;		/* value of a NUM */
+	symrec *sym;		/* symbol of a VAR or assignment */
+	func_t fnct;		/* function */
+} parser_instr;
+
+struct parser_program {
+	parser_instr *code;	/* instructions in postfix order */
+	int ncode;		/* number of instructions */
+	int stack_size;		/* maximal stack depth */
+	int nvars;		/* number of bound variables */
+};
+
+static int count_nodes(const parser_node *node) {
+	int i, count = 1;
+	for (i = 0; i < node->nargs; i++)
+		count += count_nodes(node->args[i]);
+	return count;
+}
+
+/* appends the instructions of node to prog, depth is the current stack depth */
+static void emit(parser_program *prog, const parser_node *node, int depth) {
+	int i;
+	for (i = 0; i < node->nargs; i++)
+		emit(prog, node->args[i], depth + i);
+
+	parser_instr *instr = &prog->code[prog->ncode++];
+	instr->arg = 0;
+	instr->value = 0;
+	instr->sym = 0;
+	instr->fnct = 0;
+	switch (node->type) {
+	case NODE_NUM:
+		instr->op = OP_NUM;
+		instr->value = node->value;
+		break;
+	case NODE_VAR:
+		instr->op = OP_VAR;
+		instr->sym = node->sym;
+		break;
+	case NODE_SLOT:
+		instr->op = OP_SLOT;
+		instr->arg = node->slot;
+		break;
+	case NODE_ASSIGN:
+		instr->op = OP_ASSIGN;
+		instr->sym = node->sym;
+		break;
+	case NODE_FNCT:
+		instr->op = OP_FNCT;
+		instr->arg = node->nargs;
+		instr->fnct = node->sym->value.fnctptr;
+		break;
+	case NODE_ADD:
+		instr->op = OP_ADD;
+		break;
+	case NODE_SUB:
+		instr->op = OP_SUB;
+		break;
+	case NODE_MUL:
+		instr->op = OP_MUL;
+		break;
+	case NODE_DIV:
+		instr->op = OP_DIV;
+		break;
+	case NODE_NEG:
+		instr->op = OP_NEG;
+		break;
+	case NODE_POW:
+		instr->op = OP_POW;
+		break;
+	case NODE_SEQ:
+		instr->op = OP_SEQ;
+		break;
+	}
+
+	/* the result of the node is stored at position depth */
+	if (depth + 1 > prog->stack_size)
+		prog->stack_size = depth + 1;
+}
+
+/* creates the program of the syntax tree root */
+static parser_program* compile_tree(const parser_node *root, int nvars) {
+	parser_program *prog = (parser_program *) malloc(sizeof(parser_program));
+	prog->code = (parser_instr *) malloc(count_nodes(root) * sizeof(parser_instr));
+	prog->ncode = 0;
+	prog->stack_size = 0;
+	prog->nvars = nvars;
+	emit(prog, root, 0);
+	return prog;
+}
+
+parser_program* parser_context_compile(parser_context *ctx, const char *str, const char *vars[], int nvars) {
+	pdebug("\nPARSER: parser_compile(\"%s\") nvars=%d\n", str, nvars);
+
+	param p;
+	parse_tree(&p, ctx, str, vars, nvars);
+	if (!p.root || ctx->nerrors > 0) {
+		free_nodes(&p);
+		return 0;
+	}
+
+	parser_program *prog = compile_tree(p.root, nvars);
+	free_nodes(&p);
+
+	pdebug("PARSER: parser_compile() DONE (%d instructions, stack size %d)\n", prog->ncode, prog->stack_size);
+	return prog;
+}
+
+parser_program* parser_compile(const char *str, const char *vars[], int nvars) {
+	/* be sure that the symbol table has been initialized */
+	init_table();
+	return parser_context_compile(default_context, str, vars, nvars);
+}
+
+/* symbolic differentiation */
+
+/* derivatives of the functions with one argument, u is the argument */
+static const struct {
+	const char *name;
+	const char *derivative;
+} derivatives[] = {
+	{"sin", "cos(u)"}, {"cos", "-sin(u)"}, {"tan", "1/cos(u)^2"},
+	{"sec", "sec(u)*tan(u)"}, {"csc", "-csc(u)*cot(u)"}, {"cot", "-1/sin(u)^2"},
+	{"asin", "1/sqrt(1-u^2)"}, {"acos", "-1/sqrt(1-u^2)"}, {"atan", "1/(1+u^2)"},
+	{"sinh", "cosh(u)"}, {"cosh", "sinh(u)"}, {"tanh", "1-tanh(u)^2"},
+	{"asinh", "1/sqrt(u^2+1)"}, {"acosh", "1/sqrt(u^2-1)"}, {"atanh", "1/(1-u^2)"},
+	{"exp", "exp(u)"}, {"expm1", "exp(u)"},
+	{"log", "1/u"}, {"log10", "0.43429448190325182765/u"}, {"log1p", "1/(1+u)"},
+	{"sqrt", "0.5/sqrt(u)"}, {"cbrt", "1/(3*cbrt(u)^2)"},
+	{"fabs", "sgn(u)"}, {"sgn", "0"},
+	{"erf", "1.1283791670955125739*exp(-u^2)"}, {"erfc", "-1.1283791670955125739*exp(-u^2)"},
+	{0, 0}
+};
+
+static int is_number(const parser_node *node, double value) {
+	return node->type == NODE_NUM && node->value == value;
+}
+
+/* creates an operator node of a derivative, removes operations with 0 and 1 */
+static parser_node* new_dop(param *p, node_type type, parser_node *left, parser_node *right) {
+	switch (type) {
+	case NODE_ADD:
+		if (is_number(left, 0))
+			return right;
+		if (is_number(right, 0))
+			return left;
+		break;
+	case NODE_SUB:
+		if (is_number(right, 0))
+			return left;
+		if (is_number(left, 0))
+			return new_dop(p, NODE_NEG, right, 0);
+		break;
+	case NODE_MUL:
+		if (is_number(left, 0) || is_number(right, 0))
+			return new_num(p, 0);
+		if (is_number(left, 1))
+			return right;
+		if (is_number(right, 1))
+			return left;
+		break;
+	case NODE_DIV:
+		if (is_number(left, 0))
+			return new_num(p, 0);
+		if (is_number(right, 1))
+			return left;
+		break;
+	case NODE_NEG:
+		if (left->type == NODE_NEG)
+			return left->args[0];
+		break;
+	case NODE_POW:
+		if (is_number(right, 0))
+			return new_num(p, 1);
+		if (is_number(right, 1))
+			return left;
+		break;
+	default:
+		break;
+	}
+	return new_op(p, type, left, right);
+}
+
+/* returns 1 if node depends on the bound variable slot */
+static int depends_on(const parser_node *node, int slot) {
+	int i;
+	if (node->type == NODE_SLOT)
+		return node->slot == slot;
+	for (i = 0; i < node->nargs; i++)
+		if (depends_on(node->args[i], slot))
+			return 1;
+	return 0;
+}
+
+/* returns 1 if the tree contains an assignment */
+static int has_assignment(const parser_node *node) {
+	int i;
+	if (node->type == NODE_ASSIGN)
+		return 1;
+	for (i = 0; i < node->nargs; i++)
+		if (has_assignment(node->args[i]))
+			return 1;
+	return 0;
+}
 
+/* copies the tree node of another parse, the bound variable is replaced by u */
+static parser_node* substitute(param *p, const parser_node *node, parser_node *u) {
+	parser_node *copy;
+	int i;
+	switch (node->type) {
+	case NODE_SLOT:
+		return u;
+	case NODE_NUM:
+		return new_num(p, node->value);
+	default:
+		copy = new_node(p, node->type);
+		copy->value = node->value;
+		copy->sym = node->sym;
+		copy->nargs = node->nargs;
+		for (i = 0; i < node->nargs; i++)
+			copy->args[i] = substitute(p, node->args[i], u);
+		return copy;
+	}
+}
+
+/* derivative of the function sym at u. returns 0 if the derivative is unknown */
+static parser_node* function_derivative(param *p, const symrec *sym, parser_node *u) {
+	const char *vars[] = {"u"};
+	int i;
+	if (strcmp(sym->name, "gamma") == 0 || strcmp(sym->name, "lgamma") == 0) {
+		parser_node *psi = new_fnct(p, &digamma_sym, 1, u, 0, 0, 0);
+		if (sym->name[0] == 'l')	/* psi(u) */
+			return psi;
+		/* gamma(u)*psi(u) */
+		return new_dop(p, NODE_MUL, new_fnct(p, (symrec *)sym, 1, u, 0, 0, 0), psi);
+	}
+	for (i = 0; derivatives[i].name != 0; i++) {
+		if (strcmp(derivatives[i].name, sym->name) != 0)
+			continue;
+
+		param t;
+		parse_tree(&t, p->ctx, derivatives[i].derivative, vars, 1);
+		parser_node *res = 0;
+		if (t.root && p->ctx->nerrors == 0)
+			res = substitute(p, t.root, u);
+		free_nodes(&t);
+		return res;
+	}
+	return 0;
+}
+
+/* derivative of node with respect to the bound variable slot. returns 0 if it can't be calculated */
+static parser_node* derivative(param *p, parser_node *node, int slot) {
+	if (node->type == NODE_SEQ)	/* only the last line gives the value */
+		return derivative(p, node->args[1], slot);
+	if (!depends_on(node, slot))
+		return new_num(p, 0);
+
+	parser_node *l = node->args[0], *r = node->args[1], *dl = 0, *dr = 0, *df;
+	if (node->nargs > 0 && !(dl = derivative(p, l, slot)))
+		return 0;
+	if (node->nargs > 1 && !(dr = derivative(p, r, slot)))
+		return 0;
+
+	switch (node->type) {
+	case NODE_SLOT:
+		return new_num(p, 1);
+	case NODE_ADD:
+	case NODE_SUB:
+		return new_dop(p, node->type, dl, dr);
+	case NODE_NEG:
+		return new_dop(p, NODE_NEG, dl, 0);
+	case NODE_MUL:	/* l'r + lr' */
+		return new_dop(p, NODE_ADD, new_dop(p, NODE_MUL, dl, r), new_dop(p, NODE_MUL, l, dr));
+	case NODE_DIV:	/* (l'r - lr')/r^2 */
+		return new_dop(p, NODE_DIV, new_dop(p, NODE_SUB, new_dop(p, NODE_MUL, dl, r), new_dop(p, NODE_MUL, l, dr)),
+			new_dop(p, NODE_MUL, r, r));
+	case NODE_FNCT:
+		if (node->nargs == 2 && strcmp(node->sym->name, "pow") == 0)
+			break;
+		if (node->nargs != 1 || !(df = function_derivative(p, node->sym, l)))
+			return 0;
+		return new_dop(p, NODE_MUL, df, dl);
+	case NODE_POW:
+		break;
+	default:	/* NUM and VAR don't depend on slot, assignments are not supported */
+		return 0;
+	}
+
+	/* l^r */
+	parser_node *lnode = new_fnct(p, getbuiltin("log", sym_hash(0, "log")), 1, l, 0, 0, 0);
+	if (!depends_on(r, slot))	/* r l^(r-1) l' */
+		return new_dop(p, NODE_MUL, new_dop(p, NODE_MUL, r, new_dop(p, NODE_POW, l, new_dop(p, NODE_SUB, r, new_num(p, 1)))), dl);
+	if (!depends_on(l, slot))	/* l^r log(l) r' */
+		return new_dop(p, NODE_MUL, new_dop(p, NODE_MUL, new_dop(p, NODE_POW, l, r), lnode), dr);
+	/* l^r (r' log(l) + r l'/l) */
+	return new_dop(p, NODE_MUL, new_dop(p, NODE_POW, l, r),
+		new_dop(p, NODE_ADD, new_dop(p, NODE_MUL, dr, lnode), new_dop(p, NODE_DIV, new_dop(p, NODE_MUL, r, dl), l)));
+}
+
+parser_program* parser_context_compile_derivative(parser_context *ctx, const char *str, const char *vars[], int nvars, int var) {
+	pdebug("\nPARSER: parser_compile_derivative(\"%s\") var=%d\n", str, var);
+
+	param p;
+	parse_tree(&p, ctx, str, vars, nvars);
+	if (!p.root || ctx->nerrors > 0 || has_assignment(p.root)) {
+		free_nodes(&p);
+		return 0;
+	}
+
+	parser_program *prog = 0;
+	parser_node *root = derivative(&p, p.root, var);
+	if (root)
+		prog = compile_tree(root, nvars);
+	free_nodes(&p);
+
+	pdebug("PARSER: parser_compile_derivative() DONE (%d instructions)\n", prog ? prog->ncode : 0);
+	return prog;
+}
+
+parser_program* parser_compile_derivative(const char *str, const char *vars[], int nvars, int var) {
+	/* be sure that the symbol table has been initialized */
+	init_table();
+	return parser_context_compile_derivative(default_context, str, vars, nvars, var);
+}
+
+int parser_thread_safe(const parser_program *prog) {
+	int i;
+	for (i = 0; i < prog->ncode; i++) {
+		/* assignments change the symbol table, functions without arguments are random number generators */
+		if (prog->code[i].op == OP_ASSIGN || (prog->code[i].op == OP_FNCT && prog->code[i].arg == 0))
+			return 0;
+	}
+	return 1;
+}
+
+int parser_uses_variable(const parser_program *prog, int var) {
+	int i;
+	for (i = 0; i < prog->ncode; i++) {
+		if (prog->code[i].op == OP_SLOT && prog->code[i].arg == var)
+			return 1;
+	}
+	return 0;
+}
+
+void parser_free(parser_program *prog) {
+	if (!prog)
+		return;
+	free(prog->code);
+	free(prog);
+}
+
+static double run_program(const parser_program *prog, const double *values, double *stack) {
+	const parser_instr *instr = prog->code, *end = prog->code + prog->ncode;
+	int sp = -1;
+
+	for (; instr != end; instr++) {
+		switch (instr->op) {
+		case OP_NUM:
+			stack[++sp] = instr->value;
+			break;
+		case OP_VAR:
+			stack[++sp] = instr->sym->value.var;
+			break;
+		case OP_SLOT:
+			stack[++sp] = values[instr->arg];
+			break;
+		case OP_ASSIGN:
+			instr->sym->value.var = stack[sp];
+			break;
+		case OP_FNCT:
+			switch (instr->arg) {
+			case 0:
+				stack[++sp] = (*(instr->fnct))();
+				break;
+			case 1:
+				stack[sp] = (*(instr->fnct))(stack[sp]);
+				break;
+			case 2:
+				sp--;
+				stack[sp] = (*(instr->fnct))(stack[sp], stack[sp+1]);
+				break;
+			case 3:
+				sp -= 2;
+				stack[sp] = (*(instr->fnct))(stack[sp], stack[sp+1], stack[sp+2]);
+				break;
+			default:
+				sp -= 3;
+				stack[sp] = (*(instr->fnct))(stack[sp], stack[sp+1], stack[sp+2], stack[sp+3]);
+			}
+			break;
+		case OP_ADD:
+			sp--;
+			stack[sp] += stack[sp+1];
+			break;
+		case OP_SUB:
+			sp--;
+			stack[sp] -= stack[sp+1];
+			break;
+		case OP_MUL:
+			sp--;
+			stack[sp] *= stack[sp+1];
+			break;
+		case OP_DIV:
+			sp--;
+			stack[sp] /= stack[sp+1];
+			break;
+		case OP_NEG:
+			stack[sp] = -stack[sp];
+			break;
+		case OP_POW:
+			sp--;
+			stack[sp] = pow(stack[sp], stack[sp+1]);
+			break;
+		case OP_SEQ:
+			sp--;
+			stack[sp] = stack[sp+1];
+			break;
+		}
+	}
+
+	return stack[0];
+}
+
+#define PARSER_STACK_SIZE 64
+
+double parser_eval(const parser_program *prog, const double *values) {
+	double buffer[PARSER_STACK_SIZE];
+	double *stack = buffer;
+	if (prog->stack_size > PARSER_STACK_SIZE)
+		stack = (double *) malloc(prog->stack_size * sizeof(double));
+
+	double res = run_program(prog, values, stack);
+
+	if (stack != buffer)
+		free(stack);
 	return res;
 }
 
+/* number of points evaluated together by parser_eval_array() */
+#define PARSER_BLOCK_SIZE 256
+
+/* evaluates prog for the n <= PARSER_BLOCK_SIZE points starting at first. every instruction is applied to
+ * all points of the block, so the interpreter overhead is shared and the compiler can vectorize the loops.
+ * stack holds stack_size blocks. the result is in the first block of the stack */
+static void run_program_block(const parser_program *prog, const double * const values[], const size_t strides[],
+		size_t first, size_t n, double *stack) {
+	const parser_instr *instr = prog->code, *end = prog->code + prog->ncode;
+	double *top = stack - PARSER_BLOCK_SIZE, *a, *b, *c, *d;
+	const double *src;
+	double value;
+	size_t k, stride;
+
+	for (; instr != end; instr++) {
+		switch (instr->op) {
+		case OP_NUM:
+		case OP_VAR:
+			top += PARSER_BLOCK_SIZE;
+			value = (instr->op == OP_NUM) ? instr->value : instr->sym->value.var;
+			for (k = 0; k < n; k++)
+				top[k] = value;
+			break;
+		case OP_SLOT:
+			top += PARSER_BLOCK_SIZE;
+			stride = strides[instr->arg];
+			src = values[instr->arg] + first*stride;
+			if (stride == 1)
+				memcpy(top, src, n * sizeof(double));
+			else
+				for (k = 0; k < n; k++)
+					top[k] = src[k*stride];
+			break;
+		case OP_ASSIGN:	/* programs with assignments are evaluated point by point */
+			break;
+		case OP_FNCT:
+			switch (instr->arg) {
+			case 0:
+				top += PARSER_BLOCK_SIZE;
+				for (k = 0; k < n; k++)
+					top[k] = (*(instr->fnct))();
+				break;
+			case 1:
+				for (k = 0; k < n; k++)
+					top[k] = (*(instr->fnct))(top[k]);
+				break;
+			case 2:
+				top -= PARSER_BLOCK_SIZE;
+				b = top + PARSER_BLOCK_SIZE;
+				for (k = 0; k < n; k++)
+					top[k] = (*(instr->fnct))(top[k], b[k]);
+				break;
+			case 3:
+				top -= 2 * PARSER_BLOCK_SIZE;
+				b = top + PARSER_BLOCK_SIZE;
+				c = b + PARSER_BLOCK_SIZE;
+				for (k = 0; k < n; k++)
+					top[k] = (*(instr->fnct))(top[k], b[k], c[k]);
+				break;
+			default:
+				top -= 3 * PARSER_BLOCK_SIZE;
+				b = top + PARSER_BLOCK_SIZE;
+				c = b + PARSER_BLOCK_SIZE;
+				d = c + PARSER_BLOCK_SIZE;
+				for (k = 0; k < n; k++)
+					top[k] = (*(instr->fnct))(top[k], b[k], c[k], d[k]);
+			}
+			break;
+		case OP_ADD:
+			top -= PARSER_BLOCK_SIZE;
+			a = top + PARSER_BLOCK_SIZE;
+			for (k = 0; k < n; k++)
+				top[k] += a[k];
+			break;
+		case OP_SUB:
+			top -= PARSER_BLOCK_SIZE;
+			a = top + PARSER_BLOCK_SIZE;
+			for (k = 0; k < n; k++)
+				top[k] -= a[k];
+			break;
+		case OP_MUL:
+			top -= PARSER_BLOCK_SIZE;
+			a = top + PARSER_BLOCK_SIZE;
+			for (k = 0; k < n; k++)
+				top[k] *= a[k];
+			break;
+		case OP_DIV:
+			top -= PARSER_BLOCK_SIZE;
+			a = top + PARSER_BLOCK_SIZE;
+			for (k = 0; k < n; k++)
+				top[k] /= a[k];
+			break;
+		case OP_NEG:
+			for (k = 0; k < n; k++)
+				top[k] = -top[k];
+			break;
+		case OP_POW:
+			top -= PARSER_BLOCK_SIZE;
+			a = top + PARSER_BLOCK_SIZE;
+			for (k = 0; k < n; k++)
+				top[k] = pow(top[k], a[k]);
+			break;
+		case OP_SEQ:
+			top -= PARSER_BLOCK_SIZE;
+			memcpy(top, top + PARSER_BLOCK_SIZE, n * sizeof(double));
+			break;
+		}
+	}
+}
+
+void parser_eval_array(const parser_program *prog, const double * const values[], const size_t strides[], double *result, size_t n) {
+	size_t i;
+	int j;
+
+	/* assignments and random numbers have to be evaluated point by point in the right order */
+	if (!parser_thread_safe(prog)) {
+		double buffer[PARSER_STACK_SIZE];
+		double *stack = buffer;
+		if (prog->stack_size > PARSER_STACK_SIZE)
+			stack = (double *) malloc(prog->stack_size * sizeof(double));
+		double *slots = (double *) malloc((prog->nvars > 0 ? prog->nvars : 1) * sizeof(double));
+
+		for (i = 0; i < n; i++) {
+			for (j = 0; j < prog->nvars; j++)
+				slots[j] = values[j][i*strides[j]];
+			result[i] = run_program(prog, slots, stack);
+		}
+
+		free(slots);
+		if (stack != buffer)
+			free(stack);
+		return;
+	}
+
+	double *stack = (double *) malloc(prog->stack_size * PARSER_BLOCK_SIZE * sizeof(double));
+	for (i = 0; i < n; i += PARSER_BLOCK_SIZE) {
+		const size_t count = (n - i < PARSER_BLOCK_SIZE) ? n - i : PARSER_BLOCK_SIZE;
+		run_program_block(prog, values, strides, i, count, stack);
+		memcpy(result + i, stack, count * sizeof(double));
+	}
+	free(stack);
+}
+
 double parse_with_vars(const char *str, const parser_var *vars, int nvars) {
 	pdebug("\nPARSER: parse_with_var(\"%s\") len=%zu\n", str, strlen(str));
 	int i;
@@ -1896,7 +2626,7 @@ double parse_with_vars(const char *str, const parser_var *vars, int nvars) {
 	return parse(str);
 }
 
-int yylex(param *p) {
+int yylex(YYSTYPE *lvalp, param *p) {
 	pdebug("PARSER: yylex()\n");
 	int c;
 
@@ -1911,7 +2641,7 @@ int yylex(param *p) {
 	/* check for non-ASCII chars */
 	if (!isascii(c)) {
 		pdebug("non-ASCII character found. Giving up\n");
-		yynerrs++;
+		p->ctx->nerrors++;
 		return 0;
 	}
 
@@ -1943,7 +2673,7 @@ int yylex(param *p) {
 
 		pdebug("PARSER: result = %g\n", result);
 
-		yylval.dval = result;
+		lvalp->dval = result;
 
                 p->pos += strlen(s) - strlen(remain);
 
@@ -1952,20 +2682,19 @@ int yylex(param *p) {
 
 	if (isalpha (c) || c == '.') {
 		pdebug("PARSER: reading identifier (starts with alpha: %c)\n", c);
-		static char *symbuf = 0;
-		static int length = 0;
 		int i = 0;
 
 		/* Initially make the buffer long enough for a 10-character symbol name */
-		if (length == 0)
-			length = 10, symbuf = (char *) malloc(length + 1);
+		if (p->symlength == 0)
+			p->symlength = 10, p->symbuf = (char *) malloc(p->symlength + 1);
+		char *symbuf = p->symbuf;
 
 		do {
 			pdebug("reading symbol .. ");
 			/* If buffer is full, make it bigger */
-			if (i == length) {
-				length *= 2;
-				symbuf = (char *) realloc(symbuf, length + 1);
+			if (i == p->symlength) {
+				p->symlength *= 2;
+				symbuf = p->symbuf = (char *) realloc(p->symbuf, p->symlength + 1);
 			}
 			symbuf[i++] = c;
 			c = getcharstr(p);
@@ -1978,17 +2707,25 @@ int yylex(param *p) {
 			ungetcstr(&(p->pos));
 		symbuf[i] = '\0';
 
-		symrec *s = getsym(symbuf);
+		/* bound variables of compiled expressions */
+		for (i = 0; i < p->nvars; i++) {
+			if (strcmp(p->vars[i], symbuf) == 0) {
+				lvalp->ival = i;
+				return SLOT;
+			}
+		}
+
+		symrec *s = getsym(p->ctx, symbuf);
 		if(s == 0) {	/* symbol unknown */
 			pdebug("PARSER: ERROR: symbol \"%s\" UNKNOWN\n", symbuf);
-			yynerrs++;
+			p->ctx->nerrors++;
 			return 0;
 		}
 		/* old behavior */
 		/* if (s == 0)
 			 s = putsym (symbuf, VAR);
 		*/
-		yylval.tptr = s;
+		lvalp->tptr = s;
 		return s->type;
 	}
 
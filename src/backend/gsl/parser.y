@@ -31,6 +31,11 @@
 #include <string.h>
 #include <ctype.h>
 #include <locale.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
 #include "parser.h"
 #include "constants.h"
 #include "functions.h"
@@ -43,30 +48,71 @@
 
 #define YYERROR_VERBOSE 1
 
+/* node types of the syntax tree */
+typedef enum {NODE_NUM, NODE_VAR, NODE_SLOT, NODE_ASSIGN, NODE_FNCT,
+	NODE_ADD, NODE_SUB, NODE_MUL, NODE_DIV, NODE_NEG, NODE_POW, NODE_SEQ} node_type;
+
+/* node of the syntax tree */
+typedef struct parser_node {
+	node_type type;
+	double value;		/* value of a NUM */
+	symrec *sym;		/* symbol of a VAR, FNCT or assignment */
+	int slot;		/* index of a bound variable */
+	int nargs;		/* number of arguments */
+	struct parser_node *args[4];
+	struct parser_node *next;	/* list of all nodes of a parse */
+} parser_node;
+
+/* parser context: variables of the user and number of errors of the last parse.
+ * the functions and constants are shared by all contexts */
+struct parser_context {
+	symrec **vars;		/* hash table of the variables, chained by symrec::next */
+	unsigned int nbuckets;	/* size of vars (power of 2) */
+	unsigned int nvars;	/* number of variables */
+	int nerrors;		/* number of errors of the last parse */
+};
+
 /* params passed to yylex (and yyerror) */
 typedef struct param {
 	unsigned int pos;	/* current position in string */
 	char *string;		/* the string to parse */
-/*	symrec *sym_table;	the symbol table (not used) */
+	parser_context *ctx;	/* context with the symbol table */
+	const char **vars;	/* names of the bound variables (compiled expressions only) */
+	int nvars;		/* number of bound variables */
+	parser_node *root;	/* syntax tree of the expression */
+	parser_node *nodes;	/* all allocated nodes */
+	char *symbuf;		/* buffer for identifiers */
+	int symlength;		/* size of symbuf */
 } param;
 
 int yyerror(param *p, const char *err);
-int yylex(param *p);
 
-double res;
+static parser_node* new_node(param *p, node_type type);
+static parser_node* new_num(param *p, double value);
+static parser_node* new_op(param *p, node_type type, parser_node *left, parser_node *right);
+static parser_node* new_fnct(param *p, symrec *sym, int nargs, parser_node *a1, parser_node *a2, parser_node *a3, parser_node *a4);
+static symrec* assignable(param *p, symrec *sym);
 %}
 
+%define api.pure full
 %lex-param {param *p}
 %parse-param {param *p}
 
 %union {
 double dval;	/* For returning numbers */
+int ival;	/* For returning indices of bound variables */
 symrec *tptr;   /* For returning symbol-table pointers */
+struct parser_node *node;	/* For returning syntax tree nodes */
 }
 
+%{
+int yylex(YYSTYPE *lvalp, param *p);
+%}
+
 %token <dval>  NUM 	/* Simple double precision number */
+%token <ival>  SLOT	/* bound variable of a compiled expression */
 %token <tptr> VAR FNCT	/* VARiable and FuNCTion */
-%type  <dval>  expr
+%type  <node>  expr
 
 %right '='
 %left '-' '+'
@@ -80,122 +126,337 @@ input:   /* empty */
 ;
 
 line:	'\n'
-	| expr '\n'   { res=$1; }
+	| expr '\n'   { p->root = p->root ? new_op(p, NODE_SEQ, p->root, $1) : $1; }	/* all lines are evaluated */
 	| error '\n' { yyerrok; }
 ;
 
-expr:      NUM       { $$ = $1;                         }
-| VAR                { $$ = $1->value.var;              }
-| VAR '=' expr       { $$ = $3; $1->value.var = $3;     }
-| FNCT '(' ')'       { $$ = (*($1->value.fnctptr))();   }
-| FNCT '(' expr ')'  { $$ = (*($1->value.fnctptr))($3); }
-| FNCT '(' expr ',' expr ')'  { $$ = (*($1->value.fnctptr))($3,$5); }
-| FNCT '(' expr ',' expr ','expr ')'  { $$ = (*($1->value.fnctptr))($3,$5,$7); }
-| FNCT '(' expr ',' expr ',' expr ','expr ')'  { $$ = (*($1->value.fnctptr))($3,$5,$7,$9); }
-| expr '+' expr      { $$ = $1 + $3;                    }
-| expr '-' expr      { $$ = $1 - $3;                    }
-| expr '*' expr      { $$ = $1 * $3;                    }
-| expr '/' expr      { $$ = $1 / $3;                    }
-| '-' expr  %prec NEG{ $$ = -$2;                        }
-| expr '^' expr      { $$ = pow ($1, $3);               }
-| expr '*' '*' expr  { $$ = pow ($1, $4);               }
-| '(' expr ')'       { $$ = $2;                         }
+expr:      NUM       { $$ = new_num(p, $1);                     }
+| VAR                { $$ = new_node(p, NODE_VAR); $$->sym = $1; }
+| SLOT               { $$ = new_node(p, NODE_SLOT); $$->slot = $1; }
+| VAR '=' expr       { $$ = new_node(p, NODE_ASSIGN); $$->sym = assignable(p, $1); $$->nargs = 1; $$->args[0] = $3; }
+| FNCT '(' ')'       { $$ = new_fnct(p, $1, 0, 0, 0, 0, 0);     }
+| FNCT '(' expr ')'  { $$ = new_fnct(p, $1, 1, $3, 0, 0, 0);    }
+| FNCT '(' expr ',' expr ')'  { $$ = new_fnct(p, $1, 2, $3, $5, 0, 0); }
+| FNCT '(' expr ',' expr ','expr ')'  { $$ = new_fnct(p, $1, 3, $3, $5, $7, 0); }
+| FNCT '(' expr ',' expr ',' expr ','expr ')'  { $$ = new_fnct(p, $1, 4, $3, $5, $7, $9); }
+| expr '+' expr      { $$ = new_op(p, NODE_ADD, $1, $3);        }
+| expr '-' expr      { $$ = new_op(p, NODE_SUB, $1, $3);        }
+| expr '*' expr      { $$ = new_op(p, NODE_MUL, $1, $3);        }
+| expr '/' expr      { $$ = new_op(p, NODE_DIV, $1, $3);        }
+| '-' expr  %prec NEG{ $$ = new_op(p, NODE_NEG, $2, 0);         }
+| expr '^' expr      { $$ = new_op(p, NODE_POW, $1, $3);        }
+| expr '*' '*' expr  { $$ = new_op(p, NODE_POW, $1, $4);        }
+| '(' expr ')'       { $$ = $2;                                 }
 ;
 
 %%
 
-/* global symbol table */
-symrec *sym_table = 0;
+/* default context used by the functions without context parameter */
+static parser_context *default_context = 0;
 
 int parse_errors() {
-	return yynerrs;
+	return default_context ? default_context->nerrors : 0;
 }
 
 int yyerror(param *p, const char *s) {
+	p->ctx->nerrors++;
 	/* remove trailing newline */
 	p->string[strcspn(p->string, "\n")] = 0;
 	printf("PARSER ERROR: %s @ position %d of string \'%s\'\n", s, p->pos, p->string);
 	return 0;
 }
 
-/* save symbol in symbol table */
-symrec* putsym(const char *sym_name, int sym_type) {
+/* FNV-1a hash of a symbol name. different seeds give independent hash functions */
+static unsigned int sym_hash(unsigned int seed, const char *name) {
+	unsigned int h = 2166136261u ^ (seed * 16777619u);
+	for (; *name; name++)
+		h = (h ^ (unsigned char)*name) * 16777619u;
+	return h;
+}
+
+/* built-in functions and constants.
+ * they are stored at the position given by a minimal perfect hash of their name (hash and displace):
+ * the first hash selects a displacement d. d < 0 is the position -d-1, otherwise the position is
+ * the hash with seed d. the table is build once and is read-only afterwards */
+#define NFUNCTIONS (sizeof(_functions)/sizeof(_functions[0]) - 1)
+#define NCONSTANTS (sizeof(_constants)/sizeof(_constants[0]) - 1)
+#define NBUILTINS (NFUNCTIONS + NCONSTANTS)
+
+static symrec builtins[NBUILTINS];
+static int builtin_displace[NBUILTINS];
+static unsigned int nbuiltins = 0;	/* number of different names */
+/* the digamma function for the derivatives of gamma and lgamma. "psi" is hidden by the constant of the same name */
+static symrec digamma_sym;
+
+static int compare_names(const void *a, const void *b) {
+	const symrec *s1 = *(const symrec **)a, *s2 = *(const symrec **)b;
+	int res = strcmp(s1->name, s2->name);
+	/* keep the order of the tables for equal names */
+	return res ? res : (s1 < s2 ? -1 : (s1 > s2));
+}
+
+static int compare_buckets(const void *a, const void *b) {
+	const unsigned int *b1 = (const unsigned int *)a, *b2 = (const unsigned int *)b;
+	/* largest buckets first */
+	return (b1[0] < b2[0]) - (b1[0] > b2[0]);
+}
+
+static void init_builtins(void) {
+	symrec *entries = (symrec *) malloc(NBUILTINS * sizeof(symrec));
+	symrec **sorted = (symrec **) malloc(NBUILTINS * sizeof(symrec *));
+	unsigned int i, j, n = 0;
+
+	for (i = 0; i < NFUNCTIONS; i++) {
+		entries[i].name = (char *)_functions[i].name;
+		entries[i].type = FNCT;
+		entries[i].value.fnctptr = _functions[i].fnct;
+	}
+	for (i = 0; i < NCONSTANTS; i++) {
+		entries[NFUNCTIONS + i].name = (char *)_constants[i].name;
+		entries[NFUNCTIONS + i].type = VAR;
+		entries[NFUNCTIONS + i].value.var = _constants[i].value;
+	}
+
+	/* remove duplicate names, the last entry wins (constants hide functions) */
+	for (i = 0; i < NBUILTINS; i++)
+		sorted[i] = &entries[i];
+	qsort(sorted, NBUILTINS, sizeof(symrec *), compare_names);
+	for (i = 0; i < NBUILTINS; i++) {
+		if (i + 1 < NBUILTINS && strcmp(sorted[i]->name, sorted[i+1]->name) == 0)
+			continue;
+		sorted[n++] = sorted[i];
+	}
+	nbuiltins = n;
+	digamma_sym.name = (char *)"psi";
+	digamma_sym.type = FNCT;
+	digamma_sym.value.fnctptr = gsl_sf_psi;
+
+	/* sort the names into buckets by the first hash */
+	unsigned int *bucket = (unsigned int *) malloc(n * sizeof(unsigned int));
+	unsigned int *sizes = (unsigned int *) calloc(2 * n, sizeof(unsigned int));	/* pairs (size, bucket) */
+	unsigned int *start = (unsigned int *) calloc(n + 1, sizeof(unsigned int));
+	unsigned int *keys = (unsigned int *) malloc(n * sizeof(unsigned int));
+	for (i = 0; i < n; i++) {
+		bucket[i] = sym_hash(0, sorted[i]->name) % n;
+		start[bucket[i] + 1]++;
+	}
+	for (i = 0; i < n; i++) {
+		sizes[2*i] = start[i + 1];
+		sizes[2*i + 1] = i;
+		start[i + 1] += start[i];
+	}
+	for (i = 0; i < n; i++)
+		keys[start[bucket[i]]++] = i;
+	for (i = n; i > 0; i--)	/* start[] was moved by one bucket */
+		start[i] = start[i - 1];
+	start[0] = 0;
+	qsort(sizes, n, 2 * sizeof(unsigned int), compare_buckets);
+
+	/* find a displacement for every bucket with more than one name, place the single names in free positions */
+	char *used = (char *) calloc(n, 1);
+	unsigned int *pos = (unsigned int *) malloc(n * sizeof(unsigned int));
+	unsigned int free_pos = 0;
+	for (i = 0; i < n; i++) {
+		const unsigned int size = sizes[2*i], b = sizes[2*i + 1];
+		const unsigned int *bkeys = keys + start[b];
+		if (size == 0) {
+			builtin_displace[b] = 0;
+		} else if (size == 1) {
+			while (used[free_pos])
+				free_pos++;
+			used[free_pos] = 1;
+			builtins[free_pos] = *sorted[bkeys[0]];
+			builtin_displace[b] = -(int)free_pos - 1;
+		} else {
+			int d;
+			for (d = 1; ; d++) {
+				for (j = 0; j < size; j++) {
+					pos[j] = sym_hash(d, sorted[bkeys[j]]->name) % n;
+					if (used[pos[j]])
+						break;
+					used[pos[j]] = 1;
+				}
+				if (j == size)
+					break;
+				/* collision: release the positions of this try */
+				while (j-- > 0)
+					used[pos[j]] = 0;
+			}
+			for (j = 0; j < size; j++)
+				builtins[pos[j]] = *sorted[bkeys[j]];
+			builtin_displace[b] = d;
+		}
+	}
+	for (i = 0; i < n; i++)
+		builtins[i].next = 0;
+
+	free(pos);
+	free(used);
+	free(keys);
+	free(start);
+	free(sizes);
+	free(bucket);
+	free(sorted);
+	free(entries);
+	pdebug("PARSER: init_builtins() DONE (%u symbols)\n", n);
+}
+
+#ifdef _WIN32
+static INIT_ONCE builtins_once = INIT_ONCE_STATIC_INIT;
+static BOOL CALLBACK init_builtins_once(PINIT_ONCE once, PVOID param, PVOID *context) {
+	init_builtins();
+	return TRUE;
+}
+#define INIT_BUILTINS() InitOnceExecuteOnce(&builtins_once, init_builtins_once, NULL, NULL)
+#else
+static pthread_once_t builtins_once = PTHREAD_ONCE_INIT;
+#define INIT_BUILTINS() pthread_once(&builtins_once, init_builtins)
+#endif
+
+/* get built-in function or constant. h is the hash of name with seed 0 */
+static symrec* getbuiltin(const char *name, unsigned int h) {
+	if (nbuiltins == 0)
+		return 0;
+	const int d = builtin_displace[h % nbuiltins];
+	symrec *ptr = &builtins[d < 0 ? (unsigned int)(-d - 1) : sym_hash(d, name) % nbuiltins];
+	return strcmp(ptr->name, name) == 0 ? ptr : 0;
+}
+
+static int is_builtin(const symrec *sym) {
+	return sym >= builtins && sym < builtins + NBUILTINS;
+}
+
+/* save variable in the hash table of the context */
+static symrec* putsym(parser_context *ctx, const char *sym_name, int sym_type) {
 	pdebug("PARSER: putsym(): sym_name = %s\n", sym_name);
 
+	unsigned int i;
+	if (ctx->nvars >= ctx->nbuckets) {
+		/* rehash into a table of double size */
+		const unsigned int nbuckets = 2 * ctx->nbuckets;
+		symrec **vars = (symrec **) calloc(nbuckets, sizeof(symrec *));
+		for (i = 0; i < ctx->nbuckets; i++) {
+			while (ctx->vars[i]) {
+				symrec *tmp = ctx->vars[i];
+				ctx->vars[i] = tmp->next;
+				const unsigned int b = sym_hash(0, tmp->name) & (nbuckets - 1);
+				tmp->next = vars[b];
+				vars[b] = tmp;
+			}
+		}
+		free(ctx->vars);
+		ctx->vars = vars;
+		ctx->nbuckets = nbuckets;
+	}
+
 	symrec *ptr = (symrec *) malloc(sizeof (symrec));
 	ptr->name = (char *) malloc(strlen (sym_name) + 1);
 	strcpy(ptr->name, sym_name);
 	ptr->type = sym_type;
 	ptr->value.var = 0;	/* set value to 0 even if fctn */
-	ptr->next = (struct symrec *)sym_table;
-	sym_table = ptr;
-	
+	i = sym_hash(0, sym_name) & (ctx->nbuckets - 1);
+	ptr->next = ctx->vars[i];
+	ctx->vars[i] = ptr;
+	ctx->nvars++;
+
 	pdebug("PARSER: putsym() DONE\n");
 	return ptr;
 }
 
-/* get symbol from symbol table */
-symrec* getsym(const char *sym_name) {
-	pdebug("PARSER: getsym(): sym_name = %s\n", sym_name);
-	
+/* get variable of the context */
+static symrec* getvar(const parser_context *ctx, const char *sym_name, unsigned int h) {
 	symrec *ptr;
-	for (ptr = sym_table; ptr != 0; ptr = (symrec *)ptr->next) {
-		/* pdebug("%s ", ptr->name); */
-		if (strcmp(ptr->name, sym_name) == 0) {
-			pdebug("PARSER: symbol \'%s\' found\n", sym_name);
+	for (ptr = ctx->vars[h & (ctx->nbuckets - 1)]; ptr != 0; ptr = ptr->next) {
+		if (strcmp(ptr->name, sym_name) == 0)
 			return ptr;
-		}
 	}
-
-	pdebug("PARSER: symbol \'%s\' not found\n", sym_name);
 	return 0;
 }
 
-void init_table(void) {
-	pdebug("PARSER: init_table()\n");
+/* get symbol: variables of the context hide the built-in functions and constants */
+static symrec* getsym(const parser_context *ctx, const char *sym_name) {
+	pdebug("PARSER: getsym(): sym_name = %s\n", sym_name);
 
-	symrec *ptr = 0;
-	int i;
-	/* add functions */
-	for (i = 0; _functions[i].name != 0; i++) {
-		ptr = putsym (_functions[i].name, FNCT);
-		ptr->value.fnctptr = _functions[i].fnct;
-	}
-	/* add constants */
-	for (i = 0; _constants[i].name != 0; i++) {
-		ptr = putsym (_constants[i].name, VAR);
-		ptr->value.var = _constants[i].value;
-	}
+	const unsigned int h = sym_hash(0, sym_name);
+	symrec *ptr = getvar(ctx, sym_name, h);
+	if (!ptr)
+		ptr = getbuiltin(sym_name, h);
 
-	pdebug("PARSER: init_table() DONE sym_table = %p\n", ptr);
+	pdebug("PARSER: symbol \'%s\' %s\n", sym_name, ptr ? "found" : "not found");
+	return ptr;
 }
 
-void delete_table(void) {
-	while(sym_table) {
-		symrec *tmp = sym_table;
-		sym_table = sym_table->next;
-		free(tmp->name);
-		free(tmp);
+parser_context* parser_context_new(void) {
+	pdebug("PARSER: parser_context_new()\n");
+	INIT_BUILTINS();
+
+	parser_context *ctx = (parser_context *) malloc(sizeof(parser_context));
+	ctx->nbuckets = 16;
+	ctx->vars = (symrec **) calloc(ctx->nbuckets, sizeof(symrec *));
+	ctx->nvars = 0;
+	ctx->nerrors = 0;
+
+	return ctx;
+}
+
+void parser_context_free(parser_context *ctx) {
+	if (!ctx)
+		return;
+
+	unsigned int i;
+	for (i = 0; i < ctx->nbuckets; i++) {
+		while (ctx->vars[i]) {
+			symrec *tmp = ctx->vars[i];
+			ctx->vars[i] = tmp->next;
+			free(tmp->name);
+			free(tmp);
+		}
 	}
+	free(ctx->vars);
+	free(ctx);
 }
 
-symrec* assign_variable(const char* symb_name, double value) {
-	/* new style: pdebug("PARSER: assign_variable(): symb_name = %s value = %g sym_table = %p\n", var.name, var.value, sym_table);*/
+symrec* parser_context_assign_variable(parser_context *ctx, const char* symb_name, double value) {
 	pdebug("PARSER: assign_variable() : symb_name = %s value=%g\n", symb_name, value);
 
-	/* be sure that the symbol table has been initialized */
-	if (!sym_table)
-		init_table();
-
-	symrec* ptr = getsym(symb_name);
+	symrec* ptr = getvar(ctx, symb_name, sym_hash(0, symb_name));
 	if (!ptr) {
 		pdebug("PARSER: calling putsym(): symb_name = %s\n", symb_name);
-		ptr = putsym(symb_name, VAR);
+		ptr = putsym(ctx, symb_name, VAR);
 	}
 	ptr->value.var = value;
 
 	return ptr;
-};
+}
+
+/* the built-in constants are shared and can't be changed: assignments create a variable hiding them */
+static symrec* assignable(param *p, symrec *sym) {
+	if (!is_builtin(sym))
+		return sym;
+	symrec *var = putsym(p->ctx, sym->name, VAR);
+	var->value.var = sym->value.var;
+	return var;
+}
+
+int parser_context_errors(const parser_context *ctx) {
+	return ctx->nerrors;
+}
+
+void init_table(void) {
+	if (!default_context)
+		default_context = parser_context_new();
+}
+
+void delete_table(void) {
+	parser_context_free(default_context);
+	default_context = 0;
+}
+
+symrec* assign_variable(const char* symb_name, double value) {
+	/* be sure that the symbol table has been initialized */
+	init_table();
+	return parser_context_assign_variable(default_context, symb_name, value);
+}
 
 static int getcharstr(param *p) {
 	pdebug("PARSER: getcharstr() pos = %d\n", p->pos);
@@ -211,33 +472,754 @@ static void ungetcstr(unsigned int *pos) {
         (*pos)--;
 }
 
-double parse(const char *str) {
-	pdebug("\nPARSER: parse(\"%s\") len=%zu\n", str, strlen(str));
+/* syntax tree */
 
-	/* be sure that the symbol table has been initialized */
-	if (!sym_table)
-		init_table();
+static parser_node* new_node(param *p, node_type type) {
+	parser_node *node = (parser_node *) calloc(1, sizeof(parser_node));
+	node->type = type;
+	node->next = p->nodes;
+	p->nodes = node;
+	return node;
+}
 
-	param p;
-	p.pos = 0;
+static parser_node* new_num(param *p, double value) {
+	parser_node *node = new_node(p, NODE_NUM);
+	node->value = value;
+	return node;
+}
+
+/* creates an operator node, operations on numbers are evaluated immediately */
+static parser_node* new_op(param *p, node_type type, parser_node *left, parser_node *right) {
+	if (left->type == NODE_NUM && (!right || right->type == NODE_NUM)) {
+		switch (type) {
+		case NODE_ADD:
+			return new_num(p, left->value + right->value);
+		case NODE_SUB:
+			return new_num(p, left->value - right->value);
+		case NODE_MUL:
+			return new_num(p, left->value * right->value);
+		case NODE_DIV:
+			return new_num(p, left->value / right->value);
+		case NODE_NEG:
+			return new_num(p, -left->value);
+		case NODE_POW:
+			return new_num(p, pow(left->value, right->value));
+		default:
+			break;
+		}
+	}
+
+	parser_node *node = new_node(p, type);
+	node->nargs = right ? 2 : 1;
+	node->args[0] = left;
+	node->args[1] = right;
+	return node;
+}
+
+static parser_node* new_fnct(param *p, symrec *sym, int nargs, parser_node *a1, parser_node *a2, parser_node *a3, parser_node *a4) {
+	parser_node *node = new_node(p, NODE_FNCT);
+	node->sym = sym;
+	node->nargs = nargs;
+	node->args[0] = a1;
+	node->args[1] = a2;
+	node->args[2] = a3;
+	node->args[3] = a4;
+	return node;
+}
+
+static void free_nodes(param *p) {
+	while (p->nodes) {
+		parser_node *tmp = p->nodes;
+		p->nodes = p->nodes->next;
+		free(tmp);
+	}
+	p->root = 0;
+}
+
+static double eval_node(const parser_node *node) {
+	switch (node->type) {
+	case NODE_NUM:
+		return node->value;
+	case NODE_VAR:
+		return node->sym->value.var;
+	case NODE_SLOT:	/* not used when parsing */
+		return NAN;
+	case NODE_ASSIGN:
+		return (node->sym->value.var = eval_node(node->args[0]));
+	case NODE_FNCT:
+		switch (node->nargs) {
+		case 0:
+			return (*(node->sym->value.fnctptr))();
+		case 1:
+			return (*(node->sym->value.fnctptr))(eval_node(node->args[0]));
+		case 2:
+			return (*(node->sym->value.fnctptr))(eval_node(node->args[0]), eval_node(node->args[1]));
+		case 3:
+			return (*(node->sym->value.fnctptr))(eval_node(node->args[0]), eval_node(node->args[1]),
+				eval_node(node->args[2]));
+		default:
+			return (*(node->sym->value.fnctptr))(eval_node(node->args[0]), eval_node(node->args[1]),
+				eval_node(node->args[2]), eval_node(node->args[3]));
+		}
+	case NODE_ADD:
+		return eval_node(node->args[0]) + eval_node(node->args[1]);
+	case NODE_SUB:
+		return eval_node(node->args[0]) - eval_node(node->args[1]);
+	case NODE_MUL:
+		return eval_node(node->args[0]) * eval_node(node->args[1]);
+	case NODE_DIV:
+		return eval_node(node->args[0]) / eval_node(node->args[1]);
+	case NODE_NEG:
+		return -eval_node(node->args[0]);
+	case NODE_POW:
+		return pow(eval_node(node->args[0]), eval_node(node->args[1]));
+	case NODE_SEQ:	/* value of the last line */
+		eval_node(node->args[0]);
+		return eval_node(node->args[1]);
+	}
+
+	return NAN;
+}
+
+/* parses str into p->root. vars are the names of the bound variables */
+static void parse_tree(param *p, parser_context *ctx, const char *str, const char *vars[], int nvars) {
+	p->pos = 0;
+	p->ctx = ctx;
+	p->symbuf = 0;
+	p->symlength = 0;
+	p->vars = vars;
+	p->nvars = nvars;
+	p->root = 0;
+	p->nodes = 0;
 	/* leave space to terminate string by "\n\0" */
 	size_t slen = strlen(str) + 2;
-	p.string = (char *) malloc(slen * sizeof(char));
+	p->string = (char *) malloc(slen * sizeof(char));
 
-	strncpy(p.string, str, slen);
-	p.string[strlen(p.string)] = '\n';
-	pdebug("\nPARSER: yyparse(\"%s\") len=%zu\n", p.string, strlen(p.string));
+	strncpy(p->string, str, slen);
+	p->string[strlen(p->string)] = '\n';
+	pdebug("\nPARSER: yyparse(\"%s\") len=%zu\n", p->string, strlen(p->string));
 
+	ctx->nerrors = 0;
 	/* parameter for yylex */
-	yyparse(&p);
+	yyparse(p);
+
+	free(p->string);
+	p->string = 0;
+	free(p->symbuf);
+	p->symbuf = 0;
+}
+
+double parser_context_parse(parser_context *ctx, const char *str) {
+	pdebug("\nPARSER: parse(\"%s\") len=%zu\n", str, strlen(str));
+
+	param p;
+	parse_tree(&p, ctx, str, 0, 0);
 
-	pdebug("PARSER: parse() DONE (res = %g, parse errors = %d)\n", res, parse_errors());
-	free(p.string);
-	p.string = 0;
+	double res = NAN;
+	if (p.root && ctx->nerrors == 0)
+		res = eval_node(p.root);
+	free_nodes(&p);
 
+	pdebug("PARSER: parse() DONE (res = %g, parse errors = %d)\n", res, ctx->nerrors);
 	return res;
 }
 
+double parse(const char *str) {
+	/* be sure that the symbol table has been initialized */
+	init_table();
+	return parser_context_parse(default_context, str);
+}
+
+/* compiled expressions */
+
+typedef enum {OP_NUM, OP_VAR, OP_SLOT, OP_ASSIGN, OP_FNCT, OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_NEG, OP_POW, OP_SEQ} opcode;
+
+/* instruction of the stack machine evaluating a compiled expression */
+typedef struct parser_instr {
+	opcode op;
+	int arg;		/* index of a bound variable or number of function arguments */
+	double value;		/* value of a NUM */
+	symrec *sym;		/* symbol of a VAR or assignment */
+	func_t fnct;		/* function */
+} parser_instr;
+
+struct parser_program {
+	parser_instr *code;	/* instructions in postfix order */
+	int ncode;		/* number of instructions */
+	int stack_size;		/* maximal stack depth */
+	int nvars;		/* number of bound variables */
+};
+
+static int count_nodes(const parser_node *node) {
+	int i, count = 1;
+	for (i = 0; i < node->nargs; i++)
+		count += count_nodes(node->args[i]);
+	return count;
+}
+
+/* appends the instructions of node to prog, depth is the current stack depth */
+static void emit(parser_program *prog, const parser_node *node, int depth) {
+	int i;
+	for (i = 0; i < node->nargs; i++)
+		emit(prog, node->args[i], depth + i);
+
+	parser_instr *instr = &prog->code[prog->ncode++];
+	instr->arg = 0;
+	instr->value = 0;
+	instr->sym = 0;
+	instr->fnct = 0;
+	switch (node->type) {
+	case NODE_NUM:
+		instr->op = OP_NUM;
+		instr->value = node->value;
+		break;
+	case NODE_VAR:
+		instr->op = OP_VAR;
+		instr->sym = node->sym;
+		break;
+	case NODE_SLOT:
+		instr->op = OP_SLOT;
+		instr->arg = node->slot;
+		break;
+	case NODE_ASSIGN:
+		instr->op = OP_ASSIGN;
+		instr->sym = node->sym;
+		break;
+	case NODE_FNCT:
+		instr->op = OP_FNCT;
+		instr->arg = node->nargs;
+		instr->fnct = node->sym->value.fnctptr;
+		break;
+	case NODE_ADD:
+		instr->op = OP_ADD;
+		break;
+	case NODE_SUB:
+		instr->op = OP_SUB;
+		break;
+	case NODE_MUL:
+		instr->op = OP_MUL;
+		break;
+	case NODE_DIV:
+		instr->op = OP_DIV;
+		break;
+	case NODE_NEG:
+		instr->op = OP_NEG;
+		break;
+	case NODE_POW:
+		instr->op = OP_POW;
+		break;
+	case NODE_SEQ:
+		instr->op = OP_SEQ;
+		break;
+	}
+
+	/* the result of the node is stored at position depth */
+	if (depth + 1 > prog->stack_size)
+		prog->stack_size = depth + 1;
+}
+
+/* creates the program of the syntax tree root */
+static parser_program* compile_tree(const parser_node *root, int nvars) {
+	parser_program *prog = (parser_program *) malloc(sizeof(parser_program));
+	prog->code = (parser_instr *) malloc(count_nodes(root) * sizeof(parser_instr));
+	prog->ncode = 0;
+	prog->stack_size = 0;
+	prog->nvars = nvars;
+	emit(prog, root, 0);
+	return prog;
+}
+
+parser_program* parser_context_compile(parser_context *ctx, const char *str, const char *vars[], int nvars) {
+	pdebug("\nPARSER: parser_compile(\"%s\") nvars=%d\n", str, nvars);
+
+	param p;
+	parse_tree(&p, ctx, str, vars, nvars);
+	if (!p.root || ctx->nerrors > 0) {
+		free_nodes(&p);
+		return 0;
+	}
+
+	parser_program *prog = compile_tree(p.root, nvars);
+	free_nodes(&p);
+
+	pdebug("PARSER: parser_compile() DONE (%d instructions, stack size %d)\n", prog->ncode, prog->stack_size);
+	return prog;
+}
+
+parser_program* parser_compile(const char *str, const char *vars[], int nvars) {
+	/* be sure that the symbol table has been initialized */
+	init_table();
+	return parser_context_compile(default_context, str, vars, nvars);
+}
+
+/* symbolic differentiation */
+
+/* derivatives of the functions with one argument, u is the argument */
+static const struct {
+	const char *name;
+	const char *derivative;
+} derivatives[] = {
+	{"sin", "cos(u)"}, {"cos", "-sin(u)"}, {"tan", "1/cos(u)^2"},
+	{"sec", "sec(u)*tan(u)"}, {"csc", "-csc(u)*cot(u)"}, {"cot", "-1/sin(u)^2"},
+	{"asin", "1/sqrt(1-u^2)"}, {"acos", "-1/sqrt(1-u^2)"}, {"atan", "1/(1+u^2)"},
+	{"sinh", "cosh(u)"}, {"cosh", "sinh(u)"}, {"tanh", "1-tanh(u)^2"},
+	{"asinh", "1/sqrt(u^2+1)"}, {"acosh", "1/sqrt(u^2-1)"}, {"atanh", "1/(1-u^2)"},
+	{"exp", "exp(u)"}, {"expm1", "exp(u)"},
+	{"log", "1/u"}, {"log10", "0.43429448190325182765/u"}, {"log1p", "1/(1+u)"},
+	{"sqrt", "0.5/sqrt(u)"}, {"cbrt", "1/(3*cbrt(u)^2)"},
+	{"fabs", "sgn(u)"}, {"sgn", "0"},
+	{"erf", "1.1283791670955125739*exp(-u^2)"}, {"erfc", "-1.1283791670955125739*exp(-u^2)"},
+	{0, 0}
+};
+
+static int is_number(const parser_node *node, double value) {
+	return node->type == NODE_NUM && node->value == value;
+}
+
+/* creates an operator node of a derivative, removes operations with 0 and 1 */
+static parser_node* new_dop(param *p, node_type type, parser_node *left, parser_node *right) {
+	switch (type) {
+	case NODE_ADD:
+		if (is_number(left, 0))
+			return right;
+		if (is_number(right, 0))
+			return left;
+		break;
+	case NODE_SUB:
+		if (is_number(right, 0))
+			return left;
+		if (is_number(left, 0))
+			return new_dop(p, NODE_NEG, right, 0);
+		break;
+	case NODE_MUL:
+		if (is_number(left, 0) || is_number(right, 0))
+			return new_num(p, 0);
+		if (is_number(left, 1))
+			return right;
+		if (is_number(right, 1))
+			return left;
+		break;
+	case NODE_DIV:
+		if (is_number(left, 0))
+			return new_num(p, 0);
+		if (is_number(right, 1))
+			return left;
+		break;
+	case NODE_NEG:
+		if (left->type == NODE_NEG)
+			return left->args[0];
+		break;
+	case NODE_POW:
+		if (is_number(right, 0))
+			return new_num(p, 1);
+		if (is_number(right, 1))
+			return left;
+		break;
+	default:
+		break;
+	}
+	return new_op(p, type, left, right);
+}
+
+/* returns 1 if node depends on the bound variable slot */
+static int depends_on(const parser_node *node, int slot) {
+	int i;
+	if (node->type == NODE_SLOT)
+		return node->slot == slot;
+	for (i = 0; i < node->nargs; i++)
+		if (depends_on(node->args[i], slot))
+			return 1;
+	return 0;
+}
+
+/* returns 1 if the tree contains an assignment */
+static int has_assignment(const parser_node *node) {
+	int i;
+	if (node->type == NODE_ASSIGN)
+		return 1;
+	for (i = 0; i < node->nargs; i++)
+		if (has_assignment(node->args[i]))
+			return 1;
+	return 0;
+}
+
+/* copies the tree node of another parse, the bound variable is replaced by u */
+static parser_node* substitute(param *p, const parser_node *node, parser_node *u) {
+	parser_node *copy;
+	int i;
+	switch (node->type) {
+	case NODE_SLOT:
+		return u;
+	case NODE_NUM:
+		return new_num(p, node->value);
+	default:
+		copy = new_node(p, node->type);
+		copy->value = node->value;
+		copy->sym = node->sym;
+		copy->nargs = node->nargs;
+		for (i = 0; i < node->nargs; i++)
+			copy->args[i] = substitute(p, node->args[i], u);
+		return copy;
+	}
+}
+
+/* derivative of the function sym at u. returns 0 if the derivative is unknown */
+static parser_node* function_derivative(param *p, const symrec *sym, parser_node *u) {
+	const char *vars[] = {"u"};
+	int i;
+	if (strcmp(sym->name, "gamma") == 0 || strcmp(sym->name, "lgamma") == 0) {
+		parser_node *psi = new_fnct(p, &digamma_sym, 1, u, 0, 0, 0);
+		if (sym->name[0] == 'l')	/* psi(u) */
+			return psi;
+		/* gamma(u)*psi(u) */
+		return new_dop(p, NODE_MUL, new_fnct(p, (symrec *)sym, 1, u, 0, 0, 0), psi);
+	}
+	for (i = 0; derivatives[i].name != 0; i++) {
+		if (strcmp(derivatives[i].name, sym->name) != 0)
+			continue;
+
+		param t;
+		parse_tree(&t, p->ctx, derivatives[i].derivative, vars, 1);
+		parser_node *res = 0;
+		if (t.root && p->ctx->nerrors == 0)
+			res = substitute(p, t.root, u);
+		free_nodes(&t);
+		return res;
+	}
+	return 0;
+}
+
+/* derivative of node with respect to the bound variable slot. returns 0 if it can't be calculated */
+static parser_node* derivative(param *p, parser_node *node, int slot) {
+	if (node->type == NODE_SEQ)	/* only the last line gives the value */
+		return derivative(p, node->args[1], slot);
+	if (!depends_on(node, slot))
+		return new_num(p, 0);
+
+	parser_node *l = node->args[0], *r = node->args[1], *dl = 0, *dr = 0, *df;
+	if (node->nargs > 0 && !(dl = derivative(p, l, slot)))
+		return 0;
+	if (node->nargs > 1 && !(dr = derivative(p, r, slot)))
+		return 0;
+
+	switch (node->type) {
+	case NODE_SLOT:
+		return new_num(p, 1);
+	case NODE_ADD:
+	case NODE_SUB:
+		return new_dop(p, node->type, dl, dr);
+	case NODE_NEG:
+		return new_dop(p, NODE_NEG, dl, 0);
+	case NODE_MUL:	/* l'r + lr' */
+		return new_dop(p, NODE_ADD, new_dop(p, NODE_MUL, dl, r), new_dop(p, NODE_MUL, l, dr));
+	case NODE_DIV:	/* (l'r - lr')/r^2 */
+		return new_dop(p, NODE_DIV, new_dop(p, NODE_SUB, new_dop(p, NODE_MUL, dl, r), new_dop(p, NODE_MUL, l, dr)),
+			new_dop(p, NODE_MUL, r, r));
+	case NODE_FNCT:
+		if (node->nargs == 2 && strcmp(node->sym->name, "pow") == 0)
+			break;
+		if (node->nargs != 1 || !(df = function_derivative(p, node->sym, l)))
+			return 0;
+		return new_dop(p, NODE_MUL, df, dl);
+	case NODE_POW:
+		break;
+	default:	/* NUM and VAR don't depend on slot, assignments are not supported */
+		return 0;
+	}
+
+	/* l^r */
+	parser_node *lnode = new_fnct(p, getbuiltin("log", sym_hash(0, "log")), 1, l, 0, 0, 0);
+	if (!depends_on(r, slot))	/* r l^(r-1) l' */
+		return new_dop(p, NODE_MUL, new_dop(p, NODE_MUL, r, new_dop(p, NODE_POW, l, new_dop(p, NODE_SUB, r, new_num(p, 1)))), dl);
+	if (!depends_on(l, slot))	/* l^r log(l) r' */
+		return new_dop(p, NODE_MUL, new_dop(p, NODE_MUL, new_dop(p, NODE_POW, l, r), lnode), dr);
+	/* l^r (r' log(l) + r l'/l) */
+	return new_dop(p, NODE_MUL, new_dop(p, NODE_POW, l, r),
+		new_dop(p, NODE_ADD, new_dop(p, NODE_MUL, dr, lnode), new_dop(p, NODE_DIV, new_dop(p, NODE_MUL, r, dl), l)));
+}
+
+parser_program* parser_context_compile_derivative(parser_context *ctx, const char *str, const char *vars[], int nvars, int var) {
+	pdebug("\nPARSER: parser_compile_derivative(\"%s\") var=%d\n", str, var);
+
+	param p;
+	parse_tree(&p, ctx, str, vars, nvars);
+	if (!p.root || ctx->nerrors > 0 || has_assignment(p.root)) {
+		free_nodes(&p);
+		return 0;
+	}
+
+	parser_program *prog = 0;
+	parser_node *root = derivative(&p, p.root, var);
+	if (root)
+		prog = compile_tree(root, nvars);
+	free_nodes(&p);
+
+	pdebug("PARSER: parser_compile_derivative() DONE (%d instructions)\n", prog ? prog->ncode : 0);
+	return prog;
+}
+
+parser_program* parser_compile_derivative(const char *str, const char *vars[], int nvars, int var) {
+	/* be sure that the symbol table has been initialized */
+	init_table();
+	return parser_context_compile_derivative(default_context, str, vars, nvars, var);
+}
+
+int parser_thread_safe(const parser_program *prog) {
+	int i;
+	for (i = 0; i < prog->ncode; i++) {
+		/* assignments change the symbol table, functions without arguments are random number generators */
+		if (prog->code[i].op == OP_ASSIGN || (prog->code[i].op == OP_FNCT && prog->code[i].arg == 0))
+			return 0;
+	}
+	return 1;
+}
+
+int parser_uses_variable(const parser_program *prog, int var) {
+	int i;
+	for (i = 0; i < prog->ncode; i++) {
+		if (prog->code[i].op == OP_SLOT && prog->code[i].arg == var)
+			return 1;
+	}
+	return 0;
+}
+
+void parser_free(parser_program *prog) {
+	if (!prog)
+		return;
+	free(prog->code);
+	free(prog);
+}
+
+static double run_program(const parser_program *prog, const double *values, double *stack) {
+	const parser_instr *instr = prog->code, *end = prog->code + prog->ncode;
+	int sp = -1;
+
+	for (; instr != end; instr++) {
+		switch (instr->op) {
+		case OP_NUM:
+			stack[++sp] = instr->value;
+			break;
+		case OP_VAR:
+			stack[++sp] = instr->sym->value.var;
+			break;
+		case OP_SLOT:
+			stack[++sp] = values[instr->arg];
+			break;
+		case OP_ASSIGN:
+			instr->sym->value.var = stack[sp];
+			break;
+		case OP_FNCT:
+			switch (instr->arg) {
+			case 0:
+				stack[++sp] = (*(instr->fnct))();
+				break;
+			case 1:
+				stack[sp] = (*(instr->fnct))(stack[sp]);
+				break;
+			case 2:
+				sp--;
+				stack[sp] = (*(instr->fnct))(stack[sp], stack[sp+1]);
+				break;
+			case 3:
+				sp -= 2;
+				stack[sp] = (*(instr->fnct))(stack[sp], stack[sp+1], stack[sp+2]);
+				break;
+			default:
+				sp -= 3;
+				stack[sp] = (*(instr->fnct))(stack[sp], stack[sp+1], stack[sp+2], stack[sp+3]);
+			}
+			break;
+		case OP_ADD:
+			sp--;
+			stack[sp] += stack[sp+1];
+			break;
+		case OP_SUB:
+			sp--;
+			stack[sp] -= stack[sp+1];
+			break;
+		case OP_MUL:
+			sp--;
+			stack[sp] *= stack[sp+1];
+			break;
+		case OP_DIV:
+			sp--;
+			stack[sp] /= stack[sp+1];
+			break;
+		case OP_NEG:
+			stack[sp] = -stack[sp];
+			break;
+		case OP_POW:
+			sp--;
+			stack[sp] = pow(stack[sp], stack[sp+1]);
+			break;
+		case OP_SEQ:
+			sp--;
+			stack[sp] = stack[sp+1];
+			break;
+		}
+	}
+
+	return stack[0];
+}
+
+#define PARSER_STACK_SIZE 64
+
+double parser_eval(const parser_program *prog, const double *values) {
+	double buffer[PARSER_STACK_SIZE];
+	double *stack = buffer;
+	if (prog->stack_size > PARSER_STACK_SIZE)
+		stack = (double *) malloc(prog->stack_size * sizeof(double));
+
+	double res = run_program(prog, values, stack);
+
+	if (stack != buffer)
+		free(stack);
+	return res;
+}
+
+/* number of points evaluated together by parser_eval_array() */
+#define PARSER_BLOCK_SIZE 256
+
+/* evaluates prog for the n <= PARSER_BLOCK_SIZE points starting at first. every instruction is applied to
+ * all points of the block, so the interpreter overhead is shared and the compiler can vectorize the loops.
+ * stack holds stack_size blocks. the result is in the first block of the stack */
+static void run_program_block(const parser_program *prog, const double * const values[], const size_t strides[],
+		size_t first, size_t n, double *stack) {
+	const parser_instr *instr = prog->code, *end = prog->code + prog->ncode;
+	double *top = stack - PARSER_BLOCK_SIZE, *a, *b, *c, *d;
+	const double *src;
+	double value;
+	size_t k, stride;
+
+	for (; instr != end; instr++) {
+		switch (instr->op) {
+		case OP_NUM:
+		case OP_VAR:
+			top += PARSER_BLOCK_SIZE;
+			value = (instr->op == OP_NUM) ? instr->value : instr->sym->value.var;
+			for (k = 0; k < n; k++)
+				top[k] = value;
+			break;
+		case OP_SLOT:
+			top += PARSER_BLOCK_SIZE;
+			stride = strides[instr->arg];
+			src = values[instr->arg] + first*stride;
+			if (stride == 1)
+				memcpy(top, src, n * sizeof(double));
+			else
+				for (k = 0; k < n; k++)
+					top[k] = src[k*stride];
+			break;
+		case OP_ASSIGN:	/* programs with assignments are evaluated point by point */
+			break;
+		case OP_FNCT:
+			switch (instr->arg) {
+			case 0:
+				top += PARSER_BLOCK_SIZE;
+				for (k = 0; k < n; k++)
+					top[k] = (*(instr->fnct))();
+				break;
+			case 1:
+				for (k = 0; k < n; k++)
+					top[k] = (*(instr->fnct))(top[k]);
+				break;
+			case 2:
+				top -= PARSER_BLOCK_SIZE;
+				b = top + PARSER_BLOCK_SIZE;
+				for (k = 0; k < n; k++)
+					top[k] = (*(instr->fnct))(top[k], b[k]);
+				break;
+			case 3:
+				top -= 2 * PARSER_BLOCK_SIZE;
+				b = top + PARSER_BLOCK_SIZE;
+				c = b + PARSER_BLOCK_SIZE;
+				for (k = 0; k < n; k++)
+					top[k] = (*(instr->fnct))(top[k], b[k], c[k]);
+				break;
+			default:
+				top -= 3 * PARSER_BLOCK_SIZE;
+				b = top + PARSER_BLOCK_SIZE;
+				c = b + PARSER_BLOCK_SIZE;
+				d = c + PARSER_BLOCK_SIZE;
+				for (k = 0; k < n; k++)
+					top[k] = (*(instr->fnct))(top[k], b[k], c[k], d[k]);
+			}
+			break;
+		case OP_ADD:
+			top -= PARSER_BLOCK_SIZE;
+			a = top + PARSER_BLOCK_SIZE;
+			for (k = 0; k < n; k++)
+				top[k] += a[k];
+			break;
+		case OP_SUB:
+			top -= PARSER_BLOCK_SIZE;
+			a = top + PARSER_BLOCK_SIZE;
+			for (k = 0; k < n; k++)
+				top[k] -= a[k];
+			break;
+		case OP_MUL:
+			top -= PARSER_BLOCK_SIZE;
+			a = top + PARSER_BLOCK_SIZE;
+			for (k = 0; k < n; k++)
+				top[k] *= a[k];
+			break;
+		case OP_DIV:
+			top -= PARSER_BLOCK_SIZE;
+			a = top + PARSER_BLOCK_SIZE;
+			for (k = 0; k < n; k++)
+				top[k] /= a[k];
+			break;
+		case OP_NEG:
+			for (k = 0; k < n; k++)
+				top[k] = -top[k];
+			break;
+		case OP_POW:
+			top -= PARSER_BLOCK_SIZE;
+			a = top + PARSER_BLOCK_SIZE;
+			for (k = 0; k < n; k++)
+				top[k] = pow(top[k], a[k]);
+			break;
+		case OP_SEQ:
+			top -= PARSER_BLOCK_SIZE;
+			memcpy(top, top + PARSER_BLOCK_SIZE, n * sizeof(double));
+			break;
+		}
+	}
+}
+
+void parser_eval_array(const parser_program *prog, const double * const values[], const size_t strides[], double *result, size_t n) {
+	size_t i;
+	int j;
+
+	/* assignments and random numbers have to be evaluated point by point in the right order */
+	if (!parser_thread_safe(prog)) {
+		double buffer[PARSER_STACK_SIZE];
+		double *stack = buffer;
+		if (prog->stack_size > PARSER_STACK_SIZE)
+			stack = (double *) malloc(prog->stack_size * sizeof(double));
+		double *slots = (double *) malloc((prog->nvars > 0 ? prog->nvars : 1) * sizeof(double));
+
+		for (i = 0; i < n; i++) {
+			for (j = 0; j < prog->nvars; j++)
+				slots[j] = values[j][i*strides[j]];
+			result[i] = run_program(prog, slots, stack);
+		}
+
+		free(slots);
+		if (stack != buffer)
+			free(stack);
+		return;
+	}
+
+	double *stack = (double *) malloc(prog->stack_size * PARSER_BLOCK_SIZE * sizeof(double));
+	for (i = 0; i < n; i += PARSER_BLOCK_SIZE) {
+		const size_t count = (n - i < PARSER_BLOCK_SIZE) ? n - i : PARSER_BLOCK_SIZE;
+		run_program_block(prog, values, strides, i, count, stack);
+		memcpy(result + i, stack, count * sizeof(double));
+	}
+	free(stack);
+}
+
 double parse_with_vars(const char *str, const parser_var *vars, int nvars) {
 	pdebug("\nPARSER: parse_with_var(\"%s\") len=%zu\n", str, strlen(str));
 	int i;
@@ -249,7 +1231,7 @@ double parse_with_vars(const char *str, const parser_var *vars, int nvars) {
 	return parse(str);
 }
 
-int yylex(param *p) {
+int yylex(YYSTYPE *lvalp, param *p) {
 	pdebug("PARSER: yylex()\n");
 	int c;
 
@@ -264,7 +1246,7 @@ int yylex(param *p) {
 	/* check for non-ASCII chars */
 	if (!isascii(c)) {
 		pdebug("non-ASCII character found. Giving up\n");
-		yynerrs++;
+		p->ctx->nerrors++;
 		return 0;
 	}
 
@@ -296,7 +1278,7 @@ int yylex(param *p) {
 
 		pdebug("PARSER: result = %g\n", result);
 
-		yylval.dval = result;
+		lvalp->dval = result;
 
                 p->pos += strlen(s) - strlen(remain);
 
@@ -305,20 +1287,19 @@ int yylex(param *p) {
 
 	if (isalpha (c) || c == '.') {
 		pdebug("PARSER: reading identifier (starts with alpha: %c)\n", c);
-		static char *symbuf = 0;
-		static int length = 0;
 		int i = 0;
 
 		/* Initially make the buffer long enough for a 10-character symbol name */
-		if (length == 0)
-			length = 10, symbuf = (char *) malloc(length + 1);
+		if (p->symlength == 0)
+			p->symlength = 10, p->symbuf = (char *) malloc(p->symlength + 1);
+		char *symbuf = p->symbuf;
 
 		do {
 			pdebug("reading symbol .. ");
 			/* If buffer is full, make it bigger */
-			if (i == length) {
-				length *= 2;
-				symbuf = (char *) realloc(symbuf, length + 1);
+			if (i == p->symlength) {
+				p->symlength *= 2;
+				symbuf = p->symbuf = (char *) realloc(p->symbuf, p->symlength + 1);
 			}
 			symbuf[i++] = c;
 			c = getcharstr(p);
@@ -331,17 +1312,25 @@ int yylex(param *p) {
 			ungetcstr(&(p->pos));
 		symbuf[i] = '\0';
 
-		symrec *s = getsym(symbuf);
+		/* bound variables of compiled expressions */
+		for (i = 0; i < p->nvars; i++) {
+			if (strcmp(p->vars[i], symbuf) == 0) {
+				lvalp->ival = i;
+				return SLOT;
+			}
+		}
+
+		symrec *s = getsym(p->ctx, symbuf);
 		if(s == 0) {	/* symbol unknown */
 			pdebug("PARSER: ERROR: symbol \"%s\" UNKNOWN\n", symbuf);
-			yynerrs++;
+			p->ctx->nerrors++;
 			return 0;
 		}
 		/* old behavior */
 		/* if (s == 0)
 			 s = putsym (symbuf, VAR);
 		*/
-		yylval.tptr = s;
+		lvalp->tptr = s;
 		return s->type;
 	}
 
@@ -0,0 +1,186 @@
+/***************************************************************************
+    File                 : parser_test.c
+    Project              : LabPlot
+    Description          : Parser test and benchmark
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/time.h>
+#include <pthread.h>
+#include "parser.h"
+
+#define N 1000000
+#define NTHREADS 4
+
+/* parses with an own context in every thread */
+static void* parse_thread(void *arg) {
+	double *result = (double *)arg;
+	parser_context *ctx = parser_context_new();
+	size_t i;
+
+	*result = 0;
+	for (i = 0; i < N/100; i++) {
+		parser_context_assign_variable(ctx, "x", 1.e-3 * i);
+		*result += parser_context_parse(ctx, "sin(x)*exp(-x/10)");
+	}
+	parser_context_free(ctx);
+
+	return NULL;
+}
+
+static unsigned long long msecs(struct timeval *t1, struct timeval *t2) {
+	return 1000 * (t2->tv_sec - t1->tv_sec) + (t2->tv_usec - t1->tv_usec) / 1000;
+}
+
+int main() {
+	const char *func = "sin(x)*exp(-x/10)";
+	const char *vars[] = {"x", "a"};
+	size_t i;
+
+	printf("* compare compiled expression with parse()\n");
+	parser_program *prog = parser_compile(func, vars, 1);
+	if (!prog) {
+		printf("ERROR compiling \"%s\"\n", func);
+		return -1;
+	}
+	for (i = 0; i < 10; i++) {
+		double x = 0.7 * i;
+		assign_variable("x", x);
+		printf("x = %g: parse = %.15g, compiled = %.15g, exact = %.15g\n", x, parse(func), parser_eval(prog, &x), sin(x)*exp(-x/10));
+	}
+	parser_free(prog);
+
+	printf("* constants, assignments and bound parameters\n");
+	prog = parser_compile("a*x^2 + pi - 2**3", vars, 2);
+	double values[] = {3., 2.};
+	printf("a*x^2 + pi - 2**3 (x=3, a=2) = %.15g (expected %.15g)\n", parser_eval(prog, values), 2.*9. + M_PI - 8.);
+	parser_free(prog);
+
+	printf("* multi-line expressions (all lines evaluated, last one returned)\n");
+	assign_variable("b", 0.);
+	printf("b=4\\nb*2 = %g (expected 8)\n", parse("b=4\nb*2"));
+	prog = parser_compile("b=3\n1\nb*x", vars, 1);
+	printf("b=3\\n1\\nb*x (x=3) = %g (expected 9)\n", parser_eval(prog, values));
+	parser_free(prog);
+
+	printf("* parse errors\n");
+	prog = parser_compile("sin(x", vars, 1);
+	printf("\"sin(x\": %s\n", prog ? "compiled (ERROR)" : "not compiled (OK)");
+	parser_free(prog);
+
+	printf("* derivatives\n");
+	const char *models[] = {"a*exp(-b*x)*sin(b*x+a)", "a/(1+((x-b)/a)^2)", "x^b + b^(a*x) + pow(a, b)", "sqrt(a*x) - log(b/x) + tan(a)",
+		"a*gamma(b*x)", "b*lgamma(a*x)", 0};
+	const char *pvars[] = {"x", "a", "b"};
+	for (i = 0; models[i] != 0; i++) {
+		parser_program *f = parser_compile(models[i], pvars, 3);
+		int j;
+		for (j = 1; j < 3; j++) {
+			parser_program *df = parser_compile_derivative(models[i], pvars, 3, j);
+			const double point[] = {1.3, 0.7, 1.1};
+			double p1[] = {1.3, 0.7, 1.1}, p2[] = {1.3, 0.7, 1.1};
+			const double h = 1.e-6;
+			p1[j] -= h;
+			p2[j] += h;
+			const double numeric = (parser_eval(f, p2) - parser_eval(f, p1))/(2*h);
+			const double analytic = df ? parser_eval(df, point) : NAN;
+			printf("d(%s)/d%s = %.10g (central difference %.10g)\n", models[i], pvars[j], analytic, numeric);
+			parser_free(df);
+		}
+		parser_free(f);
+	}
+
+	printf("* assignments to constants only hide them in the context\n");
+	parser_context *ctx = parser_context_new();
+	parser_context_parse(ctx, "pi = 3");
+	printf("pi = %g in the context, pi = %.15g in the default context\n", parser_context_parse(ctx, "pi"), parse("pi"));
+	parser_context_free(ctx);
+
+	printf("* parse in %d threads with separate contexts\n", NTHREADS);
+	pthread_t threads[NTHREADS];
+	double sums[NTHREADS];
+	for (i = 0; i < NTHREADS; i++)
+		pthread_create(&threads[i], NULL, parse_thread, &sums[i]);
+	for (i = 0; i < NTHREADS; i++) {
+		pthread_join(threads[i], NULL);
+		printf("thread %zu: sum = %.15g\n", i, sums[i]);
+	}
+
+	printf("* benchmark with %d points\n", N);
+	double *x = (double *)malloc(N*sizeof(double));
+	double *y = (double *)malloc(N*sizeof(double));
+	for (i = 0; i < N; i++)
+		x[i] = 1.e-5 * i;
+
+	struct timeval time1, time2;
+	gettimeofday(&time1, NULL);
+	for (i = 0; i < N; i++) {
+		assign_variable("x", x[i]);
+		y[i] = parse(func);
+	}
+	gettimeofday(&time2, NULL);
+	printf("parse() per point : %llu ms (y[N-1] = %.15g)\n", msecs(&time1, &time2), y[N-1]);
+
+	gettimeofday(&time1, NULL);
+	prog = parser_compile(func, vars, 1);
+	const double *data[] = {x};
+	const size_t strides[] = {1};
+	parser_eval_array(prog, data, strides, y, N);
+	parser_free(prog);
+	gettimeofday(&time2, NULL);
+	printf("compiled          : %llu ms (y[N-1] = %.15g)\n", msecs(&time1, &time2), y[N-1]);
+
+	/* block evaluation has to give the same results (including NaN) as the evaluation point by point */
+	const char *poly = "1 + x*(2 + x*(3 - x*4)) - (x-5)/(x^2-25) + exp(-x)*0/(x-3)";
+	double *y2 = (double *)malloc(N*sizeof(double));
+	prog = parser_compile(poly, vars, 1);
+	gettimeofday(&time1, NULL);
+	for (i = 0; i < N; i++)
+		y2[i] = parser_eval(prog, &x[i]);
+	gettimeofday(&time2, NULL);
+	printf("polynomial, point by point : %llu ms\n", msecs(&time1, &time2));
+	gettimeofday(&time1, NULL);
+	parser_eval_array(prog, data, strides, y, N);
+	gettimeofday(&time2, NULL);
+	printf("polynomial, blocks         : %llu ms\n", msecs(&time1, &time2));
+	parser_free(prog);
+	size_t diff = 0, nans = 0;
+	for (i = 0; i < N; i++) {
+		if (isnan(y[i]))
+			nans++;
+		if (!(y[i] == y2[i] || (isnan(y[i]) && isnan(y2[i]))))
+			diff++;
+	}
+	printf("%zu different values, %zu NaN\n", diff, nans);
+	free(y2);
+
+	free(x);
+	free(y);
+	delete_table();
+
+	return 0;
+}
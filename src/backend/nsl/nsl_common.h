@@ -36,4 +36,19 @@
 
 #define i18n(m) m
 
+/* mutex protecting global caches */
+#ifdef _WIN32
+#include <windows.h>
+typedef SRWLOCK nsl_mutex;
+#define NSL_MUTEX_INITIALIZER SRWLOCK_INIT
+#define nsl_mutex_lock(m) AcquireSRWLockExclusive(m)
+#define nsl_mutex_unlock(m) ReleaseSRWLockExclusive(m)
+#else
+#include <pthread.h>
+typedef pthread_mutex_t nsl_mutex;
+#define NSL_MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+#define nsl_mutex_lock(m) pthread_mutex_lock(m)
+#define nsl_mutex_unlock(m) pthread_mutex_unlock(m)
+#endif
+
 #endif /* NSL_COMMON_H */
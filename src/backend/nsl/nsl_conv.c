@@ -0,0 +1,218 @@
+/***************************************************************************
+    File                 : nsl_conv.c
+    Project              : LabPlot
+    Description          : NSL discrete convolution
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "nsl_conv.h"
+#include "nsl_common.h"
+#include "nsl_dft.h"
+#include <gsl/gsl_fft_real.h>
+#include <gsl/gsl_fft_halfcomplex.h>
+#include <math.h>
+#include <string.h>
+
+const char* nsl_conv_method_name[] = {i18n("auto"), i18n("direct"), i18n("FFT")};
+const char* nsl_conv_type_name[] = {i18n("convolution"), i18n("deconvolution")};
+
+/* relative regularization of |Y|^2 in the FFT deconvolution */
+#define NSL_CONV_DECONV_EPS 1e-12
+
+static void nsl_conv_window_direct(const double x[], size_t n, const double w[], size_t m, double result[]) {
+	size_t i, j;
+
+	for (i = 0; i < n; i++) {
+		double sum = 0.0;
+		for (j = 0; j < m; j++)
+			sum += w[j]*x[i+j];
+		result[i] = sum;
+	}
+}
+
+static int nsl_conv_window_fft(const double x[], size_t n, const double w[], size_t m, double result[]) {
+	size_t i, j, s;
+
+	/* FFT size: power of 2 with at least 4*m points */
+	size_t size = 1;
+	while (size < 4*m)
+		size *= 2;
+	const size_t step = size-m+1;
+	double *h = (double *)calloc(size, sizeof(double));
+	double *buf = (double *)malloc(size*sizeof(double));
+	if (h == NULL || buf == NULL) {
+		free(buf);
+		free(h);
+		return -1;
+	}
+
+	/* transform of the reversed weights */
+	for (j = 0; j < m; j++)
+		h[j] = w[m-1-j];
+	gsl_fft_real_radix2_transform(h, 1, size);
+
+	const size_t nx = n+m-1;
+	for (s = 0; s < n; s += step) {
+		for (i = 0; i < size; i++)
+			buf[i] = (s+i < nx) ? x[s+i] : 0.;
+		gsl_fft_real_radix2_transform(buf, 1, size);
+
+		/* multiply in half-complex format */
+		buf[0] *= h[0];
+		buf[size/2] *= h[size/2];
+		for (i = 1; i < size/2; i++) {
+			const double re = buf[i], im = buf[size-i];
+			buf[i] = re*h[i]-im*h[size-i];
+			buf[size-i] = re*h[size-i]+im*h[i];
+		}
+		gsl_fft_halfcomplex_radix2_inverse(buf, 1, size);
+
+		/* the first m-1 values are wrapped around */
+		for (i = 0; i < step && s+i < n; i++)
+			result[s+i] = buf[m-1+i];
+	}
+
+	free(buf);
+	free(h);
+	return 0;
+}
+
+int nsl_conv_window(const double x[], size_t n, const double w[], size_t m, double result[], nsl_conv_method_type method) {
+	if (m == 0)
+		return -1;
+
+	if (method == nsl_conv_method_direct || (method == nsl_conv_method_auto && m < NSL_CONV_FFT_MIN_POINTS)) {
+		nsl_conv_window_direct(x, n, w, m, result);
+		return 0;
+	}
+
+	return nsl_conv_window_fft(x, n, w, m, result);
+}
+
+/* product (deconvolve: quotient) of the spectra of x (n values) and y (m values) zero padded to size values.
+	The inverse transform (size values) is written to buf */
+static int nsl_conv_fft(const double x[], size_t n, const double y[], size_t m, size_t size, int deconvolve, double buf[]) {
+	size_t k;
+	const size_t K = size/2+1;
+	double *X = (double *)malloc(4*K*sizeof(double));
+	if (X == NULL)
+		return -1;
+	double *Y = X+2*K;
+
+	memcpy(buf, x, n*sizeof(double));
+	memset(buf+n, 0, (size-n)*sizeof(double));
+	int status = nsl_dft_forward(buf, size, X);
+	if (status == 0) {
+		memcpy(buf, y, m*sizeof(double));
+		memset(buf+m, 0, (size-m)*sizeof(double));
+		status = nsl_dft_forward(buf, size, Y);
+	}
+	if (status != 0) {
+		free(X);
+		return -1;
+	}
+
+	if (deconvolve) {
+		double max = 0;
+		for (k = 0; k < K; k++)
+			max = fmax(max, Y[2*k]*Y[2*k]+Y[2*k+1]*Y[2*k+1]);
+		const double eps = NSL_CONV_DECONV_EPS*max;
+		for (k = 0; k < K; k++) {
+			const double re = X[2*k], im = X[2*k+1];
+			const double norm = Y[2*k]*Y[2*k]+Y[2*k+1]*Y[2*k+1]+eps;
+			X[2*k] = (re*Y[2*k]+im*Y[2*k+1])/norm;
+			X[2*k+1] = (im*Y[2*k]-re*Y[2*k+1])/norm;
+		}
+	} else {
+		for (k = 0; k < K; k++) {
+			const double re = X[2*k], im = X[2*k+1];
+			X[2*k] = re*Y[2*k]-im*Y[2*k+1];
+			X[2*k+1] = re*Y[2*k+1]+im*Y[2*k];
+		}
+	}
+	status = nsl_dft_backward(X, size, buf);
+
+	free(X);
+	return (status == 0) ? 0 : -1;
+}
+
+int nsl_conv_convolution(const double x[], size_t n, const double y[], size_t m, double result[], nsl_conv_method_type method) {
+	size_t i, j;
+	if (n == 0 || m == 0)
+		return -1;
+
+	if (method == nsl_conv_method_direct || (method == nsl_conv_method_auto && (n < NSL_CONV_FFT_MIN_POINTS || m < NSL_CONV_FFT_MIN_POINTS))) {
+		for (i = 0; i < n+m-1; i++)
+			result[i] = 0;
+		for (i = 0; i < n; i++)
+			for (j = 0; j < m; j++)
+				result[i+j] += x[i]*y[j];
+		return 0;
+	}
+
+	const size_t size = nsl_dft_padded_size(n+m-1);
+	double *buf = (double *)malloc(size*sizeof(double));
+	if (buf == NULL)
+		return -1;
+	int status = nsl_conv_fft(x, n, y, m, size, 0, buf);
+	if (status == 0)
+		memcpy(result, buf, (n+m-1)*sizeof(double));
+	free(buf);
+
+	return status;
+}
+
+int nsl_conv_deconvolution(const double z[], size_t n, const double y[], size_t m, double result[], nsl_conv_method_type method) {
+	size_t i, j;
+	if (m == 0 || m > n)
+		return -1;
+
+	if (method == nsl_conv_method_direct || (method == nsl_conv_method_auto && m < NSL_CONV_FFT_MIN_POINTS)) {
+		/* leading zeros of the response only shift the signal */
+		size_t s = 0;
+		while (s < m && y[s] == 0)
+			s++;
+		if (s == m)
+			return -1;
+
+		for (i = 0; i < n-m+1; i++) {
+			double sum = z[s+i];
+			for (j = s+1; j < m && j-s <= i; j++)
+				sum -= y[j]*result[i-(j-s)];
+			result[i] = sum/y[s];
+		}
+		return 0;
+	}
+
+	const size_t size = nsl_dft_padded_size(n);
+	double *buf = (double *)malloc(size*sizeof(double));
+	if (buf == NULL)
+		return -1;
+	int status = nsl_conv_fft(z, n, y, m, size, 1, buf);
+	if (status == 0)
+		memcpy(result, buf, (n-m+1)*sizeof(double));
+	free(buf);
+
+	return status;
+}
@@ -0,0 +1,58 @@
+/***************************************************************************
+    File                 : nsl_conv.h
+    Project              : LabPlot
+    Description          : NSL discrete convolution
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef NSL_CONV_H
+#define NSL_CONV_H
+
+#include <stdlib.h>
+
+#define NSL_CONV_METHOD_COUNT 3
+/* auto: direct for short kernels, FFT otherwise */
+typedef enum {nsl_conv_method_auto, nsl_conv_method_direct, nsl_conv_method_fft} nsl_conv_method_type;
+extern const char* nsl_conv_method_name[];
+
+/* minimal kernel size for which the automatic method uses the FFT */
+#define NSL_CONV_FFT_MIN_POINTS 64
+
+/* sliding weighted sum result[i] = sum_{j<m} w[j]*x[i+j] for i = 0 .. n-1 (x has n+m-1 values).
+	The FFT method uses overlap-save block convolution with blocks of at least 4*m points. */
+int nsl_conv_window(const double x[], size_t n, const double w[], size_t m, double result[], nsl_conv_method_type method);
+
+#define NSL_CONV_TYPE_COUNT 2
+typedef enum {nsl_conv_type_convolution, nsl_conv_type_deconvolution} nsl_conv_type_type;
+extern const char* nsl_conv_type_name[];
+
+/* linear convolution result[k] = sum_j x[k-j]*y[j] of x (n values) and the response y (m values), k = 0 .. n+m-2 (n+m-1 values).
+	The FFT method transforms both zero padded to at least n+m-1 points. auto uses it if both have at least NSL_CONV_FFT_MIN_POINTS values */
+int nsl_conv_convolution(const double x[], size_t n, const double y[], size_t m, double result[], nsl_conv_method_type method);
+/* deconvolution: the signal x (n-m+1 values) whose convolution with the response y (m <= n values) is z (n values).
+	direct: recursive division (leading zeros of y are skipped), unstable if the first value of y is small.
+	FFT: division of the spectra, regularized where the spectrum of y vanishes. auto uses it if m >= NSL_CONV_FFT_MIN_POINTS */
+int nsl_conv_deconvolution(const double z[], size_t n, const double y[], size_t m, double result[], nsl_conv_method_type method);
+
+#endif /* NSL_CONV_H */
@@ -0,0 +1,99 @@
+/***************************************************************************
+    File                 : nsl_conv_test.c
+    Project              : LabPlot
+    Description          : NSL discrete convolution
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "nsl_conv.h"
+
+#define N 1000000
+
+int main() {
+	const double data[]={2,2,5,2,1,0,1,4,9};
+	const double w[]={1,2,1};
+	double result[7];
+	size_t i, m;
+
+	/* sliding weighted sum, direct and FFT */
+	nsl_conv_window(data, 7, w, 3, result, nsl_conv_method_direct);
+	for (i = 0; i < 7; i++)
+		printf(" %g", result[i]);
+	printf("\n");
+	nsl_conv_window(data, 7, w, 3, result, nsl_conv_method_fft);
+	for (i = 0; i < 7; i++)
+		printf(" %g", result[i]);
+	printf("\n");
+
+	/* full convolution and deconvolution, direct and FFT */
+	double full[9], signal[7];
+	nsl_conv_convolution(data, 7, w, 3, full, nsl_conv_method_direct);
+	for (i = 0; i < 9; i++)
+		printf(" %g", full[i]);
+	printf("\n");
+	nsl_conv_convolution(data, 7, w, 3, full, nsl_conv_method_fft);
+	for (i = 0; i < 9; i++)
+		printf(" %g", full[i]);
+	printf("\n");
+	nsl_conv_deconvolution(full, 9, w, 3, signal, nsl_conv_method_direct);
+	for (i = 0; i < 7; i++)
+		printf(" %g", signal[i]);
+	printf("\n");
+	nsl_conv_deconvolution(full, 9, w, 3, signal, nsl_conv_method_fft);
+	for (i = 0; i < 7; i++)
+		printf(" %g", signal[i]);
+	printf("\n");
+
+	/* maximum difference of the methods for long kernels */
+	double *x = (double *)malloc((N+1000)*sizeof(double));
+	double *y = (double *)malloc(N*sizeof(double));
+	double *z = (double *)malloc(N*sizeof(double));
+	double *h = (double *)malloc(1001*sizeof(double));
+	for (i = 0; i < N+1000; i++)
+		x[i] = sin(i/100.)+cos(i/7.);
+	for (m = 63; m <= 1001; m += 469) {
+		for (i = 0; i < m; i++)
+			h[i] = exp(-(double)i/m)/m;
+		clock_t start = clock();
+		nsl_conv_window(x, N, h, m, y, nsl_conv_method_direct);
+		double tdirect = (double)(clock()-start)/CLOCKS_PER_SEC;
+		start = clock();
+		nsl_conv_window(x, N, h, m, z, nsl_conv_method_fft);
+		double tfft = (double)(clock()-start)/CLOCKS_PER_SEC;
+
+		double maxdiff = 0;
+		for (i = 0; i < N; i++)
+			maxdiff = fmax(maxdiff, fabs(y[i]-z[i]));
+		printf("m = %zu: max. difference = %g (direct: %g s, FFT: %g s)\n", m, maxdiff, tdirect, tfft);
+	}
+	free(h);
+	free(z);
+	free(y);
+	free(x);
+
+	return 0;
+}
@@ -0,0 +1,143 @@
+/***************************************************************************
+    File                 : nsl_corr.c
+    Project              : LabPlot
+    Description          : NSL discrete correlation
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "nsl_corr.h"
+#include "nsl_common.h"
+#include "nsl_dft.h"
+#include <math.h>
+#include <string.h>
+
+const char* nsl_corr_norm_name[] = {i18n("none"), i18n("biased"), i18n("unbiased"), i18n("coefficient")};
+
+static void nsl_corr_direct(const double x[], size_t n, const double y[], size_t m, double result[]) {
+	long k, i;
+
+	for (k = -(long)m+1; k < (long)n; k++) {
+		const long first = (k < 0) ? -k : 0;
+		const long last = ((long)m < (long)n-k) ? (long)m : (long)n-k;
+		double sum = 0;
+		for (i = first; i < last; i++)
+			sum += x[i+k]*y[i];
+		result[k+(long)m-1] = sum;
+	}
+}
+
+/* correlation theorem: r = IFFT(X*conj(Y)), the negative lags are wrapped around to the end */
+static int nsl_corr_fft(const double x[], size_t n, const double y[], size_t m, double result[]) {
+	size_t k;
+	const size_t size = nsl_dft_padded_size(n+m-1);
+	const size_t K = size/2+1;
+	const int autocorr = (x == y && n == m);
+	double *buf = (double *)malloc(size*sizeof(double));
+	double *X = (double *)malloc((autocorr ? 2 : 4)*K*sizeof(double));
+	if (buf == NULL || X == NULL) {
+		free(X);
+		free(buf);
+		return -1;
+	}
+
+	memcpy(buf, x, n*sizeof(double));
+	memset(buf+n, 0, (size-n)*sizeof(double));
+	int status = nsl_dft_forward(buf, size, X);
+	double *Y = X+2*K;
+	if (status == 0 && !autocorr) {
+		memcpy(buf, y, m*sizeof(double));
+		memset(buf+m, 0, (size-m)*sizeof(double));
+		status = nsl_dft_forward(buf, size, Y);
+	}
+	if (status == 0) {
+		if (autocorr) {
+			for (k = 0; k < K; k++) {
+				X[2*k] = X[2*k]*X[2*k]+X[2*k+1]*X[2*k+1];
+				X[2*k+1] = 0;
+			}
+		} else {
+			for (k = 0; k < K; k++) {
+				const double re = X[2*k], im = X[2*k+1];
+				X[2*k] = re*Y[2*k]+im*Y[2*k+1];
+				X[2*k+1] = im*Y[2*k]-re*Y[2*k+1];
+			}
+		}
+		status = nsl_dft_backward(X, size, buf);
+	}
+
+	if (status == 0) {
+		memcpy(result, buf+size-(m-1), (m-1)*sizeof(double));
+		memcpy(result+m-1, buf, n*sizeof(double));
+	}
+
+	free(X);
+	free(buf);
+	return (status == 0) ? 0 : -1;
+}
+
+int nsl_corr_correlation(const double x[], size_t n, const double y[], size_t m, nsl_corr_norm_type norm, double result[], nsl_conv_method_type method) {
+	size_t i;
+	if (n == 0 || m == 0)
+		return -1;
+
+	if (method == nsl_conv_method_direct || (method == nsl_conv_method_auto && (n < NSL_CONV_FFT_MIN_POINTS || m < NSL_CONV_FFT_MIN_POINTS)))
+		nsl_corr_direct(x, n, y, m, result);
+	else if (nsl_corr_fft(x, n, y, m, result) != 0)
+		return -1;
+
+	switch (norm) {
+	case nsl_corr_norm_none:
+		break;
+	case nsl_corr_norm_biased: {
+		const double scale = 1./((n > m) ? n : m);
+		for (i = 0; i < n+m-1; i++)
+			result[i] *= scale;
+		break;
+	}
+	case nsl_corr_norm_unbiased:
+		/* number of overlapping values at the lag k = i-(m-1) */
+		for (i = 0; i < n+m-1; i++) {
+			const long k = (long)i-(long)m+1;
+			const long first = (k < 0) ? -k : 0;
+			const long last = ((long)m < (long)n-k) ? (long)m : (long)n-k;
+			result[i] /= last-first;
+		}
+		break;
+	case nsl_corr_norm_coeff: {
+		double sx = 0, sy = 0;
+		for (i = 0; i < n; i++)
+			sx += x[i]*x[i];
+		for (i = 0; i < m; i++)
+			sy += y[i]*y[i];
+		if (sx > 0 && sy > 0) {
+			const double scale = 1./sqrt(sx*sy);
+			for (i = 0; i < n+m-1; i++)
+				result[i] *= scale;
+		}
+		break;
+	}
+	}
+
+	return 0;
+}
@@ -0,0 +1,48 @@
+/***************************************************************************
+    File                 : nsl_corr.h
+    Project              : LabPlot
+    Description          : NSL discrete correlation
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef NSL_CORR_H
+#define NSL_CORR_H
+
+#include <stdlib.h>
+#include "nsl_conv.h"
+
+/* normalization of the correlation:
+	none, biased (1/max(n,m)), unbiased (1/number of overlapping values at the lag),
+	coefficient (1/sqrt(sum x^2*sum y^2), 1 at lag 0 for the autocorrelation) */
+#define NSL_CORR_NORM_COUNT 4
+typedef enum {nsl_corr_norm_none, nsl_corr_norm_biased, nsl_corr_norm_unbiased, nsl_corr_norm_coeff} nsl_corr_norm_type;
+extern const char* nsl_corr_norm_name[];
+
+/* cross-correlation r[k] = sum_i x[i+k]*y[i] of x (n values) and y (m values) at the lags k = -(m-1) .. n-1,
+	stored at result[k+m-1] (n+m-1 values). Autocorrelation for y == x (needs only one transform).
+	The FFT method multiplies the spectra zero padded to at least n+m-1 points,
+	auto uses it if both have at least NSL_CONV_FFT_MIN_POINTS values */
+int nsl_corr_correlation(const double x[], size_t n, const double y[], size_t m, nsl_corr_norm_type norm, double result[], nsl_conv_method_type method);
+
+#endif /* NSL_CORR_H */
@@ -0,0 +1,84 @@
+/***************************************************************************
+    File                 : nsl_corr_test.c
+    Project              : LabPlot
+    Description          : NSL discrete correlation
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "nsl_corr.h"
+
+#define N 1000000
+
+int main() {
+	const double x[]={1,2,3,4};
+	const double y[]={1,0,-1};
+	double result[7];
+	size_t i;
+	int norm;
+
+	/* cross-correlation, direct and FFT */
+	nsl_corr_correlation(x, 4, y, 3, nsl_corr_norm_none, result, nsl_conv_method_direct);
+	for (i = 0; i < 6; i++)
+		printf(" %g", result[i]);
+	printf("\n");
+	nsl_corr_correlation(x, 4, y, 3, nsl_corr_norm_none, result, nsl_conv_method_fft);
+	for (i = 0; i < 6; i++)
+		printf(" %g", result[i]);
+	printf("\n");
+
+	/* autocorrelation with all normalizations */
+	for (norm = 0; norm < NSL_CORR_NORM_COUNT; norm++) {
+		nsl_corr_correlation(x, 4, x, 4, (nsl_corr_norm_type)norm, result, nsl_conv_method_fft);
+		printf("%s:", nsl_corr_norm_name[norm]);
+		for (i = 0; i < 7; i++)
+			printf(" %g", result[i]);
+		printf("\n");
+	}
+
+	/* lag of a shifted signal and timing of the FFT method */
+	const size_t m = 10000, shift = 1234;
+	double *a = (double *)malloc(N*sizeof(double));
+	double *b = (double *)malloc(m*sizeof(double));
+	double *r = (double *)malloc((N+m-1)*sizeof(double));
+	for (i = 0; i < N; i++)
+		a[i] = sin(i/10.)+cos(i/(3.+i/1e5));
+	for (i = 0; i < m; i++)
+		b[i] = a[i+shift];
+	clock_t start = clock();
+	nsl_corr_correlation(a, N, b, m, nsl_corr_norm_none, r, nsl_conv_method_fft);
+	double tfft = (double)(clock()-start)/CLOCKS_PER_SEC;
+	size_t imax = 0;
+	for (i = 1; i < N+m-1; i++)
+		if (r[i] > r[imax])
+			imax = i;
+	printf("n = %d, m = %zu: maximum at lag %ld (%zu expected), FFT: %g s\n", N, m, (long)imax-(long)m+1, shift, tfft);
+	free(r);
+	free(b);
+	free(a);
+
+	return 0;
+}
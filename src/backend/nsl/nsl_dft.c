@@ -30,6 +30,7 @@
 #include "nsl_common.h"
 #include <gsl/gsl_fft_real.h>
 #include <gsl/gsl_fft_halfcomplex.h>
+#include <string.h>
 #ifdef HAVE_FFTW3
 #include <fftw3.h>
 #endif
@@ -38,125 +39,639 @@ const char* nsl_dft_result_type_name[] = {i18n("Magnitude"), i18n("Amplitude"),
 		i18n("Amplitude in dB"), i18n("normalized amplitude in dB"), i18n("Magnitude squared"), i18n("Amplitude squared"), i18n("raw")};
 const char* nsl_dft_xscale_name[] = {i18n("Frequency"), i18n("Index"), i18n("Period")};
 
-int nsl_dft_transform_window(double data[], size_t stride, size_t n, int two_sided, nsl_dft_result_type type, nsl_sf_window_type window_type) {
-	/* apply window function */
-	if (window_type != nsl_sf_window_uniform)
-		nsl_sf_apply_window(data, n, window_type);
+/* cache of FFTW plans or GSL wavetables per size and kind */
+#define NSL_DFT_CACHE_SIZE 16
+/* plan kinds: real to complex, complex to real, in-place real to halfcomplex */
+#define NSL_DFT_R2C 0
+#define NSL_DFT_C2R 1
+#define NSL_DFT_R2HC 2
+typedef struct {
+	size_t n;
+	int kind;
+	int aligned;		/* FFTW plan for SIMD aligned arrays */
+	unsigned int refcount;	/* number of users, entries in use are not replaced */
+	unsigned long last;	/* time of last use */
+	int cached;
+#ifdef HAVE_FFTW3
+	fftw_plan plan;
+#else
+	void *wavetable;	/* gsl_fft_real_wavetable or gsl_fft_halfcomplex_wavetable */
+#endif
+} nsl_dft_plan;
+static nsl_dft_plan nsl_dft_plan_cache[NSL_DFT_CACHE_SIZE];
+static unsigned long nsl_dft_plan_clock = 0;
+/* also serializes the FFTW planner, which is not thread-safe */
+static nsl_mutex nsl_dft_mutex = NSL_MUTEX_INITIALIZER;
+#ifdef HAVE_FFTW3
+static unsigned int nsl_dft_planner_flags = FFTW_ESTIMATE;
+#endif
+#ifdef HAVE_FFTW3_THREADS
+static int nsl_dft_threads = 1;
+static int nsl_dft_threads_initialized = 0;
+#endif
 
-	/* transform */
-	int status = nsl_dft_transform(data, stride, n, two_sided, type);
+/* create plan or wavetable. Called with the mutex locked */
+static int nsl_dft_plan_create(nsl_dft_plan *p, size_t n, int kind, int aligned) {
+	p->n = n;
+	p->kind = kind;
+	p->aligned = aligned;
+	p->refcount = 1;
+	p->last = ++nsl_dft_plan_clock;
+#ifdef HAVE_FFTW3
+#ifdef HAVE_FFTW3_THREADS
+	if (!nsl_dft_threads_initialized)
+		nsl_dft_threads_initialized = fftw_init_threads();
+	if (nsl_dft_threads_initialized)
+		fftw_plan_with_nthreads(n >= NSL_DFT_THREADS_MIN_POINTS ? nsl_dft_threads : 1);
+#endif
+	/* plans are executed on other arrays. Planning with FFTW_MEASURE overwrites the arrays */
+	unsigned int flags = nsl_dft_planner_flags;
+	if (!aligned)
+		flags |= FFTW_UNALIGNED;
+	double *in = (double *)fftw_malloc(2*(n/2+1)*sizeof(double));
+	double *out = (kind == NSL_DFT_R2HC) ? in : (double *)fftw_malloc(2*(n/2+1)*sizeof(double));
+	if (in == NULL || out == NULL)
+		p->plan = NULL;
+	else if (kind == NSL_DFT_C2R)
+		p->plan = fftw_plan_dft_c2r_1d(n, (fftw_complex *)in, out, flags | FFTW_PRESERVE_INPUT);
+	else if (kind == NSL_DFT_R2HC)
+		p->plan = fftw_plan_r2r_1d(n, in, in, FFTW_R2HC, flags);
+	else
+		p->plan = fftw_plan_dft_r2c_1d(n, in, (fftw_complex *)out, flags);
+	if (out != in)
+		fftw_free(out);
+	fftw_free(in);
+	return (p->plan != NULL) ? 0 : -1;
+#else
+	if (kind == NSL_DFT_C2R)
+		p->wavetable = gsl_fft_halfcomplex_wavetable_alloc(n);
+	else
+		p->wavetable = gsl_fft_real_wavetable_alloc(n);
+	return (p->wavetable != NULL) ? 0 : -1;
+#endif
+}
 
-	return status;
+static void nsl_dft_plan_destroy(nsl_dft_plan *p) {
+#ifdef HAVE_FFTW3
+	if (p->plan != NULL)
+		fftw_destroy_plan(p->plan);
+	p->plan = NULL;
+#else
+	if (p->wavetable != NULL) {
+		if (p->kind == NSL_DFT_C2R)
+			gsl_fft_halfcomplex_wavetable_free((gsl_fft_halfcomplex_wavetable *)p->wavetable);
+		else
+			gsl_fft_real_wavetable_free((gsl_fft_real_wavetable *)p->wavetable);
+	}
+	p->wavetable = NULL;
+#endif
+	p->n = 0;
 }
 
-int nsl_dft_transform(double data[], size_t stride, size_t n, int two_sided, nsl_dft_result_type type) {
+static int nsl_dft_plan_valid(const nsl_dft_plan *p) {
+#ifdef HAVE_FFTW3
+	return p->plan != NULL;
+#else
+	return p->wavetable != NULL;
+#endif
+}
+
+/* get plan from the cache or create it. Release with nsl_dft_plan_release()
+	aligned: all arrays the plan is executed on are SIMD aligned (as returned by fftw_malloc) */
+static nsl_dft_plan* nsl_dft_plan_acquire(size_t n, int kind, int aligned) {
 	size_t i;
-	double result[2*n];
-	size_t N=n/2;	/* number of resulting data points */
-	if(two_sided)
-		N=n;
-#ifdef HAVE_FFTW3
-	/* stride ignored */
-	(void)stride;
-
-	fftw_plan plan = fftw_plan_dft_r2c_1d(n, data, (fftw_complex *) result, FFTW_ESTIMATE);
-	fftw_execute(plan);
-	fftw_destroy_plan(plan);
-
-	/* 2. unpack data */
-	if(two_sided) {
-		for(i = 1; i < n-i; i++) {
-			result[2*(n - i)] = result[2*i];
-			result[2*(n - i)+1] = -result[2*i+1];
+	nsl_dft_plan *p = NULL;
+
+#ifndef HAVE_FFTW3
+	/* the GSL wavetable of the real transform is used for both */
+	if (kind == NSL_DFT_R2HC)
+		kind = NSL_DFT_R2C;
+	aligned = 0;
+#endif
+
+	nsl_mutex_lock(&nsl_dft_mutex);
+	for (i = 0; i < NSL_DFT_CACHE_SIZE; i++) {
+		nsl_dft_plan *c = &nsl_dft_plan_cache[i];
+		if (nsl_dft_plan_valid(c) && c->n == n && c->kind == kind && c->aligned == aligned) {
+			c->refcount++;
+			c->last = ++nsl_dft_plan_clock;
+			nsl_mutex_unlock(&nsl_dft_mutex);
+			return c;
 		}
-		if (i == n - i) {
-			result[2*i] = result[2*(n-1)];
-			result[2*i+1] = 0;
+		/* least recently used unused or empty slot */
+		if (c->refcount == 0 && (p == NULL || !nsl_dft_plan_valid(c) || (nsl_dft_plan_valid(p) && c->last < p->last)))
+			p = c;
+	}
+
+	if (p != NULL) {
+		nsl_dft_plan_destroy(p);
+		p->cached = 1;
+	} else {
+		/* all plans are in use */
+		p = (nsl_dft_plan *)calloc(1, sizeof(nsl_dft_plan));
+		if (p == NULL) {
+			nsl_mutex_unlock(&nsl_dft_mutex);
+			return NULL;
 		}
 	}
+
+	if (nsl_dft_plan_create(p, n, kind, aligned) != 0) {
+		nsl_dft_plan_destroy(p);
+		p->refcount = 0;
+		if (!p->cached)
+			free(p);
+		p = NULL;
+	}
+	nsl_mutex_unlock(&nsl_dft_mutex);
+
+	return p;
+}
+
+static void nsl_dft_plan_release(nsl_dft_plan *p) {
+	nsl_mutex_lock(&nsl_dft_mutex);
+	if (p->cached)
+		p->refcount--;
+	else {
+		nsl_dft_plan_destroy(p);
+		free(p);
+	}
+	nsl_mutex_unlock(&nsl_dft_mutex);
+}
+
+/* check if arrays have the alignment of fftw_malloc() */
+#ifdef HAVE_FFTW3
+#define NSL_DFT_ALIGNED(a) (fftw_alignment_of((double *)(a)) == 0)
+#else
+#define NSL_DFT_ALIGNED(a) 0
+#endif
+
+void nsl_dft_cache_clear(void) {
+	size_t i;
+	nsl_mutex_lock(&nsl_dft_mutex);
+	for (i = 0; i < NSL_DFT_CACHE_SIZE; i++)
+		if (nsl_dft_plan_cache[i].refcount == 0)
+			nsl_dft_plan_destroy(&nsl_dft_plan_cache[i]);
+	nsl_mutex_unlock(&nsl_dft_mutex);
+}
+
+void nsl_dft_set_planning(nsl_dft_planning planning) {
+#ifdef HAVE_FFTW3
+	const unsigned int flags = (planning == nsl_dft_planning_measure) ? FFTW_MEASURE : FFTW_ESTIMATE;
+	nsl_mutex_lock(&nsl_dft_mutex);
+	const int changed = (flags != nsl_dft_planner_flags);
+	nsl_dft_planner_flags = flags;
+	nsl_mutex_unlock(&nsl_dft_mutex);
+
+	if (changed)
+		nsl_dft_cache_clear();
+#else
+	(void)planning;
+#endif
+}
+
+void nsl_dft_set_threads(int nthreads) {
+#ifdef HAVE_FFTW3_THREADS
+	if (nthreads < 1)
+		nthreads = 1;
+	nsl_mutex_lock(&nsl_dft_mutex);
+	const int changed = (nthreads != nsl_dft_threads);
+	nsl_dft_threads = nthreads;
+	nsl_mutex_unlock(&nsl_dft_mutex);
+
+	if (changed)
+		nsl_dft_cache_clear();
+#else
+	(void)nthreads;
+#endif
+}
+
+int nsl_dft_wisdom_import(const char *filename) {
+#ifdef HAVE_FFTW3
+	nsl_mutex_lock(&nsl_dft_mutex);
+	const int status = fftw_import_wisdom_from_filename(filename);
+	nsl_mutex_unlock(&nsl_dft_mutex);
+	return status ? 0 : -1;
+#else
+	(void)filename;
+	return -1;
+#endif
+}
+
+int nsl_dft_wisdom_export(const char *filename) {
+#ifdef HAVE_FFTW3
+	nsl_mutex_lock(&nsl_dft_mutex);
+	const int status = fftw_export_wisdom_to_filename(filename);
+	nsl_mutex_unlock(&nsl_dft_mutex);
+	return status ? 0 : -1;
+#else
+	(void)filename;
+	return -1;
+#endif
+}
+
+size_t nsl_dft_padded_size(size_t n) {
+	size_t size;
+
+	if (n <= 1)
+		return 1;
+	for (size = n; ; size++) {
+		size_t m = size;
+		while (m%2 == 0)
+			m /= 2;
+		while (m%3 == 0)
+			m /= 3;
+		while (m%5 == 0)
+			m /= 5;
+		if (m == 1)
+			return size;
+	}
+}
+
+int nsl_dft_forward(const double data[], size_t n, double result[]) {
+	if (n == 0)
+		return -1;
+
+	nsl_dft_plan *p = nsl_dft_plan_acquire(n, NSL_DFT_R2C, NSL_DFT_ALIGNED(data) && NSL_DFT_ALIGNED(result));
+	if (p == NULL)
+		return -1;
+#ifdef HAVE_FFTW3
+	fftw_execute_dft_r2c(p->plan, (double *)data, (fftw_complex *)result);
 #else
-	/* 1. transform */
-	gsl_fft_real_wavetable *real = gsl_fft_real_wavetable_alloc(n);
+	size_t i;
 	gsl_fft_real_workspace *work = gsl_fft_real_workspace_alloc(n);
+	memcpy(result, data, n*sizeof(double));
+	gsl_fft_real_transform(result, 1, n, (const gsl_fft_real_wavetable *)p->wavetable, work);
+	gsl_fft_real_workspace_free(work);
 
-	gsl_fft_real_transform(data, stride, n, real, work);
-	gsl_fft_real_wavetable_free(real);
+	/* unpack the half-complex values in place, starting at the end */
+	if (n%2 == 0) {
+		result[n] = result[n-1];
+		result[n+1] = 0;
+	}
+	for (i = (n-1)/2; i > 0; i--) {
+		const double re = result[2*i-1], im = result[2*i];
+		result[2*i+1] = im;
+		result[2*i] = re;
+	}
+	result[1] = 0;
+#endif
+	nsl_dft_plan_release(p);
+
+	return 0;
+}
+
+int nsl_dft_backward(const double fdata[], size_t n, double result[]) {
+	if (n == 0)
+		return -1;
+
+	nsl_dft_plan *p = nsl_dft_plan_acquire(n, NSL_DFT_C2R, NSL_DFT_ALIGNED(fdata) && NSL_DFT_ALIGNED(result));
+	if (p == NULL)
+		return -1;
+
+	size_t i;
+#ifdef HAVE_FFTW3
+	fftw_execute_dft_c2r(p->plan, (fftw_complex *)fdata, result);
+	for (i = 0; i < n; i++)
+		result[i] /= n;
+#else
+	/* pack into half-complex format */
+	result[0] = fdata[0];
+	for (i = 1; i < n-i; i++) {
+		result[2*i-1] = fdata[2*i];
+		result[2*i] = fdata[2*i+1];
+	}
+	if (n%2 == 0)
+		result[n-1] = fdata[n];
+
+	gsl_fft_real_workspace *work = gsl_fft_real_workspace_alloc(n);
+	gsl_fft_halfcomplex_inverse(result, 1, n, (const gsl_fft_halfcomplex_wavetable *)p->wavetable, work);
 	gsl_fft_real_workspace_free(work);
+#endif
+	nsl_dft_plan_release(p);
+
+	return 0;
+}
 
-	/* 2. unpack data */
-	gsl_fft_halfcomplex_unpack(data, result, stride, n);
+/* in-place transform of n values to the half-complex format of the library:
+	FFTW: r0,r1,r2,...,r(n/2),i((n+1)/2-1),...,i2,i1
+	GSL: r0,r1,i1,r2,i2,...
+	Re/Im of bin 0 < k < n-k: */
+#ifdef HAVE_FFTW3
+#define NSL_DFT_HC_RE(hc, n, k) (hc)[k]
+#define NSL_DFT_HC_IM(hc, n, k) (hc)[(n)-(k)]
+#else
+#define NSL_DFT_HC_RE(hc, n, k) (hc)[2*(k)-1]
+#define NSL_DFT_HC_IM(hc, n, k) (hc)[2*(k)]
+#endif
+/* execute plan of kind NSL_DFT_R2HC on data. work: GSL work space of n values (unused with FFTW) */
+static void nsl_dft_plan_execute_r2hc(const nsl_dft_plan *p, double data[], void *work) {
+#ifdef HAVE_FFTW3
+	(void)work;
+	fftw_execute_r2r(p->plan, data, data);
+#else
+	gsl_fft_real_transform(data, 1, p->n, (const gsl_fft_real_wavetable *)p->wavetable, (gsl_fft_real_workspace *)work);
 #endif
+}
 
-	/* 3. write result */
-	switch(type) {
-	case nsl_dft_result_magnitude:
-		for (i = 0; i < N; i++)
-			data[i] = sqrt(gsl_pow_2(result[2*i])+gsl_pow_2(result[2*i+1]));
-		break;
-	case nsl_dft_result_amplitude:
-		for (i = 0; i < N; i++) {
-			data[i] = sqrt(gsl_pow_2(result[2*i])+gsl_pow_2(result[2*i+1]))/n;
-			if(i>0)
-				data[i] *= 2.;
-		}
-		break;
+static void* nsl_dft_work_alloc(size_t n) {
+#ifdef HAVE_FFTW3
+	(void)n;
+	return (void *)1;	/* not used */
+#else
+	return gsl_fft_real_workspace_alloc(n);
+#endif
+}
+
+static void nsl_dft_work_free(void *work) {
+#ifdef HAVE_FFTW3
+	(void)work;
+#else
+	gsl_fft_real_workspace_free((gsl_fft_real_workspace *)work);
+#endif
+}
+
+static int nsl_dft_halfcomplex(double data[], size_t n) {
+	nsl_dft_plan *p = nsl_dft_plan_acquire(n, NSL_DFT_R2HC, NSL_DFT_ALIGNED(data));
+	if (p == NULL)
+		return -1;
+	void *work = nsl_dft_work_alloc(n);
+	if (work == NULL) {
+		nsl_dft_plan_release(p);
+		return -1;
+	}
+	nsl_dft_plan_execute_r2hc(p, data, work);
+	nsl_dft_work_free(work);
+	nsl_dft_plan_release(p);
+
+	return 0;
+}
+
+/* write bins 0 .. K-1 (K <= n/2+1) of the half-complex values hc of n data points as result type to out (not raw).
+	out may be hc: out[k] is written after the last read of it */
+static void nsl_dft_write_result(double out[], const double hc[], size_t n, size_t K, nsl_dft_result_type type) {
+	size_t i;
+	const size_t kmax = GSL_MIN(K, (n+1)/2);	/* bins 0 < k < kmax have real and imaginary part */
+#ifdef HAVE_FFTW3
+	const double nyquist = hc[n/2];
+#else
+	const double nyquist = hc[n-1];
+#endif
+	const double dc = hc[0];
+	switch (type) {
 	case nsl_dft_result_real:
-		for (i = 0; i < N; i++)
-			data[i] = result[2*i];
+		for (i = 1; i < kmax; i++)
+			out[i] = NSL_DFT_HC_RE(hc, n, i);
+		if (K > 0)
+			out[0] = dc;
+		if (n%2 == 0 && K > n/2)
+			out[n/2] = nyquist;
 		break;
 	case nsl_dft_result_imag:
-		for (i = 0; i < N; i++)
-			data[i] = result[2*i+1];
-		break;
-	case nsl_dft_result_power:
-		for (i = 0; i < N; i++) {
-			data[i] = (gsl_pow_2(result[2*i])+gsl_pow_2(result[2*i+1]))/n;
-			if (i > 0)
-				data[i] *= 2.;
-		}
+		for (i = 1; i < kmax; i++)
+			out[i] = NSL_DFT_HC_IM(hc, n, i);
+		if (K > 0)
+			out[0] = 0;
+		if (n%2 == 0 && K > n/2)
+			out[n/2] = 0;
 		break;
 	case nsl_dft_result_phase:
-		for (i = 0; i < N; i++)
-			data[i] = -atan2(result[2*i+1],result[2*i]);
+		for (i = 1; i < kmax; i++)
+			out[i] = -atan2(NSL_DFT_HC_IM(hc, n, i), NSL_DFT_HC_RE(hc, n, i));
+		if (K > 0)
+			out[0] = -atan2(0., dc);
+		if (n%2 == 0 && K > n/2)
+			out[n/2] = -atan2(0., nyquist);
 		break;
+	default:	/* squared magnitude p */
+		for (i = 1; i < kmax; i++)
+			out[i] = gsl_pow_2(NSL_DFT_HC_RE(hc, n, i)) + gsl_pow_2(NSL_DFT_HC_IM(hc, n, i));
+		if (K > 0)
+			out[0] = gsl_pow_2(dc);
+		if (n%2 == 0 && K > n/2)
+			out[n/2] = gsl_pow_2(nyquist);
+	}
+
+	/* scale p of all bins in one pass. bin 0 is scaled with scale0 instead of scale */
+	double scale = 1., scale0 = 1.;
+	switch (type) {
+	case nsl_dft_result_amplitude:
 	case nsl_dft_result_dB:
-		for (i = 0; i < N; i++) {
-			if (i == 0)
-				data[i] = 20.*log10(sqrt(gsl_pow_2(result[2*i])+gsl_pow_2(result[2*i+1]))/(double)n);
-			else
-				data[i] = 20.*log10(2.*sqrt(gsl_pow_2(result[2*i])+gsl_pow_2(result[2*i+1]))/(double)n);
-		}
+	case nsl_dft_result_normdB:
+	case nsl_dft_result_squareamplitude:
+		scale0 = 1./gsl_pow_2(n);
+		scale = 4.*scale0;
 		break;
-	case nsl_dft_result_normdB: {
-		double maxdB=0;
-		for (i = 0; i < N; i++) {
-			if (i == 0)
-				data[i] = 20.*log10(sqrt(gsl_pow_2(result[2*i])+gsl_pow_2(result[2*i+1]))/(double)n);
-			else
-				data[i] = 20.*log10(2.*sqrt(gsl_pow_2(result[2*i])+gsl_pow_2(result[2*i+1]))/(double)n);
-
-			if (i == 0 || maxdB < data[i])
-				maxdB = data[i];
-		}
-		for (i = 0; i < N; i++)
-			data[i] -= maxdB;
+	case nsl_dft_result_power:
+		scale0 = 1./n;
+		scale = 2.*scale0;
+		break;
+	default:
 		break;
 	}
-	case nsl_dft_result_squaremagnitude:
-		for (i = 0; i < N; i++)
-			data[i] = gsl_pow_2(result[2*i])+gsl_pow_2(result[2*i+1]);
+	if (K > 0)
+		out[0] *= scale0/scale;
+	switch (type) {
+	case nsl_dft_result_magnitude:
+	case nsl_dft_result_amplitude:
+		/* sqrt(p)*c = sqrt(p*c^2) */
+		for (i = 0; i < K; i++)
+			out[i] = sqrt(out[i]*scale);
 		break;
+	case nsl_dft_result_power:
+	case nsl_dft_result_squaremagnitude:
 	case nsl_dft_result_squareamplitude:
-		for (i = 0; i < N; i++) {
-			data[i] = (gsl_pow_2(result[2*i])+gsl_pow_2(result[2*i+1]))/gsl_pow_2(n);
-			if (i > 0)
-				data[i] *= 4.;
-		}
+		for (i = 0; i < K; i++)
+			out[i] *= scale;
+		break;
+	case nsl_dft_result_dB:
+	case nsl_dft_result_normdB:
+		/* 20 log10(sqrt(p)*c) = 10 log10(p*c^2) */
+		for (i = 0; i < K; i++)
+			out[i] = 10.*log10(out[i]*scale);
 		break;
-	case nsl_dft_result_raw:
+	default:
 		break;
 	}
+	if (type == nsl_dft_result_normdB && K > 0) {
+		double maxdB = out[0];
+		for (i = 1; i < K; i++)
+			if (out[i] > maxdB)
+				maxdB = out[i];
+		for (i = 0; i < K; i++)
+			out[i] -= maxdB;
+	}
+}
+
+int nsl_dft_transform_window(double data[], size_t stride, size_t n, int two_sided, nsl_dft_result_type type, nsl_sf_window_type window_type) {
+	/* apply window function */
+	if (window_type != nsl_sf_window_uniform)
+		nsl_sf_apply_window(data, n, window_type);
+
+	/* transform */
+	int status = nsl_dft_transform(data, stride, n, two_sided, type);
+
+	return status;
+}
+
+int nsl_dft_transform(double data[], size_t stride, size_t n, int two_sided, nsl_dft_result_type type) {
+	size_t i;
+	if (n == 0)
+		return -1;
+	size_t N = n/2;	/* number of resulting data points */
+	if (two_sided)
+		N = n;
+
+	/* 1. transform in place (or in a copy of the strided data) */
+	double *hc = data;
+	if (stride != 1) {
+		hc = (double *)malloc(n*sizeof(double));
+		if (hc == NULL)
+			return -1;
+		for (i = 0; i < n; i++)
+			hc[i] = data[i*stride];
+	}
+	if (nsl_dft_halfcomplex(hc, n) != 0) {
+		if (hc != data)
+			free(hc);
+		return -1;
+	}
+
+	if (type == nsl_dft_result_raw) {
+#ifdef HAVE_FFTW3
+		/* reorder to GSL format */
+		double *tmp = hc;
+		if (hc == data) {
+			tmp = (double *)malloc(n*sizeof(double));
+			if (tmp == NULL)
+				return -1;
+			memcpy(tmp, data, n*sizeof(double));
+		}
+		data[0] = tmp[0];
+		for (i = 1; i < n-i; i++) {
+			data[2*i-1] = tmp[i];
+			data[2*i] = tmp[n-i];
+		}
+		if (n%2 == 0)
+			data[n-1] = tmp[n/2];
+		free(tmp);
+#else
+		if (hc != data) {
+			memcpy(data, hc, n*sizeof(double));
+			free(hc);
+		}
+#endif
+		return 0;
+	}
+
+	/* 2. write bins 0 .. K-1 to data */
+	const size_t K = two_sided ? n/2+1 : N;
+	nsl_dft_write_result(data, hc, n, K, type);
+	if (hc != data)
+		free(hc);
+
+	/* 4. two sided: bins n-k are the complex conjugates of bins k */
+	if (two_sided) {
+		const double sign = (type == nsl_dft_result_imag || type == nsl_dft_result_phase) ? -1. : 1.;
+		for (i = n/2+1; i < n; i++)
+			data[i] = sign*data[n-i];
+	}
 
 	return 0;
 }
 
+size_t nsl_dft_stft_frames(size_t n, size_t segment, size_t overlap) {
+	if (segment == 0 || overlap >= segment || n < segment)
+		return 0;
+	return (n - segment)/(segment - overlap) + 1;
+}
+
+/* transform frames first .. last-1 with one plan and work space.
+	sum == 0: write result type of frame j to result[(j-first)*K]
+	sum != 0: add the squared magnitudes of all frames to result (K values) */
+static int nsl_dft_frames(const double data[], size_t segment, size_t overlap, nsl_sf_window_type window, nsl_dft_result_type type,
+		size_t first, size_t last, double result[], int sum) {
+	const size_t K = segment/2+1, hop = segment - overlap;
+	size_t i, j;
+
+#ifdef HAVE_FFTW3
+	double *buf = (double *)fftw_malloc(segment*sizeof(double));
+#else
+	double *buf = (double *)malloc(segment*sizeof(double));
+#endif
+	double *w = (double *)malloc(segment*sizeof(double));
+	void *work = nsl_dft_work_alloc(segment);
+	nsl_dft_plan *p = nsl_dft_plan_acquire(segment, NSL_DFT_R2HC, NSL_DFT_ALIGNED(buf));
+	int status = (buf != NULL && w != NULL && work != NULL && p != NULL) ? 0 : -1;
+	if (status == 0)
+		status = nsl_sf_window_coefficients(w, segment, window);
+
+	for (j = first; j < last && status == 0; j++) {
+		const double *x = &data[j*hop];
+		for (i = 0; i < segment; i++)
+			buf[i] = w[i]*x[i];
+		nsl_dft_plan_execute_r2hc(p, buf, work);
+
+		if (sum) {
+			nsl_dft_write_result(buf, buf, segment, K, nsl_dft_result_squaremagnitude);
+			for (i = 0; i < K; i++)
+				result[i] += buf[i];
+		} else
+			nsl_dft_write_result(&result[(j-first)*K], buf, segment, K, type);
+	}
+
+	if (p != NULL)
+		nsl_dft_plan_release(p);
+	if (work != NULL)
+		nsl_dft_work_free(work);
+	free(w);
+#ifdef HAVE_FFTW3
+	fftw_free(buf);
+#else
+	free(buf);
+#endif
+
+	return status;
+}
+
+int nsl_dft_stft(const double data[], size_t n, size_t segment, size_t overlap, nsl_sf_window_type window, nsl_dft_result_type type,
+		size_t first, size_t last, double result[]) {
+	if (type == nsl_dft_result_raw || last > nsl_dft_stft_frames(n, segment, overlap) || first > last)
+		return -1;
+
+	return nsl_dft_frames(data, segment, overlap, window, type, first, last, result, 0);
+}
+
+int nsl_dft_welch(const double data[], size_t n, size_t segment, size_t overlap, nsl_sf_window_type window, double rate, double result[]) {
+	const size_t frames = nsl_dft_stft_frames(n, segment, overlap);
+	const size_t K = segment/2+1;
+	size_t i;
+	if (frames == 0 || rate <= 0)
+		return -1;
+
+	for (i = 0; i < K; i++)
+		result[i] = 0;
+	if (nsl_dft_frames(data, segment, overlap, window, nsl_dft_result_squaremagnitude, 0, frames, result, 1) != 0)
+		return -1;
+
+	/* normalize with the power of the window (sum w^2), one-sided */
+	double *w = (double *)malloc(segment*sizeof(double));
+	if (w == NULL)
+		return -1;
+	if (nsl_sf_window_coefficients(w, segment, window) != 0) {
+		free(w);
+		return -1;
+	}
+	double U = 0;
+	for (i = 0; i < segment; i++)
+		U += w[i]*w[i];
+	free(w);
+
+	const double scale = 2./(frames*rate*U);
+	for (i = 0; i < K; i++)
+		result[i] *= scale;
+	result[0] /= 2.;
+	if (segment%2 == 0)
+		result[K-1] /= 2.;
+
+	return 0;
+}
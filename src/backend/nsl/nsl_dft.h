@@ -43,7 +43,7 @@
 	normdB = dB - max(dB)
 	squaremagnitude = magnitude^2
 	squareamplitude = amplitude^2 aka MSA
-	raw = halfcomplex GSL output (TODO: FFTW)
+	raw = halfcomplex output (GSL format)
 	TODO: PSD (aka TISA), normdB
  */
 #define NSL_DFT_RESULT_TYPE_COUNT 11
@@ -56,11 +56,46 @@ extern const char* nsl_dft_result_type_name[];
 typedef enum {nsl_dft_xscale_frequency, nsl_dft_xscale_index, nsl_dft_xscale_period} nsl_dft_xscale; 
 extern const char* nsl_dft_xscale_name[];
 
+/* real FFT of n values with cached plans (FFTW) or wavetables (GSL) per size and direction. The cache is thread-safe.
+	forward: result contains the n/2+1 complex values re0,im0,re1,im1,... (2*(n/2+1) values)
+	backward: inverse transform of the n/2+1 complex values fdata, normalized by 1/n
+	data and result must not overlap */
+int nsl_dft_forward(const double data[], size_t n, double result[]);
+int nsl_dft_backward(const double fdata[], size_t n, double result[]);
+/* smallest transform size >= n with only the factors 2, 3 and 5 (fast for FFTW and GSL), used for zero padding */
+size_t nsl_dft_padded_size(size_t n);
+/* free all unused cached plans */
+void nsl_dft_cache_clear(void);
+
+/* planning of new FFTW plans: estimate (fast) or measure (slow, but faster transforms). Clears the cache when changed */
+typedef enum {nsl_dft_planning_estimate, nsl_dft_planning_measure} nsl_dft_planning;
+void nsl_dft_set_planning(nsl_dft_planning planning);
+/* load/save the FFTW planning results (wisdom) from/to a file. Returns -1 on error or without FFTW */
+int nsl_dft_wisdom_import(const char *filename);
+int nsl_dft_wisdom_export(const char *filename);
+/* number of threads used for transforms of at least NSL_DFT_THREADS_MIN_POINTS values (needs FFTW threads) */
+#define NSL_DFT_THREADS_MIN_POINTS 262144
+void nsl_dft_set_threads(int nthreads);
+
 /* transform data of size n. result in data 
 	calculates the two-sided DFT
+	transforms in place (GSL needs a workspace of n values, stride != 1 a copy of the data)
 */
 int nsl_dft_transform(double data[], size_t stride, size_t n, int two_sided, nsl_dft_result_type type);
 /* windowed version */
 int nsl_dft_transform_window(double data[], size_t stride, size_t n, int two_sided, nsl_dft_result_type type, nsl_sf_window_type window);
 
+/* short-time Fourier transform (spectrogram) of n values
+	frame j contains the segment values starting at j*(segment-overlap), weighted with the window.
+	Incomplete frames at the end are dropped.
+	result contains the one-sided spectra (segment/2+1 values, not raw) of the frames first .. last-1:
+	frame j at result[(j-first)*(segment/2+1)]. Ranges of frames can be calculated in parallel.
+	normdB is normalized per frame */
+size_t nsl_dft_stft_frames(size_t n, size_t segment, size_t overlap);
+int nsl_dft_stft(const double data[], size_t n, size_t segment, size_t overlap, nsl_sf_window_type window, nsl_dft_result_type type,
+		size_t first, size_t last, double result[]);
+/* Welch's power spectral density: mean periodogram of all frames (as above, no detrending)
+	result contains the one-sided density (unit^2/Hz) at the frequencies k*rate/segment, k = 0 .. segment/2 */
+int nsl_dft_welch(const double data[], size_t n, size_t segment, size_t overlap, nsl_sf_window_type window, double rate, double result[]);
+
 #endif /* NSL_DFT_H */
@@ -138,4 +138,25 @@ int main() {
 	for(i=0; i < size; i++)
 		printf("%g ", data11[i]);
 	puts("");
+
+	/* short-time transform: frames of 4 values, overlapping by 2 */
+	double data12[]={1, 1, 3, 3, 1, -1, 0, 1, 1, 0};
+	const size_t segment=4, overlap=2;
+	const size_t frames=nsl_dft_stft_frames(N, segment, overlap);
+	double result[4*3];
+	nsl_dft_stft(data12, N, segment, overlap, nsl_sf_window_hann, nsl_dft_result_magnitude, 0, frames, result);
+
+	printf("STFT (%zu frames):\n", frames);
+	size_t j, k;
+	for(j=0; j < frames; j++) {
+		for(k=0; k < segment/2+1; k++)
+			printf("%g ", result[j*(segment/2+1)+k]);
+		puts("");
+	}
+
+	nsl_dft_welch(data12, N, segment, overlap, nsl_sf_window_hann, 1., result);
+	puts("Welch PSD:");
+	for(k=0; k < segment/2+1; k++)
+		printf("%g ", result[k]);
+	puts("");
 }
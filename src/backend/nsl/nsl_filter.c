@@ -29,12 +29,10 @@
 #include "nsl_filter.h"
 #include "nsl_common.h"
 #include "nsl_sf_poly.h"
+#include "nsl_dft.h"
+#include <string.h>
+#include <gsl/gsl_math.h>
 #include <gsl/gsl_sf_pow_int.h>
-#include <gsl/gsl_fft_real.h>
-#include <gsl/gsl_fft_halfcomplex.h>
-#ifdef HAVE_FFTW3
-#include <fftw3.h>
-#endif
 
 const char* nsl_filter_type_name[] = { i18n("Low pass"), i18n("High pass"), i18n("Band pass"), i18n("Band reject") };
 const char* nsl_filter_form_name[] = { i18n("Ideal"), i18n("Butterworth"), i18n("Chebyshev type I"), i18n("Chebyshev type II"), i18n("Legendre (Optimum L)"), i18n("Bessel (Thomson)") };
@@ -54,6 +52,10 @@ int nsl_filter_apply(double data[], size_t n, nsl_filter_type type, nsl_filter_f
 		printf("index for cutoff must be <= n/2+1\n");
 		return -1;
 	}
+	if ((type == nsl_filter_type_band_pass || type == nsl_filter_type_band_reject) && bandwidth <= 0) {
+		printf("bandwidth must be > 0\n");
+		return -1;
+	}
 
 	size_t i;
 	double factor, centerindex = cutindex + bandwidth/2.;
@@ -201,7 +203,7 @@ int nsl_filter_apply(double data[], size_t n, nsl_filter_type type, nsl_filter_f
 	case nsl_filter_type_band_reject:
 		switch (form) {
 		case nsl_filter_form_ideal:
-			for (i = cutindex; i < cutindex + bandwidth; i++)
+			for (i = cutindex; i < GSL_MIN(cutindex + bandwidth, n/2+1); i++)
 				data[2*i] = data[2*i+1] = 0;
 			break;
 		case nsl_filter_form_butterworth:
@@ -267,41 +269,379 @@ void print_fdata(double data[], size_t n) {
 
 int nsl_filter_fourier(double data[], size_t n, nsl_filter_type type, nsl_filter_form form, int order, int cutindex, int bandwidth) {
 	/* 1. transform */
-	double fdata[2*n];	/* contains re0,im0,re1,im1,re2,im2,... */
-#ifdef HAVE_FFTW3
-        fftw_plan plan = fftw_plan_dft_r2c_1d(n, data, (fftw_complex *) fdata, FFTW_ESTIMATE);
-        fftw_execute(plan);
-	fftw_destroy_plan(plan);
-#else
-	gsl_fft_real_wavetable *real = gsl_fft_real_wavetable_alloc(n);
-	gsl_fft_real_workspace *work = gsl_fft_real_workspace_alloc(n);
-
-	gsl_fft_real_transform(data, 1, n, real, work);
-	gsl_fft_real_wavetable_free(real);
-
-	gsl_fft_halfcomplex_unpack(data, fdata, 1, n);
-#endif
+	double *fdata = (double *)malloc(2*(n/2+1)*sizeof(double));	/* contains re0,im0,re1,im1,re2,im2,... */
+	if (fdata == NULL)
+		return -1;
+	if (nsl_dft_forward(data, n, fdata) != 0) {
+		free(fdata);
+		return -1;
+	}
 
 	/* 2. apply filter */
 	/*print_fdata(fdata, n);*/
 	int status = nsl_filter_apply(fdata, n, type, form, order, cutindex, bandwidth);
 	/*print_fdata(fdata, n);*/
-	
+
 	/* 3. back transform */
-#ifdef HAVE_FFTW3
-        plan = fftw_plan_dft_c2r_1d(n, (fftw_complex *) fdata, data, FFTW_ESTIMATE);
-        fftw_execute(plan);
-	fftw_destroy_plan(plan);
-	/* normalize*/
-	size_t i;
-	for (i=0; i < n; i++)
-		data[i] /= n;
-#else
-	gsl_fft_halfcomplex_wavetable *hc = gsl_fft_halfcomplex_wavetable_alloc(n);
-	gsl_fft_halfcomplex_inverse(data, 1, n, hc, work);
-	gsl_fft_halfcomplex_wavetable_free(hc);
-	gsl_fft_real_workspace_free (work);
-#endif
+	nsl_dft_backward(fdata, n, data);
+	free(fdata);
 
 	return status;
 }
+
+/*********************** time domain (IIR) filter ***********************/
+
+/* analog prototype with cutoff 1: poles p[], zeros z[] and gain k
+	same ripple (epsilon=1) as the Fourier filter forms above
+	returns number of poles, *nz is set to the number of zeros */
+static int nsl_filter_iir_prototype(nsl_filter_form form, int order, double complex p[], double complex z[], int *nz, double *k) {
+	int i, j;
+	double complex prod = 1.;
+	double mu = gsl_asinh(1.)/order;
+	*nz = 0;
+
+	switch (form) {
+	case nsl_filter_form_butterworth:
+		for (i = 0; i < order; i++)
+			p[i] = cexp(I*M_PI*(2*i + order + 1)/(2.*order));
+		break;
+	case nsl_filter_form_chebyshev_i:
+		for (i = 0; i < order; i++) {
+			double theta = M_PI*(2*i + 1)/(2.*order);
+			p[i] = -sinh(mu)*sin(theta) + I*cosh(mu)*cos(theta);
+		}
+		break;
+	case nsl_filter_form_chebyshev_ii:
+		for (i = 0; i < order; i++) {
+			double theta = M_PI*(2*i + 1)/(2.*order);
+			p[i] = 1./(-sinh(mu)*sin(theta) + I*cosh(mu)*cos(theta));
+			if (2*i + 1 != order)	/* no zero for the middle pole of odd orders */
+				z[(*nz)++] = I/cos(theta);
+		}
+		break;
+	case nsl_filter_form_bessel:
+		/* roots of the reversed Bessel polynomial (monic) by Durand-Kerner iteration
+			same normalization as nsl_filter_gain_bessel() */
+		for (i = 0; i < order; i++)
+			p[i] = cpow(0.4 + 0.9*I, i);
+		for (j = 0; j < 500; j++) {
+			double delta = 0;
+			for (i = 0; i < order; i++) {
+				double complex d = 1.;
+				int l;
+				for (l = 0; l < order; l++)
+					if (l != i)
+						d *= p[i] - p[l];
+				d = nsl_sf_poly_reversed_bessel_theta(order, p[i])/d;
+				p[i] -= d;
+				delta = GSL_MAX(delta, cabs(d));
+			}
+			if (delta < 1.e-14)
+				break;
+		}
+		break;
+	default:
+		return 0;
+	}
+
+	/* unity gain at DC (Chebyshev I of even order: at the ripple minimum) */
+	for (i = 0; i < order; i++)
+		prod *= -p[i];
+	for (i = 0; i < *nz; i++)
+		prod /= -z[i];
+	*k = creal(prod);
+	if (form == nsl_filter_form_chebyshev_i && order % 2 == 0)
+		*k /= M_SQRT2;
+
+	return order;
+}
+
+/* add pole (or zero) pair to section: coefficients of (1 - a z^-1)(1 - b z^-1) */
+static void nsl_filter_iir_poly(double complex a, double complex b, double c[3]) {
+	c[0] = 1.;
+	c[1] = -creal(a + b);
+	c[2] = creal(a*b);
+}
+
+/* set coefficients of section s with gain g */
+static void nsl_filter_iir_section(nsl_filter_iir* filter, size_t s, const double b[3], const double a[3], double g) {
+	double *c = filter->coeff + 5*s;
+	c[0] = g*b[0];
+	c[1] = g*b[1];
+	c[2] = g*b[2];
+	c[3] = a[1];
+	c[4] = a[2];
+}
+
+/* index of the remaining root closest to r (real roots only if real != 0) */
+static int nsl_filter_iir_closest(const double complex roots[], const int used[], int n, double complex r, int real) {
+	int i, best = -1;
+	for (i = 0; i < n; i++) {
+		if (used[i] || cimag(roots[i]) < 0 || (real && cimag(roots[i]) != 0))
+			continue;
+		if (best < 0 || cabs(roots[i] - r) < cabs(roots[best] - r))
+			best = i;
+	}
+	return best;
+}
+
+nsl_filter_iir* nsl_filter_iir_new(nsl_filter_type type, nsl_filter_form form, int order, double cutoff, double bandwidth) {
+	if (order < 1 || cutoff <= 0 || cutoff >= 1)
+		return NULL;
+	const int band = (type == nsl_filter_type_band_pass || type == nsl_filter_type_band_reject);
+	if (band && (bandwidth <= 0 || cutoff + bandwidth >= 1))
+		return NULL;
+
+	const int np = band ? 2*order : order;
+	double complex *p = (double complex *)malloc(4*np*sizeof(double complex));
+	if (p == NULL)
+		return NULL;
+	double complex *z = p + np, *tp = z + np, *tz = tp + np;
+	int i, nz, ntz = 0;
+	double k;
+	if (nsl_filter_iir_prototype(form, order, p, z, &nz, &k) == 0) {
+		free(p);
+		return NULL;
+	}
+
+	/* prewarped analog frequencies (sample rate 1, bilinear s = 2(z-1)/(z+1)) */
+	const double w1 = 2.*tan(M_PI*cutoff/2.);
+	const double w2 = band ? 2.*tan(M_PI*(cutoff + bandwidth)/2.) : w1;
+	const double w0 = sqrt(w1*w2), bw = w2 - w1;
+	double complex prod = 1.;
+
+	/* frequency transformation of the prototype */
+	switch (type) {
+	case nsl_filter_type_low_pass:
+		for (i = 0; i < order; i++)
+			tp[i] = w1*p[i];
+		for (i = 0; i < nz; i++)
+			tz[ntz++] = w1*z[i];
+		k *= gsl_sf_pow_int(w1, order - nz);
+		break;
+	case nsl_filter_type_high_pass:
+		for (i = 0; i < order; i++) {
+			tp[i] = w1/p[i];
+			prod /= -p[i];
+		}
+		for (i = 0; i < nz; i++) {
+			tz[ntz++] = w1/z[i];
+			prod *= -z[i];
+		}
+		while (ntz < order)
+			tz[ntz++] = 0;
+		k *= creal(prod);
+		break;
+	case nsl_filter_type_band_pass:
+		for (i = 0; i < order; i++) {
+			double complex r = p[i]*bw/2., sq = csqrt(r*r - w0*w0);
+			tp[2*i] = r + sq;
+			tp[2*i+1] = r - sq;
+		}
+		for (i = 0; i < nz; i++) {
+			double complex r = z[i]*bw/2., sq = csqrt(r*r - w0*w0);
+			tz[ntz++] = r + sq;
+			tz[ntz++] = r - sq;
+		}
+		for (i = nz; i < order; i++)
+			tz[ntz++] = 0;
+		k *= gsl_sf_pow_int(bw, order - nz);
+		break;
+	case nsl_filter_type_band_reject:
+		for (i = 0; i < order; i++) {
+			double complex r = bw/2./p[i], sq = csqrt(r*r - w0*w0);
+			tp[2*i] = r + sq;
+			tp[2*i+1] = r - sq;
+			prod /= -p[i];
+		}
+		for (i = 0; i < nz; i++) {
+			double complex r = bw/2./z[i], sq = csqrt(r*r - w0*w0);
+			tz[ntz++] = r + sq;
+			tz[ntz++] = r - sq;
+			prod *= -z[i];
+		}
+		while (ntz < np) {
+			tz[ntz++] = I*w0;
+			tz[ntz++] = -I*w0;
+		}
+		k *= creal(prod);
+		break;
+	}
+
+	/* bilinear transform, zeros at infinity go to z=-1 */
+	prod = 1.;
+	for (i = 0; i < np; i++) {
+		prod /= 2. - tp[i];
+		tp[i] = (2. + tp[i])/(2. - tp[i]);
+	}
+	for (i = 0; i < ntz; i++) {
+		prod *= 2. - tz[i];
+		tz[i] = (2. + tz[i])/(2. - tz[i]);
+	}
+	while (ntz < np)
+		tz[ntz++] = -1.;
+	k *= creal(prod);
+
+	/* clean up rounding: roots that should be real */
+	for (i = 0; i < np; i++) {
+		if (fabs(cimag(tp[i])) < 1.e-10*GSL_MAX(1., cabs(tp[i])))
+			tp[i] = creal(tp[i]);
+		if (fabs(cimag(tz[i])) < 1.e-10*GSL_MAX(1., cabs(tz[i])))
+			tz[i] = creal(tz[i]);
+	}
+
+	/* pair poles and zeros into second order sections */
+	nsl_filter_iir* filter = (nsl_filter_iir *)malloc(sizeof(nsl_filter_iir));
+	int *used = (int *)calloc(2*np, sizeof(int));
+	if (filter == NULL || used == NULL) {
+		free(filter);
+		free(used);
+		free(p);
+		return NULL;
+	}
+	int *zused = used + np;
+	filter->sections = (np + 1)/2;
+	filter->coeff = (double *)malloc(5*filter->sections*sizeof(double));
+	filter->state = (double *)calloc(2*filter->sections, sizeof(double));
+	if (filter->coeff == NULL || filter->state == NULL) {
+		free(used);
+		free(p);
+		nsl_filter_iir_free(filter);
+		return NULL;
+	}
+
+	size_t s = 0;
+	double a[3], b[3];
+	int ip, iq, iz;
+	/* odd number of real poles: the one farthest from the unit circle gets a first order section */
+	int nreal = 0;
+	ip = -1;
+	for (i = 0; i < np; i++)
+		if (cimag(tp[i]) == 0) {
+			nreal++;
+			if (ip < 0 || cabs(tp[i]) < cabs(tp[ip]))
+				ip = i;
+		}
+	if (nreal % 2) {
+		used[ip] = 1;
+		iz = nsl_filter_iir_closest(tz, zused, np, tp[ip], 1);
+		zused[iz] = 1;
+		a[0] = 1.; a[1] = -creal(tp[ip]); a[2] = 0;
+		b[0] = 1.; b[1] = -creal(tz[iz]); b[2] = 0;
+		nsl_filter_iir_section(filter, s, b, a, k);
+		s++;
+	}
+	/* remaining poles closest to the unit circle first, each with the closest zero (pair) */
+	for (;;) {
+		ip = iq = -1;
+		for (i = 0; i < np; i++)
+			if (!used[i] && cimag(tp[i]) >= 0 && (ip < 0 || cabs(tp[i]) > cabs(tp[ip])))
+				ip = i;
+		if (ip < 0)
+			break;
+		used[ip] = 1;
+		if (cimag(tp[ip]) == 0) {	/* second real pole */
+			for (i = 0; i < np; i++)
+				if (!used[i] && cimag(tp[i]) == 0 && (iq < 0 || cabs(tp[i]) > cabs(tp[iq])))
+					iq = i;
+			used[iq] = 1;
+			nsl_filter_iir_poly(tp[ip], tp[iq], a);
+		} else
+			nsl_filter_iir_poly(tp[ip], conj(tp[ip]), a);
+
+		iz = nsl_filter_iir_closest(tz, zused, np, tp[ip], 0);
+		zused[iz] = 1;
+		if (cimag(tz[iz]) != 0)
+			nsl_filter_iir_poly(tz[iz], conj(tz[iz]), b);
+		else {	/* the number of remaining real zeros is even */
+			int jz = nsl_filter_iir_closest(tz, zused, np, tp[ip], 1);
+			zused[jz] = 1;
+			nsl_filter_iir_poly(tz[iz], tz[jz], b);
+		}
+		/* total gain in the first section */
+		nsl_filter_iir_section(filter, s, b, a, s == 0 ? k : 1.);
+		s++;
+	}
+	filter->sections = s;
+
+	free(used);
+	free(p);
+	return filter;
+}
+
+void nsl_filter_iir_free(nsl_filter_iir* filter) {
+	if (filter == NULL)
+		return;
+	free(filter->coeff);
+	free(filter->state);
+	free(filter);
+}
+
+void nsl_filter_iir_reset(nsl_filter_iir* filter) {
+	size_t s;
+	for (s = 0; s < 2*filter->sections; s++)
+		filter->state[s] = 0;
+}
+
+void nsl_filter_iir_init(nsl_filter_iir* filter, double x0) {
+	size_t s;
+	for (s = 0; s < filter->sections; s++) {
+		const double *c = filter->coeff + 5*s;
+		/* DC gain of the section */
+		const double y0 = x0*(c[0] + c[1] + c[2])/(1. + c[3] + c[4]);
+		filter->state[2*s] = y0 - c[0]*x0;
+		filter->state[2*s+1] = c[2]*x0 - c[4]*y0;
+		x0 = y0;
+	}
+}
+
+void nsl_filter_iir_process(nsl_filter_iir* filter, const double in[], double out[], size_t n) {
+	size_t i, s;
+	if (in != out)
+		memcpy(out, in, n*sizeof(double));
+
+	/* section by section: the coefficients stay in registers for the whole block */
+	for (s = 0; s < filter->sections; s++) {
+		const double *c = filter->coeff + 5*s;
+		const double b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+		double s1 = filter->state[2*s], s2 = filter->state[2*s+1];
+		for (i = 0; i < n; i++) {
+			const double x = out[i];
+			const double y = b0*x + s1;
+			s1 = b1*x - a1*y + s2;
+			s2 = b2*x - a2*y;
+			out[i] = y;
+		}
+		filter->state[2*s] = s1;
+		filter->state[2*s+1] = s2;
+	}
+}
+
+static void nsl_filter_reverse(double data[], size_t n) {
+	size_t i;
+	for (i = 0; i < n/2; i++) {
+		double tmp = data[i];
+		data[i] = data[n-1-i];
+		data[n-1-i] = tmp;
+	}
+}
+
+int nsl_filter_iir_apply(double data[], size_t n, nsl_filter_type type, nsl_filter_form form, int order, double cutoff, double bandwidth, int zerophase) {
+	if (n == 0)
+		return 0;
+	nsl_filter_iir* filter = nsl_filter_iir_new(type, form, order, cutoff, bandwidth);
+	if (filter == NULL)
+		return -1;
+
+	nsl_filter_iir_init(filter, data[0]);
+	nsl_filter_iir_process(filter, data, data, n);
+	if (zerophase) {
+		nsl_filter_reverse(data, n);
+		nsl_filter_iir_init(filter, data[0]);
+		nsl_filter_iir_process(filter, data, data, n);
+		nsl_filter_reverse(data, n);
+	}
+
+	nsl_filter_iir_free(filter);
+	return 0;
+}
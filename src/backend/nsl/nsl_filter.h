@@ -53,4 +53,30 @@ double nsl_filter_gain_bessel(int n, double x);
 int nsl_filter_apply(double data[], size_t n, nsl_filter_type type, nsl_filter_form form, int order, double cutindex, double bandwidth);
 int nsl_filter_fourier(double data[], size_t n, nsl_filter_type type, nsl_filter_form form, int order, int cutindex, int bandwidth);
 
+/* time domain IIR filter realized as cascade of second order sections (biquads)
+	designed from the analog prototype (Butterworth, Chebyshev I/II or Bessel) by bilinear transform
+	cutoff and bandwidth are fractions of the Nyquist frequency (0..1)
+	the state is kept between calls of nsl_filter_iir_process(), so appended data can be filtered
+	block by block with O(order) work per sample
+*/
+typedef struct {
+	size_t sections;
+	double *coeff;	/* b0,b1,b2,a1,a2 of each section (a0=1) */
+	double *state;	/* two delay values of each section (transposed direct form II) */
+} nsl_filter_iir;
+
+/* returns NULL if the form is not available in the time domain (ideal, Legendre) or the parameters are invalid */
+nsl_filter_iir* nsl_filter_iir_new(nsl_filter_type type, nsl_filter_form form, int order, double cutoff, double bandwidth);
+void nsl_filter_iir_free(nsl_filter_iir* filter);
+/* clear the state */
+void nsl_filter_iir_reset(nsl_filter_iir* filter);
+/* set the state to the steady state response to a constant input x0 (avoids the startup transient) */
+void nsl_filter_iir_init(nsl_filter_iir* filter, double x0);
+/* filter n samples, in and out may be the same array */
+void nsl_filter_iir_process(nsl_filter_iir* filter, const double in[], double out[], size_t n);
+/* filter data in place, starting from the steady state at data[0]
+	zerophase: filter forward and backward (no phase shift, squared magnitude response)
+*/
+int nsl_filter_iir_apply(double data[], size_t n, nsl_filter_type type, nsl_filter_form form, int order, double cutoff, double bandwidth, int zerophase);
+
 #endif /* NSL_FILTER_H */
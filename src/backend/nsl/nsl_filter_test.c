@@ -42,7 +42,7 @@ int main() {
         /*double data[]={1, 2, 3, 3, 1};*/
         const int N=1002;
         /*const int N=9;*/
-        double data[N];
+        double data[2*(N/2+1)];	/* room for the spectrum used by nsl_filter_apply() */
 
 	int i;
 	for(i=0;i<N;i++)
@@ -63,6 +63,10 @@ int main() {
 	for(i=0; i < N/2; i++)
 		printf("%d %g\n", i, data[2*i]);
 
+	/* the band of the ideal band reject is limited to the spectrum, a band width <= 0 is rejected */
+	printf("band reject beyond n/2: status %d\n", nsl_filter_apply(data, N, nsl_filter_type_band_reject, nsl_filter_form_ideal, 0, N/2-10, 100));
+	printf("band width 0: status %d\n", nsl_filter_apply(data, N, nsl_filter_type_band_pass, nsl_filter_form_butterworth, 2, 100, 0));
+
 	/*print_data(data, N);*/
 	/* all pass order,cut,bw */
 	/*nsl_filter_fourier(data, N, nsl_filter_type_high_pass, nsl_filter_form_ideal, 0, 0, 2); */
@@ -77,5 +81,27 @@ int main() {
 	/*nsl_filter_fourier(data, N, nsl_filter_type_band_pass, nsl_filter_form_butterworth, 2, 2, 2);*/
 	/*print_data(data, N);*/
 
+	/* time domain (IIR) filter */
+	nsl_filter_iir* filter = nsl_filter_iir_new(nsl_filter_type_low_pass, nsl_filter_form_butterworth, 4, 0.1, 0);
+	printf("Butterworth low pass (order 4): %zu sections\n", filter->sections);
+	for (i = 0; i < (int)filter->sections; i++)
+		printf("b = %g %g %g, a = 1 %g %g\n", filter->coeff[5*i], filter->coeff[5*i+1], filter->coeff[5*i+2],
+			filter->coeff[5*i+3], filter->coeff[5*i+4]);
+
+	/* step response, filtered in blocks of 100 samples */
+	for (i = 0; i < N; i++)
+		data[i] = (i < 10) ? 0.0 : 1.0;
+	for (i = 0; i < N; i += 100)
+		nsl_filter_iir_process(filter, data + i, data + i, (i + 100 > N) ? N - i : 100);
+	for (i = 0; i < 50; i++)
+		printf("%d %g\n", i, data[i]);
+	nsl_filter_iir_free(filter);
+
+	/* zero phase: a constant stays constant */
+	for (i = 0; i < N; i++)
+		data[i] = 1.0;
+	nsl_filter_iir_apply(data, N, nsl_filter_type_band_reject, nsl_filter_form_butterworth, 2, 0.2, 0.1, 1);
+	printf("zero phase band reject: %g %g %g\n", data[0], data[N/2], data[N-1]);
+
 	return 0;
 }
@@ -409,78 +409,106 @@ size_t nsl_geom_linesim_interp_auto(const double xdata[], const double ydata[],
 	return nsl_geom_linesim_interp(xdata, ydata, n, tol, index);
 }
 
+/* indexed binary min heap of points ordered by (area, point), pos[] is the heap position of a point */
+static int nsl_geom_linesim_heap_less(const double area[], size_t a, size_t b) {
+	return area[a] < area[b] || (area[a] == area[b] && a < b);
+}
+
+static void nsl_geom_linesim_heap_swap(size_t heap[], size_t pos[], size_t i, size_t j) {
+	size_t tmp = heap[i];
+	heap[i] = heap[j];
+	heap[j] = tmp;
+	pos[heap[i]] = i;
+	pos[heap[j]] = j;
+}
+
+static void nsl_geom_linesim_heap_down(const double area[], size_t heap[], size_t pos[], size_t size, size_t i) {
+	for (;;) {
+		size_t min = i, l = 2*i+1, r = 2*i+2;
+		if (l < size && nsl_geom_linesim_heap_less(area, heap[l], heap[min]))
+			min = l;
+		if (r < size && nsl_geom_linesim_heap_less(area, heap[r], heap[min]))
+			min = r;
+		if (min == i)
+			break;
+		nsl_geom_linesim_heap_swap(heap, pos, i, min);
+		i = min;
+	}
+}
+
+/* remove points of smallest effective area from a heap, neighbors are found in a doubly linked list
+	of the remaining points: O(n log n) */
 size_t nsl_geom_linesim_visvalingam_whyatt(const double xdata[], const double ydata[], const size_t n, const double tol, size_t index[]) {
 	size_t i, nout = n;
 
-	double *area = (double *) malloc((n-2)*sizeof(double));	/* area associated with every point */
 	for (i = 0; i < n; i++)
 		index[i] = i;
-	for (i = 1; i < n-1; i++)
-		area[i-1] = nsl_geom_three_point_area(xdata[i-1], ydata[i-1], xdata[i], ydata[i], xdata[i+1], ydata[i+1]);
-
-	double minarea;
-	size_t minindex;
-	while ( (minarea = nsl_stats_minimum(area, n-2, &minindex)) < tol && nout > 2) {
-		/*for (i=0; i < n-2; i++)
-			if (area[i]<DBL_MAX)
-				printf("area[%zu] = %g\n", i, area[i]);
-		*/
-		/* remove point minindex */
-		/*printf("removing point %zu (minindex = %zu, minarea = %g) nout=%zu\n", minindex+1, minindex, minarea, nout-1);*/
-		index[minindex+1] = 0;
-		area[minindex] = DBL_MAX;
+	if (n < 3)
+		return n;
+
+	double *area = (double *) malloc(n*sizeof(double));	/* area associated with every point */
+	size_t *heap = (size_t *) malloc(4*n*sizeof(size_t));
+	if (area == NULL || heap == NULL) {
+		free(area);
+		free(heap);
+		return n;
+	}
+	size_t *pos = heap + n, *prev = pos + n, *next = prev + n;
+	for (i = 0; i < n; i++) {
+		prev[i] = i-1;	/* prev[0] and next[n-1] are never used */
+		next[i] = i+1;
+	}
+
+	size_t size = n-2;
+	for (i = 1; i < n-1; i++) {
+		area[i] = nsl_geom_three_point_area(xdata[i-1], ydata[i-1], xdata[i], ydata[i], xdata[i+1], ydata[i+1]);
+		heap[i-1] = i;
+		pos[i] = i-1;
+	}
+	for (i = size/2; i-- > 0; )
+		nsl_geom_linesim_heap_down(area, heap, pos, size, i);
+
+	while (size > 0 && area[heap[0]] < tol) {
+		/* remove point with minimal area */
+		const size_t point = heap[0];
+		nsl_geom_linesim_heap_swap(heap, pos, 0, --size);
+		nsl_geom_linesim_heap_down(area, heap, pos, size, 0);
+		index[point] = 0;
+
+		const size_t before = prev[point], after = next[point];
+		next[before] = after;
+		prev[after] = before;
+
+		/* update area of neighbor points (take largest value of new and old area) */
 		double tmparea;
-		/* update area of neigbor points */
-		size_t before = minindex, after = minindex+2;	/* find index before and after */
-		while (index[before] == 0 && before > 0)
-			before--;
-		while (index[after] == 0 && after < n-1)
-			after++;
-		if (minindex > 0) {	/*before */
-			if (before > 0) {
-				size_t beforebefore=before-1;
-				while (index[beforebefore] == 0 && beforebefore > 0)
-					beforebefore--;
-				/*printf("recalculate area[%zu] from %zu %zu %zu\n", before-1, beforebefore, before, after);*/
-				tmparea = nsl_geom_three_point_area(xdata[beforebefore], ydata[beforebefore], xdata[before], ydata[before], xdata[after], ydata[after]);
-				if (tmparea > area[before-1])	/* take largest value of new and old area */
-					area[before-1] = tmparea;
+		if (before > 0) {
+			tmparea = nsl_geom_three_point_area(xdata[prev[before]], ydata[prev[before]], xdata[before], ydata[before], xdata[after], ydata[after]);
+			if (tmparea > area[before]) {
+				area[before] = tmparea;
+				nsl_geom_linesim_heap_down(area, heap, pos, size, pos[before]);
 			}
 		}
-		if (minindex < n-3) {	/* after */
-			if (after < n-1) {
-				size_t afterafter = after+1;
-				while (index[afterafter] == 0 && afterafter < n-1)
-					afterafter++;
-				/*printf("recalculate area[%zu] from %zu %zu %zu\n",after-1, before, after, afterafter);*/
-				tmparea = nsl_geom_three_point_area(xdata[before], ydata[before], xdata[after], ydata[after], xdata[afterafter], ydata[afterafter]);
-				if (tmparea > area[after-1])	/* take largest value of new and old area */
-					area[after-1] = tmparea;
+		if (after < n-1) {
+			tmparea = nsl_geom_three_point_area(xdata[before], ydata[before], xdata[after], ydata[after], xdata[next[after]], ydata[next[after]]);
+			if (tmparea > area[after]) {
+				area[after] = tmparea;
+				nsl_geom_linesim_heap_down(area, heap, pos, size, pos[after]);
 			}
 		}
 		nout--;
 	};
 
-	/*for(i=0;i<n;i++)
-		printf("INDEX = %d\n", index[i]);
-	*/
-
 	/* condens index */
-	i = 1;
-	size_t newi = 1;
-	while (newi < n-1) {
-		while (index[newi] == 0)
-			newi++;
-		index[i++] = index[newi++];
-	};
-
-	/*for(i=0;i<nout;i++)
-		printf("INDEX2 = %d\n", index[i]);
-	*/
+	nout = 0;
+	for (i = 0; i < n-1; i = next[i])
+		index[nout++] = i;
+	index[nout++] = n-1;
 
+	free(heap);
 	free(area);
 	return nout;
 }
+
 size_t nsl_geom_linesim_visvalingam_whyatt_auto(const double xdata[], const double ydata[], const size_t n, size_t index[]) {
 	double tol = nsl_geom_linesim_clip_area_perpoint(xdata, ydata, n);
 
@@ -27,11 +27,20 @@
  ***************************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/time.h>
 #include "nsl_geom_linesim.h"
 
 #define FILENAME "morse_code.dat"
 #define N 152000
 #define NOUT 15200
+/* largest size of the synthetic benchmark */
+#define NBENCH 1000000
+
+static unsigned long long run_time(struct timeval time1, struct timeval time2) {
+	return 1000 * (time2.tv_sec - time1.tv_sec) + (time2.tv_usec - time1.tv_usec) / 1000;
+}
 
 int main() {
 	double *xdata, *ydata;
@@ -58,8 +67,41 @@ int main() {
 	gettimeofday(&time1, NULL);
 	double tolout = nsl_geom_linesim_douglas_peucker_variant(xdata, ydata, N, NOUT, index);
 	gettimeofday(&time2, NULL);
-	printf("run time : %llu ms\n", 1000 * (time2.tv_sec - time1.tv_sec) + (time2.tv_usec - time1.tv_usec) / 1000);
+	printf("run time : %llu ms\n", run_time(time1, time2));
 
 	printf("maxtol = %g (pos. error = %g, area error = %g)\n", tolout, nsl_geom_linesim_positional_squared_error(xdata, ydata, N, index), nsl_geom_linesim_area_error(xdata, ydata, N, index));
 
+	printf("* simplification (Visvalingam-Whyatt, automatic tolerance)\n");
+	gettimeofday(&time1, NULL);
+	size_t nout = nsl_geom_linesim_visvalingam_whyatt_auto(xdata, ydata, N, index);
+	gettimeofday(&time2, NULL);
+	printf("run time : %llu ms\n", run_time(time1, time2));
+	printf("nout = %zu (pos. error = %g, area error = %g)\n", nout, nsl_geom_linesim_positional_squared_error(xdata, ydata, N, index), nsl_geom_linesim_area_error(xdata, ydata, N, index));
+
+	free(xdata);
+	free(ydata);
+	fclose(file);
+
+	/* scaling of Visvalingam-Whyatt with the number of points (noisy sine) */
+	printf("* Visvalingam-Whyatt benchmark\n");
+	xdata = (double *)malloc(NBENCH*sizeof(double));
+	ydata = (double *)malloc(NBENCH*sizeof(double));
+	size_t *bindex = (size_t *)malloc(NBENCH*sizeof(size_t));
+	size_t n;
+	for (n = 10000; n <= NBENCH; n *= 10) {
+		for (i = 0; i < n; i++) {
+			xdata[i] = i;
+			ydata[i] = sin(i/100.) + 0.1*rand()/RAND_MAX;
+		}
+		gettimeofday(&time1, NULL);
+		nout = nsl_geom_linesim_visvalingam_whyatt_auto(xdata, ydata, n, bindex);
+		gettimeofday(&time2, NULL);
+		printf("n = %zu: nout = %zu, run time : %llu ms\n", n, nout, run_time(time1, time2));
+	}
+
+	free(bindex);
+	free(xdata);
+	free(ydata);
+
+	return 0;
 }
@@ -0,0 +1,266 @@
+/***************************************************************************
+    File                 : nsl_rolling.c
+    Project              : LabPlot
+    Description          : NSL order statistics of a sliding window
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "nsl_rolling.h"
+#include "nsl_common.h"
+#include <math.h>
+
+/* nodes of the treap are stored in an array, children are indices (-1: none) */
+typedef struct {
+	double value;
+	unsigned int priority;
+	int left, right;
+	size_t size;	/* number of nodes in the subtree */
+} nsl_rolling_node;
+
+struct nsl_rolling {
+	nsl_rolling_node *nodes;
+	int *free_nodes;	/* stack of unused nodes */
+	size_t nfree;
+	size_t size;
+	int root;
+	unsigned int seed;
+};
+
+#define NSL_ROLLING_SIZE(w, i) ((i) < 0 ? 0 : (w)->nodes[i].size)
+
+static void nsl_rolling_update(nsl_rolling *w, int i) {
+	w->nodes[i].size = 1 + NSL_ROLLING_SIZE(w, w->nodes[i].left) + NSL_ROLLING_SIZE(w, w->nodes[i].right);
+}
+
+/* xorshift random numbers for the priorities */
+static unsigned int nsl_rolling_random(nsl_rolling *w) {
+	w->seed ^= w->seed << 13;
+	w->seed ^= w->seed >> 17;
+	w->seed ^= w->seed << 5;
+	return w->seed;
+}
+
+/* merge two treaps, all values of a are smaller or equal than the values of b */
+static int nsl_rolling_merge(nsl_rolling *w, int a, int b) {
+	if (a < 0)
+		return b;
+	if (b < 0)
+		return a;
+
+	if (w->nodes[a].priority > w->nodes[b].priority) {
+		w->nodes[a].right = nsl_rolling_merge(w, w->nodes[a].right, b);
+		nsl_rolling_update(w, a);
+		return a;
+	}
+	w->nodes[b].left = nsl_rolling_merge(w, a, w->nodes[b].left);
+	nsl_rolling_update(w, b);
+	return b;
+}
+
+/* split treap t into the values smaller than value (l) and the others (r) */
+static void nsl_rolling_split(nsl_rolling *w, int t, double value, int *l, int *r) {
+	if (t < 0) {
+		*l = *r = -1;
+		return;
+	}
+
+	if (w->nodes[t].value < value) {
+		nsl_rolling_split(w, w->nodes[t].right, value, &w->nodes[t].right, r);
+		*l = t;
+	} else {
+		nsl_rolling_split(w, w->nodes[t].left, value, l, &w->nodes[t].left);
+		*r = t;
+	}
+	nsl_rolling_update(w, t);
+}
+
+/* insert node i into the treap t, returns the new root */
+static int nsl_rolling_insert_node(nsl_rolling *w, int t, int i) {
+	if (t < 0)
+		return i;
+
+	if (w->nodes[i].priority > w->nodes[t].priority) {
+		nsl_rolling_split(w, t, w->nodes[i].value, &w->nodes[i].left, &w->nodes[i].right);
+		nsl_rolling_update(w, i);
+		return i;
+	}
+
+	if (w->nodes[i].value < w->nodes[t].value)
+		w->nodes[t].left = nsl_rolling_insert_node(w, w->nodes[t].left, i);
+	else
+		w->nodes[t].right = nsl_rolling_insert_node(w, w->nodes[t].right, i);
+	nsl_rolling_update(w, t);
+	return t;
+}
+
+/* remove one node with the given value from treap t, returns the new root. *removed is set to the removed node */
+static int nsl_rolling_remove_node(nsl_rolling *w, int t, double value, int *removed) {
+	if (t < 0)
+		return -1;
+
+	if (w->nodes[t].value == value) {
+		*removed = t;
+		return nsl_rolling_merge(w, w->nodes[t].left, w->nodes[t].right);
+	}
+
+	if (value < w->nodes[t].value)
+		w->nodes[t].left = nsl_rolling_remove_node(w, w->nodes[t].left, value, removed);
+	else
+		w->nodes[t].right = nsl_rolling_remove_node(w, w->nodes[t].right, value, removed);
+	nsl_rolling_update(w, t);
+	return t;
+}
+
+nsl_rolling* nsl_rolling_alloc(size_t size) {
+	nsl_rolling *w = (nsl_rolling *)malloc(sizeof(nsl_rolling));
+	if (w == NULL)
+		return NULL;
+	w->nodes = (nsl_rolling_node *)malloc(size*sizeof(nsl_rolling_node));
+	w->free_nodes = (int *)malloc(size*sizeof(int));
+	if ((w->nodes == NULL || w->free_nodes == NULL) && size > 0) {
+		nsl_rolling_free(w);
+		return NULL;
+	}
+	w->size = size;
+	w->seed = 2463534242u;
+	nsl_rolling_reset(w);
+
+	return w;
+}
+
+void nsl_rolling_free(nsl_rolling *w) {
+	if (w == NULL)
+		return;
+	free(w->nodes);
+	free(w->free_nodes);
+	free(w);
+}
+
+void nsl_rolling_reset(nsl_rolling *w) {
+	size_t i;
+	for (i = 0; i < w->size; i++)
+		w->free_nodes[i] = (int)(w->size-1-i);
+	w->nfree = w->size;
+	w->root = -1;
+}
+
+size_t nsl_rolling_count(const nsl_rolling *w) {
+	return NSL_ROLLING_SIZE(w, w->root);
+}
+
+int nsl_rolling_insert(nsl_rolling *w, double value) {
+	if (w->nfree == 0)
+		return -1;
+
+	int i = w->free_nodes[--w->nfree];
+	w->nodes[i].value = value;
+	w->nodes[i].priority = nsl_rolling_random(w);
+	w->nodes[i].left = w->nodes[i].right = -1;
+	w->nodes[i].size = 1;
+	w->root = nsl_rolling_insert_node(w, w->root, i);
+
+	return 0;
+}
+
+int nsl_rolling_remove(nsl_rolling *w, double value) {
+	int removed = -1;
+	w->root = nsl_rolling_remove_node(w, w->root, value, &removed);
+	if (removed < 0)
+		return -1;
+
+	w->free_nodes[w->nfree++] = removed;
+	return 0;
+}
+
+double nsl_rolling_select(const nsl_rolling *w, size_t k) {
+	int t = w->root;
+	while (t >= 0) {
+		size_t left = NSL_ROLLING_SIZE(w, w->nodes[t].left);
+		if (k < left)
+			t = w->nodes[t].left;
+		else if (k == left)
+			return w->nodes[t].value;
+		else {
+			k -= left+1;
+			t = w->nodes[t].right;
+		}
+	}
+
+	return NAN;
+}
+
+double nsl_rolling_quantile(const nsl_rolling *w, double p, nsl_stats_quantile_type type) {
+	const size_t n = nsl_rolling_count(w);
+	if (n == 0)
+		return NAN;
+
+	size_t i;
+	double frac;
+	nsl_stats_quantile_position(n, p, type, &i, &frac);
+
+	const double value = nsl_rolling_select(w, i);
+	if (frac == 0.0)
+		return value;
+	return value+frac*(nsl_rolling_select(w, i+1)-value);
+}
+
+int nsl_rolling_quantile_array(const double data[], size_t n, size_t points, double p, nsl_stats_quantile_type type, double result[]) {
+	size_t i;
+
+	if (points == 0) {
+		printf("The number of points must be greater than zero.");
+		return -1;
+	}
+	if (n == 0)
+		return 0;
+
+	nsl_rolling *w = nsl_rolling_alloc(points);
+	if (w == NULL)
+		return -1;
+
+	/* the values leaving the window are needed after result may have overwritten data */
+	double *window = (double *)malloc(points*sizeof(double));
+	if (window == NULL) {
+		nsl_rolling_free(w);
+		return -1;
+	}
+
+	for (i = 0; i < n; i++) {
+		const double value = data[i];
+		if (i >= points && !isnan(window[i%points]))
+			nsl_rolling_remove(w, window[i%points]);
+		window[i%points] = value;
+		if (!isnan(value))
+			nsl_rolling_insert(w, value);
+		result[i] = nsl_rolling_quantile(w, p, type);
+	}
+
+	free(window);
+	nsl_rolling_free(w);
+	return 0;
+}
+
+int nsl_rolling_median(const double data[], size_t n, size_t points, nsl_stats_quantile_type type, double result[]) {
+	return nsl_rolling_quantile_array(data, n, points, 0.5, type, result);
+}
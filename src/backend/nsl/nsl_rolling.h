@@ -0,0 +1,63 @@
+/***************************************************************************
+    File                 : nsl_rolling.h
+    Project              : LabPlot
+    Description          : NSL order statistics of a sliding window
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef NSL_ROLLING_H
+#define NSL_ROLLING_H
+
+#include <stdlib.h>
+#include "nsl_stats.h"
+
+/* multiset of up to size values supporting insert, remove and selection of the k-th smallest value
+	in O(log size) (order statistic tree, implemented as a treap) */
+typedef struct nsl_rolling nsl_rolling;
+
+/* allocate window for at most size values */
+nsl_rolling* nsl_rolling_alloc(size_t size);
+void nsl_rolling_free(nsl_rolling *w);
+/* remove all values */
+void nsl_rolling_reset(nsl_rolling *w);
+/* number of values in the window */
+size_t nsl_rolling_count(const nsl_rolling *w);
+
+/* insert value, returns -1 if the window is full */
+int nsl_rolling_insert(nsl_rolling *w, double value);
+/* remove one occurrence of value, returns -1 if the value is not in the window */
+int nsl_rolling_remove(nsl_rolling *w, double value);
+
+/* k-th smallest value (k = 0 .. count-1) */
+double nsl_rolling_select(const nsl_rolling *w, size_t k);
+/* quantile of the values in the window (see nsl_stats_quantile()) */
+double nsl_rolling_quantile(const nsl_rolling *w, double p, nsl_stats_quantile_type type);
+
+/* rolling quantile of data: result[i] is the quantile of the last (up to) points values data[i-points+1] .. data[i].
+	NaN values are ignored. result may be data. */
+int nsl_rolling_quantile_array(const double data[], size_t n, size_t points, double p, nsl_stats_quantile_type type, double result[]);
+/* rolling median (see nsl_rolling_quantile_array()) */
+int nsl_rolling_median(const double data[], size_t n, size_t points, nsl_stats_quantile_type type, double result[]);
+
+#endif /* NSL_ROLLING_H */
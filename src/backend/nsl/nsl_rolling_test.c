@@ -0,0 +1,82 @@
+/***************************************************************************
+    File                 : nsl_rolling_test.c
+    Project              : LabPlot
+    Description          : NSL order statistics of a sliding window
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "nsl_rolling.h"
+#include "nsl_stats.h"
+
+#define N 1000000
+
+int main() {
+	const double data[]={2,2,5,2,1,0,1,4,9};
+	double result[9], window[5];
+	size_t i, j, k;
+	int type;
+
+	printf("rolling median (5 points):\n");
+	nsl_rolling_median(data, 9, 5, nsl_stats_quantile_type7, result);
+	for(i=0;i<9;i++)
+		printf(" %g",result[i]);
+	puts("");
+
+	/* compare with sorting every window */
+	printf("rolling quantiles equal to sorted windows:");
+	for(type=1;type<=9;type++) {
+		int equal = 1;
+		for(k=0;k<=10;k++) {
+			const double p = k/10.;
+			nsl_rolling_quantile_array(data, 9, 5, p, type, result);
+			for(i=0;i<9;i++) {
+				const size_t first = (i < 4) ? 0 : i-4;
+				for(j=first;j<=i;j++)
+					window[j-first] = data[j];
+				if (fabs(nsl_stats_quantile(window, 1, i-first+1, p, type)-result[i]) > 1.e-12)
+					equal = 0;
+			}
+		}
+		printf(" %d:%s", type, equal ? "yes" : "NO");
+	}
+	puts("");
+
+	/* performance */
+	double *x = (double *)malloc(N*sizeof(double));
+	double *y = (double *)malloc(N*sizeof(double));
+	for(i=0;i<N;i++)
+		x[i] = sin(i/1000.)+(double)((i*7919)%1000)/1000.;
+
+	clock_t start = clock();
+	nsl_rolling_median(x, N, 1001, nsl_stats_quantile_type7, y);
+	printf("rolling median of %d values (1001 points): %g s\n", N, (double)(clock()-start)/CLOCKS_PER_SEC);
+
+	free(x);
+	free(y);
+
+	return 0;
+}
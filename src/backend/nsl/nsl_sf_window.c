@@ -30,76 +30,173 @@
 #include "nsl_common.h"
 #include <gsl/gsl_math.h>
 #include <gsl/gsl_sf_trig.h>
+#include <string.h>
 
 const char* nsl_sf_window_type_name[] = {i18n("rectangular (uniform)"), i18n("triangular"), i18n("triangular II (Bartlett)"), i18n("triangular III (Parzen)") ,
 	i18n("Welch (parabolic)"), i18n("Hann (raised cosine)"), i18n("Hamming"), i18n("Blackman"), i18n("Nuttall"), i18n("Blackman-Nuttall"), i18n("Blackman-Harris"),
 	i18n("Flat top"), i18n("Cosine"), i18n("Bartlett-Hann"), i18n("Lanczos")};
 
-int nsl_sf_apply_window(double data[], size_t N, nsl_sf_window_type type) {
-	if (N == 0)
-		return -1;
+double nsl_sf_window(size_t i, size_t N, nsl_sf_window_type type) {
+	if (N < 2)
+		return 1.0;
 
-	size_t i;
 	switch (type) {
 	case nsl_sf_window_uniform:
-		/* do nothing */
-		break;
+		return 1.0;
 	case nsl_sf_window_triangle:
-		for (i = 0; i < N; i++)
-			data[i] = 1.0 - 2./N*fabs(i-(N-1)/2.);
-		break;
+		return 1.0 - 2./N*fabs(i-(N-1)/2.);
 	case nsl_sf_window_triangleII:
-		for (i = 0; i < N; i++)
-			data[i] = 1.0 - 2./(N-1)*fabs(i-(N-1)/2.);
-		break;
+		return 1.0 - 2./(N-1)*fabs(i-(N-1)/2.);
 	case nsl_sf_window_triangleIII:
-		for (i = 0; i < N; i++)
-			data[i] = 1.0 - 2./(N+1)*fabs(i-(N-1)/2.);
-		break;
+		return 1.0 - 2./(N+1)*fabs(i-(N-1)/2.);
 	case nsl_sf_window_welch:
-		for (i = 0; i < N; i++)
-			data[i] = 1.0 - gsl_pow_2(2*(i-(N-1)/2.)/(N+1));
-		break;
+		return 1.0 - gsl_pow_2(2*(i-(N-1)/2.)/(N+1));
 	case nsl_sf_window_hann:
-		for (i = 0; i < N; i++)
-			data[i] = 0.5*(1. - cos(2.*M_PI*i/(N-1)));
-		break;
+		return 0.5*(1. - cos(2.*M_PI*i/(N-1)));
 	case nsl_sf_window_hamming:
-		for (i = 0; i < N; i++)
-			data[i] = 0.54 - 0.46*cos(2.*M_PI*i/(N-1));
-		break;
+		return 0.54 - 0.46*cos(2.*M_PI*i/(N-1));
 	case nsl_sf_window_blackman:
-		for (i = 0; i < N; i++)
-			data[i] = 0.42 - 0.5*cos(2.*M_PI*i/(N-1)) + 0.08*cos(4.*M_PI*i/(N-1));
-		break;
+		return 0.42 - 0.5*cos(2.*M_PI*i/(N-1)) + 0.08*cos(4.*M_PI*i/(N-1));
 	case nsl_sf_window_nuttall:
-		for (i = 0; i < N; i++)
-			data[i] = 0.355768 - 0.487396*cos(2.*M_PI*i/(N-1)) + 0.144232*cos(4.*M_PI*i/(N-1)) - 0.012604*cos(6.*M_PI*i/(N-1));
-		break;
+		return 0.355768 - 0.487396*cos(2.*M_PI*i/(N-1)) + 0.144232*cos(4.*M_PI*i/(N-1)) - 0.012604*cos(6.*M_PI*i/(N-1));
 	case nsl_sf_window_blackman_nuttall:
-		for (i = 0; i < N; i++)
-			data[i] = 0.3635819 - 0.4891775*cos(2.*M_PI*i/(N-1)) + 0.1365995*cos(4.*M_PI*i/(N-1)) - 0.0106411*cos(6.*M_PI*i/(N-1));
-		break;
+		return 0.3635819 - 0.4891775*cos(2.*M_PI*i/(N-1)) + 0.1365995*cos(4.*M_PI*i/(N-1)) - 0.0106411*cos(6.*M_PI*i/(N-1));
 	case nsl_sf_window_blackman_harris:
-		for (i = 0; i < N; i++)
-			data[i] = 0.35875 - 0.48829*cos(2.*M_PI*i/(N-1)) + 0.14128*cos(4.*M_PI*i/(N-1)) - 0.01168*cos(6.*M_PI*i/(N-1));
-		break;
+		return 0.35875 - 0.48829*cos(2.*M_PI*i/(N-1)) + 0.14128*cos(4.*M_PI*i/(N-1)) - 0.01168*cos(6.*M_PI*i/(N-1));
 	case nsl_sf_window_flat_top:
-		for (i = 0; i < N; i++)
-			data[i] = 1 - 1.93*cos(2.*M_PI*i/(N-1)) + 1.29*cos(4.*M_PI*i/(N-1)) - 0.388*cos(6.*M_PI*i/(N-1)) + 0.028*cos(8.*M_PI*i/(N-1));
-		break;
+		return 1 - 1.93*cos(2.*M_PI*i/(N-1)) + 1.29*cos(4.*M_PI*i/(N-1)) - 0.388*cos(6.*M_PI*i/(N-1)) + 0.028*cos(8.*M_PI*i/(N-1));
 	case nsl_sf_window_cosine:
-		for (i = 0; i < N; i++)
-			data[i] = sin(M_PI*i/(N-1));  
-		break;
+		return sin(M_PI*i/(N-1));
 	case nsl_sf_window_bartlett_hann:
-		for (i = 0; i < N; i++)
-			data[i] = 0.62 - 0.48*fabs(i/(double)(N-1)-0.5) - 0.38*cos(2.*M_PI*i/(N-1));  
-		break;
+		return 0.62 - 0.48*fabs(i/(double)(N-1)-0.5) - 0.38*cos(2.*M_PI*i/(N-1));
 	case nsl_sf_window_lanczos:
+		return gsl_sf_sinc(2.*i/(N-1)-1.);
+	}
+
+	return 1.0;
+}
+
+/* cache of the coefficients of the last used (type, N) pairs.
+	Windows in use are never replaced (refcount > 0) */
+#define NSL_SF_WINDOW_CACHE_SIZE 8
+/* larger windows are not cached but calculated when applied */
+#define NSL_SF_WINDOW_CACHE_MAX_POINTS 65536
+static struct {
+	nsl_sf_window_type type;
+	size_t N;
+	double *w;
+	unsigned int refcount;
+	unsigned long last;	/* time of last use */
+} nsl_sf_window_cache[NSL_SF_WINDOW_CACHE_SIZE];
+static unsigned long nsl_sf_window_cache_clock = 0;
+static nsl_mutex nsl_sf_window_mutex = NSL_MUTEX_INITIALIZER;
+
+/* cached coefficients of the window (type, N), NULL if the window is too large or on error.
+	Release with nsl_sf_window_release() */
+static const double* nsl_sf_window_get(size_t N, nsl_sf_window_type type) {
+	size_t i;
+	if (N > NSL_SF_WINDOW_CACHE_MAX_POINTS)
+		return NULL;
+
+	nsl_mutex_lock(&nsl_sf_window_mutex);
+	for (i = 0; i < NSL_SF_WINDOW_CACHE_SIZE; i++)
+		if (nsl_sf_window_cache[i].w != NULL && nsl_sf_window_cache[i].N == N && nsl_sf_window_cache[i].type == type) {
+			nsl_sf_window_cache[i].refcount++;
+			nsl_sf_window_cache[i].last = ++nsl_sf_window_cache_clock;
+			nsl_mutex_unlock(&nsl_sf_window_mutex);
+			return nsl_sf_window_cache[i].w;
+		}
+	nsl_mutex_unlock(&nsl_sf_window_mutex);
+
+	/* calculated without holding the lock */
+	double *w = (double *)malloc(N*sizeof(double));
+	if (w == NULL)
+		return NULL;
+	for (i = 0; i < N; i++)
+		w[i] = nsl_sf_window(i, N, type);
+
+	/* least recently used unused or empty slot. If all windows are in use, w is not cached */
+	nsl_mutex_lock(&nsl_sf_window_mutex);
+	int slot = -1;
+	for (i = 0; i < NSL_SF_WINDOW_CACHE_SIZE; i++)
+		if (nsl_sf_window_cache[i].refcount == 0 && (slot == -1 || nsl_sf_window_cache[i].w == NULL
+				|| (nsl_sf_window_cache[slot].w != NULL && nsl_sf_window_cache[i].last < nsl_sf_window_cache[slot].last)))
+			slot = (int)i;
+	if (slot != -1) {
+		free(nsl_sf_window_cache[slot].w);
+		nsl_sf_window_cache[slot].type = type;
+		nsl_sf_window_cache[slot].N = N;
+		nsl_sf_window_cache[slot].w = w;
+		nsl_sf_window_cache[slot].refcount = 1;
+		nsl_sf_window_cache[slot].last = ++nsl_sf_window_cache_clock;
+	}
+	nsl_mutex_unlock(&nsl_sf_window_mutex);
+
+	return w;
+}
+
+static void nsl_sf_window_release(const double *w) {
+	size_t i;
+	nsl_mutex_lock(&nsl_sf_window_mutex);
+	for (i = 0; i < NSL_SF_WINDOW_CACHE_SIZE; i++)
+		if (nsl_sf_window_cache[i].w == w) {
+			nsl_sf_window_cache[i].refcount--;
+			nsl_mutex_unlock(&nsl_sf_window_mutex);
+			return;
+		}
+	nsl_mutex_unlock(&nsl_sf_window_mutex);
+	free((double *)w);
+}
+
+void nsl_sf_window_cache_clear(void) {
+	size_t i;
+	nsl_mutex_lock(&nsl_sf_window_mutex);
+	for (i = 0; i < NSL_SF_WINDOW_CACHE_SIZE; i++)
+		if (nsl_sf_window_cache[i].refcount == 0 && nsl_sf_window_cache[i].w != NULL) {
+			free(nsl_sf_window_cache[i].w);
+			nsl_sf_window_cache[i].w = NULL;
+		}
+	nsl_mutex_unlock(&nsl_sf_window_mutex);
+}
+
+int nsl_sf_window_coefficients(double w[], size_t N, nsl_sf_window_type type) {
+	if (N == 0)
+		return -1;
+
+	size_t i;
+	if (type == nsl_sf_window_uniform) {
+		for (i = 0; i < N; i++)
+			w[i] = 1.0;
+		return 0;
+	}
+
+	const double *cached = nsl_sf_window_get(N, type);
+	if (cached != NULL) {
+		memcpy(w, cached, N*sizeof(double));
+		nsl_sf_window_release(cached);
+	} else {
+		for (i = 0; i < N; i++)
+			w[i] = nsl_sf_window(i, N, type);
+	}
+
+	return 0;
+}
+
+int nsl_sf_apply_window(double data[], size_t N, nsl_sf_window_type type) {
+	if (N == 0)
+		return -1;
+	if (type == nsl_sf_window_uniform)
+		return 0;
+
+	size_t i;
+	const double *w = nsl_sf_window_get(N, type);
+	if (w != NULL) {
+		for (i = 0; i < N; i++)
+			data[i] *= w[i];
+		nsl_sf_window_release(w);
+	} else {
 		for (i = 0; i < N; i++)
-			data[i] = gsl_sf_sinc(2.*i/(N-1)-1.);
-		break;
+			data[i] *= nsl_sf_window(i, N, type);
 	}
 
 	return 0;
@@ -38,9 +38,13 @@ typedef enum {nsl_sf_window_uniform, nsl_sf_window_triangle, nsl_sf_window_trian
 	nsl_sf_window_bartlett_hann, nsl_sf_window_lanczos} nsl_sf_window_type;
 extern const char* nsl_sf_window_type_name[];
 
-/* u range: [0:1] or [0:N-1] ? */
-
-/* uniform */
+/* value of the window of size N at index i = 0 .. N-1 */
+double nsl_sf_window(size_t i, size_t N, nsl_sf_window_type type);
+/* window coefficients of size N. Windows up to 65536 points are cached per (type, N), the cache is thread-safe */
+int nsl_sf_window_coefficients(double w[], size_t N, nsl_sf_window_type type);
+/* multiply data of size N with the window */
 int nsl_sf_apply_window(double data[], size_t N, nsl_sf_window_type type);
+/* free all unused cached windows */
+void nsl_sf_window_cache_clear(void);
 
 #endif /* NSL_SF_WINDOW_H */
@@ -27,6 +27,7 @@
  ***************************************************************************/
 
 #include <stdio.h>
+#include <math.h>
 #include "nsl_sf_window.h"
 
 int main() {
@@ -79,4 +80,23 @@ int main() {
 		printf("%g ", nsl_sf_window(i,N, nsl_sf_window_lanczos));
 	puts("\n");
 
+	/* cached (small) and uncached (large) windows */
+	const size_t sizes[] = {N, 100000};
+	size_t j, k;
+	for (j = 0; j < 2; j++) {
+		double *w = (double *)malloc(sizes[j]*sizeof(double)), *data = (double *)malloc(sizes[j]*sizeof(double));
+		double err = 0;
+		for (k = 0; k < 2; k++) {	/* second run uses the cache */
+			nsl_sf_window_coefficients(w, sizes[j], nsl_sf_window_hann);
+			for (i = 0; i < (int)sizes[j]; i++)
+				data[i] = 2.;
+			nsl_sf_apply_window(data, sizes[j], nsl_sf_window_hann);
+			for (i = 0; i < (int)sizes[j]; i++)
+				err = fmax(err, fabs(w[i] - nsl_sf_window(i, sizes[j], nsl_sf_window_hann)) + fabs(data[i] - 2.*w[i]));
+		}
+		printf("Hann window N = %zu: max. error = %g\n", sizes[j], err);
+		free(w);
+		free(data);
+	}
+	nsl_sf_window_cache_clear();
 }
@@ -30,329 +30,341 @@
 #include "nsl_common.h"
 #include "nsl_sf_kernel.h"
 #include "nsl_stats.h"
+#include "nsl_rolling.h"
+#include "nsl_conv.h"
 #include <gsl/gsl_math.h>
 #include <gsl/gsl_linalg.h>
 #include <gsl/gsl_blas.h>
-#include <gsl/gsl_sf_gamma.h>   /* gsl_sf_choose */
+#include <gsl/gsl_sf_gamma.h>   /* gsl_sf_lnchoose */
+#include <string.h>
 
-const char* nsl_smooth_type_name[] = { i18n("moving average (central)"), i18n("moving average (lagged)"), i18n("percentile"), i18n("Savitzky-Golay") };
+const char* nsl_smooth_type_name[] = { i18n("moving average (central)"), i18n("moving average (lagged)"), i18n("percentile"), i18n("Savitzky-Golay"), i18n("LOWESS") };
 const char* nsl_smooth_pad_mode_name[] = { i18n("none"), i18n("interpolating"), i18n("mirror"), i18n("nearest"), i18n("constant"), i18n("periodic") };
 const char* nsl_smooth_weight_type_name[] = { i18n("uniform (rectangular)"), i18n("triangular"), i18n("binomial"), i18n("parabolic (Epanechnikov)"),
 		i18n("quartic (biweight)"), i18n("triweight"), i18n("tricube"), i18n("cosine")  };
 double nsl_smooth_pad_constant_lvalue = 0.0, nsl_smooth_pad_constant_rvalue = 0.0;
 
-int nsl_smooth_moving_average(double *data, unsigned int n, unsigned int points, nsl_smooth_weight_type weight, nsl_smooth_pad_mode mode) {
-	unsigned int i,j;
-	double *result = (double *)malloc(n*sizeof(double));
-	for (i=0; i<n; i++)
-		result[i]=0;
-
-	for(i=0;i<n;i++) {
-		unsigned int np=points;
-		unsigned int half=(points-1)/2;
-		if(mode == nsl_smooth_pad_none) { /* reduce points */
-			half = GSL_MIN(GSL_MIN((points-1)/2,i),n-i-1);
-			np = 2*half+1;
-		}
+/* weights of the moving average of np points, central (lagged = 0) or lagged */
+static void nsl_smooth_weights(double *w, unsigned int np, nsl_smooth_weight_type weight, int lagged) {
+	unsigned int j;
+	double sum=0.0;
 
-		/* weight */
-		double sum=0.0, *w = (double *)malloc(np*sizeof(double));
-		switch(weight) {
-		case nsl_smooth_weight_uniform:
+	switch(weight) {
+	case nsl_smooth_weight_uniform:
+		for(j=0;j<np;j++)
+			w[j]=1./np;
+		return;
+	case nsl_smooth_weight_triangular:
+		if(lagged) {
+			sum = np*(np+1)/2;
 			for(j=0;j<np;j++)
-				w[j]=1./np;
-			break;
-		case nsl_smooth_weight_triangular:
+				w[j]=(j+1)/sum;
+		} else {
 			sum = gsl_pow_2((np+1)/2);
 			for(j=0;j<np;j++)
 				w[j]=GSL_MIN(j+1,np-j)/sum;
-			break;
-		case nsl_smooth_weight_binomial:
-			sum = (np-1)/2.;
-			for(j=0;j<np;j++)
-				w[j]=gsl_sf_choose(2*sum,sum+fabs(j-sum))/pow(4.,sum);
-			break;
-		case nsl_smooth_weight_parabolic:
-			for(j=0;j<np;j++) {
-				w[j]=nsl_sf_kernel_parabolic(2.*(j-(np-1)/2.)/(np+1));
-				sum += w[j];
-			}
-			for(j=0;j<np;j++)
-				w[j] /= sum;
-			break;
-		case nsl_smooth_weight_quartic:
-			for(j=0;j<np;j++) {
-				w[j]=nsl_sf_kernel_quartic(2.*(j-(np-1)/2.)/(np+1));
-				sum += w[j];
-			}
-			for(j=0;j<np;j++)
-				w[j] /= sum;
-			break;
-		case nsl_smooth_weight_triweight:
-			for(j=0;j<np;j++) {
-				w[j]=nsl_sf_kernel_triweight(2.*(j-(np-1)/2.)/(np+1));
-				sum += w[j];
-			}
+		}
+		return;
+	case nsl_smooth_weight_binomial:
+		/* logarithms avoid the overflow of the binomial coefficients for large windows */
+		if(lagged) {
 			for(j=0;j<np;j++)
-				w[j] /= sum;
+				w[j]=exp(gsl_sf_lnchoose(2*(np-1),j)-gsl_sf_lnchoose(2*(np-1),np-1));
 			break;
-		case nsl_smooth_weight_tricube:
-			for(j=0;j<np;j++) {
-				w[j]=nsl_sf_kernel_tricube(2.*(j-(np-1)/2.)/(np+1));
-				sum += w[j];
-			}
+		}
+		sum = (np-1)/2.;
+		for(j=0;j<np;j++)
+			w[j]=exp(gsl_sf_lnchoose(2*sum,sum+fabs(j-sum))-sum*M_LN2*2.);
+		return;
+	case nsl_smooth_weight_parabolic:
+		for(j=0;j<np;j++)
+			w[j]=nsl_sf_kernel_parabolic(lagged ? 1.-(1+j)/(double)np : 2.*(j-(np-1)/2.)/(np+1));
+		break;
+	case nsl_smooth_weight_quartic:
+		for(j=0;j<np;j++)
+			w[j]=nsl_sf_kernel_quartic(lagged ? 1.-(1+j)/(double)np : 2.*(j-(np-1)/2.)/(np+1));
+		break;
+	case nsl_smooth_weight_triweight:
+		for(j=0;j<np;j++)
+			w[j]=nsl_sf_kernel_triweight(lagged ? 1.-(1+j)/(double)np : 2.*(j-(np-1)/2.)/(np+1));
+		break;
+	case nsl_smooth_weight_tricube:
+		for(j=0;j<np;j++)
+			w[j]=nsl_sf_kernel_tricube(lagged ? 1.-(1+j)/(double)np : 2.*(j-(np-1)/2.)/(np+1));
+		break;
+	case nsl_smooth_weight_cosine:
+		for(j=0;j<np;j++)
+			w[j]=nsl_sf_kernel_cosine(lagged ? (np-1-j)/(double)np : (j-(np-1)/2.)/((np+1)/2.));
+		break;
+	}
+
+	/* normalize */
+	sum=0.0;
+	for(j=0;j<np;j++)
+		sum += w[j];
+	for(j=0;j<np;j++)
+		w[j] /= sum;
+}
+
+/* result[i] = scale*sum_{j<np} x[i+j] for i<n using a running sum, x has n+np-1 values */
+static void nsl_smooth_box(const double *x, size_t n, unsigned int np, double scale, double *result) {
+	size_t i;
+	unsigned int j, k=0;
+	double sum=0.0;
+
+	for(i=0;i<n;i++,k--) {
+		if(k == 0) {	/* sum up again every np values to avoid accumulating rounding errors */
+			k=np;
+			sum=0.0;
 			for(j=0;j<np;j++)
-				w[j] /= sum;
-			break;
-		case nsl_smooth_weight_cosine:
+				sum += x[i+j];
+		} else
+			sum += x[i+np-1]-x[i-1];
+		result[i] = scale*sum;
+	}
+}
+
+/* result[i] = scale*sum_{j<np} (j+1)*x[i+j] for i<n using running sums, x has n+np-1 values */
+static void nsl_smooth_ramp(const double *x, size_t n, unsigned int np, double scale, double *result) {
+	size_t i;
+	unsigned int j, k=0;
+	double sum=0.0, rsum=0.0;
+
+	for(i=0;i<n;i++,k--) {
+		if(k == 0) {
+			k=np;
+			sum=0.0, rsum=0.0;
 			for(j=0;j<np;j++) {
-				w[j]=nsl_sf_kernel_cosine((j-(np-1)/2.)/((np+1)/2.));
-				sum += w[j];
+				sum += x[i+j];
+				rsum += (j+1)*x[i+j];
 			}
-			for(j=0;j<np;j++)
-				w[j] /= sum;
-			break;
+		} else {
+			rsum += np*x[i+np-1]-sum;
+			sum += x[i+np-1]-x[i-1];
 		}
+		result[i] = scale*rsum;
+	}
+}
 
-		/*printf("(%d) w:",i);
-		for(j=0;j<np;j++)
-			printf(" %g",w[j]);
-		printf(" (half=%d) index = ",half);*/
-
-		/* calculate weighted average */
-		for(j=0;j<np;j++) {
-			int index=i-half+j;
-			switch(mode) {
-			case nsl_smooth_pad_none:
-				result[i] += w[j]*data[index];
-				break;
-			case nsl_smooth_pad_interp:
-				printf("not implemented yet\n");
-				break;
-			case nsl_smooth_pad_mirror:
-				index=abs((int)(i-half+j));
-				/*printf(" %d",GSL_MIN(index,2*(n-1)-index));*/
-				result[i] += w[j]*data[GSL_MIN(index,2*((int)n-1)-index)];
-				break;
-			case nsl_smooth_pad_nearest:
-				/*printf(" %d",GSL_MIN(n-1,GSL_MAX(0,index)));*/
-				result[i] += w[j]*data[GSL_MIN((int)n-1,GSL_MAX(0,index))];
-				break;
-			case nsl_smooth_pad_constant:
-				if(index<0)
-					result[i] += w[j]*nsl_smooth_pad_constant_lvalue;
-				else if(index>(int)n-1)
-					result[i] += w[j]*nsl_smooth_pad_constant_rvalue;
-				else
-					result[i] += w[j]*data[index];
-				break;
-			case nsl_smooth_pad_periodic:
-				if(index<0)
-					index = n+index;
-				else if(index>(int)n-1)
-					index = index-n;
-				result[i] += w[j]*data[index];
-				break;
-			}
+/* result[i] = sum_{j<np} w[j]*x[i+j] for i<n with the weights of the given type, x has n+np-1 values.
+	returns -1 if the memory could not be allocated */
+static int nsl_smooth_filter(const double *x, size_t n, const double *w, unsigned int np, nsl_smooth_weight_type weight, int lagged, double *result) {
+	switch(weight) {
+	case nsl_smooth_weight_uniform:
+		nsl_smooth_box(x, n, np, 1./np, result);
+		break;
+	case nsl_smooth_weight_triangular:
+		if(lagged)
+			nsl_smooth_ramp(x, n, np, 1./(np*(np+1)/2), result);
+		else {
+			/* the triangle min(j+1,np-j) is the convolution of two boxes of (np+1)/2 and np/2+1 points */
+			const unsigned int np1=(np+1)/2, np2=np/2+1;
+			double *box = (double *)malloc((n+np2-1)*sizeof(double));
+			if(box == NULL)
+				return -1;
+			nsl_smooth_box(x, n+np2-1, np1, 1., box);
+			nsl_smooth_box(box, n, np2, 1./gsl_pow_2(np1), result);
+			free(box);
 		}
-		/*puts("");*/
-		free(w);
+		break;
+	default:
+		return nsl_conv_window(x, n, w, np, result, nsl_conv_method_auto);
 	}
-	
-	for (i=0; i<n; i++)
-		data[i]=result[i];
-	free(result);
 
 	return 0;
 }
 
-int nsl_smooth_moving_average_lagged(double *data, unsigned int n, unsigned int points, nsl_smooth_weight_type weight, nsl_smooth_pad_mode mode) {
-	unsigned int i,j;
-	double *result = (double *)malloc(n*sizeof(double));
-	for (i=0; i<n; i++)
-		result[i]=0;
+/* value of the padded signal at index (-n < index < 2n-1) */
+static double nsl_smooth_pad_value(const double *data, unsigned int n, int index, nsl_smooth_pad_mode mode) {
+	switch(mode) {
+	case nsl_smooth_pad_mirror:
+		index=abs(index);
+		return data[GSL_MIN(index,2*((int)n-1)-index)];
+	case nsl_smooth_pad_nearest:
+		return data[GSL_MIN((int)n-1,GSL_MAX(0,index))];
+	case nsl_smooth_pad_constant:
+		if(index<0)
+			return nsl_smooth_pad_constant_lvalue;
+		else if(index>(int)n-1)
+			return nsl_smooth_pad_constant_rvalue;
+		return data[index];
+	case nsl_smooth_pad_periodic:
+		if(index<0)
+			index = n+index;
+		else if(index>(int)n-1)
+			index = index-n;
+		return data[index];
+	case nsl_smooth_pad_none:
+	case nsl_smooth_pad_interp:
+		break;
+	}
 
-	for(i=0;i<n;i++) {
-		unsigned int np=points;
-		unsigned int half=(points-1)/2;
-		if(mode == nsl_smooth_pad_none) { /* reduce points */
-			np = GSL_MIN(points,i+1);
-			half = np-1;
-		}
+	return data[index];
+}
 
-		/* weight */
-		double sum=0.0, *w = (double *)malloc(np*sizeof(double));
-		switch(weight) {
-		case nsl_smooth_weight_uniform:
-			for(j=0;j<np;j++)
-				w[j]=1./np;
-			break;
-		case nsl_smooth_weight_triangular:
-			sum = np*(np+1)/2;
-			for(j=0;j<np;j++)
-				w[j]=(j+1)/sum;
-			break;
-		case nsl_smooth_weight_binomial:
-			for(j=0;j<np;j++) {
-				w[j]=gsl_sf_choose(2*(np-1),j);
-				sum += w[j];
-			}
-			for(j=0;j<np;j++)
-				w[j] /= sum;
-			break;
-		case nsl_smooth_weight_parabolic:
-			for(j=0;j<np;j++) {
-				w[j]=nsl_sf_kernel_parabolic(1.-(1+j)/(double)np);
-				sum += w[j];
-			}
-			for(j=0;j<np;j++)
-				w[j] /= sum;
-			break;
-		case nsl_smooth_weight_quartic:
-			for(j=0;j<np;j++) {
-				w[j]=nsl_sf_kernel_quartic(1.-(1+j)/(double)np);
-				sum += w[j];
-			}
-			for(j=0;j<np;j++)
-				w[j] /= sum;
-			break;
-		case nsl_smooth_weight_triweight:
-			for(j=0;j<np;j++) {
-				w[j]=nsl_sf_kernel_triweight(1.-(1+j)/(double)np);
-				sum += w[j];
-			}
-			for(j=0;j<np;j++)
-				w[j] /= sum;
-			break;
-		case nsl_smooth_weight_tricube:
-			for(j=0;j<np;j++) {
-				w[j]=nsl_sf_kernel_tricube(1.-(1+j)/(double)np);
-				sum += w[j];
+/* weighted moving average of points values starting half points left of every point, shared by central and lagged average */
+static int nsl_smooth_moving_average_window(double *data, unsigned int n, unsigned int points, unsigned int half,
+		nsl_smooth_weight_type weight, nsl_smooth_pad_mode mode, int lagged) {
+	unsigned int i, j;
+
+	if(n == 0)
+		return 0;
+	if(points == 0) {
+		printf("The number of points must be greater than zero.");
+		return -1;
+	}
+	if(mode == nsl_smooth_pad_interp) {
+		printf("not implemented yet\n");
+		for(i=0;i<n;i++)
+			data[i]=0;
+		return 0;
+	}
+
+	/* weights of the full window are calculated only once */
+	double *w = (double *)malloc(points*sizeof(double));
+	if(w == NULL)
+		return -1;
+
+	if(mode == nsl_smooth_pad_none) { /* reduce points at the edges */
+		double *x = (double *)malloc(n*sizeof(double));
+		if(x == NULL) {
+			free(w);
+			return -1;
+		}
+		memcpy(x, data, n*sizeof(double));
+
+		/* windows fitting completely into the data */
+		unsigned int np = lagged ? points : 2*half+1;
+		if(np <= n) {
+			nsl_smooth_weights(w, np, weight, lagged);
+			if(nsl_smooth_filter(x, n-np+1, w, np, weight, lagged, data+(lagged ? np-1 : half)) != 0) {
+				free(x);
+				free(w);
+				return -1;
 			}
-			for(j=0;j<np;j++)
-				w[j] /= sum;
-			break;
-		case nsl_smooth_weight_cosine:
-			for(j=0;j<np;j++) {
-				w[j]=nsl_sf_kernel_cosine((np-1-j)/(double)np);
-				sum += w[j];
+		}
+
+		/* edges */
+		for(i=0;i<n;i++) {
+			unsigned int first;
+			if(lagged) {
+				if(i+1 >= points)
+					break;
+				np = i+1;
+				first = 0;
+			} else {
+				if(i >= half && i+half < n) {
+					/* skip to the right edge */
+					i = n-half-1;
+					continue;
+				}
+				unsigned int rhalf = GSL_MIN(GSL_MIN(half,i),n-i-1);
+				np = 2*rhalf+1;
+				first = i-rhalf;
 			}
+
+			nsl_smooth_weights(w, np, weight, lagged);
+			double sum=0.0;
 			for(j=0;j<np;j++)
-				w[j] /= sum;
-			break;
+				sum += w[j]*x[first+j];
+			data[i] = sum;
 		}
 
-		/*printf("(%d) w:",i);
-		for(j=0;j<np;j++)
-			printf(" %g",w[j]);
-		printf(" (half=%d) index = ",half);*/
-
-		/* calculate weighted average */
-		for(j=0;j<np;j++) {
-			int index=i-np+1+j;
-			switch(mode) {
-			case nsl_smooth_pad_none:
-				result[i] += w[j]*data[i-half+j];
-				/*printf(" %d",index);*/
-				break;
-			case nsl_smooth_pad_interp:
-				printf("not implemented yet\n");
-				break;
-			case nsl_smooth_pad_mirror:
-				index=abs(index);
-				/*printf(" %d",index);*/
-				result[i] += w[j]*data[index];
-				break;
-			case nsl_smooth_pad_nearest:
-				/*printf(" %d",GSL_MAX(0,index));*/
-				result[i] += w[j]*data[index];
-				break;
-			case nsl_smooth_pad_constant:
-				if(index < 0)
-					result[i] += w[j]*nsl_smooth_pad_constant_lvalue;
-				else
-					result[i] += w[j]*data[index];
+		free(x);
+		free(w);
+		return 0;
+	}
 
-				break;
-			case nsl_smooth_pad_periodic:
-				if(index < 0)
-					index += n;
-				/*printf(" %d",index);*/
-				result[i] += w[j]*data[index];
-				break;
-			}
-		}
-		/*puts("");*/
+	/* padded signal */
+	const unsigned int rpad = points-1-half;
+	double *x = (double *)malloc((n+points-1)*sizeof(double));
+	if(x == NULL) {
 		free(w);
+		return -1;
 	}
+	for(i=0;i<half;i++)
+		x[i] = nsl_smooth_pad_value(data, n, (int)i-(int)half, mode);
+	memcpy(x+half, data, n*sizeof(double));
+	for(i=0;i<rpad;i++)
+		x[half+n+i] = nsl_smooth_pad_value(data, n, n+i, mode);
+
+	nsl_smooth_weights(w, points, weight, lagged);
+	const int status = nsl_smooth_filter(x, n, w, points, weight, lagged, data);
+
+	free(x);
+	free(w);
+	return status;
+}
 
-	for (i=0; i<n; i++)
-		data[i]=result[i];
-	free(result);
+int nsl_smooth_moving_average(double *data, unsigned int n, unsigned int points, nsl_smooth_weight_type weight, nsl_smooth_pad_mode mode) {
+	return nsl_smooth_moving_average_window(data, n, points, (points-1)/2, weight, mode, 0);
+}
 
-	return 0;
+int nsl_smooth_moving_average_lagged(double *data, unsigned int n, unsigned int points, nsl_smooth_weight_type weight, nsl_smooth_pad_mode mode) {
+	return nsl_smooth_moving_average_window(data, n, points, points-1, weight, mode, 1);
 }
 
 int nsl_smooth_percentile(double *data, unsigned int n, unsigned int points, double percentile, nsl_smooth_pad_mode mode) {
-	unsigned int i,j;
-	double *result = (double *)malloc(n*sizeof(double));
+	/*using type 4 as default */
+	return nsl_smooth_percentile_type(data, n, points, percentile, nsl_stats_quantile_type4, mode);
+}
+
+int nsl_smooth_percentile_type(double *data, unsigned int n, unsigned int points, double percentile, nsl_stats_quantile_type type, nsl_smooth_pad_mode mode) {
+	unsigned int i;
+	const unsigned int half=(points-1)/2;
+
+	if(n == 0)
+		return 0;
+	if(points == 0) {
+		printf("The number of points must be greater than zero.");
+		return -1;
+	}
+	if(mode == nsl_smooth_pad_interp) {
+		printf("not implemented yet\n");
+		for(i=0;i<n;i++)
+			data[i]=0;
+		return 0;
+	}
 
+	/* signal (padded if needed), the window of point i is x[first..last) */
+	const unsigned int rpad = (mode == nsl_smooth_pad_none) ? 0 : points-1-half;
+	const unsigned int lpad = (mode == nsl_smooth_pad_none) ? 0 : half;
+	double *x = (double *)malloc((n+lpad+rpad)*sizeof(double));
+	if (x == NULL)
+		return -1;
+	for(i=0;i<lpad;i++)
+		x[i] = nsl_smooth_pad_value(data, n, (int)i-(int)half, mode);
+	memcpy(x+lpad, data, n*sizeof(double));
+	for(i=0;i<rpad;i++)
+		x[lpad+n+i] = nsl_smooth_pad_value(data, n, n+i, mode);
+
+	/* sliding window: every value is inserted and removed once in O(log points) */
+	nsl_rolling *w = nsl_rolling_alloc(points);
+	if (w == NULL) {
+		free(x);
+		return -1;
+	}
+	size_t lo=0, hi=0;
 	for(i=0;i<n;i++) {
-		unsigned int np=points;
-		unsigned int half=(points-1)/2;
+		size_t first=i, last=i+points;
 		if(mode == nsl_smooth_pad_none) { /* reduce points */
-			half = GSL_MIN(GSL_MIN((points-1)/2,i),n-i-1);
-			np = 2*half+1;
+			unsigned int rhalf = GSL_MIN(GSL_MIN(half,i),n-i-1);
+			first = i-rhalf;
+			last = i+rhalf+1;
 		}
 
-		double *values = (double *)malloc(np*sizeof(double));
-		for(j=0;j<np;j++) {
-			int index = i-half+j;
-			switch(mode) {
-			case nsl_smooth_pad_none:
-				/*printf(" %d",index);*/
-				values[j] = data[index];
-				break;
-			case nsl_smooth_pad_interp:
-				printf("not implemented yet\n");
-				break;
-			case nsl_smooth_pad_mirror:
-				index=abs(index);
-				/*printf(" %d",GSL_MIN(index,2*(n-1)-index));*/
-				values[j] = data[GSL_MIN(index,2*((int)n-1)-index)];
-				break;
-			case nsl_smooth_pad_nearest:
-				/*printf(" %d",GSL_MIN(n-1,GSL_MAX(0,index)));*/
-				values[j] = data[GSL_MIN((int)n-1,GSL_MAX(0,index))];
-				break;
-			case nsl_smooth_pad_constant:
-				if(index<0)
-					values[j] = nsl_smooth_pad_constant_lvalue;
-				else if(index>(int)n-1)
-					values[j] = nsl_smooth_pad_constant_rvalue;
-				else
-					values[j] = data[index];
-				break;
-			case nsl_smooth_pad_periodic:
-				if(index<0)
-					index = n+index;
-				else if(index>(int)n-1)
-					index = index-n;
-				/*printf(" %d",index);*/
-				values[j] = data[index];
-				break;
-			}
-		}
-		/*puts("");*/
+		for(;lo<first;lo++)
+			if(!isnan(x[lo]))
+				nsl_rolling_remove(w, x[lo]);
+		for(;hi<last;hi++)
+			if(!isnan(x[hi]))
+				nsl_rolling_insert(w, x[hi]);
 
-		/*using type 4 as default */
-		result[i] = nsl_stats_quantile(values, 1, np, percentile, nsl_stats_quantile_type4);
-		free(values);
+		data[i] = nsl_rolling_quantile(w, percentile, type);
 	}
 
-	for (i=0; i<n; i++)
-		data[i]=result[i];
-	free(result);
+	nsl_rolling_free(w);
+	free(x);
 
 	return 0;
 }
@@ -408,6 +420,89 @@ void nsl_smooth_pad_constant_set(double lvalue, double rvalue) {
 	nsl_smooth_pad_constant_rvalue = rvalue;
 }
 
+/* cache of the coefficient matrices of the last used (points, order) pairs.
+	Matrices in use are never replaced (refcount > 0) */
+#define NSL_SMOOTH_SAVGOL_CACHE_SIZE 4
+/* larger matrices are not cached */
+#define NSL_SMOOTH_SAVGOL_CACHE_MAX_POINTS 1024
+static struct {
+	unsigned int points, order;
+	gsl_matrix *h;
+	unsigned int refcount;
+	unsigned long last;
+} nsl_smooth_savgol_cache[NSL_SMOOTH_SAVGOL_CACHE_SIZE];
+static unsigned long nsl_smooth_savgol_cache_clock = 0;
+static nsl_mutex nsl_smooth_savgol_mutex = NSL_MUTEX_INITIALIZER;
+
+/* coefficient matrix for (points, order), NULL on error. Release with nsl_smooth_savgol_coeff_release() */
+static gsl_matrix* nsl_smooth_savgol_coeff_get(unsigned int points, unsigned int order, int *error) {
+	unsigned int i;
+	nsl_mutex_lock(&nsl_smooth_savgol_mutex);
+	for (i = 0; i < NSL_SMOOTH_SAVGOL_CACHE_SIZE; i++)
+		if (nsl_smooth_savgol_cache[i].h != NULL && nsl_smooth_savgol_cache[i].points == points && nsl_smooth_savgol_cache[i].order == order) {
+			nsl_smooth_savgol_cache[i].refcount++;
+			nsl_smooth_savgol_cache[i].last = ++nsl_smooth_savgol_cache_clock;
+			nsl_mutex_unlock(&nsl_smooth_savgol_mutex);
+			return nsl_smooth_savgol_cache[i].h;
+		}
+	nsl_mutex_unlock(&nsl_smooth_savgol_mutex);
+
+	/* calculated without holding the lock */
+	gsl_matrix *h = gsl_matrix_alloc(points, points);
+	*error = nsl_smooth_savgol_coeff(points, order, h);
+	if (*error) {
+		gsl_matrix_free(h);
+		return NULL;
+	}
+
+	if (points > NSL_SMOOTH_SAVGOL_CACHE_MAX_POINTS)
+		return h;
+
+	/* least recently used unused or empty slot. If all matrices are in use, h is not cached */
+	nsl_mutex_lock(&nsl_smooth_savgol_mutex);
+	int slot = -1;
+	for (i = 0; i < NSL_SMOOTH_SAVGOL_CACHE_SIZE; i++)
+		if (nsl_smooth_savgol_cache[i].refcount == 0 && (slot == -1 || nsl_smooth_savgol_cache[i].h == NULL
+				|| (nsl_smooth_savgol_cache[slot].h != NULL && nsl_smooth_savgol_cache[i].last < nsl_smooth_savgol_cache[slot].last)))
+			slot = (int)i;
+	if (slot != -1) {
+		if (nsl_smooth_savgol_cache[slot].h != NULL)
+			gsl_matrix_free(nsl_smooth_savgol_cache[slot].h);
+		nsl_smooth_savgol_cache[slot].points = points;
+		nsl_smooth_savgol_cache[slot].order = order;
+		nsl_smooth_savgol_cache[slot].h = h;
+		nsl_smooth_savgol_cache[slot].refcount = 1;
+		nsl_smooth_savgol_cache[slot].last = ++nsl_smooth_savgol_cache_clock;
+	}
+	nsl_mutex_unlock(&nsl_smooth_savgol_mutex);
+
+	return h;
+}
+
+static void nsl_smooth_savgol_coeff_release(gsl_matrix *h) {
+	unsigned int i;
+	nsl_mutex_lock(&nsl_smooth_savgol_mutex);
+	for (i = 0; i < NSL_SMOOTH_SAVGOL_CACHE_SIZE; i++)
+		if (nsl_smooth_savgol_cache[i].h == h) {
+			nsl_smooth_savgol_cache[i].refcount--;
+			nsl_mutex_unlock(&nsl_smooth_savgol_mutex);
+			return;
+		}
+	nsl_mutex_unlock(&nsl_smooth_savgol_mutex);
+	gsl_matrix_free(h);
+}
+
+void nsl_smooth_cache_clear(void) {
+	unsigned int i;
+	nsl_mutex_lock(&nsl_smooth_savgol_mutex);
+	for (i = 0; i < NSL_SMOOTH_SAVGOL_CACHE_SIZE; i++)
+		if (nsl_smooth_savgol_cache[i].refcount == 0 && nsl_smooth_savgol_cache[i].h != NULL) {
+			gsl_matrix_free(nsl_smooth_savgol_cache[i].h);
+			nsl_smooth_savgol_cache[i].h = NULL;
+		}
+	nsl_mutex_unlock(&nsl_smooth_savgol_mutex);
+}
+
 int nsl_smooth_savgol(double *data, unsigned int n, unsigned int points, unsigned int order, nsl_smooth_pad_mode mode) {
 	unsigned int i, k;
 	int error = 0;
@@ -423,22 +518,24 @@ int nsl_smooth_savgol(double *data, unsigned int n, unsigned int points, unsigne
 	}
 
 	/* Savitzky-Golay coefficient matrix, y' = H y */
-	gsl_matrix *h = gsl_matrix_alloc(points, points);
-	error = nsl_smooth_savgol_coeff(points, order, h);
-	if (error) {
+	gsl_matrix *h = nsl_smooth_savgol_coeff_get(points, order, &error);
+	if (h == NULL) {
 		printf("Internal error in Savitzky-Golay algorithm:\n%s",gsl_strerror(error));
-		gsl_matrix_free(h);
 		return error;
 	}
 
 	double *result = (double *)malloc(n*sizeof(double));
+	if (result == NULL) {
+		nsl_smooth_savgol_coeff_release(h);
+		return -1;
+	}
 	for (i = 0; i < n; i++)
 		result[i] = 0;
 
-	/* left edge */
+	/* edges */
 	if(mode == nsl_smooth_pad_none) {
+		/* reduce points and order. The same reduced matrix is used for point i of the left and right edge */
 		for (i = 0; i < half; i++) {
-			/*reduce points and order*/
 			unsigned int rpoints = 2*i+1, rorder = GSL_MIN(order, rpoints-GSL_MIN(rpoints, 2));
 
 			gsl_matrix *rh = gsl_matrix_alloc(rpoints, rpoints);
@@ -446,12 +543,16 @@ int nsl_smooth_savgol(double *data, unsigned int n, unsigned int points, unsigne
 			if (error) {
 				printf("Internal error in Savitzky-Golay algorithm:\n%s",gsl_strerror(error));
 				gsl_matrix_free(rh);
+				nsl_smooth_savgol_coeff_release(h);
 				free(result);
 				return error;
 			}
-			
-			for (k = 0; k < rpoints; k++)
+
+			for (k = 0; k < rpoints; k++) {
 				result[i] += gsl_matrix_get(rh, i, k) * data[k];
+				result[n-1-i] += gsl_matrix_get(rh, i, k) * data[n-rpoints+k];
+			}
+			gsl_matrix_free(rh);
 		}
 	} else {
 		for (i = 0; i < half; i++) {
@@ -478,32 +579,6 @@ int nsl_smooth_savgol(double *data, unsigned int n, unsigned int points, unsigne
 					break;
 				}
 		}
-	}
-
-	/* central part: convolve with fixed row of h */
-	for (i = half; i < n-half; i++)
-		for (k = 0; k < points; k++)
-			result[i] += gsl_matrix_get(h, half, k) * data[i-half+k];
-
-	/* right edge */
-	if(mode == nsl_smooth_pad_none) {
-		for (i = n-half; i < n; i++) {
-			/*reduce points and order*/
-			unsigned int rpoints = 2*(n-1-i) + 1, rorder=GSL_MIN(order, rpoints-GSL_MIN(2, rpoints));
-
-			gsl_matrix *rh = gsl_matrix_alloc(rpoints, rpoints);
-			error = nsl_smooth_savgol_coeff(rpoints, rorder, rh);
-			if (error) {
-				printf("Internal error in Savitzky-Golay algorithm:\n%s",gsl_strerror(error));
-				gsl_matrix_free(rh);
-				free(result);
-				return error;
-			}
-			
-			for (k = 0; k < rpoints; k++)
-				result[i] += gsl_matrix_get(rh, n-1-i, k) * data[n-rpoints+k];
-		}
-	} else {
 		for (i = n-half; i < n; i++) {
 			for (k = 0; k < points; k++)
 				switch(mode) {
@@ -530,7 +605,14 @@ int nsl_smooth_savgol(double *data, unsigned int n, unsigned int points, unsigne
 		}
 	}
 
-	gsl_matrix_free(h);
+	/* central part: convolve with fixed row of h */
+	double *w = (double *)malloc(points*sizeof(double));
+	for (k = 0; k < points; k++)
+		w[k] = gsl_matrix_get(h, half, k);
+	nsl_conv_window(data, n-2*half, w, points, result+half, nsl_conv_method_auto);
+	free(w);
+
+	nsl_smooth_savgol_coeff_release(h);
 
 	for (i = 0; i < n; i++)
 		data[i] = result[i];
@@ -542,3 +624,142 @@ int nsl_smooth_savgol(double *data, unsigned int n, unsigned int points, unsigne
 int nsl_smooth_savgol_default( double *data, unsigned int n, unsigned int points, unsigned int order) {
 	return nsl_smooth_savgol(data, n, points, order, nsl_smooth_pad_constant);
 }
+
+/* LOWESS fit at x[i] using the points nearest neighbours starting at index left.
+	The sums are taken relative to x[i] to avoid cancellation */
+static double nsl_smooth_lowess_fit(const double x[], const double y[], const double rweights[], size_t n, size_t points,
+		size_t i, size_t left, double range) {
+	size_t j;
+	const double h = GSL_MAX(x[i]-x[left], x[left+points-1]-x[i]), h9 = 0.999*h;
+
+	/* ties beyond the window are included */
+	double sumw = 0.0, sumwx = 0.0, sumwxx = 0.0, sumwy = 0.0, sumwxy = 0.0;
+	for (j = left; j < n; j++) {
+		const double dx = x[j]-x[i], r = fabs(dx);
+		if (r > h9) {
+			if (dx > 0)
+				break;
+			continue;
+		}
+		double w = (h > 0) ? nsl_sf_kernel_tricube(r/h) : 1.0;
+		if (rweights != NULL)
+			w *= rweights[j];
+		sumw += w;
+		sumwx += w*dx;
+		sumwxx += w*dx*dx;
+		sumwy += w*y[j];
+		sumwxy += w*dx*y[j];
+	}
+	if (sumw <= 0.0)
+		return y[i];
+
+	/* local linear fit, weighted mean if the x values are too close */
+	const double a = sumwx/sumw, c = sumwxx-sumw*a*a;
+	if (c > 0 && sqrt(c/sumw) > 0.001*range)
+		return sumwy/sumw - a*(sumwxy-a*sumwy)/c;
+
+	return sumwy/sumw;
+}
+
+int nsl_smooth_lowess_range(const double x[], const double y[], const double rweights[], size_t n, size_t points, double delta,
+		size_t first, size_t last, double result[]) {
+	if (points < 2 || points > n) {
+		printf("The number of neighbours must be between 2 and %zu (%zu given).", n, points);
+		return -1;
+	}
+	if (first >= last || last > n)
+		return -2;
+
+	const double range = x[n-1]-x[0];
+	/* the window of points values containing x[i] starts at i-points+1 or later */
+	size_t left = (first+1 > points) ? first+1-points : 0;
+	size_t i = first, prev = first, fitted = 0, j;
+	for (;;) {
+		/* move the window of the nearest neighbours */
+		while (left+points < n && x[i]-x[left] > x[left+points]-x[i])
+			left++;
+		result[i] = nsl_smooth_lowess_fit(x, y, rweights, n, points, i, left, range);
+
+		/* linear interpolation of the skipped points */
+		if (fitted && i > prev+1) {
+			const double slope = (result[i]-result[prev])/(x[i]-x[prev]);
+			for (j = prev+1; j < i; j++)
+				result[j] = result[prev] + slope*(x[j]-x[prev]);
+		}
+		fitted = 1;
+		prev = i;
+		if (i == last-1)
+			break;
+
+		/* skip points closer than delta, ties get the same value */
+		const double cut = x[prev]+delta;
+		for (i = prev+1; i < last; i++) {
+			if (x[i] > cut)
+				break;
+			if (x[i] == x[prev]) {
+				result[i] = result[prev];
+				prev = i;
+			}
+		}
+		i = GSL_MAX(prev+1, i-1);
+		if (i >= last)
+			break;
+	}
+
+	return 0;
+}
+
+int nsl_smooth_lowess_weights(const double y[], const double fit[], size_t n, double rweights[]) {
+	size_t i;
+	double sum = 0.0;
+
+	for (i = 0; i < n; i++) {
+		rweights[i] = fabs(y[i]-fit[i]);
+		sum += rweights[i];
+	}
+
+	double *residuals = (double *)malloc(n*sizeof(double));
+	if (residuals == NULL)
+		return -1;
+	memcpy(residuals, rweights, n*sizeof(double));
+	const double cmad = 6.0*nsl_stats_median(residuals, 1, n, nsl_stats_quantile_type7);
+	free(residuals);
+
+	/* the fit is (almost) exact */
+	if (cmad < 1.e-7*sum/n)
+		return 1;
+
+	/* bisquare weights */
+	const double c9 = 0.999*cmad, c1 = 0.001*cmad;
+	for (i = 0; i < n; i++) {
+		const double r = rweights[i];
+		if (r <= c1)
+			rweights[i] = 1.0;
+		else if (r <= c9)
+			rweights[i] = gsl_pow_2(1.0-gsl_pow_2(r/cmad));
+		else
+			rweights[i] = 0.0;
+	}
+
+	return 0;
+}
+
+int nsl_smooth_lowess(const double x[], const double y[], size_t n, size_t points, unsigned int iterations, double delta, double result[]) {
+	unsigned int iter;
+
+	int status = nsl_smooth_lowess_range(x, y, NULL, n, points, delta, 0, n, result);
+	if (status != 0 || iterations == 0)
+		return status;
+
+	double *rweights = (double *)malloc(n*sizeof(double));
+	if (rweights == NULL)
+		return -1;
+	for (iter = 0; iter < iterations; iter++) {
+		if (nsl_smooth_lowess_weights(y, result, n, rweights) != 0)
+			break;
+		nsl_smooth_lowess_range(x, y, rweights, n, points, delta, 0, n, result);
+	}
+	free(rweights);
+
+	return 0;
+}
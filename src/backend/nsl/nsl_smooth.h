@@ -30,12 +30,13 @@
 #define NSL_SMOOTH_H
 
 #include <gsl/gsl_matrix.h>
+#include "nsl_stats.h"
 
-#define NSL_SMOOTH_TYPE_COUNT 4
+#define NSL_SMOOTH_TYPE_COUNT 5
 typedef enum {nsl_smooth_type_moving_average, nsl_smooth_type_moving_average_lagged, nsl_smooth_type_percentile,
-	nsl_smooth_type_savitzky_golay} nsl_smooth_type;
+	nsl_smooth_type_savitzky_golay, nsl_smooth_type_lowess} nsl_smooth_type;
 extern const char* nsl_smooth_type_name[];
-/* TODO: LOWESS/etc., Bezier, B-Spline, (FFT Filter) */
+/* TODO: LOESS/etc., Bezier, B-Spline, (FFT Filter) */
 
 /* mode of extension for padding signal 
  *	none: reduce points at edges
@@ -68,8 +69,10 @@ int nsl_smooth_moving_average(double *data, unsigned int n, unsigned int points,
 /* Lagged moving average */
 int nsl_smooth_moving_average_lagged(double *data, unsigned int n, unsigned int points, nsl_smooth_weight_type weight, nsl_smooth_pad_mode mode);
 
-/* Percentile filter */
+/* Percentile filter (quantile type 4) */
 int nsl_smooth_percentile(double *data, unsigned int n, unsigned int points, double percentile, nsl_smooth_pad_mode mode);
+/* Percentile filter with given quantile type, O(n log points). NaN values are ignored */
+int nsl_smooth_percentile_type(double *data, unsigned int n, unsigned int points, double percentile, nsl_stats_quantile_type type, nsl_smooth_pad_mode mode);
 
 /* Savitzky-Golay coefficents */
 /**
@@ -105,6 +108,27 @@ int nsl_smooth_savgol(double *data, unsigned int n, unsigned int points, unsigne
 /* Savitzky-Golay default smooting (interp) */
 int nsl_smooth_savgol_default(double *data, unsigned int n, unsigned int points, unsigned int order);
 
+/* free the unused cached Savitzky-Golay coefficient matrices. The cache is thread-safe */
+void nsl_smooth_cache_clear(void);
+
+/* LOWESS (locally weighted scatterplot smoothing, Cleveland 1979) */
+/**
+ * \brief LOWESS smoothing of y(x) with x sorted ascending.
+ *
+ * Each value is replaced by a local linear fit to its #points nearest neighbours with tricube weights
+ * (nsl_sf_kernel_tricube()), followed by #iterations robustness iterations with bisquare weights of the residuals.
+ * Points closer than #delta to the last fitted x are interpolated linearly (0: fit all points).
+ * The neighbourhood window is moved along the sorted x, so the complexity is O(n*points).
+ * result must not be y.
+ */
+int nsl_smooth_lowess(const double x[], const double y[], size_t n, size_t points, unsigned int iterations, double delta, double result[]);
+/* LOWESS fit of result[first] .. result[last-1] with robustness weights rweights (NULL: no weights).
+	Ranges are independent and may be processed in parallel. */
+int nsl_smooth_lowess_range(const double x[], const double y[], const double rweights[], size_t n, size_t points, double delta,
+		size_t first, size_t last, double result[]);
+/* robustness weights of the residuals y-fit. Returns 1 if the fit is (almost) exact and no further iteration is needed */
+int nsl_smooth_lowess_weights(const double y[], const double fit[], size_t n, double rweights[]);
+
 /* TODO SmoothFilter::smoothModifiedSavGol(double *x_in, double *y_inout)
 	see SmoothFilter.cpp of libscidavis
 */
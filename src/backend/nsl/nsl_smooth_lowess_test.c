@@ -0,0 +1,52 @@
+/***************************************************************************
+    File                 : nsl_smooth_lowess_test.c
+    Project              : LabPlot
+    Description          : NSL smooth functions
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include <stdio.h>
+#include "nsl_smooth.h"
+
+int main() {
+	/* cars data set (speed, dist). R: lowess(cars) gives 4.965459 4.965459 13.124495 ... 84.328698 */
+	double x[]={4,4,7,7,8,9,10,10,10,11,11,12,12,12,12,13,13,13,13,14,14,14,14,15,15,15,16,16,17,17,17,18,18,18,18,19,19,19,20,20,20,20,20,22,23,24,24,24,24,25};
+	double y[]={2,10,4,22,16,10,18,26,34,17,28,14,20,24,28,26,34,34,46,26,36,60,80,20,26,54,32,40,32,40,50,42,56,76,84,36,46,68,32,48,52,56,64,66,54,70,92,93,120,85};
+	double result[50];
+	int i, n=50;
+
+	/* f = 2/3: 33 neighbours, 3 iterations, delta = 0.01*range */
+	nsl_smooth_lowess(x, y, n, 33, 3, 0.21, result);
+	for(i=0;i<n;i++)
+		printf(" %.6f",result[i]);
+	printf("\n");
+
+	/* no robustness iterations, no interpolation */
+	nsl_smooth_lowess(x, y, n, 33, 0, 0, result);
+	for(i=0;i<n;i++)
+		printf(" %.6f",result[i]);
+	printf("\n");
+
+	return 0;
+}
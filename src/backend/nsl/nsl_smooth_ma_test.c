@@ -62,5 +62,17 @@ int main() {
 	status = nsl_smooth_moving_average(data5, 9, points, weight, nsl_smooth_pad_periodic);
 	for(i=0;i<9;i++)
 		printf(" %g",data5[i]);
+
+	/* large window (FFT convolution) */
+	printf("\npad_periodic, 101 points, cosine weight (sum should be 600)\n");
+	double data6[300], sum=0;
+	for(i=0;i<300;i++)
+		data6[i] = 1.+(i%3);
+	status = nsl_smooth_moving_average(data6, 300, 101, nsl_smooth_weight_cosine, nsl_smooth_pad_periodic);
+	for(i=0;i<300;i++)
+		sum += data6[i];
+	for(i=0;i<9;i++)
+		printf(" %g",data6[i]);
+	printf(" (sum = %g)", sum);
 	puts("");
 }
@@ -120,4 +120,14 @@ int main() {
 	for(i=0;i<9;i++)
 		printf(" %7.4f",data5[i]);
 	printf("\n");
+
+	/* the cached coefficients of the first call are used */
+	double data6[9]={2,2,5,2,1,0,1,4,9};
+	printf("mode:interp (cached)\n");
+	nsl_smooth_savgol(data6,9,m,order,nsl_smooth_pad_interp);
+	for(i=0;i<9;i++)
+		printf(" %7.4f",data6[i]);
+	printf("\n");
+
+	nsl_smooth_cache_clear();
 }
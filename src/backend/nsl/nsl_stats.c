@@ -85,84 +85,94 @@ double nsl_stats_quantile(double data[], size_t stride, size_t n, double p, nsl_
 }
 
 double nsl_stats_quantile_sorted(const double d[], size_t stride, size_t n, double p, nsl_stats_quantile_type type) {
+	size_t i;
+	double frac;
+	nsl_stats_quantile_position(n, p, type, &i, &frac);
+
+	if (frac == 0.0)
+		return d[i*stride];
+	return d[i*stride]+frac*(d[(i+1)*stride]-d[i*stride]);
+}
+
+void nsl_stats_quantile_position(size_t n, double p, nsl_stats_quantile_type type, size_t *index, double *frac) {
+	int i = 1;
+	double h = 0.0;	/* position (starting at 1) of the quantile in the sorted data */
 
 	switch(type) {
 	case nsl_stats_quantile_type1:
-		if (p == 0.0)
-			return d[0];
-		else
-			return d[((int)ceil(n*p)-1)*stride];
+		if (p != 0.0)
+			i = (int)ceil(n*p);
+		break;
 	case nsl_stats_quantile_type2:
-		if (p == 0.0)
-                        return d[0];
-		else if (p == 1.0)
-                        return d[(n-1)*stride];
-		else
-			return (d[((int)ceil(n*p)-1)*stride]+d[((int)ceil(n*p+1)-1)*stride])/2.;
+		if (p == 1.0)
+			i = n;
+		else if (p != 0.0) {
+			i = (int)ceil(n*p);
+			/* mean of the values at n*p and n*p+1 if n*p is an integer */
+			if (i == n*p)
+				h = 0.5;
+		}
+		break;
 	case nsl_stats_quantile_type3:
-		if(p <= 0.5/n)
-			return d[0];
-		else
+		if(p > 0.5/n)
 #ifdef _WIN32
-			return d[((int)(n*p)-1)*stride];
+			i = (int)(n*p);
 #else
-			return d[(lrint(n*p)-1)*stride];
+			i = lrint(n*p);
 #endif
+		break;
 	case nsl_stats_quantile_type4:
-		if(p < 1./n)
-			return d[0];
-		else if (p == 1.0)
-			return d[(n-1)*stride];
-		else {
-			int i = floor(n*p);
-			return d[(i-1)*stride]+(n*p-i)*(d[i*stride]-d[(i-1)*stride]);	
+		if (p == 1.0)
+			i = n;
+		else if(p >= 1./n) {
+			i = floor(n*p);
+			h = n*p-i;
 		}
+		break;
 	case nsl_stats_quantile_type5:
-		if(p < 0.5/n)
-			return d[0];
-		else if (p >= (n-0.5)/n)
-			return d[(n-1)*stride];
-		else {
-			int i = floor(n*p+0.5);
-			return d[(i-1)*stride]+(n*p+0.5-i)*(d[i*stride]-d[(i-1)*stride]);	
+		if (p >= (n-0.5)/n)
+			i = n;
+		else if(p >= 0.5/n) {
+			i = floor(n*p+0.5);
+			h = n*p+0.5-i;
 		}
+		break;
 	case nsl_stats_quantile_type6:
-		if(p < 1./(n+1.))
-			return d[0];
-		else if (p > n/(n+1.))
-			return d[(n-1)*stride];
-		else {
-			int i = floor((n+1)*p);
-			return d[(i-1)*stride]+((n+1)*p-i)*(d[i*stride]-d[(i-1)*stride]);	
+		if (p > n/(n+1.))
+			i = n;
+		else if(p >= 1./(n+1.)) {
+			i = floor((n+1)*p);
+			h = (n+1)*p-i;
 		}
+		break;
 	case nsl_stats_quantile_type7:
 		if (p == 1.0)
-                        return d[(n-1)*stride];
-                else {
-			int i = floor((n-1)*p+1);
-			return d[(i-1)*stride]+((n-1)*p+1-i)*(d[i*stride]-d[(i-1)*stride]);	
+			i = n;
+		else {
+			i = floor((n-1)*p+1);
+			h = (n-1)*p+1-i;
 		}
+		break;
 	case nsl_stats_quantile_type8:
-		if (p < 2./3./(n+1./3.))
-			return d[0];
-		else if (p >= (n-1./3.)/(n+1./3.))
-			return d[(n-1)*stride];
-		else {
-			int i = floor((n+1./3.)*p+1./3.);
-			return d[(i-1)*stride]+((n+1./3.)*p+1./3.-i)*(d[i*stride]-d[(i-1)*stride]);	
+		if (p >= (n-1./3.)/(n+1./3.))
+			i = n;
+		else if (p >= 2./3./(n+1./3.)) {
+			i = floor((n+1./3.)*p+1./3.);
+			h = (n+1./3.)*p+1./3.-i;
 		}
+		break;
 	case nsl_stats_quantile_type9:
-		if (p < 5./8./(n+1./4.))
-			return d[0];
-		else if (p >= (n-3./8.)/(n+1./4.))
-			return d[(n-1)*stride];
-		else {
-			int i = floor((n+1./4.)*p+3./8.);
-			return d[(i-1)*stride]+((n+1./4.)*p+3./8.-i)*(d[i*stride]-d[(i-1)*stride]);	
+		if (p >= (n-3./8.)/(n+1./4.))
+			i = n;
+		else if (p >= 5./8./(n+1./4.)) {
+			i = floor((n+1./4.)*p+3./8.);
+			h = (n+1./4.)*p+3./8.-i;
 		}
+		break;
 	}
 
-	return 0;
+	*index = i-1;
+	*frac = h;
 }
 
 double nsl_stats_quantile_from_sorted_data(const double sorted_data[], size_t stride, size_t n, double p) {
@@ -62,5 +62,8 @@ double nsl_stats_quantile(double data[], size_t stride, size_t n, double p, nsl_
 double nsl_stats_quantile_sorted(const double sorted_data[], size_t stride, size_t n, double p, nsl_stats_quantile_type type);
 /* GSL legacy function */
 double nsl_stats_quantile_from_sorted_data(const double sorted_data[], size_t stride, size_t n, double p);
+/* position of the quantile in sorted data of size n: the quantile is
+	d[index] + frac*(d[index+1]-d[index]), d[index+1] is only needed if frac > 0 */
+void nsl_stats_quantile_position(size_t n, double p, nsl_stats_quantile_type type, size_t *index, double *frac);
 
 #endif /* NSL_STATS_H */
@@ -30,12 +30,19 @@
 #include "Spreadsheet.h"
 #include "backend/core/AspectPrivate.h"
 #include "backend/core/AbstractAspect.h"
+#include "backend/core/Folder.h"
+#include "backend/matrix/Matrix.h"
 #include "commonfrontend/spreadsheet/SpreadsheetView.h"
 #include "kdefrontend/spreadsheet/ExportSpreadsheetDialog.h"
 
 #include <QPrinter>
 #include <QPrintDialog>
 #include <QPrintPreviewDialog>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
 
 #include <KIcon>
 #include <KConfigGroup>
@@ -378,6 +385,22 @@ void Spreadsheet::copy(Spreadsheet * other)
 	RESET_CURSOR;
 }
 
+/*!
+  creates a view on the rows fulfilling the conditions \c conditions
+  with a filtered column for every column of the spreadsheet.
+*/
+SpreadsheetFilterView* Spreadsheet::addFilterView(const QString& name, const QList<SpreadsheetFilterView::Condition>& conditions, bool matchAll) {
+	beginMacro(i18n("%1: add filter view", this->name()));
+
+	SpreadsheetFilterView* view = new SpreadsheetFilterView(name);
+	addChild(view);
+	view->setConditions(conditions, matchAll);
+	view->addColumns(children<Column>());
+
+	endMacro();
+	return view;
+}
+
 // FIXME: replace index-based API with Column*-based one
 /*!
   Determines the corresponding X column.
@@ -430,6 +453,227 @@ int Spreadsheet::colY(int col)
 	return -1;
 }
 
+//##############################################################################
+//##############################  Sorting  #####################################
+//##############################################################################
+namespace {
+
+/*!
+ * one sort key, i.e. the contiguous data of one key column together with the sort order.
+ * Date-time values are converted once to milliseconds so that the comparison doesn't
+ * need to go through QDateTime for every pair of rows.
+ */
+struct SortKey {
+	AbstractColumn::ColumnMode mode;
+	bool ascending;
+	QVector<double> values;
+	QVector<qint64> dateTimes;
+	QStringList texts;
+};
+
+class RowLess {
+	public:
+		explicit RowLess(const QVector<SortKey>& keys) : m_keys(keys) {}
+
+		bool operator()(int a, int b) const {
+			for (int k = 0; k < m_keys.size(); ++k) {
+				const int result = compare(m_keys.at(k), a, b);
+				if (result != 0)
+					return result < 0;
+			}
+			return false;
+		}
+
+	private:
+		static int compare(const SortKey& key, int a, int b) {
+			int result = 0;
+			switch (key.mode) {
+				case AbstractColumn::Numeric: {
+					const double x = key.values.at(a);
+					const double y = key.values.at(b);
+					if (x < y)
+						result = -1;
+					else if (x > y)
+						result = 1;
+					else {
+						// NaNs are always sorted to the end, independent of the sort order
+						const bool nanX = std::isnan(x);
+						if (nanX != std::isnan(y))
+							return nanX ? 1 : -1;
+					}
+					break;
+				}
+				case AbstractColumn::Text: {
+					const QString& x = key.texts.at(a);
+					const QString& y = key.texts.at(b);
+					if (x < y)
+						result = -1;
+					else if (y < x)
+						result = 1;
+					break;
+				}
+				case AbstractColumn::DateTime:
+				case AbstractColumn::Month:
+				case AbstractColumn::Day: {
+					const qint64 x = key.dateTimes.at(a);
+					const qint64 y = key.dateTimes.at(b);
+					if (x < y)
+						result = -1;
+					else if (x > y)
+						result = 1;
+					break;
+				}
+			}
+
+			return key.ascending ? result : -result;
+		}
+
+		const QVector<SortKey>& m_keys;
+};
+
+class SortRowsTask : public QRunnable {
+	public:
+		SortRowsTask(int* first, int* last, const RowLess& less) : m_first(first), m_last(last), m_less(less) {}
+
+		void run() {
+			std::stable_sort(m_first, m_last, m_less);
+		}
+
+	private:
+		int* m_first;
+		int* m_last;
+		RowLess m_less;
+};
+
+class MergeRowsTask : public QRunnable {
+	public:
+		MergeRowsTask(const int* first, const int* middle, const int* last, int* dest, const RowLess& less)
+			: m_first(first), m_middle(middle), m_last(last), m_dest(dest), m_less(less) {}
+
+		void run() {
+			// std::merge takes equal elements from the first range first -> stable
+			std::merge(m_first, m_middle, m_middle, m_last, m_dest, m_less);
+		}
+
+	private:
+		const int* m_first;
+		const int* m_middle;
+		const int* m_last;
+		int* m_dest;
+		RowLess m_less;
+};
+
+SortKey sortKey(const Column* col, int rows, bool ascending) {
+	SortKey key;
+	key.mode = col->columnMode();
+	key.ascending = ascending;
+
+	switch (key.mode) {
+		case AbstractColumn::Numeric:
+			// implicitly shared, no copy is made as long as the column has enough rows
+			key.values = *static_cast<QVector<double>* >(col->data());
+			if (key.values.size() < rows)
+				key.values.insert(key.values.size(), rows - key.values.size(), NAN);
+			break;
+		case AbstractColumn::Text:
+			key.texts = *static_cast<QStringList*>(col->data());
+			while (key.texts.size() < rows)
+				key.texts << QString();
+			break;
+		case AbstractColumn::DateTime:
+		case AbstractColumn::Month:
+		case AbstractColumn::Day: {
+			const QList<QDateTime>* data = static_cast<QList<QDateTime>* >(col->data());
+			key.dateTimes.resize(rows);
+			const qint64 invalid = std::numeric_limits<qint64>::min();
+			for (int i = 0; i < rows; ++i) {
+				if (i < data->size() && data->at(i).isValid())
+					key.dateTimes[i] = data->at(i).toMSecsSinceEpoch();
+				else
+					key.dateTimes[i] = invalid;
+			}
+			break;
+		}
+	}
+
+	return key;
+}
+
+/*!
+ * determines the permutation sorting the rows according to the key columns \c keys.
+ * The first key has the highest priority, the following keys are only used to sort rows with equal values in the previous keys.
+ * The rows are sorted stably in parallel chunks that are merged pairwise afterwards.
+ */
+QVector<int> sortPermutation(const QList<Column*>& keyColumns, const QList<bool>& ascending) {
+	int rows = 0;
+	foreach (const Column* col, keyColumns)
+		rows = qMax(rows, col->rowCount());
+
+	QVector<SortKey> keys;
+	for (int i = 0; i < keyColumns.size(); ++i)
+		keys << sortKey(keyColumns.at(i), rows, i < ascending.size() ? ascending.at(i) : true);
+
+	QVector<int> permutation(rows);
+	for (int i = 0; i < rows; ++i)
+		permutation[i] = i;
+
+	const RowLess less(keys);
+	QThreadPool pool;
+	const int minChunkSize = 50000;
+	const int chunks = qMin(pool.maxThreadCount(), rows/minChunkSize);
+	if (chunks < 2) {
+		std::stable_sort(permutation.begin(), permutation.end(), less);
+		return permutation;
+	}
+
+	// sort the chunks
+	QVector<int> bounds;
+	for (int i = 0; i <= chunks; ++i)
+		bounds << (int)((qint64)rows*i/chunks);
+
+	int* data = permutation.data();
+	for (int i = 0; i < chunks; ++i)
+		pool.start(new SortRowsTask(data + bounds.at(i), data + bounds.at(i+1), less));
+	pool.waitForDone();
+
+	// merge neighbouring chunks until only one sorted range is left
+	QVector<int> buffer(rows);
+	int* src = data;
+	int* dest = buffer.data();
+	while (bounds.size() > 2) {
+		QVector<int> newBounds;
+		int i = 0;
+		for (; i + 2 < bounds.size(); i += 2) {
+			pool.start(new MergeRowsTask(src + bounds.at(i), src + bounds.at(i+1), src + bounds.at(i+2), dest + bounds.at(i), less));
+			newBounds << bounds.at(i);
+		}
+		if (i + 1 < bounds.size()) { // odd number of ranges, the last one is moved unchanged
+			std::copy(src + bounds.at(i), src + bounds.at(i+1), dest + bounds.at(i));
+			newBounds << bounds.at(i);
+		}
+		newBounds << rows;
+		pool.waitForDone();
+
+		bounds = newBounds;
+		std::swap(src, dest);
+	}
+
+	if (src != data)
+		return buffer;
+
+	return permutation;
+}
+
+bool isIdentity(const QVector<int>& permutation) {
+	for (int i = 0; i < permutation.size(); ++i) {
+		if (permutation.at(i) != i)
+			return false;
+	}
+	return true;
+}
+
+}
+
 /*! Sorts the given list of column.
   If 'leading' is a null pointer, each column is sorted separately.
 */
@@ -437,229 +681,939 @@ void Spreadsheet::sortColumns(Column *leading, QList<Column*> cols, bool ascendi
 {
 	if(cols.isEmpty()) return;
 
-	// the normal QPair comparison does not work properly with descending sorting
-	// thefore we use our own compare functions
-	class CompareFunctions {
-		public:
-			static bool doubleLess(const QPair<double, int>& a, const QPair<double, int>& b)
-			{
-				return a.first < b.first;
-			}
-			static bool doubleGreater(const QPair<double, int>& a, const QPair<double, int>& b)
-			{
-				return a.first > b.first;
-			}
-			static bool QStringLess(const QPair<QString, int>& a, const QPair<QString, int>& b)
-			{
-				return a < b;
+	if (leading) {
+		sortColumns(QList<Column*>() << leading, QList<bool>() << ascending, cols);
+		return;
+	}
+
+	// sort separately
+	WAIT_CURSOR;
+	beginMacro(i18n("%1: sort columns", name()));
+	foreach(Column* col, cols) {
+		const QVector<int> permutation = sortPermutation(QList<Column*>() << col, QList<bool>() << ascending);
+		if (!isIdentity(permutation))
+			col->permuteRows(permutation);
+	}
+	endMacro();
+	RESET_CURSOR;
+}
+
+/*! Sorts the columns \c cols together according to the values in the key columns \c keys.
+  The first key column has the highest priority, \c ascending contains the sort order for each key column.
+  The permutation is determined once and applied to all columns, the undo stack only stores the permutation.
+*/
+void Spreadsheet::sortColumns(const QList<Column*>& keys, const QList<bool>& ascending, QList<Column*> cols)
+{
+	if(cols.isEmpty() || keys.isEmpty()) return;
+
+	WAIT_CURSOR;
+	beginMacro(i18n("%1: sort columns", name()));
+	const QVector<int> permutation = sortPermutation(keys, ascending);
+	if (!isIdentity(permutation)) {
+		foreach(Column* col, cols)
+			col->permuteRows(permutation);
+	}
+	endMacro();
+	RESET_CURSOR;
+} // end of sortColumns()
+
+//##############################################################################
+//##############################  Grouping  ####################################
+//##############################################################################
+namespace {
+
+const qint64 missingKey = std::numeric_limits<qint64>::min();
+
+/*!
+ * one key column of a group-by operation. Every value is mapped to a 64-bit code
+ * with equal codes for equal values: numeric values by their bit pattern, date-time values
+ * by the milliseconds since epoch and texts by the index in the list of distinct texts.
+ */
+struct GroupKeyColumn {
+	AbstractColumn::ColumnMode mode;
+	const Column* column;
+	QVector<int> textIds; // -1 for empty texts
+
+	qint64 code(int row) const {
+		switch (mode) {
+			case AbstractColumn::Numeric: {
+				const QVector<double>* data = static_cast<QVector<double>* >(column->data());
+				if (row >= data->size())
+					return missingKey;
+				const double value = data->at(row);
+				if (std::isnan(value))
+					return missingKey;
+				if (value == 0.0) // -0.0 and 0.0 are the same group
+					return 0;
+				qint64 code;
+				memcpy(&code, &value, sizeof(code));
+				return code;
 			}
-			static bool QStringGreater(const QPair<QString, int>& a, const QPair<QString, int>& b)
-			{
-				return a > b;
+			case AbstractColumn::Text:
+				return (row < textIds.size() && textIds.at(row) != -1) ? textIds.at(row) : missingKey;
+			case AbstractColumn::DateTime:
+			case AbstractColumn::Month:
+			case AbstractColumn::Day: {
+				const QList<QDateTime>* data = static_cast<QList<QDateTime>* >(column->data());
+				if (row >= data->size() || !data->at(row).isValid())
+					return missingKey;
+				return data->at(row).toMSecsSinceEpoch();
 			}
-			static bool QDateTimeLess(const QPair<QDateTime, int>& a, const QPair<QDateTime, int>& b)
-			{
-				return a < b;
+		}
+		return missingKey;
+	}
+};
+
+/*!
+ * creates the key column for \c col. Texts are mapped to the indices in \c ids, new texts are added to \c ids.
+ * Columns whose keys are compared with each other have to use the same \c ids.
+ */
+GroupKeyColumn groupKeyColumn(const Column* col, QHash<QString, int>& ids) {
+	GroupKeyColumn key;
+	key.mode = col->columnMode();
+	key.column = col;
+	if (key.mode == AbstractColumn::Text) {
+		const QStringList* data = static_cast<QStringList*>(col->data());
+		key.textIds.resize(data->size());
+		for (int i = 0; i < data->size(); ++i) {
+			const QString& text = data->at(i);
+			if (text.isEmpty()) {
+				key.textIds[i] = -1;
+				continue;
 			}
-			static bool QDateTimeGreater(const QPair<QDateTime, int>& a, const QPair<QDateTime, int>& b)
-			{
-				return a > b;
+			QHash<QString, int>::const_iterator it = ids.constFind(text);
+			if (it == ids.constEnd())
+				it = ids.insert(text, ids.size());
+			key.textIds[i] = it.value();
+		}
+	}
+	return key;
+}
+
+struct GroupKey {
+	QVector<qint64> codes;
+
+	bool operator==(const GroupKey& other) const {
+		return codes == other.codes;
+	}
+};
+
+uint qHash(const GroupKey& key) {
+	uint h = 0;
+	foreach (qint64 code, key.codes)
+		h = 31*h ^ ::qHash((quint64)code);
+	return h;
+}
+
+/*!
+ * determines the key of the row \c row. Returns \c false if the row is masked in one of the key columns
+ * or if all key values are missing, such rows are not part of any group.
+ */
+bool groupKey(const QVector<GroupKeyColumn>& keys, int row, GroupKey& key) {
+	bool valid = false;
+	for (int k = 0; k < keys.size(); ++k) {
+		const GroupKeyColumn& keyColumn = keys.at(k);
+		if (keyColumn.column->isMasked(row))
+			return false;
+		key.codes[k] = keyColumn.code(row);
+		if (key.codes.at(k) != missingKey)
+			valid = true;
+	}
+	return valid;
+}
+
+typedef bool (*KeyFunction)(const QVector<GroupKeyColumn>&, int row, GroupKey&);
+
+/*!
+ * assigns the rows from \c first to \c last (exclusive) to the partitions by the hash of their keys.
+ * Rows for which \c keyFunction returns \c false get the partition \c invalid.
+ */
+class PartitionRowsTask : public QRunnable {
+	public:
+		PartitionRowsTask(const QVector<GroupKeyColumn>& keys, KeyFunction keyFunction, int first, int last, int partitions, uchar* partition)
+			: m_keys(keys), m_keyFunction(keyFunction), m_first(first), m_last(last), m_partitions(partitions), m_partition(partition) {}
+
+		static const uchar invalid = 255;
+
+		void run() {
+			GroupKey key;
+			key.codes.resize(m_keys.size());
+			for (int row = m_first; row < m_last; ++row) {
+				if (m_keyFunction(m_keys, row, key))
+					m_partition[row] = qHash(key) % m_partitions;
+				else
+					m_partition[row] = invalid;
 			}
-	};
+		}
 
-	WAIT_CURSOR;
-	beginMacro(i18n("%1: sort columns", name()));
+	private:
+		const QVector<GroupKeyColumn>& m_keys;
+		KeyFunction m_keyFunction;
+		int m_first;
+		int m_last;
+		int m_partitions;
+		uchar* m_partition;
+};
 
-	if(leading == 0) { // sort separately
-		foreach(Column *col, cols) {
-			switch (col->columnMode()) {
-				case AbstractColumn::Numeric:
-					{
-						int rows = col->rowCount();
-						QList< QPair<double, int> > map;
-
-						for(int j=0; j<rows; j++)
-							map.append(QPair<double, int>(col->valueAt(j), j));
-
-						if(ascending)
-							qStableSort(map.begin(), map.end(), CompareFunctions::doubleLess);
-						else
-							qStableSort(map.begin(), map.end(), CompareFunctions::doubleGreater);
-
-						QListIterator< QPair<double, int> > it(map);
-						Column *temp_col = new Column("temp", col->columnMode());
-
-						int k=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, k, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							k++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
-						break;
-					}
-				case AbstractColumn::Text:
-					{
-						int rows = col->rowCount();
-						QList< QPair<QString, int> > map;
-
-						for(int j=0; j<rows; j++)
-							map.append(QPair<QString, int>(col->textAt(j), j));
-
-						if(ascending)
-							qStableSort(map.begin(), map.end(), CompareFunctions::QStringLess);
-						else
-							qStableSort(map.begin(), map.end(), CompareFunctions::QStringGreater);
-
-						QListIterator< QPair<QString, int> > it(map);
-						Column *temp_col = new Column("temp", col->columnMode());
-
-						int k=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, k, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							k++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
-						break;
+/*!
+ * returns the number of hash partitions for \c rows rows. There are at least as many partitions as threads,
+ * for large data sets the number of partitions grows with the number of rows to limit the size of the partitions.
+ */
+int partitionCount(int rows) {
+	const int maxPartitionRows = 1 << 22;
+	const int threads = QThreadPool::globalInstance()->maxThreadCount();
+	return qBound(1, qMax(threads, rows/maxPartitionRows + 1), (int)PartitionRowsTask::invalid);
+}
+
+/*!
+ * rows of all partitions in one array. The rows of the partition \c p are \c rows[start[p]] to \c rows[start[p+1]-1]
+ * in ascending order.
+ */
+struct PartitionedRows {
+	QVector<int> rows;
+	QVector<int> start;
+};
+
+/*!
+ * distributes the first \c rows rows to \c partitions partitions. The partitions are determined in parallel,
+ * the rows are then counted per partition and collected in one exactly sized array in ascending order.
+ * Rows without a valid key are not part of any partition.
+ */
+PartitionedRows partitionRows(const QVector<GroupKeyColumn>& keys, KeyFunction keyFunction, int rows, int partitions) {
+	QVector<uchar> partition(rows);
+	QThreadPool pool;
+	const int chunks = qMax(1, qMin(pool.maxThreadCount(), rows/50000));
+	for (int i = 0; i < chunks; ++i) {
+		const int first = (int)((qint64)rows*i/chunks);
+		const int last = (int)((qint64)rows*(i+1)/chunks);
+		pool.start(new PartitionRowsTask(keys, keyFunction, first, last, partitions, partition.data()));
+	}
+	pool.waitForDone();
+
+	PartitionedRows result;
+	result.start.fill(0, partitions + 1);
+	const uchar* p = partition.constData();
+	for (int row = 0; row < rows; ++row) {
+		if (p[row] != PartitionRowsTask::invalid)
+			++result.start[p[row] + 1];
+	}
+	for (int i = 0; i < partitions; ++i)
+		result.start[i + 1] += result.start[i];
+
+	result.rows.resize(result.start.last());
+	QVector<int> pos = result.start;
+	int* r = result.rows.data();
+	for (int row = 0; row < rows; ++row) {
+		if (p[row] != PartitionRowsTask::invalid)
+			r[pos[p[row]]++] = row;
+	}
+	return result;
+}
+
+/*!
+ * groups of one partition. For every group the first row and the number of rows are stored,
+ * \c values contains the aggregated values for every pair of value column and aggregation.
+ */
+struct GroupResult {
+	QVector<int> firstRows;
+	QVector<int> counts;
+	QVector<QVector<double> > values;
+};
+
+/*!
+ * calculates the aggregations of the valid values \c data of one group on demand.
+ * Only the requested aggregations are calculated, the mean, the median and the variance
+ * are calculated at most once. \c data is sorted in place if needed.
+ */
+class GroupAggregator {
+	public:
+		explicit GroupAggregator(QVector<double>& data) : m_data(data), m_n(data.size()), m_sorted(false),
+			m_mean(NAN), m_median(NAN), m_variance(NAN) {}
+
+		double value(Spreadsheet::Aggregation aggregation) {
+			if (aggregation == Spreadsheet::Count)
+				return m_n;
+			if (m_n == 0)
+				return NAN;
+
+			switch (aggregation) {
+				case Spreadsheet::Count:
+					break;
+				case Spreadsheet::Minimum:
+					return m_sorted ? m_data.first() : *std::min_element(m_data.constBegin(), m_data.constEnd());
+				case Spreadsheet::Maximum:
+					return m_sorted ? m_data.last() : *std::max_element(m_data.constBegin(), m_data.constEnd());
+				case Spreadsheet::ArithmeticMean:
+					return mean();
+				case Spreadsheet::GeometricMean: {
+					double product = 1.0;
+					foreach (double value, m_data)
+						product *= value;
+					return pow(product, 1.0/m_n);
+				}
+				case Spreadsheet::HarmonicMean: {
+					double sum = 0.0;
+					foreach (double value, m_data)
+						sum += 1.0/value;
+					return m_n/sum;
+				}
+				case Spreadsheet::ContraharmonicMean: {
+					double sum = 0.0, sumSquare = 0.0;
+					foreach (double value, m_data) {
+						sum += value;
+						sumSquare += value*value;
 					}
-				case AbstractColumn::DateTime:
-				case AbstractColumn::Month:
-				case AbstractColumn::Day:
-					{
-						int rows = col->rowCount();
-						QList< QPair<QDateTime, int> > map;
-
-						for(int j=0; j<rows; j++)
-							map.append(QPair<QDateTime, int>(col->dateTimeAt(j), j));
-
-						if(ascending)
-							qStableSort(map.begin(), map.end(), CompareFunctions::QDateTimeLess);
-						else
-							qStableSort(map.begin(), map.end(), CompareFunctions::QDateTimeGreater);
-
-						QListIterator< QPair<QDateTime, int> > it(map);
-						Column *temp_col = new Column("temp", col->columnMode());
-
-						int k=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, k, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							k++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
-						break;
+					return sumSquare/sum;
+				}
+				case Spreadsheet::Median:
+					return median();
+				case Spreadsheet::Variance:
+					return variance();
+				case Spreadsheet::StandardDeviation:
+					return sqrt(variance());
+				case Spreadsheet::MeanDeviation:
+					return meanAbsoluteDeviation(mean());
+				case Spreadsheet::MeanDeviationAroundMedian:
+					return meanAbsoluteDeviation(median());
+				case Spreadsheet::MedianDeviation: {
+					const double center = median();
+					QVector<double> deviations(m_n);
+					for (int i = 0; i < m_n; ++i)
+						deviations[i] = fabs(m_data.at(i) - center);
+					std::sort(deviations.begin(), deviations.end());
+					return middle(deviations);
+				}
+				case Spreadsheet::Skewness:
+					return centralMoment(3)/pow(variance(), 1.5);
+				case Spreadsheet::Kurtosis:
+					return centralMoment(4)/(variance()*variance()) - 3.0;
+				case Spreadsheet::Entropy: {
+					// equal values are adjacent in the sorted data
+					sort();
+					double entropy = 0.0;
+					for (int i = 0; i < m_n;) {
+						int j = i + 1;
+						while (j < m_n && m_data.at(j) == m_data.at(i))
+							++j;
+						const double frequency = (double)(j - i)/m_n;
+						entropy -= frequency*log2(frequency);
+						i = j;
 					}
+					return entropy;
+				}
 			}
+			return NAN;
 		}
-	} else { // sort with leading column
-		switch (leading->columnMode()) {
-			case AbstractColumn::Numeric:
-				{
-					QList< QPair<double, int> > map;
-					int rows = leading->rowCount();
-
-					for(int i=0; i<rows; i++)
-						map.append(QPair<double, int>(leading->valueAt(i), i));
-
-					if(ascending)
-						qStableSort(map.begin(), map.end(), CompareFunctions::doubleLess);
-					else
-						qStableSort(map.begin(), map.end(), CompareFunctions::doubleGreater);
-					QListIterator< QPair<double, int> > it(map);
-
-					foreach (Column *col, cols) {
-						Column *temp_col = new Column("temp", col->columnMode());
-						it.toFront();
-						int j=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, j, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							j++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
+
+	private:
+		void sort() {
+			if (!m_sorted) {
+				std::sort(m_data.begin(), m_data.end());
+				m_sorted = true;
+			}
+		}
+
+		static double middle(const QVector<double>& sorted) {
+			const int n = sorted.size();
+			return (n%2) ? sorted.at((n-1)/2) : (sorted.at((n-1)/2) + sorted.at(n/2))/2.0;
+		}
+
+		double mean() {
+			if (std::isnan(m_mean)) {
+				double sum = 0.0;
+				foreach (double value, m_data)
+					sum += value;
+				m_mean = sum/m_n;
+			}
+			return m_mean;
+		}
+
+		double median() {
+			if (std::isnan(m_median)) {
+				sort();
+				m_median = middle(m_data);
+			}
+			return m_median;
+		}
+
+		double variance() {
+			if (std::isnan(m_variance))
+				m_variance = centralMoment(2);
+			return m_variance;
+		}
+
+		double centralMoment(int r) {
+			const double m = mean();
+			double sum = 0.0;
+			foreach (double value, m_data)
+				sum += pow(value - m, r);
+			return sum/m_n;
+		}
+
+		double meanAbsoluteDeviation(double center) const {
+			double sum = 0.0;
+			foreach (double value, m_data)
+				sum += fabs(value - center);
+			return sum/m_n;
+		}
+
+		QVector<double>& m_data;
+		const int m_n;
+		bool m_sorted;
+		double m_mean;
+		double m_median;
+		double m_variance;
+};
+
+/*!
+ * builds the groups of the \c count rows \c rows of one partition with a hash table and aggregates the values of every group.
+ * The rows are ordered by their group with a counting sort, the memory needed is proportional to the size of the partition.
+ */
+class GroupPartitionTask : public QRunnable {
+	public:
+		GroupPartitionTask(const QVector<GroupKeyColumn>& keys, const int* rows, int count,
+		                   const QList<Column*>& values, const QList<Spreadsheet::Aggregation>& aggregations, GroupResult& result)
+			: m_keys(keys), m_rows(rows), m_count(count), m_values(values), m_aggregations(aggregations), m_result(result) {}
+
+		void run() {
+			QHash<GroupKey, int> index;
+			QVector<int> groupOf(m_count);
+			QVector<int> start(1, 0); // number of rows per group, converted to the start of the groups below
+			GroupKey key;
+			key.codes.resize(m_keys.size());
+
+			for (int i = 0; i < m_count; ++i) {
+				groupKey(m_keys, m_rows[i], key);
+				QHash<GroupKey, int>::const_iterator it = index.constFind(key);
+				int group;
+				if (it == index.constEnd()) {
+					group = start.size() - 1;
+					index.insert(key, group);
+					start << 0;
+				} else
+					group = it.value();
+				groupOf[i] = group;
+				++start[group + 1];
+			}
+			index.clear();
+
+			// order the rows by their group, the rows of every group stay in ascending order
+			const int groups = start.size() - 1;
+			for (int g = 0; g < groups; ++g)
+				start[g + 1] += start[g];
+			QVector<int> groupRows(m_count);
+			QVector<int> pos = start;
+			for (int i = 0; i < m_count; ++i)
+				groupRows[pos[groupOf.at(i)]++] = m_rows[i];
+			groupOf = QVector<int>();
+			pos = QVector<int>();
+
+			m_result.firstRows.resize(groups);
+			m_result.counts.resize(groups);
+			m_result.values.resize(m_values.size()*m_aggregations.size());
+			for (int i = 0; i < m_result.values.size(); ++i)
+				m_result.values[i].resize(groups);
+
+			QVector<double> rowData;
+			for (int g = 0; g < groups; ++g) {
+				const int first = start.at(g);
+				const int last = start.at(g + 1);
+				m_result.firstRows[g] = groupRows.at(first);
+				m_result.counts[g] = last - first;
+
+				for (int v = 0; v < m_values.size(); ++v) {
+					const Column* col = m_values.at(v);
+					const QVector<double>* data = static_cast<QVector<double>* >(col->data());
+					rowData.clear();
+					for (int i = first; i < last; ++i) {
+						const int row = groupRows.at(i);
+						if (row >= data->size())
+							continue;
+						const double value = data->at(row);
+						if (!std::isnan(value) && !col->isMasked(row))
+							rowData << value;
 					}
-					break;
+
+					GroupAggregator aggregator(rowData);
+					for (int a = 0; a < m_aggregations.size(); ++a)
+						m_result.values[v*m_aggregations.size() + a][g] = aggregator.value(m_aggregations.at(a));
 				}
-			case AbstractColumn::Text:
-				{
-					QList< QPair<QString, int> > map;
-					int rows = leading->rowCount();
-
-					for(int i=0; i<rows; i++)
-						map.append(QPair<QString, int>(leading->textAt(i), i));
-
-					if(ascending)
-						qStableSort(map.begin(), map.end(), CompareFunctions::QStringLess);
-					else
-						qStableSort(map.begin(), map.end(), CompareFunctions::QStringGreater);
-					QListIterator< QPair<QString, int> > it(map);
-
-					foreach (Column *col, cols) {
-						Column *temp_col = new Column("temp", col->columnMode());
-						it.toFront();
-						int j=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, j, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							j++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
+			}
+		}
+
+	private:
+		const QVector<GroupKeyColumn>& m_keys;
+		const int* m_rows;
+		const int m_count;
+		const QList<Column*>& m_values;
+		const QList<Spreadsheet::Aggregation>& m_aggregations;
+		GroupResult& m_result;
+};
+
+/*!
+ * creates a column with the name \c name containing the values of \c source in the rows \c rows.
+ */
+Column* gatherColumn(const Column* source, const QVector<int>& rows, const QString& name) {
+	Column* col = new Column(name, source->columnMode());
+	switch (source->columnMode()) {
+		case AbstractColumn::Numeric: {
+			const QVector<double>* data = static_cast<QVector<double>* >(source->data());
+			QVector<double> values(rows.size());
+			for (int i = 0; i < rows.size(); ++i) {
+				const int row = rows.at(i);
+				values[i] = (row >= 0 && row < data->size()) ? data->at(row) : NAN;
+			}
+			col->replaceValues(0, values);
+			break;
+		}
+		case AbstractColumn::Text: {
+			const QStringList* data = static_cast<QStringList*>(source->data());
+			QStringList texts;
+			texts.reserve(rows.size());
+			foreach (int row, rows)
+				texts << ((row >= 0 && row < data->size()) ? data->at(row) : QString());
+			col->replaceTexts(0, texts);
+			break;
+		}
+		case AbstractColumn::DateTime:
+		case AbstractColumn::Month:
+		case AbstractColumn::Day: {
+			const QList<QDateTime>* data = static_cast<QList<QDateTime>* >(source->data());
+			QList<QDateTime> dateTimes;
+			dateTimes.reserve(rows.size());
+			foreach (int row, rows)
+				dateTimes << ((row >= 0 && row < data->size()) ? data->at(row) : QDateTime());
+			col->replaceDateTimes(0, dateTimes);
+			break;
+		}
+	}
+	return col;
+}
+
+}
+
+/*!
+  returns the name of the aggregation \c aggregation used in the names of the aggregated columns.
+*/
+QString Spreadsheet::aggregationName(Aggregation aggregation) {
+	switch (aggregation) {
+		case Spreadsheet::Count:
+			return i18n("count");
+		case Spreadsheet::Minimum:
+			return i18n("min");
+		case Spreadsheet::Maximum:
+			return i18n("max");
+		case Spreadsheet::ArithmeticMean:
+			return i18n("mean");
+		case Spreadsheet::GeometricMean:
+			return i18n("geometric mean");
+		case Spreadsheet::HarmonicMean:
+			return i18n("harmonic mean");
+		case Spreadsheet::ContraharmonicMean:
+			return i18n("contraharmonic mean");
+		case Spreadsheet::Median:
+			return i18n("median");
+		case Spreadsheet::Variance:
+			return i18n("variance");
+		case Spreadsheet::StandardDeviation:
+			return i18n("standard deviation");
+		case Spreadsheet::MeanDeviation:
+			return i18n("mean deviation");
+		case Spreadsheet::MeanDeviationAroundMedian:
+			return i18n("mean deviation around median");
+		case Spreadsheet::MedianDeviation:
+			return i18n("median deviation");
+		case Spreadsheet::Skewness:
+			return i18n("skewness");
+		case Spreadsheet::Kurtosis:
+			return i18n("kurtosis");
+		case Spreadsheet::Entropy:
+			return i18n("entropy");
+	}
+	return QString();
+}
+
+/*!
+  groups the rows by the values in the key columns \c keys and aggregates the numeric columns \c values
+  in every group with the statistics \c aggregations. Rows masked in one of the key columns and rows
+  without any key value are ignored, masked and missing values are not part of the statistics.
+
+  The result is written to a new spreadsheet in the same folder containing the key columns,
+  the number of rows in every group and one column for every pair of value column and aggregation.
+  The groups are ordered by their first occurrence.
+
+  The rows are distributed by the hash of their keys to partitions in one pass. The partitions are aggregated
+  in parallel with one hash table per partition. The number of partitions grows with the number of rows
+  to limit the size of the hash tables. Only the requested aggregations are calculated for every group.
+  Besides the hash tables, the partitioning needs one byte and one row index per row. Every running partition
+  task needs two more row indices per row of its partition.
+*/
+Spreadsheet* Spreadsheet::groupBy(const QList<Column*>& keys, const QList<Column*>& values, const QList<Aggregation>& aggregations) {
+	if (keys.isEmpty())
+		return 0;
+
+	WAIT_CURSOR;
+
+	int rows = 0;
+	QVector<GroupKeyColumn> keyColumns;
+	foreach (const Column* col, keys) {
+		rows = qMax(rows, col->rowCount());
+		QHash<QString, int> ids;
+		keyColumns << groupKeyColumn(col, ids);
+	}
+
+	QList<Column*> valueColumns;
+	foreach (Column* col, values) {
+		if (col->columnMode() == AbstractColumn::Numeric)
+			valueColumns << col;
+	}
+
+	// partition the rows
+	const int partitions = partitionCount(rows);
+	PartitionedRows partitionedRows = partitionRows(keyColumns, groupKey, rows, partitions);
+
+	// aggregate the partitions
+	QThreadPool pool;
+	QVector<GroupResult> results(partitions);
+	const int* partitionRowData = partitionedRows.rows.constData();
+	for (int p = 0; p < partitions; ++p) {
+		const int first = partitionedRows.start.at(p);
+		pool.start(new GroupPartitionTask(keyColumns, partitionRowData + first, partitionedRows.start.at(p + 1) - first,
+		                                  valueColumns, aggregations, results[p]));
+	}
+	pool.waitForDone();
+	partitionedRows = PartitionedRows();
+
+	// order the groups of all partitions by their first row
+	QVector<QPair<int, QPair<int, int> > > order;
+	for (int p = 0; p < partitions; ++p) {
+		const GroupResult& result = results.at(p);
+		for (int g = 0; g < result.firstRows.size(); ++g)
+			order << qMakePair(result.firstRows.at(g), qMakePair(p, g));
+	}
+	std::sort(order.begin(), order.end());
+
+	const int groups = order.size();
+	QVector<int> firstRows(groups);
+	QVector<double> counts(groups);
+	QVector<QVector<double> > aggregated(valueColumns.size()*aggregations.size(), QVector<double>(groups));
+	for (int i = 0; i < groups; ++i) {
+		const GroupResult& result = results.at(order.at(i).second.first);
+		const int g = order.at(i).second.second;
+		firstRows[i] = result.firstRows.at(g);
+		counts[i] = result.counts.at(g);
+		for (int j = 0; j < aggregated.size(); ++j)
+			aggregated[j][i] = result.values.at(j).at(g);
+	}
+	results.clear();
+
+	// create the resulting spreadsheet
+	Spreadsheet* spreadsheet = new Spreadsheet(0, i18n("%1 grouped", name()), true);
+	for (int k = 0; k < keys.size(); ++k) {
+		Column* col = gatherColumn(keys.at(k), firstRows, keys.at(k)->name());
+		col->setPlotDesignation(k == 0 ? AbstractColumn::X : AbstractColumn::noDesignation);
+		spreadsheet->addChild(col);
+	}
+
+	Column* countColumn = new Column(i18n("count"), AbstractColumn::Numeric);
+	countColumn->replaceValues(0, counts);
+	spreadsheet->addChild(countColumn);
+
+	for (int v = 0; v < valueColumns.size(); ++v) {
+		for (int a = 0; a < aggregations.size(); ++a) {
+			Column* col = new Column(valueColumns.at(v)->name() + ' ' + aggregationName(aggregations.at(a)), AbstractColumn::Numeric);
+			col->replaceValues(0, aggregated.at(v*aggregations.size() + a));
+			col->setPlotDesignation(AbstractColumn::Y);
+			spreadsheet->addChild(col);
+		}
+	}
+
+	if (folder())
+		folder()->addChild(spreadsheet);
+
+	RESET_CURSOR;
+	return spreadsheet;
+}
+
+//##############################################################################
+//##############################  Joining  #####################################
+//##############################################################################
+namespace {
+
+/*!
+ * determines the join key of the row \c row. Returns \c false if one of the key values is missing,
+ * rows with missing keys don't match any other row.
+ */
+bool joinKey(const QVector<GroupKeyColumn>& keys, int row, GroupKey& key) {
+	for (int k = 0; k < keys.size(); ++k) {
+		const GroupKeyColumn& keyColumn = keys.at(k);
+		if (keyColumn.column->isMasked(row))
+			return false;
+		key.codes[k] = keyColumn.code(row);
+		if (key.codes.at(k) == missingKey)
+			return false;
+	}
+	return true;
+}
+
+// rows of the right spreadsheet for every key, in the order of the rows or of the time stamps for as-of joins
+typedef QHash<GroupKey, QVector<int> > JoinTable;
+
+class TimeStampLess {
+	public:
+		explicit TimeStampLess(const GroupKeyColumn& timeStamps) : m_timeStamps(timeStamps) {}
+
+		bool operator()(int a, int b) const {
+			return m_timeStamps.code(a) < m_timeStamps.code(b);
+		}
+
+		bool operator()(qint64 timeStamp, int row) const {
+			return timeStamp < m_timeStamps.code(row);
+		}
+
+	private:
+		const GroupKeyColumn& m_timeStamps;
+};
+
+/*!
+ * builds the hash table for one partition of the right spreadsheet.
+ */
+class BuildJoinTableTask : public QRunnable {
+	public:
+		BuildJoinTableTask(const QVector<GroupKeyColumn>& keys, const GroupKeyColumn* timeStamps,
+		                   const int* rows, int count, JoinTable& table)
+			: m_keys(keys), m_timeStamps(timeStamps), m_rows(rows), m_count(count), m_table(table) {}
+
+		void run() {
+			GroupKey key;
+			key.codes.resize(m_keys.size());
+			for (int i = 0; i < m_count; ++i) {
+				const int row = m_rows[i];
+				if (m_timeStamps && (m_timeStamps->column->isMasked(row) || m_timeStamps->code(row) == missingKey))
+					continue;
+
+				if (joinKey(m_keys, row, key))
+					m_table[key] << row;
+			}
+
+			if (m_timeStamps) {
+				const TimeStampLess less(*m_timeStamps);
+				for (JoinTable::iterator it = m_table.begin(); it != m_table.end(); ++it)
+					std::stable_sort(it.value().begin(), it.value().end(), less);
+			}
+		}
+
+	private:
+		const QVector<GroupKeyColumn>& m_keys;
+		const GroupKeyColumn* m_timeStamps;
+		const int* m_rows;
+		const int m_count;
+		JoinTable& m_table;
+};
+
+/*!
+ * looks up the matching right rows for the left rows from \c first to \c last (exclusive).
+ * The pairs of matching rows are stored in \c leftRows and \c rightRows, the right row is -1
+ * for left rows without a match in left and as-of joins. Rows masked in the key columns don't match
+ * any right row, they are skipped in inner joins only.
+ */
+class ProbeJoinTableTask : public QRunnable {
+	public:
+		ProbeJoinTableTask(const QVector<GroupKeyColumn>& keys, const GroupKeyColumn* timeStamps,
+		                   const GroupKeyColumn* rightTimeStamps, const QVector<JoinTable>& tables,
+		                   Spreadsheet::JoinType type, int first, int last, QVector<int>& leftRows, QVector<int>& rightRows)
+			: m_keys(keys), m_timeStamps(timeStamps), m_rightTimeStamps(rightTimeStamps), m_tables(tables),
+			  m_type(type), m_first(first), m_last(last), m_leftRows(leftRows), m_rightRows(rightRows) {}
+
+		void run() {
+			GroupKey key;
+			key.codes.resize(m_keys.size());
+			m_leftRows.reserve(m_last - m_first);
+			m_rightRows.reserve(m_last - m_first);
+
+			for (int row = m_first; row < m_last; ++row) {
+				if (masked(row)) {
+					if (m_type != Spreadsheet::InnerJoin) {
+						m_leftRows << row;
+						m_rightRows << -1;
 					}
-					break;
+					continue;
 				}
-			case AbstractColumn::DateTime:
-			case AbstractColumn::Month:
-			case AbstractColumn::Day:
-				{
-					QList< QPair<QDateTime, int> > map;
-					int rows = leading->rowCount();
-
-					for(int i=0; i<rows; i++)
-						map.append(QPair<QDateTime, int>(leading->dateTimeAt(i), i));
-
-					if(ascending)
-						qStableSort(map.begin(), map.end(), CompareFunctions::QDateTimeLess);
-					else
-						qStableSort(map.begin(), map.end(), CompareFunctions::QDateTimeGreater);
-					QListIterator< QPair<QDateTime, int> > it(map);
-
-					foreach (Column *col, cols) {
-						Column *temp_col = new Column("temp", col->columnMode());
-						it.toFront();
-						int j=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, j, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							j++;
+
+				const QVector<int>* matches = 0;
+				if (joinKey(m_keys, row, key)) {
+					const JoinTable& table = m_tables.at(qHash(key) % m_tables.size());
+					JoinTable::const_iterator it = table.constFind(key);
+					if (it != table.constEnd())
+						matches = &it.value();
+				}
+
+				if (m_type == Spreadsheet::AsOfJoin) {
+					// the row with the nearest time stamp, the earlier one for equal distances
+					int match = -1;
+					const qint64 timeStamp = m_timeStamps->code(row);
+					if (matches && timeStamp != missingKey) {
+						QVector<int>::const_iterator it = std::upper_bound(matches->constBegin(), matches->constEnd(),
+						                                                   timeStamp, TimeStampLess(*m_rightTimeStamps));
+						if (it != matches->constEnd())
+							match = *it;
+						if (it != matches->constBegin()) {
+							const int previous = *(it - 1);
+							if (match == -1 || timeStamp - m_rightTimeStamps->code(previous) <= m_rightTimeStamps->code(match) - timeStamp)
+								match = previous;
 						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
 					}
-					break;
+					m_leftRows << row;
+					m_rightRows << match;
+				} else if (matches) {
+					foreach (int match, *matches) {
+						m_leftRows << row;
+						m_rightRows << match;
+					}
+				} else if (m_type == Spreadsheet::LeftJoin) {
+					m_leftRows << row;
+					m_rightRows << -1;
 				}
+			}
 		}
+
+	private:
+		bool masked(int row) const {
+			foreach (const GroupKeyColumn& key, m_keys) {
+				if (key.column->isMasked(row))
+					return true;
+			}
+			return m_timeStamps && m_timeStamps->column->isMasked(row);
+		}
+
+		const QVector<GroupKeyColumn>& m_keys;
+		const GroupKeyColumn* m_timeStamps;
+		const GroupKeyColumn* m_rightTimeStamps;
+		const QVector<JoinTable>& m_tables;
+		Spreadsheet::JoinType m_type;
+		int m_first;
+		int m_last;
+		QVector<int>& m_leftRows;
+		QVector<int>& m_rightRows;
+};
+
+}
+
+/*!
+  joins the rows of this spreadsheet with the rows of the spreadsheet \c right having equal values
+  in the key columns \c keys and \c rightKeys, respectively. The key columns are compared pairwise
+  and need to have the same column mode.
+
+  For \c InnerJoin only pairs of matching rows are part of the result, for \c LeftJoin
+  the rows of this spreadsheet without a match are added with empty values for the right columns.
+  For \c AsOfJoin the last pair of key columns has to contain date-time values, every row is joined
+  with the right row having the nearest time stamp and equal values in the other key columns.
+  Rows masked in the key columns of this spreadsheet are part of the result of left and as-of joins
+  with empty values for the right columns.
+
+  The result is written to a new spreadsheet in the same folder containing all columns of this spreadsheet
+  followed by the columns of \c right except for the key columns used for the exact comparison.
+
+  The hash table is built in parallel for hash partitions of the right rows, the left rows
+  are looked up in parallel chunks. The columns of the result are filled with one gather per column.
+*/
+Spreadsheet* Spreadsheet::join(Spreadsheet* right, const QList<Column*>& keys, const QList<Column*>& rightKeys, JoinType type) {
+	if (!right || keys.isEmpty() || keys.size() != rightKeys.size())
+		return 0;
+
+	for (int k = 0; k < keys.size(); ++k) {
+		const AbstractColumn::ColumnMode mode = keys.at(k)->columnMode();
+		const AbstractColumn::ColumnMode rightMode = rightKeys.at(k)->columnMode();
+		const bool dateTime = (mode == AbstractColumn::DateTime || mode == AbstractColumn::Month || mode == AbstractColumn::Day);
+		const bool rightDateTime = (rightMode == AbstractColumn::DateTime || rightMode == AbstractColumn::Month
+		                            || rightMode == AbstractColumn::Day);
+		if (mode != rightMode && !(dateTime && rightDateTime))
+			return 0;
+		if (type == AsOfJoin && k == keys.size() - 1 && !dateTime)
+			return 0;
 	}
-	endMacro();
+
+	WAIT_CURSOR;
+
+	// the texts of both spreadsheets are mapped to the same ids
+	QHash<QString, int> ids;
+	QVector<GroupKeyColumn> keyColumns;
+	QVector<GroupKeyColumn> rightKeyColumns;
+	const int exactKeys = (type == AsOfJoin) ? keys.size() - 1 : keys.size();
+	for (int k = 0; k < exactKeys; ++k) {
+		keyColumns << groupKeyColumn(keys.at(k), ids);
+		rightKeyColumns << groupKeyColumn(rightKeys.at(k), ids);
+	}
+
+	GroupKeyColumn timeStamps;
+	GroupKeyColumn rightTimeStamps;
+	if (type == AsOfJoin) {
+		timeStamps = groupKeyColumn(keys.last(), ids);
+		rightTimeStamps = groupKeyColumn(rightKeys.last(), ids);
+	}
+
+	// build the hash tables for the partitions of the right rows
+	const int rightRowCount = right->rowCount();
+	const int partitions = partitionCount(rightRowCount);
+	PartitionedRows partitionedRows = partitionRows(rightKeyColumns, joinKey, rightRowCount, partitions);
+	QVector<JoinTable> tables(partitions);
+	QThreadPool pool;
+	const int* partitionRowData = partitionedRows.rows.constData();
+	for (int p = 0; p < partitions; ++p) {
+		const int first = partitionedRows.start.at(p);
+		pool.start(new BuildJoinTableTask(rightKeyColumns, (type == AsOfJoin) ? &rightTimeStamps : 0,
+		                                  partitionRowData + first, partitionedRows.start.at(p + 1) - first, tables[p]));
+	}
+	pool.waitForDone();
+	partitionedRows = PartitionedRows();
+
+	// look up the left rows in chunks
+	const int rows = rowCount();
+	const int chunks = qMax(1, qMin(pool.maxThreadCount(), rows/50000));
+	QVector<QVector<int> > chunkLeftRows(chunks);
+	QVector<QVector<int> > chunkRightRows(chunks);
+	for (int i = 0; i < chunks; ++i) {
+		const int first = (int)((qint64)rows*i/chunks);
+		const int last = (int)((qint64)rows*(i+1)/chunks);
+		pool.start(new ProbeJoinTableTask(keyColumns, (type == AsOfJoin) ? &timeStamps : 0,
+		                                  (type == AsOfJoin) ? &rightTimeStamps : 0, tables, type,
+		                                  first, last, chunkLeftRows[i], chunkRightRows[i]));
+	}
+	pool.waitForDone();
+	tables.clear();
+
+	QVector<int> leftRows;
+	QVector<int> rightRows;
+	for (int i = 0; i < chunks; ++i) {
+		leftRows += chunkLeftRows.at(i);
+		rightRows += chunkRightRows.at(i);
+		chunkLeftRows[i] = QVector<int>();
+		chunkRightRows[i] = QVector<int>();
+	}
+
+	// create the resulting spreadsheet
+	Spreadsheet* spreadsheet = new Spreadsheet(0, i18n("%1 joined with %2", name(), right->name()), true);
+	foreach (const Column* col, children<Column>()) {
+		Column* newCol = gatherColumn(col, leftRows, col->name());
+		newCol->setPlotDesignation(col->plotDesignation());
+		spreadsheet->addChild(newCol);
+	}
+
+	foreach (const Column* col, right->children<Column>()) {
+		if (rightKeys.indexOf(const_cast<Column*>(col)) != -1 && !(type == AsOfJoin && col == rightKeys.last()))
+			continue;
+
+		Column* newCol = gatherColumn(col, rightRows, col->name());
+		newCol->setPlotDesignation(col->plotDesignation());
+		spreadsheet->addChild(newCol);
+	}
+
+	if (folder())
+		folder()->addChild(spreadsheet);
+
 	RESET_CURSOR;
-} // end of sortColumns()
+	return spreadsheet;
+}
 
 /*!
   Returns an icon to be used for decorating my views.
@@ -722,6 +1676,171 @@ void Spreadsheet::setColumnSelectedInView(int index, bool selected){
   }
 }
 
+//##############################################################################
+//########################  Spectral analysis  #################################
+//##############################################################################
+namespace {
+
+/*!
+ * returns the values of the numeric column \c col without masked and missing values.
+ */
+QVector<double> validValues(const Column* col) {
+	QVector<double> values;
+	values.reserve(col->rowCount());
+	for (int row = 0; row < col->rowCount(); ++row) {
+		const double value = col->valueAt(row);
+		if (!std::isnan(value) && !col->isMasked(row))
+			values << value;
+	}
+	return values;
+}
+
+/* task class transforming the frames first .. last-1 of a spectrogram, using one FFT plan for all of them.
+	The status of nsl_dft_stft() is stored in status */
+class SpectrogramTask : public QRunnable {
+	public:
+		SpectrogramTask(const QVector<double>& data, int segment, int overlap, nsl_sf_window_type window, nsl_dft_result_type type,
+		                int first, int last, QVector<QVector<double> >& result, int& status)
+			: m_data(data), m_segment(segment), m_overlap(overlap), m_window(window), m_type(type),
+			  m_first(first), m_last(last), m_result(result), m_status(status) {}
+
+		void run() {
+			const int bins = m_segment/2 + 1;
+			QVector<double> spectra((m_last - m_first)*bins);
+			m_status = nsl_dft_stft(m_data.constData(), m_data.size(), m_segment, m_overlap, m_window, m_type, m_first, m_last, spectra.data());
+			if (m_status != 0)
+				return;
+
+			for (int j = m_first; j < m_last; ++j)
+				memcpy(m_result[j].data(), spectra.constData() + (j - m_first)*bins, bins*sizeof(double));
+		}
+
+	private:
+		const QVector<double>& m_data;
+		const int m_segment;
+		const int m_overlap;
+		const nsl_sf_window_type m_window;
+		const nsl_dft_result_type m_type;
+		const int m_first;
+		const int m_last;
+		QVector<QVector<double> >& m_result;
+		int& m_status;
+};
+
+}
+
+/*!
+  calculates the spectrogram (short-time Fourier transform) of the values of \c column sampled with the rate \c rate.
+  The values are split into frames of \c segment values overlapping by \c overlap values that are weighted
+  with the window function \c window. Masked and missing values are skipped.
+
+  The spectrum of every frame (result type \c type, except for raw) is written to one column of a new matrix
+  in the same folder. The rows correspond to the frequencies 0 .. rate/2, the x-coordinates of the matrix
+  to the times of the frame centers. normdB is normalized to the maximum of all frames.
+
+  The frames are transformed in parallel, every task uses one FFT plan for all of its frames.
+  Returns 0 if there are less valid values than \c segment or if the transformation failed.
+*/
+Matrix* Spreadsheet::spectrogram(const Column* column, double rate, int segment, int overlap, nsl_sf_window_type window, nsl_dft_result_type type) {
+	if (!column || column->columnMode() != AbstractColumn::Numeric || rate <= 0 || segment < 2
+			|| overlap < 0 || overlap >= segment || type == nsl_dft_result_raw)
+		return 0;
+
+	WAIT_CURSOR;
+
+	const QVector<double> data = validValues(column);
+	const int frames = nsl_dft_stft_frames(data.size(), segment, overlap);
+	if (frames == 0) {
+		RESET_CURSOR;
+		return 0;
+	}
+	const int bins = segment/2 + 1;
+
+	QVector<QVector<double> > result(frames);
+	for (int j = 0; j < frames; ++j)
+		result[j].resize(bins);
+
+	QThreadPool pool;
+	const int chunks = qMin(pool.maxThreadCount(), frames);
+	QVector<int> status(chunks, 0);
+	for (int i = 0; i < chunks; ++i) {
+		const int first = (int)((qint64)frames*i/chunks);
+		const int last = (int)((qint64)frames*(i+1)/chunks);
+		pool.start(new SpectrogramTask(data, segment, overlap, window, (type == nsl_dft_result_normdB) ? nsl_dft_result_dB : type,
+		                               first, last, result, status[i]));
+	}
+	pool.waitForDone();
+
+	if (status.count(0) != chunks) {
+		RESET_CURSOR;
+		return 0;
+	}
+
+	if (type == nsl_dft_result_normdB) {
+		double max = -std::numeric_limits<double>::infinity();
+		for (int j = 0; j < frames; ++j)
+			max = qMax(max, *std::max_element(result.at(j).constBegin(), result.at(j).constEnd()));
+		for (int j = 0; j < frames; ++j) {
+			double* values = result[j].data();
+			for (int k = 0; k < bins; ++k)
+				values[k] -= max;
+		}
+	}
+
+	const int hop = segment - overlap;
+	Matrix* matrix = new Matrix(0, i18n("%1 spectrogram", column->name()));
+	matrix->setDimensions(bins, frames);
+	matrix->setCoordinates(0.5*(segment - 1)/rate, ((frames - 1)*hop + 0.5*(segment - 1))/rate, 0, (bins - 1)*rate/segment);
+	matrix->setData(result);
+
+	if (folder())
+		folder()->addChild(matrix);
+
+	RESET_CURSOR;
+	return matrix;
+}
+
+/*!
+  calculates Welch's estimate of the power spectral density of the values of \c column sampled with the rate \c rate,
+  the mean of the periodograms of the frames defined as in spectrogram().
+
+  The frequencies 0 .. rate/2 and the one-sided density are written to a new spreadsheet in the same folder.
+  Returns 0 if there are less valid values than \c segment or if the calculation failed.
+*/
+Spreadsheet* Spreadsheet::powerSpectralDensity(const Column* column, double rate, int segment, int overlap, nsl_sf_window_type window) {
+	if (!column || column->columnMode() != AbstractColumn::Numeric || rate <= 0 || segment < 2 || overlap < 0 || overlap >= segment)
+		return 0;
+
+	WAIT_CURSOR;
+
+	const QVector<double> data = validValues(column);
+	const int bins = segment/2 + 1;
+	QVector<double> frequencies(bins);
+	QVector<double> density(bins);
+	if (nsl_dft_welch(data.constData(), data.size(), segment, overlap, window, rate, density.data()) != 0) {
+		RESET_CURSOR;
+		return 0;
+	}
+	for (int k = 0; k < bins; ++k)
+		frequencies[k] = k*rate/segment;
+
+	Spreadsheet* spreadsheet = new Spreadsheet(0, i18n("%1 PSD", column->name()), true);
+	Column* col = new Column(i18n("frequency"), AbstractColumn::Numeric);
+	col->replaceValues(0, frequencies);
+	col->setPlotDesignation(AbstractColumn::X);
+	spreadsheet->addChild(col);
+	col = new Column(i18n("PSD"), AbstractColumn::Numeric);
+	col->replaceValues(0, density);
+	col->setPlotDesignation(AbstractColumn::Y);
+	spreadsheet->addChild(col);
+
+	if (folder())
+		folder()->addChild(spreadsheet);
+
+	RESET_CURSOR;
+	return spreadsheet;
+}
+
 //##############################################################################
 //##################  Serialization/Deserialization  ###########################
 //##############################################################################
@@ -737,6 +1856,10 @@ void Spreadsheet::save(QXmlStreamWriter* writer) const {
 	foreach (Column* col, children<Column>(IncludeHidden))
 		col->save(writer);
 
+	//filter views
+	foreach (SpreadsheetFilterView* view, children<SpreadsheetFilterView>(IncludeHidden))
+		view->save(writer);
+
 	writer->writeEndElement(); // "spreadsheet"
 }
 
@@ -773,6 +1896,17 @@ bool Spreadsheet::load(XmlStreamReader * reader)
 					}
 					addChild(column);
 				}
+				else if(reader->name() == "filterView")
+				{
+					SpreadsheetFilterView* view = new SpreadsheetFilterView("");
+					if (!view->load(reader))
+					{
+						delete view;
+						return false;
+					}
+					addChild(view);
+					view->init();
+				}
 				else // unknown element
 				{
 					reader->raiseWarning(i18n("unknown element '%1'", reader->name().toString()));
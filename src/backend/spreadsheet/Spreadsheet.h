@@ -31,12 +31,24 @@
 
 #include "backend/datasources/AbstractDataSource.h"
 #include "backend/core/column/Column.h"
+#include "backend/spreadsheet/SpreadsheetFilterView.h"
 #include <QList>
 
+extern "C" {
+#include "backend/nsl/nsl_dft.h"
+}
+
+class Matrix;
+
 class Spreadsheet : public AbstractDataSource {
 	Q_OBJECT
 
 	public:
+		enum Aggregation {Count, Minimum, Maximum, ArithmeticMean, GeometricMean, HarmonicMean, ContraharmonicMean,
+			Median, Variance, StandardDeviation, MeanDeviation, MeanDeviationAroundMedian, MedianDeviation,
+			Skewness, Kurtosis, Entropy};
+		enum JoinType {InnerJoin, LeftJoin, AsOfJoin};
+
 		Spreadsheet(AbstractScriptingEngine* engine, const QString& name, bool loading = false);
 
 		virtual QIcon icon() const;
@@ -64,6 +76,13 @@ class Spreadsheet : public AbstractDataSource {
 
 		void copy(Spreadsheet* other);
 
+		Spreadsheet* groupBy(const QList<Column*>& keys, const QList<Column*>& values, const QList<Aggregation>&);
+		static QString aggregationName(Aggregation);
+		Spreadsheet* join(Spreadsheet* right, const QList<Column*>& keys, const QList<Column*>& rightKeys, JoinType);
+		Matrix* spectrogram(const Column*, double rate, int segment, int overlap, nsl_sf_window_type, nsl_dft_result_type);
+		Spreadsheet* powerSpectralDensity(const Column*, double rate, int segment, int overlap, nsl_sf_window_type);
+		SpreadsheetFilterView* addFilterView(const QString& name, const QList<SpreadsheetFilterView::Condition>&, bool matchAll = true);
+
 		virtual void save(QXmlStreamWriter*) const;
 		virtual bool load(XmlStreamReader*);
 
@@ -88,6 +107,7 @@ class Spreadsheet : public AbstractDataSource {
 
 		void moveColumn(int from, int to);
 		void sortColumns(Column* leading, QList<Column*> cols, bool ascending);
+		void sortColumns(const QList<Column*>& keys, const QList<bool>& ascending, QList<Column*> cols);
 
 	private:
 		void init();
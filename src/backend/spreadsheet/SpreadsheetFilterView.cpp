@@ -0,0 +1,591 @@
+/***************************************************************************
+    File                 : SpreadsheetFilterView.cpp
+    Project              : LabPlot
+    Description          : View on the rows of a spreadsheet fulfilling a filter condition
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#include "SpreadsheetFilterView.h"
+#include "backend/spreadsheet/Spreadsheet.h"
+#include "backend/lib/XmlStreamReader.h"
+#include "kdefrontend/spreadsheet/StatisticsDialog.h"
+
+#include <QMenu>
+#include <algorithm>
+#include <KIcon>
+#include <KLocale>
+
+/*!
+  \class SpreadsheetFilterView
+  \brief View on the rows of a spreadsheet fulfilling a filter condition.
+
+  The filter consists of a list of conditions on the columns of the parent spreadsheet that
+  are combined with "and" (matchAll() is \c true) or with "or". The conditions are evaluated
+  once for the whole column data and the result is stored as the list of the indices of the matching rows.
+  Masked rows of the columns used in the conditions are not part of the view.
+
+  The children of the view are FilteredColumns providing the values of the matching rows of the
+  spreadsheet columns via the AbstractColumn interface. They can be used in curves, analysis curves
+  and for the calculation of statistics like usual columns without copying the data.
+
+  If the columns used in the conditions are changed, only the rows starting at the first changed row
+  are evaluated again. For rows appended to the spreadsheet and filled with values, only the new rows are evaluated.
+  Changes of the column mode or of the masking lead to a re-evaluation of the whole filter.
+  The evaluation is done on demand when the rows of the view are accessed.
+
+  \ingroup backend
+*/
+
+namespace {
+
+template <typename T>
+void compareValues(const T* data, int n, SpreadsheetFilterView::Operator op, T value1, T value2, char* result) {
+	switch (op) {
+		case SpreadsheetFilterView::Equal:
+			for (int i = 0; i < n; ++i)
+				result[i] = (data[i] == value1);
+			break;
+		case SpreadsheetFilterView::NotEqual:
+			// data[i] == data[i] is false for NaN, invalid values are never part of the view
+			for (int i = 0; i < n; ++i)
+				result[i] = (data[i] == data[i] && data[i] != value1);
+			break;
+		case SpreadsheetFilterView::Less:
+			for (int i = 0; i < n; ++i)
+				result[i] = (data[i] < value1);
+			break;
+		case SpreadsheetFilterView::LessEqual:
+			for (int i = 0; i < n; ++i)
+				result[i] = (data[i] <= value1);
+			break;
+		case SpreadsheetFilterView::Greater:
+			for (int i = 0; i < n; ++i)
+				result[i] = (data[i] > value1);
+			break;
+		case SpreadsheetFilterView::GreaterEqual:
+			for (int i = 0; i < n; ++i)
+				result[i] = (data[i] >= value1);
+			break;
+		case SpreadsheetFilterView::Between:
+			for (int i = 0; i < n; ++i)
+				result[i] = (data[i] >= value1 && data[i] <= value2);
+			break;
+		case SpreadsheetFilterView::Contains:
+			break;
+	}
+}
+
+}
+
+SpreadsheetFilterView::SpreadsheetFilterView(const QString& name) : AbstractAspect(name),
+	m_matchAll(true), m_evaluatedRows(0) {
+}
+
+QIcon SpreadsheetFilterView::icon() const {
+	return KIcon("view-filter");
+}
+
+/*!
+  Returns a new context menu. The caller takes ownership of the menu.
+*/
+QMenu* SpreadsheetFilterView::createContextMenu() {
+	QMenu* menu = AbstractAspect::createContextMenu();
+	Q_ASSERT(menu);
+	QAction* firstAction = menu->actions().at(1); //skip the first action because of the "title-action"
+
+	QAction* statisticsAction = new QAction(KIcon("view-statistics"), i18n("Column Statistics"), this);
+	connect(statisticsAction, SIGNAL(triggered()), this, SLOT(showStatistics()));
+	menu->insertAction(firstAction, statisticsAction);
+	menu->insertSeparator(firstAction);
+
+	return menu;
+}
+
+/*!
+  shows the statistics of the numeric columns of the view.
+*/
+void SpreadsheetFilterView::showStatistics() {
+	QList<FilteredColumn*> columns;
+	foreach (FilteredColumn* col, children<FilteredColumn>()) {
+		if (col->columnMode() == AbstractColumn::Numeric)
+			columns << col;
+	}
+
+	StatisticsDialog* dlg = new StatisticsDialog(i18n("%1: column statistics", name()));
+	dlg->setAttribute(Qt::WA_DeleteOnClose);
+	dlg->setColumns(columns);
+	if (columns.size() > 1)
+		dlg->showMaximized();
+	else
+		dlg->show();
+}
+
+Spreadsheet* SpreadsheetFilterView::spreadsheet() const {
+	return dynamic_cast<Spreadsheet*>(parentAspect());
+}
+
+/*!
+  sets the filter conditions. If \c matchAll is \c true, a row is part of the view if all conditions are fulfilled,
+  otherwise if at least one condition is fulfilled.
+*/
+void SpreadsheetFilterView::setConditions(const QList<Condition>& conditions, bool matchAll) {
+	m_conditions = conditions;
+	m_matchAll = matchAll;
+	init();
+}
+
+const QList<SpreadsheetFilterView::Condition>& SpreadsheetFilterView::conditions() const {
+	return m_conditions;
+}
+
+bool SpreadsheetFilterView::matchAll() const {
+	return m_matchAll;
+}
+
+/*!
+  adds a filtered column for each of the spreadsheet columns in \c columns.
+*/
+void SpreadsheetFilterView::addColumns(const QList<Column*>& columns) {
+	foreach (const Column* col, columns) {
+		FilteredColumn* filtered = new FilteredColumn(col->name(), this);
+		addChild(filtered);
+	}
+	init();
+}
+
+/*!
+  resolves the spreadsheet columns used in the conditions and in the filtered columns
+  and connects to their signals. Has to be called after the view was added to the spreadsheet
+  and after the view was loaded.
+*/
+void SpreadsheetFilterView::init() {
+	foreach (const Column* col, m_conditionColumns)
+		disconnect(col, 0, this, 0);
+	m_conditionColumns.clear();
+
+	const Spreadsheet* s = spreadsheet();
+	if (!s)
+		return;
+
+	foreach (const Condition& condition, m_conditions) {
+		const Column* col = s->column(condition.columnName);
+		if (!col || m_conditionColumns.contains(col))
+			continue;
+
+		m_conditionColumns << col;
+		connect(col, SIGNAL(rowsInserted(const AbstractColumn*,int,int)),
+		        this, SLOT(handleSourceRowsInserted(const AbstractColumn*,int,int)));
+		connect(col, SIGNAL(rowsRemoved(const AbstractColumn*,int,int)),
+		        this, SLOT(handleSourceRowsRemoved(const AbstractColumn*,int,int)));
+		connect(col, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(handleSourceDataChange(const AbstractColumn*)));
+		connect(col, SIGNAL(modeChanged(const AbstractColumn*)), this, SLOT(handleSourceChange()));
+		connect(col, SIGNAL(maskingChanged(const AbstractColumn*)), this, SLOT(handleSourceChange()));
+	}
+
+	foreach (FilteredColumn* col, children<FilteredColumn>())
+		col->setSourceColumn(s->column(col->sourceName()));
+
+	reset();
+}
+
+void SpreadsheetFilterView::handleSourceRowsInserted(const AbstractColumn* col, int before, int count) {
+	Q_UNUSED(col);
+	Q_UNUSED(count);
+	// the rows in front of the inserted rows are not changed
+	rewind(before);
+}
+
+void SpreadsheetFilterView::handleSourceRowsRemoved(const AbstractColumn* col, int first, int count) {
+	Q_UNUSED(col);
+	Q_UNUSED(count);
+	rewind(first);
+}
+
+void SpreadsheetFilterView::handleSourceDataChange(const AbstractColumn* col) {
+	// only the rows starting at the first changed one are evaluated again,
+	// for appended rows that are filled with values this is the old end of the column
+	rewind(static_cast<const Column*>(col)->firstChangedRow());
+}
+
+void SpreadsheetFilterView::handleSourceChange() {
+	reset();
+}
+
+void SpreadsheetFilterView::reset() {
+	rewind(0);
+}
+
+/*!
+  drops the evaluation of the spreadsheet rows starting at \c row. They are evaluated again on the next access.
+*/
+void SpreadsheetFilterView::rewind(int row) {
+	if (row < m_evaluatedRows) {
+		m_rows.erase(std::lower_bound(m_rows.begin(), m_rows.end(), row), m_rows.end());
+		m_evaluatedRows = row;
+	}
+	emit rowsChanged();
+}
+
+/*!
+  returns the number of rows in the view. The rows of the spreadsheet not evaluated yet are evaluated here.
+*/
+int SpreadsheetFilterView::rowCount() const {
+	update();
+	return m_rows.size();
+}
+
+/*!
+  returns the index of the spreadsheet row corresponding to the row \c row of the view.
+*/
+int SpreadsheetFilterView::sourceRow(int row) const {
+	update();
+	if (row < 0 || row >= m_rows.size())
+		return -1;
+	return m_rows.at(row);
+}
+
+/*!
+  returns the indices of the spreadsheet rows in the view.
+*/
+const QVector<int>& SpreadsheetFilterView::sourceRows() const {
+	update();
+	return m_rows;
+}
+
+FilteredColumn* SpreadsheetFilterView::column(int index) const {
+	return child<FilteredColumn>(index);
+}
+
+FilteredColumn* SpreadsheetFilterView::column(const QString& name) const {
+	return child<FilteredColumn>(name);
+}
+
+/*!
+  evaluates the conditions for the spreadsheet rows that were not evaluated yet
+  and appends the matching rows to the list of rows.
+*/
+void SpreadsheetFilterView::update() const {
+	const Spreadsheet* s = spreadsheet();
+	if (!s)
+		return;
+
+	const int rows = s->rowCount();
+	if (m_evaluatedRows >= rows)
+		return;
+
+	const int first = m_evaluatedRows;
+	const int n = rows - first;
+	QVector<char> match(n, (m_matchAll || m_conditions.isEmpty()) ? 1 : 0);
+	foreach (const Condition& condition, m_conditions)
+		evaluate(condition, first, rows, match);
+
+	const char* m = match.constData();
+	for (int i = 0; i < n; ++i) {
+		if (m[i])
+			m_rows << first + i;
+	}
+	m_evaluatedRows = rows;
+}
+
+/*!
+  evaluates the condition \c condition for the spreadsheet rows from \c first to \c last (exclusive)
+  and combines the result with \c match.
+*/
+void SpreadsheetFilterView::evaluate(const Condition& condition, int first, int last, QVector<char>& match) const {
+	const int n = last - first;
+	QVector<char> result(n, 0);
+	char* r = result.data();
+
+	const Column* col = spreadsheet()->column(condition.columnName);
+	if (col) {
+		const int available = qMax(0, qMin(last, col->rowCount()) - first);
+		switch (col->columnMode()) {
+			case AbstractColumn::Numeric: {
+				const double* data = static_cast<QVector<double>* >(col->data())->constData() + first;
+				compareValues(data, available, condition.op, condition.value1, condition.value2, r);
+				break;
+			}
+			case AbstractColumn::DateTime:
+			case AbstractColumn::Month:
+			case AbstractColumn::Day: {
+				const QList<QDateTime>* data = static_cast<QList<QDateTime>* >(col->data());
+				QVector<double> values(available);
+				for (int i = 0; i < available; ++i) {
+					const QDateTime& dt = data->at(first + i);
+					values[i] = dt.isValid() ? (double)dt.toMSecsSinceEpoch() : NAN;
+				}
+				compareValues(values.constData(), available, condition.op, condition.value1, condition.value2, r);
+				break;
+			}
+			case AbstractColumn::Text: {
+				const QStringList* data = static_cast<QStringList*>(col->data());
+				for (int i = 0; i < available; ++i) {
+					const QString& text = data->at(first + i);
+					const int c = text.compare(condition.text);
+					switch (condition.op) {
+						case Equal:
+							r[i] = (c == 0);
+							break;
+						case NotEqual:
+							r[i] = (c != 0);
+							break;
+						case Less:
+							r[i] = (c < 0);
+							break;
+						case LessEqual:
+							r[i] = (c <= 0);
+							break;
+						case Greater:
+							r[i] = (c > 0);
+							break;
+						case GreaterEqual:
+							r[i] = (c >= 0);
+							break;
+						case Between: // not defined for texts
+							break;
+						case Contains:
+							r[i] = text.contains(condition.text);
+							break;
+					}
+				}
+				break;
+			}
+		}
+
+		// masked rows are ignored in all operations
+		foreach (const Interval<int>& iv, col->maskedIntervals()) {
+			const int start = qMax(iv.start(), first);
+			const int end = qMin(iv.end(), last - 1);
+			for (int row = start; row <= end; ++row)
+				r[row - first] = 0;
+		}
+	}
+
+	char* m = match.data();
+	if (m_matchAll) {
+		for (int i = 0; i < n; ++i)
+			m[i] &= r[i];
+	} else {
+		for (int i = 0; i < n; ++i)
+			m[i] |= r[i];
+	}
+}
+
+//##############################################################################
+//##################  Serialization/Deserialization  ###########################
+//##############################################################################
+/*!
+  Saves as XML.
+ */
+void SpreadsheetFilterView::save(QXmlStreamWriter* writer) const {
+	writer->writeStartElement("filterView");
+	writeBasicAttributes(writer);
+	writer->writeAttribute("matchAll", QString::number(m_matchAll));
+	writeCommentElement(writer);
+
+	foreach (const Condition& condition, m_conditions) {
+		writer->writeStartElement("condition");
+		writer->writeAttribute("column", condition.columnName);
+		writer->writeAttribute("operator", QString::number(condition.op));
+		writer->writeAttribute("value1", QString::number(condition.value1, 'g', 16));
+		writer->writeAttribute("value2", QString::number(condition.value2, 'g', 16));
+		writer->writeAttribute("text", condition.text);
+		writer->writeEndElement();
+	}
+
+	foreach (const FilteredColumn* col, children<FilteredColumn>())
+		col->save(writer);
+
+	writer->writeEndElement(); // "filterView"
+}
+
+/*!
+  Loads from XML. init() has to be called after the view was added to the spreadsheet.
+*/
+bool SpreadsheetFilterView::load(XmlStreamReader* reader) {
+	if (!reader->isStartElement() || reader->name() != "filterView") {
+		reader->raiseError(i18n("no filter view element found"));
+		return false;
+	}
+
+	if (!readBasicAttributes(reader))
+		return false;
+
+	QString attributeWarning = i18n("Attribute '%1' missing or empty, default value is used");
+	QXmlStreamAttributes attribs = reader->attributes();
+	QString str = attribs.value("matchAll").toString();
+	if (str.isEmpty())
+		reader->raiseWarning(attributeWarning.arg("'matchAll'"));
+	else
+		m_matchAll = str.toInt();
+
+	while (!reader->atEnd()) {
+		reader->readNext();
+		if (reader->isEndElement() && reader->name() == "filterView")
+			break;
+
+		if (!reader->isStartElement())
+			continue;
+
+		if (reader->name() == "comment") {
+			if (!readCommentElement(reader)) return false;
+		} else if (reader->name() == "condition") {
+			attribs = reader->attributes();
+			Condition condition;
+			condition.columnName = attribs.value("column").toString();
+			condition.op = (Operator)attribs.value("operator").toString().toInt();
+			condition.value1 = attribs.value("value1").toString().toDouble();
+			condition.value2 = attribs.value("value2").toString().toDouble();
+			condition.text = attribs.value("text").toString();
+			m_conditions << condition;
+		} else if (reader->name() == "filteredColumn") {
+			attribs = reader->attributes();
+			FilteredColumn* col = new FilteredColumn(attribs.value("source").toString(), this);
+			if (!col->readBasicAttributes(reader)) {
+				delete col;
+				return false;
+			}
+			addChild(col);
+		} else { // unknown element
+			reader->raiseWarning(i18n("unknown element '%1'", reader->name().toString()));
+			if (!reader->skipToEndElement()) return false;
+		}
+	}
+
+	return !reader->hasError();
+}
+
+/*!
+  \class FilteredColumn
+  \brief Read-only column providing the values of a spreadsheet column in the rows of a SpreadsheetFilterView.
+
+  No data is copied, the values are read from the source column via the row indices of the view.
+
+  \ingroup backend
+*/
+FilteredColumn::FilteredColumn(const QString& sourceName, SpreadsheetFilterView* view) : AbstractColumn(sourceName),
+	m_sourceName(sourceName), m_source(0), m_view(view), m_statisticsAvailable(false) {
+
+	connect(m_view, SIGNAL(rowsChanged()), this, SLOT(handleViewChange()));
+}
+
+QIcon FilteredColumn::icon() const {
+	return KIcon("view-filter");
+}
+
+const QString& FilteredColumn::sourceName() const {
+	return m_sourceName;
+}
+
+const AbstractColumn* FilteredColumn::sourceColumn() const {
+	return m_source;
+}
+
+void FilteredColumn::setSourceColumn(const AbstractColumn* source) {
+	if (m_source)
+		disconnect(m_source, 0, this, 0);
+
+	m_source = source;
+	if (m_source) {
+		connect(m_source, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(handleSourceDataChange()));
+		connect(m_source, SIGNAL(modeChanged(const AbstractColumn*)), this, SLOT(handleSourceDataChange()));
+	}
+	handleSourceDataChange();
+}
+
+void FilteredColumn::handleSourceDataChange() {
+	m_statisticsAvailable = false;
+	emit dataChanged(this);
+}
+
+void FilteredColumn::handleViewChange() {
+	m_statisticsAvailable = false;
+	emit dataChanged(this);
+}
+
+AbstractColumn::ColumnMode FilteredColumn::columnMode() const {
+	return m_source ? m_source->columnMode() : AbstractColumn::Numeric;
+}
+
+AbstractColumn::PlotDesignation FilteredColumn::plotDesignation() const {
+	return m_source ? m_source->plotDesignation() : AbstractColumn::noDesignation;
+}
+
+int FilteredColumn::rowCount() const {
+	return m_source ? m_view->rowCount() : 0;
+}
+
+QString FilteredColumn::textAt(int row) const {
+	const int sourceRow = m_view->sourceRow(row);
+	return (m_source && sourceRow != -1) ? m_source->textAt(sourceRow) : QString();
+}
+
+QDate FilteredColumn::dateAt(int row) const {
+	const int sourceRow = m_view->sourceRow(row);
+	return (m_source && sourceRow != -1) ? m_source->dateAt(sourceRow) : QDate();
+}
+
+QTime FilteredColumn::timeAt(int row) const {
+	const int sourceRow = m_view->sourceRow(row);
+	return (m_source && sourceRow != -1) ? m_source->timeAt(sourceRow) : QTime();
+}
+
+QDateTime FilteredColumn::dateTimeAt(int row) const {
+	const int sourceRow = m_view->sourceRow(row);
+	return (m_source && sourceRow != -1) ? m_source->dateTimeAt(sourceRow) : QDateTime();
+}
+
+double FilteredColumn::valueAt(int row) const {
+	const int sourceRow = m_view->sourceRow(row);
+	return (m_source && sourceRow != -1) ? m_source->valueAt(sourceRow) : NAN;
+}
+
+/*!
+  returns the statistics of the values of the source column in the rows of the view.
+*/
+const Column::ColumnStatistics& FilteredColumn::statistics() {
+	if (m_statisticsAvailable)
+		return m_statistics;
+
+	QVector<double> rowData;
+	if (m_source && m_source->columnMode() == AbstractColumn::Numeric) {
+		const QVector<int>& rows = m_view->sourceRows();
+		rowData.reserve(rows.size());
+		foreach (int row, rows) {
+			const double value = m_source->valueAt(row);
+			if (!std::isnan(value) && !m_source->isMasked(row))
+				rowData << value;
+		}
+	}
+
+	Column::calculateStatistics(m_statistics, rowData);
+	m_statisticsAvailable = true;
+	return m_statistics;
+}
+
+void FilteredColumn::save(QXmlStreamWriter* writer) const {
+	writer->writeStartElement("filteredColumn");
+	writeBasicAttributes(writer);
+	writer->writeAttribute("source", m_sourceName);
+	writer->writeEndElement();
+}
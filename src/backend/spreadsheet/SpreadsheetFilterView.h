@@ -0,0 +1,136 @@
+/***************************************************************************
+    File                 : SpreadsheetFilterView.h
+    Project              : LabPlot
+    Description          : View on the rows of a spreadsheet fulfilling a filter condition
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef SPREADSHEETFILTERVIEW_H
+#define SPREADSHEETFILTERVIEW_H
+
+#include "backend/core/column/Column.h"
+#include <QVector>
+
+class Spreadsheet;
+class SpreadsheetFilterView;
+
+class FilteredColumn : public AbstractColumn {
+	Q_OBJECT
+
+	public:
+		FilteredColumn(const QString& sourceName, SpreadsheetFilterView* view);
+
+		virtual QIcon icon() const;
+		const QString& sourceName() const;
+		const AbstractColumn* sourceColumn() const;
+		void setSourceColumn(const AbstractColumn*);
+
+		virtual AbstractColumn::ColumnMode columnMode() const;
+		virtual AbstractColumn::PlotDesignation plotDesignation() const;
+		virtual int rowCount() const;
+
+		virtual QString textAt(int row) const;
+		virtual QDate dateAt(int row) const;
+		virtual QTime timeAt(int row) const;
+		virtual QDateTime dateTimeAt(int row) const;
+		virtual double valueAt(int row) const;
+
+		const Column::ColumnStatistics& statistics();
+
+		void save(QXmlStreamWriter*) const;
+
+	private:
+		QString m_sourceName;
+		const AbstractColumn* m_source;
+		SpreadsheetFilterView* m_view;
+		Column::ColumnStatistics m_statistics;
+		bool m_statisticsAvailable;
+
+		friend class SpreadsheetFilterView;
+
+	private slots:
+		void handleSourceDataChange();
+		void handleViewChange();
+};
+
+class SpreadsheetFilterView : public AbstractAspect {
+	Q_OBJECT
+
+	public:
+		enum Operator {Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual, Between, Contains};
+
+		struct Condition {
+			Condition() : op(Equal), value1(0.0), value2(0.0) {}
+			QString columnName; // name of the column in the spreadsheet
+			Operator op;
+			double value1; // numeric value, for date-time columns milliseconds since epoch
+			double value2; // upper limit for Between
+			QString text; // value for text columns
+		};
+
+		explicit SpreadsheetFilterView(const QString& name);
+
+		virtual QIcon icon() const;
+		virtual QMenu* createContextMenu();
+
+		void setConditions(const QList<Condition>&, bool matchAll = true);
+		const QList<Condition>& conditions() const;
+		bool matchAll() const;
+
+		void addColumns(const QList<Column*>&);
+		void init();
+
+		int rowCount() const;
+		int sourceRow(int row) const;
+		const QVector<int>& sourceRows() const;
+		FilteredColumn* column(int index) const;
+		FilteredColumn* column(const QString& name) const;
+
+		void save(QXmlStreamWriter*) const;
+		bool load(XmlStreamReader*);
+
+	private slots:
+		void handleSourceRowsInserted(const AbstractColumn*, int before, int count);
+		void handleSourceRowsRemoved(const AbstractColumn*, int first, int count);
+		void handleSourceDataChange(const AbstractColumn*);
+		void handleSourceChange();
+		void showStatistics();
+
+	private:
+		Spreadsheet* spreadsheet() const;
+		void update() const;
+		void reset();
+		void rewind(int row);
+		void evaluate(const Condition&, int first, int last, QVector<char>& match) const;
+
+		QList<Condition> m_conditions;
+		bool m_matchAll;
+		QList<const Column*> m_conditionColumns;
+		mutable QVector<int> m_rows;
+		mutable int m_evaluatedRows;
+
+	signals:
+		void rowsChanged();
+};
+
+#endif
@@ -0,0 +1,135 @@
+/***************************************************************************
+    File                 : SpreadsheetFilterViewTest.cpp
+    Project              : LabPlot
+    Description          : Tests for the incremental evaluation of filter views
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#include "backend/spreadsheet/Spreadsheet.h"
+#include "backend/spreadsheet/SpreadsheetFilterView.h"
+
+#include <QtTest>
+#include <qtest_kde.h>
+
+/*!
+  The tests change the values of the spreadsheet directly via Column::data() without emitting a signal.
+  If the view evaluates a row again, the changed value is used, otherwise the old result is kept.
+  This shows which rows are evaluated after a change of the spreadsheet.
+*/
+class SpreadsheetFilterViewTest : public QObject {
+	Q_OBJECT
+
+	private slots:
+		void init();
+		void cleanup();
+		void appendWithValues();
+		void changeValue();
+		void insertRows();
+
+	private:
+		double* values() const;
+
+		Spreadsheet* m_spreadsheet;
+		Column* m_column;
+		SpreadsheetFilterView* m_view;
+};
+
+void SpreadsheetFilterViewTest::init() {
+	m_spreadsheet = new Spreadsheet(0, "spreadsheet", true);
+	m_column = new Column("x", QVector<double>() << 0 << 1 << 2 << 3 << 4 << 5 << 6 << 7 << 8 << 9);
+	m_spreadsheet->addChild(m_column);
+
+	SpreadsheetFilterView::Condition condition;
+	condition.columnName = "x";
+	condition.op = SpreadsheetFilterView::Greater;
+	condition.value1 = 4.5;
+	m_view = m_spreadsheet->addFilterView("filter", QList<SpreadsheetFilterView::Condition>() << condition);
+	QCOMPARE(m_view->rowCount(), 5);
+	QCOMPARE(m_view->sourceRow(0), 5);
+}
+
+void SpreadsheetFilterViewTest::cleanup() {
+	delete m_spreadsheet;
+}
+
+double* SpreadsheetFilterViewTest::values() const {
+	return static_cast<QVector<double>* >(m_column->data())->data();
+}
+
+/*!
+  appends rows and fills them with values afterwards like the import of new data does.
+  Only the new rows are evaluated.
+*/
+void SpreadsheetFilterViewTest::appendWithValues() {
+	values()[0] = 10; // not seen by the view as long as row 0 is not evaluated again
+
+	m_spreadsheet->appendRows(3);
+	m_column->replaceValues(10, QVector<double>() << 20 << 1 << 30);
+
+	QCOMPARE(m_view->rowCount(), 7);
+	QCOMPARE(m_view->sourceRow(0), 5);
+	QCOMPARE(m_view->sourceRow(5), 10);
+	QCOMPARE(m_view->sourceRow(6), 12);
+
+	// values appended without inserting the rows first
+	m_column->setValueAt(13, 40);
+	QCOMPARE(m_view->rowCount(), 8);
+	QCOMPARE(m_view->sourceRow(0), 5);
+	QCOMPARE(m_view->sourceRow(7), 13);
+}
+
+/*!
+  changes a value inside of the evaluated rows. The rows in front of it are not evaluated again.
+*/
+void SpreadsheetFilterViewTest::changeValue() {
+	values()[0] = 10;
+
+	m_column->setValueAt(6, 0);
+	QCOMPARE(m_view->rowCount(), 4);
+	QCOMPARE(m_view->sourceRow(0), 5);
+	QCOMPARE(m_view->sourceRow(1), 7);
+
+	m_column->setValueAt(0, 10);
+	QCOMPARE(m_view->rowCount(), 5);
+	QCOMPARE(m_view->sourceRow(0), 0);
+}
+
+/*!
+  inserts rows in the middle of the spreadsheet, the rows behind them are evaluated again.
+*/
+void SpreadsheetFilterViewTest::insertRows() {
+	values()[0] = 10;
+
+	m_spreadsheet->insertRows(7, 2);
+	m_column->replaceValues(7, QVector<double>() << 50 << 0);
+
+	QCOMPARE(m_view->rowCount(), 6);
+	QCOMPARE(m_view->sourceRow(0), 5);
+	QCOMPARE(m_view->sourceRow(2), 7);
+	QCOMPARE(m_view->sourceRow(3), 9);
+	QCOMPARE(m_view->sourceRow(5), 11);
+}
+
+QTEST_KDEMAIN(SpreadsheetFilterViewTest, NoGUI)
+
+#include "SpreadsheetFilterViewTest.moc"
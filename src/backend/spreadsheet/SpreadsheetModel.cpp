@@ -35,6 +35,7 @@
 #include <QBrush>
 #include <QIcon>
 #include <QFontMetrics>
+#include <QTimer>
 
 #include <KLocale>
 
@@ -50,18 +51,38 @@
 	is obtained by calling Spreadsheet::column() and the manipulation is done using the
 	public API of column.
 
+	The texts of the cells are formatted by the output filters of the columns. To avoid formatting
+	the same cells again on every repaint, the formatted texts are cached in blocks of consecutive rows.
+	The blocks are invalidated when the data, the format or the masking of the column changes.
+	The view informs the model about the visible region via setViewport(), the blocks
+	around the visible region are formatted in advance to keep the scrolling smooth.
+
 	\ingroup backend
 */
-SpreadsheetModel::SpreadsheetModel(Spreadsheet* spreadsheet)
-	: QAbstractItemModel(0), m_spreadsheet(spreadsheet), m_formula_mode(false) {
-	updateVerticalHeader();
-	updateHorizontalHeader();
 
+//number of rows in one cached block of formatted texts
+static const int FormattedBlockSize = 256;
+
+//maximal number of cached blocks
+static const int MaxFormattedBlocks = 1024;
+
+uint qHash(const SpreadsheetModel::FormattedBlockKey& key) {
+	return qHash(key.column) ^ qHash(key.block) ^ (uint(key.version) << 16);
+}
+
+SpreadsheetModel::SpreadsheetModel(Spreadsheet* spreadsheet)
+	: QAbstractItemModel(0), m_spreadsheet(spreadsheet), m_formula_mode(false), m_rowCount(0), m_verticalHeaderWidth(0),
+	m_formattedCache(MaxFormattedBlocks), m_versionCounter(0),
+	m_viewportFirstRow(0), m_viewportLastRow(-1), m_viewportFirstColumn(0), m_viewportLastColumn(-1),
+	m_prefetchPending(false) {
 	QFont font;
 	font.setFamily(font.defaultFamily());
 	QFontMetrics fm(font);
 	m_defaultHeaderHeight = fm.height()+5;
 
+	updateVerticalHeader();
+	updateHorizontalHeader();
+
 	connect(m_spreadsheet, SIGNAL(aspectAboutToBeAdded(const AbstractAspect*,const AbstractAspect*,const AbstractAspect*)),
 	        this, SLOT(handleAspectAboutToBeAdded(const AbstractAspect*,const AbstractAspect*,const AbstractAspect*)));
 	connect(m_spreadsheet, SIGNAL(aspectAdded(const AbstractAspect*)),
@@ -99,11 +120,13 @@ QVariant SpreadsheetModel::data(const QModelIndex& index, int role) const {
 
 	switch(role) {
 		case Qt::ToolTipRole: {
-			if(col_ptr->isValid(row)) {
+			const FormattedBlock* block = formattedBlock(col_ptr, row/FormattedBlockSize);
+			const int i = row%FormattedBlockSize;
+			if(block->valid.testBit(i)) {
 				if(col_ptr->isMasked(row))
-					return QVariant(col_ptr->asStringColumn()->textAt(row) + i18n(", masked (ignored in all operations)"));
+					return QVariant(block->texts.at(i) + i18n(", masked (ignored in all operations)"));
 				else
-					return QVariant(col_ptr->asStringColumn()->textAt(row));
+					return QVariant(block->texts.at(i));
 			} else {
 				if(col_ptr->isMasked(row))
 					return QVariant(i18n("invalid cell, masked (ignored in all operations)"));
@@ -112,8 +135,10 @@ QVariant SpreadsheetModel::data(const QModelIndex& index, int role) const {
 			}
 		}
 		case Qt::EditRole: {
-			if(col_ptr->isValid(row))
-				return QVariant(col_ptr->asStringColumn()->textAt(row));
+			const FormattedBlock* block = formattedBlock(col_ptr, row/FormattedBlockSize);
+			const int i = row%FormattedBlockSize;
+			if(block->valid.testBit(i))
+				return QVariant(block->texts.at(i));
 
 			//m_formula_mode is not used at the moment
 			//if(m_formula_mode)
@@ -122,14 +147,16 @@ QVariant SpreadsheetModel::data(const QModelIndex& index, int role) const {
 			return QVariant();
 		}
 		case Qt::DisplayRole: {
-			if(!col_ptr->isValid(row))
+			const FormattedBlock* block = formattedBlock(col_ptr, row/FormattedBlockSize);
+			const int i = row%FormattedBlockSize;
+			if(!block->valid.testBit(i))
 				return QVariant("-");
 
 			//m_formula_mode is not used at the moment
 			//if(m_formula_mode)
 			//	return QVariant(col_ptr->formula(row));
 
-			return QVariant(col_ptr->asStringColumn()->textAt(row));
+			return QVariant(block->texts.at(i));
 		}
 		case Qt::ForegroundRole: {
 			if(!col_ptr->isValid(index.row()))
@@ -170,7 +197,10 @@ QVariant SpreadsheetModel::headerData(int section, Qt::Orientation orientation,
 			switch(role) {
 				case Qt::DisplayRole:
 				case Qt::ToolTipRole:
-					return m_vertical_header_data.at(section);
+					return section+1;
+				case Qt::SizeHintRole:
+					//the same for all rows, the header doesn't need to measure the row numbers
+					return QSize(m_verticalHeaderWidth, m_defaultHeaderHeight);
 			}
 	}
 
@@ -267,7 +297,9 @@ void SpreadsheetModel::handleAspectAdded(const AbstractAspect * aspect) {
 	connect(col, SIGNAL(rowsRemoved(const AbstractColumn*,int,int)), this,
 	        SLOT(handleRowsRemoved(const AbstractColumn*,int,int)));
 	connect(col, SIGNAL(maskingChanged(const AbstractColumn*)), this,
-	        SLOT(handleDataChange(const AbstractColumn*)));
+	        SLOT(handleMaskingChange(const AbstractColumn*)));
+
+	invalidateFormattedCache(col);
 
 	beginResetModel();
 	//TODO: breaks undo/redo
@@ -286,6 +318,7 @@ void SpreadsheetModel::handleAspectAboutToBeRemoved(const AbstractAspect* aspect
 	int index = m_spreadsheet->indexOfChild<Column>(col);
 	beginRemoveColumns(QModelIndex(), index, index);
 	disconnect(col, 0, this, 0);
+	m_columnVersion.remove(col);
 }
 
 void SpreadsheetModel::handleAspectRemoved(const AbstractAspect* parent, const AbstractAspect* before, const AbstractAspect* child) {
@@ -329,12 +362,20 @@ void SpreadsheetModel::handlePlotDesignationChange(const AbstractColumn* col) {
 }
 
 void SpreadsheetModel::handleDataChange(const AbstractColumn* col) {
+	invalidateFormattedCache(col);
+	int i = m_spreadsheet->indexOfChild<Column>(col);
+	emit dataChanged(index(0, i), index(col->rowCount()-1, i));
+}
+
+void SpreadsheetModel::handleMaskingChange(const AbstractColumn* col) {
+	//the formatted texts don't depend on the masking, only the views need to be updated
 	int i = m_spreadsheet->indexOfChild<Column>(col);
 	emit dataChanged(index(0, i), index(col->rowCount()-1, i));
 }
 
 void SpreadsheetModel::handleRowsInserted(const AbstractColumn* col, int before, int count) {
 	Q_UNUSED(before) Q_UNUSED(count)
+	invalidateFormattedCache(col);
 	updateVerticalHeader();
 	int i = m_spreadsheet->indexOfChild<Column>(col);
 	emit dataChanged(index(0, i), index(col->rowCount()-1, i));
@@ -343,6 +384,7 @@ void SpreadsheetModel::handleRowsInserted(const AbstractColumn* col, int before,
 
 void SpreadsheetModel::handleRowsRemoved(const AbstractColumn* col, int first, int count) {
 	Q_UNUSED(first) Q_UNUSED(count)
+	invalidateFormattedCache(col);
 	updateVerticalHeader();
 	int i = m_spreadsheet->indexOfChild<Column>(col);
 	emit dataChanged(index(0, i), index(col->rowCount()-1, i));
@@ -350,26 +392,25 @@ void SpreadsheetModel::handleRowsRemoved(const AbstractColumn* col, int first, i
 }
 
 void SpreadsheetModel::updateVerticalHeader() {
-	int old_rows = m_vertical_header_data.size();
+	//the row numbers are determined in headerData(), only the number of rows needs to be tracked here
+	int old_rows = m_rowCount;
 	int new_rows = m_spreadsheet->rowCount();
 
 	if (new_rows > old_rows) {
 		beginInsertRows(QModelIndex(), old_rows, new_rows-1);
-
-		for(int i=old_rows+1; i<=new_rows; i++)
-			m_vertical_header_data << i;
-
+		m_rowCount = new_rows;
 		endInsertRows();
 	} else if (new_rows < old_rows) {
 		beginRemoveRows(QModelIndex(), new_rows, old_rows-1);
-
-		while (m_vertical_header_data.size() > new_rows)
-			m_vertical_header_data.removeLast();
-
+		m_rowCount = new_rows;
 		endRemoveRows();
 	}
 
-	Q_ASSERT(m_vertical_header_data.size() == m_spreadsheet->rowCount());
+	//the header width changes only with the number of digits of the largest row number
+	QFont font;
+	font.setFamily(font.defaultFamily());
+	QFontMetrics fm(font);
+	m_verticalHeaderWidth = fm.width(QString(QString::number(qMax(new_rows, 1)).size(), '0')) + 10;
 }
 
 void SpreadsheetModel::updateHorizontalHeader() {
@@ -452,3 +493,76 @@ void SpreadsheetModel::activateFormulaMode(bool on) {
 bool SpreadsheetModel::formulaModeActive() const {
 	return m_formula_mode;
 }
+
+/*!
+  Informs the model about the currently visible region of the view.
+  The formatted texts of the cells in and around this region are determined in advance.
+*/
+void SpreadsheetModel::setViewport(int firstRow, int lastRow, int firstColumn, int lastColumn) {
+	m_viewportFirstRow = firstRow;
+	m_viewportLastRow = lastRow;
+	m_viewportFirstColumn = firstColumn;
+	m_viewportLastColumn = lastColumn;
+
+	//prefetch after the view was repainted
+	if (!m_prefetchPending) {
+		m_prefetchPending = true;
+		QTimer::singleShot(0, this, SLOT(prefetch()));
+	}
+}
+
+/*!
+  Formats the blocks of the visible region and one page of rows above and below it.
+*/
+void SpreadsheetModel::prefetch() {
+	m_prefetchPending = false;
+	if (m_viewportLastRow < m_viewportFirstRow || m_viewportLastColumn < m_viewportFirstColumn)
+		return;
+
+	const int page = m_viewportLastRow - m_viewportFirstRow + 1;
+	const int firstBlock = qMax(0, m_viewportFirstRow - page)/FormattedBlockSize;
+	const int lastBlock = qMin(m_rowCount - 1, m_viewportLastRow + page)/FormattedBlockSize;
+	const int lastColumn = qMin(m_viewportLastColumn, m_spreadsheet->columnCount() - 1);
+	for (int col = qMax(0, m_viewportFirstColumn); col <= lastColumn; ++col) {
+		const Column* col_ptr = m_spreadsheet->column(col);
+		for (int block = firstBlock; block <= lastBlock; ++block)
+			formattedBlock(col_ptr, block);
+	}
+}
+
+/*!
+  Returns the formatted texts of the rows in the block \c block of the column \c col.
+  The block is formatted and added to the cache if it is not available yet.
+*/
+const SpreadsheetModel::FormattedBlock* SpreadsheetModel::formattedBlock(const Column* col, int block) const {
+	const FormattedBlockKey key(col, block, m_columnVersion.value(col));
+	const FormattedBlock* cached = m_formattedCache.object(key);
+	if (cached)
+		return cached;
+
+	FormattedBlock* formatted = new FormattedBlock;
+	const int first = block*FormattedBlockSize;
+	const int last = qMin(first + FormattedBlockSize, col->rowCount());
+	formatted->valid.resize(FormattedBlockSize);
+	const AbstractColumn* string_col = col->asStringColumn();
+	for (int row = first; row < last; ++row) {
+		if (col->isValid(row)) {
+			formatted->valid.setBit(row - first);
+			formatted->texts << string_col->textAt(row);
+		} else
+			formatted->texts << QString();
+	}
+	while (formatted->texts.size() < FormattedBlockSize)
+		formatted->texts << QString();
+
+	m_formattedCache.insert(key, formatted);
+	return formatted;
+}
+
+/*!
+  Invalidates all cached formatted texts of the column \c col.
+  The outdated blocks are not accessed anymore and are removed from the cache with the time.
+*/
+void SpreadsheetModel::invalidateFormattedCache(const AbstractColumn* col) {
+	m_columnVersion[col] = ++m_versionCounter;
+}
@@ -33,6 +33,9 @@
 
 #include <QAbstractItemModel>
 #include <QStringList>
+#include <QBitArray>
+#include <QCache>
+#include <QHash>
 
 class Column;
 class Spreadsheet;
@@ -66,6 +69,8 @@ public:
 	void activateFormulaMode(bool on);
 	bool formulaModeActive() const;
 
+	void setViewport(int firstRow, int lastRow, int firstColumn, int lastColumn);
+
 private slots:
 	void handleAspectAboutToBeAdded(const AbstractAspect* parent, const AbstractAspect* before, const AbstractAspect* child);
 	void handleAspectAdded(const AbstractAspect*);
@@ -78,17 +83,51 @@ private slots:
 	void handleDataChange(const AbstractColumn*);
 	void handleRowsInserted(const AbstractColumn* col, int before, int count);
 	void handleRowsRemoved(const AbstractColumn* col, int first, int count);
+	void handleMaskingChange(const AbstractColumn*);
+	void prefetch();
 
 protected:
 	void updateVerticalHeader();
 	void updateHorizontalHeader();
 
 private:
+	//! formatted texts of a block of consecutive rows of one column
+	struct FormattedBlock {
+		QStringList texts;
+		QBitArray valid;
+	};
+
+	//! key of a cached block: column, block index and the format/data version of the column
+	struct FormattedBlockKey {
+		FormattedBlockKey() : column(0), block(0), version(0) {}
+		FormattedBlockKey(const AbstractColumn* c, int b, int v) : column(c), block(b), version(v) {}
+		bool operator==(const FormattedBlockKey& other) const {
+			return column == other.column && block == other.block && version == other.version;
+		}
+		const AbstractColumn* column;
+		int block;
+		int version;
+	};
+	friend uint qHash(const FormattedBlockKey&);
+
+	const FormattedBlock* formattedBlock(const Column*, int block) const;
+	void invalidateFormattedCache(const AbstractColumn*);
+
 	Spreadsheet* m_spreadsheet;
 	bool m_formula_mode;
-	QList<int> m_vertical_header_data;
+	int m_rowCount;
 	QStringList m_horizontal_header_data;
 	int m_defaultHeaderHeight;
+	int m_verticalHeaderWidth;	// width needed for the largest row number
+
+	mutable QCache<FormattedBlockKey, FormattedBlock> m_formattedCache;
+	QHash<const AbstractColumn*, int> m_columnVersion;
+	int m_versionCounter;
+	int m_viewportFirstRow;
+	int m_viewportLastRow;
+	int m_viewportFirstColumn;
+	int m_viewportLastColumn;
+	bool m_prefetchPending;
 };
 
 #endif
@@ -40,6 +40,8 @@
 #include "XYFitCurve.h"
 #include "XYFourierFilterCurve.h"
 #include "XYFourierTransformCurve.h"
+#include "XYConvolutionCurve.h"
+#include "XYCorrelationCurve.h"
 #include "backend/core/Project.h"
 #include "backend/worksheet/plots/cartesian/CartesianPlotLegend.h"
 #include "backend/worksheet/plots/cartesian/CustomPoint.h"
@@ -362,6 +364,8 @@ void CartesianPlot::initActions() {
 	addFitCurveAction = new KAction(KIcon("labplot-xy-fit-curve"), i18n("xy-curve from a fit to data"), this);
 	addFourierFilterCurveAction = new KAction(i18n("xy-curve from a Fourier filter"), this);
 	addFourierTransformCurveAction = new KAction(i18n("xy-curve from a Fourier transform"), this);
+	addConvolutionCurveAction = new KAction(i18n("xy-curve from a convolution"), this);
+	addCorrelationCurveAction = new KAction(i18n("xy-curve from a correlation"), this);
 //	addInterpolationCurveAction = new KAction(KIcon("labplot-xy-interpolation-curve"), i18n("xy-curve from an interpolation"), this);
 //	addSmoothCurveAction = new KAction(KIcon("labplot-xy-smooth-curve"), i18n("xy-curve from a smooth"), this);
 //	addFourierFilterCurveAction = new KAction(KIcon("labplot-xy-fourier_filter-curve"), i18n("xy-curve from a Fourier filter"), this);
@@ -378,6 +382,8 @@ void CartesianPlot::initActions() {
 	connect(addFitCurveAction, SIGNAL(triggered()), SLOT(addFitCurve()));
 	connect(addFourierFilterCurveAction, SIGNAL(triggered()), SLOT(addFourierFilterCurve()));
 	connect(addFourierTransformCurveAction, SIGNAL(triggered()), SLOT(addFourierTransformCurve()));
+	connect(addConvolutionCurveAction, SIGNAL(triggered()), SLOT(addConvolutionCurve()));
+	connect(addCorrelationCurveAction, SIGNAL(triggered()), SLOT(addCorrelationCurve()));
 	connect(addLegendAction, SIGNAL(triggered()), SLOT(addLegend()));
 	connect(addHorizontalAxisAction, SIGNAL(triggered()), SLOT(addHorizontalAxis()));
 	connect(addVerticalAxisAction, SIGNAL(triggered()), SLOT(addVerticalAxis()));
@@ -430,6 +436,8 @@ void CartesianPlot::initMenus() {
 	addNewMenu->addAction(addFitCurveAction);
 	addNewMenu->addAction(addFourierFilterCurveAction);
 	addNewMenu->addAction(addFourierTransformCurveAction);
+	addNewMenu->addAction(addConvolutionCurveAction);
+	addNewMenu->addAction(addCorrelationCurveAction);
 	addNewMenu->addAction(addLegendAction);
 	addNewMenu->addSeparator();
 	addNewMenu->addAction(addHorizontalAxisAction);
@@ -799,6 +807,20 @@ XYFourierTransformCurve* CartesianPlot::addFourierTransformCurve() {
 	return curve;
 }
 
+XYConvolutionCurve* CartesianPlot::addConvolutionCurve() {
+	XYConvolutionCurve* curve = new XYConvolutionCurve("Convolution");
+	this->addChild(curve);
+	this->applyThemeOnNewCurve(curve);
+	return curve;
+}
+
+XYCorrelationCurve* CartesianPlot::addCorrelationCurve() {
+	XYCorrelationCurve* curve = new XYCorrelationCurve("Correlation");
+	this->addChild(curve);
+	this->applyThemeOnNewCurve(curve);
+	return curve;
+}
+
 void CartesianPlot::addLegend() {
 	//don't do anything if there's already a legend
 	if (m_legend)
@@ -2161,6 +2183,18 @@ bool CartesianPlot::load(XmlStreamReader* reader) {
 				removeChild(curve);
 				return false;
 			}
+		} else if (reader->name() == "xyConvolutionCurve") {
+			XYConvolutionCurve* curve = addConvolutionCurve();
+			if (!curve->load(reader)) {
+				removeChild(curve);
+				return false;
+			}
+		} else if (reader->name() == "xyCorrelationCurve") {
+			XYCorrelationCurve* curve = addCorrelationCurve();
+			if (!curve->load(reader)) {
+				removeChild(curve);
+				return false;
+			}
 		} else if (reader->name() == "xySmoothCurve") {
 			XYSmoothCurve* curve = addSmoothCurve();
 			if (!curve->load(reader)) {
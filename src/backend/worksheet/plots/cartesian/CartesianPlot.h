@@ -47,6 +47,8 @@ class XYFitCurve;
 class XYFourierFilterCurve;
 class KConfig;
 class XYFourierTransformCurve;
+class XYConvolutionCurve;
+class XYCorrelationCurve;
 
 class CartesianPlot:public AbstractPlot{
 	Q_OBJECT
@@ -132,6 +134,8 @@ class CartesianPlot:public AbstractPlot{
 		QAction* addFitCurveAction;
 		QAction* addFourierFilterCurveAction;
 		QAction* addFourierTransformCurveAction;
+		QAction* addConvolutionCurveAction;
+		QAction* addCorrelationCurveAction;
 		QAction* addHorizontalAxisAction;
 		QAction* addVerticalAxisAction;
  		QAction* addLegendAction;
@@ -170,6 +174,8 @@ class CartesianPlot:public AbstractPlot{
 		XYFitCurve* addFitCurve();
 		XYFourierFilterCurve* addFourierFilterCurve();
 		XYFourierTransformCurve* addFourierTransformCurve();
+		XYConvolutionCurve* addConvolutionCurve();
+		XYCorrelationCurve* addCorrelationCurve();
 		void addLegend();
 		void addCustomPoint();
 		void scaleAuto();
@@ -0,0 +1,446 @@
+/***************************************************************************
+    File                 : XYConvolutionCurve.cpp
+    Project              : LabPlot
+    Description          : A xy-curve defined by a convolution
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+/*!
+  \class XYConvolutionCurve
+  \brief A xy-curve defined by a convolution or deconvolution of two data sets
+
+  The data sets are assumed to be sampled equidistantly with the x-values of the first one.
+  Long data sets are processed with zero padded FFTs, short ones directly.
+
+  \ingroup worksheet
+*/
+
+#include "XYConvolutionCurve.h"
+#include "XYConvolutionCurvePrivate.h"
+#include "backend/core/AbstractColumn.h"
+#include "backend/core/column/Column.h"
+#include "backend/lib/commandtemplates.h"
+#include "backend/lib/macros.h"
+
+#include <cmath>	// isnan
+extern "C" {
+#include <gsl/gsl_errno.h>
+}
+
+#include <KIcon>
+#include <KLocale>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QThreadPool>
+
+XYConvolutionCurve::XYConvolutionCurve(const QString& name)
+		: XYCurve(name, new XYConvolutionCurvePrivate(this)) {
+	init();
+}
+
+XYConvolutionCurve::XYConvolutionCurve(const QString& name, XYConvolutionCurvePrivate* dd)
+		: XYCurve(name, dd) {
+	init();
+}
+
+
+XYConvolutionCurve::~XYConvolutionCurve() {
+	//no need to delete the d-pointer here - it inherits from QGraphicsItem
+	//and is deleted during the cleanup in QGraphicsScene
+}
+
+void XYConvolutionCurve::init() {
+	Q_D(XYConvolutionCurve);
+
+	d->lineType = XYCurve::Line;
+	d->symbolsStyle = Symbol::NoSymbols;
+}
+
+void XYConvolutionCurve::recalculate() {
+	Q_D(XYConvolutionCurve);
+	d->recalculate();
+}
+
+/*!
+	Returns an icon to be used in the project explorer.
+*/
+QIcon XYConvolutionCurve::icon() const {
+	return KIcon("labplot-xy-convolution-curve");
+}
+
+//##############################################################################
+//##########################  getter methods  ##################################
+//##############################################################################
+BASIC_SHARED_D_READER_IMPL(XYConvolutionCurve, const AbstractColumn*, xDataColumn, xDataColumn)
+BASIC_SHARED_D_READER_IMPL(XYConvolutionCurve, const AbstractColumn*, yDataColumn, yDataColumn)
+BASIC_SHARED_D_READER_IMPL(XYConvolutionCurve, const AbstractColumn*, y2DataColumn, y2DataColumn)
+const QString& XYConvolutionCurve::xDataColumnPath() const { Q_D(const XYConvolutionCurve); return d->xDataColumnPath; }
+const QString& XYConvolutionCurve::yDataColumnPath() const { Q_D(const XYConvolutionCurve); return d->yDataColumnPath; }
+const QString& XYConvolutionCurve::y2DataColumnPath() const { Q_D(const XYConvolutionCurve); return d->y2DataColumnPath; }
+
+BASIC_SHARED_D_READER_IMPL(XYConvolutionCurve, XYConvolutionCurve::ConvolutionData, convolutionData, convolutionData)
+
+const XYConvolutionCurve::ConvolutionResult& XYConvolutionCurve::convolutionResult() const {
+	Q_D(const XYConvolutionCurve);
+	return d->convolutionResult;
+}
+
+bool XYConvolutionCurve::isSourceDataChangedSinceLastConvolution() const {
+	Q_D(const XYConvolutionCurve);
+	return d->sourceDataChangedSinceLastConvolution;
+}
+
+//##############################################################################
+//#################  setter methods and undo commands ##########################
+//##############################################################################
+STD_SETTER_CMD_IMPL_S(XYConvolutionCurve, SetXDataColumn, const AbstractColumn*, xDataColumn)
+void XYConvolutionCurve::setXDataColumn(const AbstractColumn* column) {
+	Q_D(XYConvolutionCurve);
+	if (column != d->xDataColumn) {
+		exec(new XYConvolutionCurveSetXDataColumnCmd(d, column, i18n("%1: assign x-data")));
+		emit sourceDataChangedSinceLastConvolution();
+		if (column) {
+			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(handleSourceDataChanged()));
+			//TODO disconnect on undo
+		}
+	}
+}
+
+STD_SETTER_CMD_IMPL_S(XYConvolutionCurve, SetYDataColumn, const AbstractColumn*, yDataColumn)
+void XYConvolutionCurve::setYDataColumn(const AbstractColumn* column) {
+	Q_D(XYConvolutionCurve);
+	if (column != d->yDataColumn) {
+		exec(new XYConvolutionCurveSetYDataColumnCmd(d, column, i18n("%1: assign y-data")));
+		emit sourceDataChangedSinceLastConvolution();
+		if (column) {
+			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(handleSourceDataChanged()));
+			//TODO disconnect on undo
+		}
+	}
+}
+
+STD_SETTER_CMD_IMPL_S(XYConvolutionCurve, SetY2DataColumn, const AbstractColumn*, y2DataColumn)
+void XYConvolutionCurve::setY2DataColumn(const AbstractColumn* column) {
+	Q_D(XYConvolutionCurve);
+	if (column != d->y2DataColumn) {
+		exec(new XYConvolutionCurveSetY2DataColumnCmd(d, column, i18n("%1: assign y2-data")));
+		emit sourceDataChangedSinceLastConvolution();
+		if (column) {
+			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(handleSourceDataChanged()));
+			//TODO disconnect on undo
+		}
+	}
+}
+
+STD_SETTER_CMD_IMPL_F_S(XYConvolutionCurve, SetConvolutionData, XYConvolutionCurve::ConvolutionData, convolutionData, recalculate);
+void XYConvolutionCurve::setConvolutionData(const XYConvolutionCurve::ConvolutionData& convolutionData) {
+	Q_D(XYConvolutionCurve);
+	exec(new XYConvolutionCurveSetConvolutionDataCmd(d, convolutionData, i18n("%1: set options and perform the convolution")));
+}
+
+//##############################################################################
+//################################## SLOTS ####################################
+//##############################################################################
+void XYConvolutionCurve::handleSourceDataChanged() {
+	Q_D(XYConvolutionCurve);
+	d->sourceDataChangedSinceLastConvolution = true;
+	emit sourceDataChangedSinceLastConvolution();
+}
+//##############################################################################
+//######################### Private implementation #############################
+//##############################################################################
+XYConvolutionCurvePrivate::XYConvolutionCurvePrivate(XYConvolutionCurve* owner) : XYCurvePrivate(owner),
+	xDataColumn(0), yDataColumn(0), y2DataColumn(0),
+	xColumn(0), yColumn(0),
+	xVector(0), yVector(0),
+	sourceDataChangedSinceLastConvolution(false),
+	q(owner) {
+
+}
+
+XYConvolutionCurvePrivate::~XYConvolutionCurvePrivate() {
+	//no need to delete xColumn and yColumn, they are deleted
+	//when the parent aspect is removed
+}
+
+void XYConvolutionCurvePrivate::recalculate() {
+	QElapsedTimer timer;
+	timer.start();
+
+	//create result columns if not available yet, clear them otherwise
+	if (!xColumn) {
+		xColumn = new Column("x", AbstractColumn::Numeric);
+		yColumn = new Column("y", AbstractColumn::Numeric);
+		xVector = static_cast<QVector<double>* >(xColumn->data());
+		yVector = static_cast<QVector<double>* >(yColumn->data());
+
+		xColumn->setHidden(true);
+		q->addChild(xColumn);
+		yColumn->setHidden(true);
+		q->addChild(yColumn);
+
+		q->setUndoAware(false);
+		q->setXColumn(xColumn);
+		q->setYColumn(yColumn);
+		q->setUndoAware(true);
+	} else {
+		xVector->clear();
+		yVector->clear();
+	}
+
+	// clear the previous result
+	convolutionResult = XYConvolutionCurve::ConvolutionResult();
+
+	if (!xDataColumn || !yDataColumn || !y2DataColumn) {
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastConvolution = false;
+		return;
+	}
+
+	//check column sizes
+	if (xDataColumn->rowCount()!=yDataColumn->rowCount()) {
+		convolutionResult.available = true;
+		convolutionResult.valid = false;
+		convolutionResult.status = i18n("Number of x and y data points must be equal.");
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastConvolution = false;
+		return;
+	}
+
+	//copy all valid data points to temporary vectors.
+	//the y2-data may have another number of valid points, it shares the x-data with the y-data
+	QVector<double> xdataVector;
+	QVector<double> ydataVector;
+	QVector<double> y2dataVector;
+	double xmin, xmax;
+	if (convolutionData.autoRange) {
+		xmin = xDataColumn->minimum();
+		xmax = xDataColumn->maximum();
+	} else {
+		xmin = convolutionData.xRange.first();
+		xmax = convolutionData.xRange.last();
+	}
+	for (int row=0; row<xDataColumn->rowCount(); ++row) {
+		const double x = xDataColumn->valueAt(row);
+		if (std::isnan(x) || xDataColumn->isMasked(row) || x < xmin || x > xmax)
+			continue;
+
+		if (!std::isnan(yDataColumn->valueAt(row)) && !yDataColumn->isMasked(row)) {
+			xdataVector.append(x);
+			ydataVector.append(yDataColumn->valueAt(row));
+		}
+		if (y2DataColumn && row < y2DataColumn->rowCount()
+				&& !std::isnan(y2DataColumn->valueAt(row)) && !y2DataColumn->isMasked(row))
+			y2dataVector.append(y2DataColumn->valueAt(row));
+	}
+
+	//number of data points
+	const unsigned int n = ydataVector.size();
+	unsigned int m = y2dataVector.size();
+	if (n == 0) {
+		convolutionResult.available = true;
+		convolutionResult.valid = false;
+		convolutionResult.status = i18n("No data points available.");
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastConvolution = false;
+		return;
+	}
+
+	// sampling interval
+	const double dx = (n > 1) ? (xdataVector.last() - xdataVector.first())/(n - 1) : 1.;
+
+	// settings
+	const nsl_conv_type_type type = convolutionData.type;
+	const nsl_conv_method_type method = convolutionData.method;
+
+	DEBUG("n ="<<n<<", m ="<<m);
+	DEBUG("type:"<<nsl_conv_type_name[type]);
+	DEBUG("method:"<<nsl_conv_method_name[method]);
+
+///////////////////////////////////////////////////////////
+	if (m == 0) {
+		convolutionResult.available = true;
+		convolutionResult.valid = false;
+		convolutionResult.status = i18n("No response data points available.");
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastConvolution = false;
+		return;
+	}
+	if (type == nsl_conv_type_deconvolution && m > n) {
+		convolutionResult.available = true;
+		convolutionResult.valid = false;
+		convolutionResult.status = i18n("The response must not have more data points than the signal.");
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastConvolution = false;
+		return;
+	}
+
+	// the result is sampled like the signal, starting at its first point
+	const unsigned int np = (type == nsl_conv_type_convolution) ? n+m-1 : n-m+1;
+	xVector->resize(np);
+	yVector->resize(np);
+	int status;
+	if (type == nsl_conv_type_convolution)
+		status = nsl_conv_convolution(ydataVector.constData(), n, y2dataVector.constData(), m, yVector->data(), method);
+	else
+		status = nsl_conv_deconvolution(ydataVector.constData(), n, y2dataVector.constData(), m, yVector->data(), method);
+
+	double* xdata = xVector->data();
+	for (unsigned int i = 0; i < np; ++i)
+		xdata[i] = xdataVector.first() + i*dx;
+///////////////////////////////////////////////////////////
+
+	//write the result
+	convolutionResult.available = true;
+	convolutionResult.valid = (status == 0);
+	convolutionResult.status = QString(gsl_strerror(status));
+	convolutionResult.elapsedTime = timer.elapsed();
+
+	//redraw the curve
+	emit (q->dataChanged());
+	sourceDataChangedSinceLastConvolution = false;
+}
+
+//##############################################################################
+//##################  Serialization/Deserialization  ###########################
+//##############################################################################
+//! Save as XML
+void XYConvolutionCurve::save(QXmlStreamWriter* writer) const{
+	Q_D(const XYConvolutionCurve);
+
+	writer->writeStartElement("xyConvolutionCurve");
+
+	//write xy-curve information
+	XYCurve::save(writer);
+
+	//write xy-convolution-curve specific information
+	//convolution data
+	writer->writeStartElement("convolutionData");
+	WRITE_COLUMN(d->xDataColumn, xDataColumn);
+	WRITE_COLUMN(d->yDataColumn, yDataColumn);
+	WRITE_COLUMN(d->y2DataColumn, y2DataColumn);
+	writer->writeAttribute( "autoRange", QString::number(d->convolutionData.autoRange) );
+	writer->writeAttribute( "xRangeMin", QString::number(d->convolutionData.xRange.first()) );
+	writer->writeAttribute( "xRangeMax", QString::number(d->convolutionData.xRange.last()) );
+	writer->writeAttribute( "type", QString::number(d->convolutionData.type) );
+	writer->writeAttribute( "method", QString::number(d->convolutionData.method) );
+	writer->writeEndElement();// convolutionData
+
+	//convolution results (generated columns)
+	writer->writeStartElement("convolutionResult");
+	writer->writeAttribute( "available", QString::number(d->convolutionResult.available) );
+	writer->writeAttribute( "valid", QString::number(d->convolutionResult.valid) );
+	writer->writeAttribute( "status", d->convolutionResult.status );
+	writer->writeAttribute( "time", QString::number(d->convolutionResult.elapsedTime) );
+
+	//save calculated columns if available
+	if (d->xColumn && d->yColumn) {
+		d->xColumn->save(writer);
+		d->yColumn->save(writer);
+	}
+	writer->writeEndElement(); //"convolutionResult"
+	writer->writeEndElement(); //"xyConvolutionCurve"
+}
+
+//! Load from XML
+bool XYConvolutionCurve::load(XmlStreamReader* reader) {
+	Q_D(XYConvolutionCurve);
+
+	if (!reader->isStartElement() || reader->name() != "xyConvolutionCurve") {
+		reader->raiseError(i18n("no xy convolution curve element found"));
+		return false;
+	}
+
+	QString attributeWarning = i18n("Attribute '%1' missing or empty, default value is used");
+	QXmlStreamAttributes attribs;
+	QString str;
+
+	while (!reader->atEnd()) {
+		reader->readNext();
+		if (reader->isEndElement() && reader->name() == "xyConvolutionCurve")
+			break;
+
+		if (!reader->isStartElement())
+			continue;
+
+		if (reader->name() == "xyCurve") {
+			if ( !XYCurve::load(reader) )
+				return false;
+		} else if (reader->name() == "convolutionData") {
+			attribs = reader->attributes();
+
+			READ_COLUMN(xDataColumn);
+			READ_COLUMN(yDataColumn);
+			READ_COLUMN(y2DataColumn);
+
+			READ_INT_VALUE("autoRange", convolutionData.autoRange, bool);
+			READ_DOUBLE_VALUE("xRangeMin", convolutionData.xRange.first());
+			READ_DOUBLE_VALUE("xRangeMax", convolutionData.xRange.last());
+			READ_INT_VALUE("type", convolutionData.type, nsl_conv_type_type);
+			READ_INT_VALUE("method", convolutionData.method, nsl_conv_method_type);
+		} else if (reader->name() == "convolutionResult") {
+
+			attribs = reader->attributes();
+
+			READ_INT_VALUE("available", convolutionResult.available, int);
+			READ_INT_VALUE("valid", convolutionResult.valid, int);
+			READ_STRING_VALUE("status", convolutionResult.status);
+			READ_INT_VALUE("time", convolutionResult.elapsedTime, int);
+		} else if (reader->name() == "column") {
+			Column* column = new Column("", AbstractColumn::Numeric);
+			if (!column->load(reader)) {
+				delete column;
+				return false;
+			}
+
+			if (column->name() == "x")
+				d->xColumn = column;
+			else if (column->name() == "y")
+				d->yColumn = column;
+		}
+	}
+
+	// wait for data to be read before using the pointers
+	QThreadPool::globalInstance()->waitForDone();
+
+	if (d->xColumn && d->yColumn) {
+		d->xColumn->setHidden(true);
+		addChild(d->xColumn);
+
+		d->yColumn->setHidden(true);
+		addChild(d->yColumn);
+
+		d->xVector = static_cast<QVector<double>* >(d->xColumn->data());
+		d->yVector = static_cast<QVector<double>* >(d->yColumn->data());
+
+		setUndoAware(false);
+		XYCurve::d_ptr->xColumn = d->xColumn;
+		XYCurve::d_ptr->yColumn = d->yColumn;
+		setUndoAware(true);
+	} else {
+		qWarning()<<"	d->xColumn == NULL!";
+	}
+
+	return true;
+}
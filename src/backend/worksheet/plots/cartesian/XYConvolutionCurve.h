@@ -0,0 +1,105 @@
+/***************************************************************************
+    File                 : XYConvolutionCurve.h
+    Project              : LabPlot
+    Description          : A xy-curve defined by a convolution
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef XYCONVOLUTIONCURVE_H
+#define XYCONVOLUTIONCURVE_H
+
+#include "backend/worksheet/plots/cartesian/XYCurve.h"
+extern "C" {
+#include "backend/nsl/nsl_conv.h"
+}
+
+class XYConvolutionCurvePrivate;
+class XYConvolutionCurve: public XYCurve {
+	Q_OBJECT
+
+	public:
+		struct ConvolutionData {
+			ConvolutionData() : type(nsl_conv_type_convolution), method(nsl_conv_method_auto),
+				autoRange(true), xRange(2) {};
+
+			nsl_conv_type_type type;			// convolution or deconvolution
+			nsl_conv_method_type method;		// direct, FFT or automatic choice
+			bool autoRange;			// use all data?
+			QVector<double> xRange;		// x range for the convolution
+		};
+		struct ConvolutionResult {
+			ConvolutionResult() : available(false), valid(false), elapsedTime(0) {};
+
+			bool available;
+			bool valid;
+			QString status;
+			qint64 elapsedTime;
+		};
+
+		explicit XYConvolutionCurve(const QString& name);
+		virtual ~XYConvolutionCurve();
+
+		void recalculate();
+		virtual QIcon icon() const;
+		virtual void save(QXmlStreamWriter*) const;
+		virtual bool load(XmlStreamReader*);
+
+		POINTER_D_ACCESSOR_DECL(const AbstractColumn, xDataColumn, XDataColumn)
+		POINTER_D_ACCESSOR_DECL(const AbstractColumn, yDataColumn, YDataColumn)
+		POINTER_D_ACCESSOR_DECL(const AbstractColumn, y2DataColumn, Y2DataColumn)
+		const QString& xDataColumnPath() const;
+		const QString& yDataColumnPath() const;
+		const QString& y2DataColumnPath() const;
+
+		CLASS_D_ACCESSOR_DECL(ConvolutionData, convolutionData, ConvolutionData)
+		const ConvolutionResult& convolutionResult() const;
+		bool isSourceDataChangedSinceLastConvolution() const;
+
+		typedef WorksheetElement BaseClass;
+		typedef XYConvolutionCurvePrivate Private;
+
+	protected:
+		XYConvolutionCurve(const QString& name, XYConvolutionCurvePrivate* dd);
+
+	private:
+		Q_DECLARE_PRIVATE(XYConvolutionCurve)
+		void init();
+
+	private slots:
+		void handleSourceDataChanged();
+
+	signals:
+		friend class XYConvolutionCurveSetXDataColumnCmd;
+		friend class XYConvolutionCurveSetYDataColumnCmd;
+		friend class XYConvolutionCurveSetY2DataColumnCmd;
+		void xDataColumnChanged(const AbstractColumn*);
+		void yDataColumnChanged(const AbstractColumn*);
+		void y2DataColumnChanged(const AbstractColumn*);
+
+		friend class XYConvolutionCurveSetConvolutionDataCmd;
+		void convolutionDataChanged(const XYConvolutionCurve::ConvolutionData&);
+		void sourceDataChangedSinceLastConvolution();
+};
+
+#endif
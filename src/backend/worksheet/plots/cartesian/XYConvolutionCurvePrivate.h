@@ -0,0 +1,64 @@
+/***************************************************************************
+    File                 : XYConvolutionCurvePrivate.h
+    Project              : LabPlot
+    Description          : Private members of XYConvolutionCurve
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef XYCONVOLUTIONCURVEPRIVATE_H
+#define XYCONVOLUTIONCURVEPRIVATE_H
+
+#include "backend/worksheet/plots/cartesian/XYCurvePrivate.h"
+#include "backend/worksheet/plots/cartesian/XYConvolutionCurve.h"
+
+class XYConvolutionCurve;
+class Column;
+
+class XYConvolutionCurvePrivate: public XYCurvePrivate {
+	public:
+		explicit XYConvolutionCurvePrivate(XYConvolutionCurve*);
+		~XYConvolutionCurvePrivate();
+		void recalculate();
+
+		const AbstractColumn* xDataColumn; //<! column storing the values for the x-data
+		const AbstractColumn* yDataColumn; //<! column storing the values for the y-data
+		const AbstractColumn* y2DataColumn; //<! column storing the values for the response
+		QString xDataColumnPath;
+		QString yDataColumnPath;
+		QString y2DataColumnPath;
+
+		XYConvolutionCurve::ConvolutionData convolutionData;
+		XYConvolutionCurve::ConvolutionResult convolutionResult;
+
+		Column* xColumn; //<! column used internally for storing the x-values of the result curve
+		Column* yColumn; //<! column used internally for storing the y-values of the result curve
+		QVector<double>* xVector;
+		QVector<double>* yVector;
+
+		bool sourceDataChangedSinceLastConvolution; //<! \c true if the data in the source columns (x, y, y2) was changed, \c false otherwise
+
+		XYConvolutionCurve* const q;
+};
+
+#endif
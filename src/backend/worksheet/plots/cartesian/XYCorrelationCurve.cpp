@@ -0,0 +1,442 @@
+/***************************************************************************
+    File                 : XYCorrelationCurve.cpp
+    Project              : LabPlot
+    Description          : A xy-curve defined by a correlation
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+/*!
+  \class XYCorrelationCurve
+  \brief A xy-curve defined by the cross-correlation of two data sets or the autocorrelation of one
+
+  The data sets are assumed to be sampled equidistantly with the x-values of the first one.
+  Long data sets are processed with zero padded FFTs, short ones directly.
+
+  \ingroup worksheet
+*/
+
+#include "XYCorrelationCurve.h"
+#include "XYCorrelationCurvePrivate.h"
+#include "backend/core/AbstractColumn.h"
+#include "backend/core/column/Column.h"
+#include "backend/lib/commandtemplates.h"
+#include "backend/lib/macros.h"
+
+#include <cmath>	// isnan
+extern "C" {
+#include <gsl/gsl_errno.h>
+}
+
+#include <KIcon>
+#include <KLocale>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QThreadPool>
+
+XYCorrelationCurve::XYCorrelationCurve(const QString& name)
+		: XYCurve(name, new XYCorrelationCurvePrivate(this)) {
+	init();
+}
+
+XYCorrelationCurve::XYCorrelationCurve(const QString& name, XYCorrelationCurvePrivate* dd)
+		: XYCurve(name, dd) {
+	init();
+}
+
+
+XYCorrelationCurve::~XYCorrelationCurve() {
+	//no need to delete the d-pointer here - it inherits from QGraphicsItem
+	//and is deleted during the cleanup in QGraphicsScene
+}
+
+void XYCorrelationCurve::init() {
+	Q_D(XYCorrelationCurve);
+
+	d->lineType = XYCurve::Line;
+	d->symbolsStyle = Symbol::NoSymbols;
+}
+
+void XYCorrelationCurve::recalculate() {
+	Q_D(XYCorrelationCurve);
+	d->recalculate();
+}
+
+/*!
+	Returns an icon to be used in the project explorer.
+*/
+QIcon XYCorrelationCurve::icon() const {
+	return KIcon("labplot-xy-correlation-curve");
+}
+
+//##############################################################################
+//##########################  getter methods  ##################################
+//##############################################################################
+BASIC_SHARED_D_READER_IMPL(XYCorrelationCurve, const AbstractColumn*, xDataColumn, xDataColumn)
+BASIC_SHARED_D_READER_IMPL(XYCorrelationCurve, const AbstractColumn*, yDataColumn, yDataColumn)
+BASIC_SHARED_D_READER_IMPL(XYCorrelationCurve, const AbstractColumn*, y2DataColumn, y2DataColumn)
+const QString& XYCorrelationCurve::xDataColumnPath() const { Q_D(const XYCorrelationCurve); return d->xDataColumnPath; }
+const QString& XYCorrelationCurve::yDataColumnPath() const { Q_D(const XYCorrelationCurve); return d->yDataColumnPath; }
+const QString& XYCorrelationCurve::y2DataColumnPath() const { Q_D(const XYCorrelationCurve); return d->y2DataColumnPath; }
+
+BASIC_SHARED_D_READER_IMPL(XYCorrelationCurve, XYCorrelationCurve::CorrelationData, correlationData, correlationData)
+
+const XYCorrelationCurve::CorrelationResult& XYCorrelationCurve::correlationResult() const {
+	Q_D(const XYCorrelationCurve);
+	return d->correlationResult;
+}
+
+bool XYCorrelationCurve::isSourceDataChangedSinceLastCorrelation() const {
+	Q_D(const XYCorrelationCurve);
+	return d->sourceDataChangedSinceLastCorrelation;
+}
+
+//##############################################################################
+//#################  setter methods and undo commands ##########################
+//##############################################################################
+STD_SETTER_CMD_IMPL_S(XYCorrelationCurve, SetXDataColumn, const AbstractColumn*, xDataColumn)
+void XYCorrelationCurve::setXDataColumn(const AbstractColumn* column) {
+	Q_D(XYCorrelationCurve);
+	if (column != d->xDataColumn) {
+		exec(new XYCorrelationCurveSetXDataColumnCmd(d, column, i18n("%1: assign x-data")));
+		emit sourceDataChangedSinceLastCorrelation();
+		if (column) {
+			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(handleSourceDataChanged()));
+			//TODO disconnect on undo
+		}
+	}
+}
+
+STD_SETTER_CMD_IMPL_S(XYCorrelationCurve, SetYDataColumn, const AbstractColumn*, yDataColumn)
+void XYCorrelationCurve::setYDataColumn(const AbstractColumn* column) {
+	Q_D(XYCorrelationCurve);
+	if (column != d->yDataColumn) {
+		exec(new XYCorrelationCurveSetYDataColumnCmd(d, column, i18n("%1: assign y-data")));
+		emit sourceDataChangedSinceLastCorrelation();
+		if (column) {
+			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(handleSourceDataChanged()));
+			//TODO disconnect on undo
+		}
+	}
+}
+
+STD_SETTER_CMD_IMPL_S(XYCorrelationCurve, SetY2DataColumn, const AbstractColumn*, y2DataColumn)
+void XYCorrelationCurve::setY2DataColumn(const AbstractColumn* column) {
+	Q_D(XYCorrelationCurve);
+	if (column != d->y2DataColumn) {
+		exec(new XYCorrelationCurveSetY2DataColumnCmd(d, column, i18n("%1: assign y2-data")));
+		emit sourceDataChangedSinceLastCorrelation();
+		if (column) {
+			connect(column, SIGNAL(dataChanged(const AbstractColumn*)), this, SLOT(handleSourceDataChanged()));
+			//TODO disconnect on undo
+		}
+	}
+}
+
+STD_SETTER_CMD_IMPL_F_S(XYCorrelationCurve, SetCorrelationData, XYCorrelationCurve::CorrelationData, correlationData, recalculate);
+void XYCorrelationCurve::setCorrelationData(const XYCorrelationCurve::CorrelationData& correlationData) {
+	Q_D(XYCorrelationCurve);
+	exec(new XYCorrelationCurveSetCorrelationDataCmd(d, correlationData, i18n("%1: set options and perform the correlation")));
+}
+
+//##############################################################################
+//################################## SLOTS ####################################
+//##############################################################################
+void XYCorrelationCurve::handleSourceDataChanged() {
+	Q_D(XYCorrelationCurve);
+	d->sourceDataChangedSinceLastCorrelation = true;
+	emit sourceDataChangedSinceLastCorrelation();
+}
+//##############################################################################
+//######################### Private implementation #############################
+//##############################################################################
+XYCorrelationCurvePrivate::XYCorrelationCurvePrivate(XYCorrelationCurve* owner) : XYCurvePrivate(owner),
+	xDataColumn(0), yDataColumn(0), y2DataColumn(0),
+	xColumn(0), yColumn(0),
+	xVector(0), yVector(0),
+	sourceDataChangedSinceLastCorrelation(false),
+	q(owner) {
+
+}
+
+XYCorrelationCurvePrivate::~XYCorrelationCurvePrivate() {
+	//no need to delete xColumn and yColumn, they are deleted
+	//when the parent aspect is removed
+}
+
+void XYCorrelationCurvePrivate::recalculate() {
+	QElapsedTimer timer;
+	timer.start();
+
+	//create result columns if not available yet, clear them otherwise
+	if (!xColumn) {
+		xColumn = new Column("x", AbstractColumn::Numeric);
+		yColumn = new Column("y", AbstractColumn::Numeric);
+		xVector = static_cast<QVector<double>* >(xColumn->data());
+		yVector = static_cast<QVector<double>* >(yColumn->data());
+
+		xColumn->setHidden(true);
+		q->addChild(xColumn);
+		yColumn->setHidden(true);
+		q->addChild(yColumn);
+
+		q->setUndoAware(false);
+		q->setXColumn(xColumn);
+		q->setYColumn(yColumn);
+		q->setUndoAware(true);
+	} else {
+		xVector->clear();
+		yVector->clear();
+	}
+
+	// clear the previous result
+	correlationResult = XYCorrelationCurve::CorrelationResult();
+
+	if (!xDataColumn || !yDataColumn) {
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastCorrelation = false;
+		return;
+	}
+
+	//check column sizes
+	if (xDataColumn->rowCount()!=yDataColumn->rowCount()) {
+		correlationResult.available = true;
+		correlationResult.valid = false;
+		correlationResult.status = i18n("Number of x and y data points must be equal.");
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastCorrelation = false;
+		return;
+	}
+
+	//copy all valid data points to temporary vectors.
+	//the y2-data may have another number of valid points, it shares the x-data with the y-data
+	QVector<double> xdataVector;
+	QVector<double> ydataVector;
+	QVector<double> y2dataVector;
+	double xmin, xmax;
+	if (correlationData.autoRange) {
+		xmin = xDataColumn->minimum();
+		xmax = xDataColumn->maximum();
+	} else {
+		xmin = correlationData.xRange.first();
+		xmax = correlationData.xRange.last();
+	}
+	for (int row=0; row<xDataColumn->rowCount(); ++row) {
+		const double x = xDataColumn->valueAt(row);
+		if (std::isnan(x) || xDataColumn->isMasked(row) || x < xmin || x > xmax)
+			continue;
+
+		if (!std::isnan(yDataColumn->valueAt(row)) && !yDataColumn->isMasked(row)) {
+			xdataVector.append(x);
+			ydataVector.append(yDataColumn->valueAt(row));
+		}
+		if (y2DataColumn && row < y2DataColumn->rowCount()
+				&& !std::isnan(y2DataColumn->valueAt(row)) && !y2DataColumn->isMasked(row))
+			y2dataVector.append(y2DataColumn->valueAt(row));
+	}
+
+	//number of data points
+	const unsigned int n = ydataVector.size();
+	unsigned int m = y2dataVector.size();
+	if (n == 0) {
+		correlationResult.available = true;
+		correlationResult.valid = false;
+		correlationResult.status = i18n("No data points available.");
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastCorrelation = false;
+		return;
+	}
+
+	// sampling interval
+	const double dx = (n > 1) ? (xdataVector.last() - xdataVector.first())/(n - 1) : 1.;
+
+	// settings
+	const bool autocorrelation = correlationData.autocorrelation;
+	const nsl_corr_norm_type normalization = correlationData.normalization;
+	const nsl_conv_method_type method = correlationData.method;
+
+	DEBUG("n ="<<n<<", m ="<<m);
+	DEBUG("autocorrelation:"<<autocorrelation);
+	DEBUG("normalization:"<<nsl_corr_norm_name[normalization]);
+	DEBUG("method:"<<nsl_conv_method_name[method]);
+
+///////////////////////////////////////////////////////////
+	// the autocorrelation uses the y-data twice, only one transform is needed then
+	const double* y2data = autocorrelation ? ydataVector.constData() : y2dataVector.constData();
+	if (autocorrelation)
+		m = n;
+	if (m == 0) {
+		correlationResult.available = true;
+		correlationResult.valid = false;
+		correlationResult.status = i18n("No data points of the second data set available.");
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastCorrelation = false;
+		return;
+	}
+
+	// x-values are the lags -(m-1)*dx .. (n-1)*dx
+	const unsigned int np = n+m-1;
+	xVector->resize(np);
+	yVector->resize(np);
+	int status = nsl_corr_correlation(ydataVector.constData(), n, y2data, m, normalization, yVector->data(), method);
+
+	double* xdata = xVector->data();
+	for (unsigned int i = 0; i < np; ++i)
+		xdata[i] = ((int)i - (int)m + 1)*dx;
+///////////////////////////////////////////////////////////
+
+	//write the result
+	correlationResult.available = true;
+	correlationResult.valid = (status == 0);
+	correlationResult.status = QString(gsl_strerror(status));
+	correlationResult.elapsedTime = timer.elapsed();
+
+	//redraw the curve
+	emit (q->dataChanged());
+	sourceDataChangedSinceLastCorrelation = false;
+}
+
+//##############################################################################
+//##################  Serialization/Deserialization  ###########################
+//##############################################################################
+//! Save as XML
+void XYCorrelationCurve::save(QXmlStreamWriter* writer) const{
+	Q_D(const XYCorrelationCurve);
+
+	writer->writeStartElement("xyCorrelationCurve");
+
+	//write xy-curve information
+	XYCurve::save(writer);
+
+	//write xy-correlation-curve specific information
+	//correlation data
+	writer->writeStartElement("correlationData");
+	WRITE_COLUMN(d->xDataColumn, xDataColumn);
+	WRITE_COLUMN(d->yDataColumn, yDataColumn);
+	WRITE_COLUMN(d->y2DataColumn, y2DataColumn);
+	writer->writeAttribute( "autoRange", QString::number(d->correlationData.autoRange) );
+	writer->writeAttribute( "xRangeMin", QString::number(d->correlationData.xRange.first()) );
+	writer->writeAttribute( "xRangeMax", QString::number(d->correlationData.xRange.last()) );
+	writer->writeAttribute( "autocorrelation", QString::number(d->correlationData.autocorrelation) );
+	writer->writeAttribute( "normalization", QString::number(d->correlationData.normalization) );
+	writer->writeAttribute( "method", QString::number(d->correlationData.method) );
+	writer->writeEndElement();// correlationData
+
+	//correlation results (generated columns)
+	writer->writeStartElement("correlationResult");
+	writer->writeAttribute( "available", QString::number(d->correlationResult.available) );
+	writer->writeAttribute( "valid", QString::number(d->correlationResult.valid) );
+	writer->writeAttribute( "status", d->correlationResult.status );
+	writer->writeAttribute( "time", QString::number(d->correlationResult.elapsedTime) );
+
+	//save calculated columns if available
+	if (d->xColumn && d->yColumn) {
+		d->xColumn->save(writer);
+		d->yColumn->save(writer);
+	}
+	writer->writeEndElement(); //"correlationResult"
+	writer->writeEndElement(); //"xyCorrelationCurve"
+}
+
+//! Load from XML
+bool XYCorrelationCurve::load(XmlStreamReader* reader) {
+	Q_D(XYCorrelationCurve);
+
+	if (!reader->isStartElement() || reader->name() != "xyCorrelationCurve") {
+		reader->raiseError(i18n("no xy correlation curve element found"));
+		return false;
+	}
+
+	QString attributeWarning = i18n("Attribute '%1' missing or empty, default value is used");
+	QXmlStreamAttributes attribs;
+	QString str;
+
+	while (!reader->atEnd()) {
+		reader->readNext();
+		if (reader->isEndElement() && reader->name() == "xyCorrelationCurve")
+			break;
+
+		if (!reader->isStartElement())
+			continue;
+
+		if (reader->name() == "xyCurve") {
+			if ( !XYCurve::load(reader) )
+				return false;
+		} else if (reader->name() == "correlationData") {
+			attribs = reader->attributes();
+
+			READ_COLUMN(xDataColumn);
+			READ_COLUMN(yDataColumn);
+			READ_COLUMN(y2DataColumn);
+
+			READ_INT_VALUE("autoRange", correlationData.autoRange, bool);
+			READ_DOUBLE_VALUE("xRangeMin", correlationData.xRange.first());
+			READ_DOUBLE_VALUE("xRangeMax", correlationData.xRange.last());
+			READ_INT_VALUE("autocorrelation", correlationData.autocorrelation, bool);
+			READ_INT_VALUE("normalization", correlationData.normalization, nsl_corr_norm_type);
+			READ_INT_VALUE("method", correlationData.method, nsl_conv_method_type);
+		} else if (reader->name() == "correlationResult") {
+
+			attribs = reader->attributes();
+
+			READ_INT_VALUE("available", correlationResult.available, int);
+			READ_INT_VALUE("valid", correlationResult.valid, int);
+			READ_STRING_VALUE("status", correlationResult.status);
+			READ_INT_VALUE("time", correlationResult.elapsedTime, int);
+		} else if (reader->name() == "column") {
+			Column* column = new Column("", AbstractColumn::Numeric);
+			if (!column->load(reader)) {
+				delete column;
+				return false;
+			}
+
+			if (column->name() == "x")
+				d->xColumn = column;
+			else if (column->name() == "y")
+				d->yColumn = column;
+		}
+	}
+
+	// wait for data to be read before using the pointers
+	QThreadPool::globalInstance()->waitForDone();
+
+	if (d->xColumn && d->yColumn) {
+		d->xColumn->setHidden(true);
+		addChild(d->xColumn);
+
+		d->yColumn->setHidden(true);
+		addChild(d->yColumn);
+
+		d->xVector = static_cast<QVector<double>* >(d->xColumn->data());
+		d->yVector = static_cast<QVector<double>* >(d->yColumn->data());
+
+		setUndoAware(false);
+		XYCurve::d_ptr->xColumn = d->xColumn;
+		XYCurve::d_ptr->yColumn = d->yColumn;
+		setUndoAware(true);
+	} else {
+		qWarning()<<"	d->xColumn == NULL!";
+	}
+
+	return true;
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+    File                 : XYCorrelationCurve.h
+    Project              : LabPlot
+    Description          : A xy-curve defined by a correlation
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef XYCORRELATIONCURVE_H
+#define XYCORRELATIONCURVE_H
+
+#include "backend/worksheet/plots/cartesian/XYCurve.h"
+extern "C" {
+#include "backend/nsl/nsl_corr.h"
+}
+
+class XYCorrelationCurvePrivate;
+class XYCorrelationCurve: public XYCurve {
+	Q_OBJECT
+
+	public:
+		struct CorrelationData {
+			CorrelationData() : autocorrelation(false), normalization(nsl_corr_norm_none), method(nsl_conv_method_auto),
+				autoRange(true), xRange(2) {};
+
+			bool autocorrelation;			// correlate the y-data with itself?
+			nsl_corr_norm_type normalization;	// normalization of the correlation
+			nsl_conv_method_type method;		// direct, FFT or automatic choice
+			bool autoRange;			// use all data?
+			QVector<double> xRange;		// x range for the correlation
+		};
+		struct CorrelationResult {
+			CorrelationResult() : available(false), valid(false), elapsedTime(0) {};
+
+			bool available;
+			bool valid;
+			QString status;
+			qint64 elapsedTime;
+		};
+
+		explicit XYCorrelationCurve(const QString& name);
+		virtual ~XYCorrelationCurve();
+
+		void recalculate();
+		virtual QIcon icon() const;
+		virtual void save(QXmlStreamWriter*) const;
+		virtual bool load(XmlStreamReader*);
+
+		POINTER_D_ACCESSOR_DECL(const AbstractColumn, xDataColumn, XDataColumn)
+		POINTER_D_ACCESSOR_DECL(const AbstractColumn, yDataColumn, YDataColumn)
+		POINTER_D_ACCESSOR_DECL(const AbstractColumn, y2DataColumn, Y2DataColumn)
+		const QString& xDataColumnPath() const;
+		const QString& yDataColumnPath() const;
+		const QString& y2DataColumnPath() const;
+
+		CLASS_D_ACCESSOR_DECL(CorrelationData, correlationData, CorrelationData)
+		const CorrelationResult& correlationResult() const;
+		bool isSourceDataChangedSinceLastCorrelation() const;
+
+		typedef WorksheetElement BaseClass;
+		typedef XYCorrelationCurvePrivate Private;
+
+	protected:
+		XYCorrelationCurve(const QString& name, XYCorrelationCurvePrivate* dd);
+
+	private:
+		Q_DECLARE_PRIVATE(XYCorrelationCurve)
+		void init();
+
+	private slots:
+		void handleSourceDataChanged();
+
+	signals:
+		friend class XYCorrelationCurveSetXDataColumnCmd;
+		friend class XYCorrelationCurveSetYDataColumnCmd;
+		friend class XYCorrelationCurveSetY2DataColumnCmd;
+		void xDataColumnChanged(const AbstractColumn*);
+		void yDataColumnChanged(const AbstractColumn*);
+		void y2DataColumnChanged(const AbstractColumn*);
+
+		friend class XYCorrelationCurveSetCorrelationDataCmd;
+		void correlationDataChanged(const XYCorrelationCurve::CorrelationData&);
+		void sourceDataChangedSinceLastCorrelation();
+};
+
+#endif
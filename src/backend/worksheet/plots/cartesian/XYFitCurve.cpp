@@ -39,6 +39,7 @@
 #include "XYFitCurvePrivate.h"
 #include "backend/core/AbstractColumn.h"
 #include "backend/core/column/Column.h"
+#include "backend/spreadsheet/Spreadsheet.h"
 #include "backend/lib/commandtemplates.h"
 #include "backend/lib/macros.h"
 #include "backend/gsl/ExpressionParser.h"
@@ -47,6 +48,12 @@ extern "C" {
 #include <gsl/gsl_blas.h>
 #include <gsl/gsl_vector.h>
 #include <gsl/gsl_matrix.h>
+#include <gsl/gsl_multifit.h>
+#include <gsl/gsl_linalg.h>
+#include <gsl/gsl_randist.h>
+#include <gsl/gsl_rng.h>
+#include <gsl/gsl_sort.h>
+#include <gsl/gsl_statistics.h>
 #include <gsl/gsl_version.h>
 #include "backend/gsl/parser.h" 
 #include "backend/nsl/nsl_fit.h"
@@ -57,7 +64,9 @@ extern "C" {
 #include <KIcon>
 #include <KLocale>
 #include <QElapsedTimer>
+#include <QMenu>
 #include <QThreadPool>
+#include <QTimer>
 
 XYFitCurve::XYFitCurve(const QString& name)
 		: XYCurve(name, new XYFitCurvePrivate(this)) {
@@ -80,6 +89,13 @@ void XYFitCurve::init() {
 	//TODO: read from the saved settings for XYFitCurve?
 	d->lineType = XYCurve::Line;
 	d->symbolsStyle = Symbol::NoSymbols;
+
+	d->refitTimer = new QTimer(this);
+	d->refitTimer->setSingleShot(true);
+	connect(d->refitTimer, SIGNAL(timeout()), this, SLOT(refit()));
+
+	batchFitAction = new QAction(KIcon("labplot-xy-fit-curve"), "", this);
+	connect(batchFitAction, SIGNAL(triggered()), this, SLOT(fitAllColumns()));
 }
 
 void XYFitCurve::recalculate() {
@@ -94,6 +110,22 @@ QIcon XYFitCurve::icon() const {
 	return KIcon("labplot-xy-fit-curve");
 }
 
+QMenu* XYFitCurve::createContextMenu() {
+	Q_D(const XYFitCurve);
+	QMenu* menu = XYCurve::createContextMenu();
+
+	//"Fit all columns"-action, show only if the y-data is from a spreadsheet
+	const Spreadsheet* spreadsheet = d->yDataColumn ? dynamic_cast<const Spreadsheet*>(d->yDataColumn->parentAspect()) : 0;
+	if (spreadsheet && d->xDataColumn) {
+		QAction* firstAction = menu->actions().at(1); //skip the first action because of the "title-action"
+		batchFitAction->setText(i18n("Fit model to all columns of \"%1\"", spreadsheet->name()));
+		menu->insertAction(firstAction, batchFitAction);
+		menu->insertSeparator(firstAction);
+	}
+
+	return menu;
+}
+
 //##############################################################################
 //##########################  getter methods  ##################################
 //##############################################################################
@@ -171,6 +203,40 @@ void XYFitCurve::handleSourceDataChanged() {
 	Q_D(XYFitCurve);
 	d->sourceDataChangedSinceLastFit = true;
 	emit sourceDataChangedSinceLastFit();
+
+	// refit once after all source columns are changed
+	if (d->fitData.incrementalRefit)
+		d->refitTimer->start(0);
+}
+
+/*!
+ * fits the model of the curve to all numeric columns of the spreadsheet containing the y-data, except the x-data column.
+ * The spreadsheet with the results is added next to the source spreadsheet.
+ */
+void XYFitCurve::fitAllColumns() {
+	Q_D(const XYFitCurve);
+	if (!d->xDataColumn || !d->yDataColumn)
+		return;
+	Spreadsheet* spreadsheet = dynamic_cast<Spreadsheet*>(d->yDataColumn->parentAspect());
+	if (!spreadsheet)
+		return;
+
+	QList<const AbstractColumn*> yColumns;
+	foreach (const Column* col, spreadsheet->children<Column>()) {
+		if (col != d->xDataColumn && col->columnMode() == AbstractColumn::Numeric)
+			yColumns << col;
+	}
+
+	Spreadsheet* results = batchFit(d->fitData, d->xDataColumn, yColumns);
+	if (!results)
+		return;
+	results->setName(i18n("%1 - fit results", spreadsheet->name()));
+	spreadsheet->parentAspect()->addChild(results);
+}
+
+void XYFitCurve::refit() {
+	Q_D(XYFitCurve);
+	d->recalculate(true);
 }
 
 //##############################################################################
@@ -181,6 +247,7 @@ XYFitCurvePrivate::XYFitCurvePrivate(XYFitCurve* owner) : XYCurvePrivate(owner),
 	xColumn(0), yColumn(0), residualsColumn(0),
 	xVector(0), yVector(0), residualsVector(0),
 	sourceDataChangedSinceLastFit(false),
+	refitTimer(0), fullRefitPending(false),
 	q(owner)  {
 
 }
@@ -190,22 +257,104 @@ XYFitCurvePrivate::~XYFitCurvePrivate() {
 	//when the parent aspect is removed
 }
 
+XYFitCurve::FitWorkspace::FitWorkspace() : n(0), np(0), solver(0), covar(0), residuals(0), J(0) {
+}
+
+XYFitCurve::FitWorkspace::~FitWorkspace() {
+	resize(0, 0);
+}
+
+/*!
+ * makes the workspace ready for a fit of \c n data points with \c np parameters.
+ * The allocations are kept if the sizes didn't change.
+ */
+void XYFitCurve::FitWorkspace::resize(size_t n, size_t np) {
+	if (n == this->n && np == this->np && covar)
+		return;
+
+	if (solver)
+		gsl_multifit_fdfsolver_free(solver);
+	if (covar)
+		gsl_matrix_free(covar);
+	if (residuals)
+		gsl_vector_free(residuals);
+	if (J)
+		gsl_matrix_free(J);
+	solver = 0;
+	covar = 0;
+	residuals = 0;
+	J = 0;
+
+	this->n = n;
+	this->np = np;
+	if (n > 0 && np > 0) {
+		covar = gsl_matrix_alloc(np, np);
+		residuals = gsl_vector_alloc(n);
+	}
+}
+
 /* data structure to pass parameter to functions */
 struct data {
 	size_t n;	//number of data points
-	double* x;	//pointer to the vector with x-data values
-	double* y;	//pointer to the vector with y-data values
-	double* sigma;	//pointer to the vector with sigma values
+	const double* x;	//pointer to the vector with x-data values
+	const double* y;	//pointer to the vector with y-data values
+	const double* sigma;	//pointer to the vector with sigma values
 	nsl_fit_model_category modelCategory;
 	unsigned int modelType;
 	int degree;
-	QString* func;	// string containing the definition of the model/function
-	QStringList* paramNames;
-	double* paramMin;	// lower parameter limits
-	double* paramMax;	// upper parameter limits
-	bool* paramFixed;	// parameter fixed?
+	const QString* func;	// string containing the definition of the model/function
+	const QStringList* paramNames;
+	const double* paramMin;	// lower parameter limits
+	const double* paramMax;	// upper parameter limits
+	const bool* paramFixed;	// parameter fixed?
+	parser_context* ctx;	// parser context of the thread, 0 for the default context
+	parser_program* model;	// compiled model function, see compilePrograms()
+	QVector<parser_program*> derivs;	// compiled derivatives of a custom model (0: finite differences)
 };
 
+/* compiles the model function or its derivative with respect to the parameter deriv-1 (deriv > 0) */
+static parser_program* compileModel(const struct data* params, const QByteArray& func, const QVector<const char*>& names, int deriv = 0) {
+	if (deriv > 0)
+		return params->ctx ? parser_context_compile_derivative(params->ctx, func.constData(), names.data(), names.size(), deriv)
+			: parser_compile_derivative(func.constData(), names.data(), names.size(), deriv);
+	return params->ctx ? parser_context_compile(params->ctx, func.constData(), names.data(), names.size())
+		: parser_compile(func.constData(), names.data(), names.size());
+}
+
+/*!
+ * compiles the model and, for custom models, its derivatives with respect to the free parameters once
+ * for all evaluations of a fit. The programs are released with freePrograms().
+ */
+static void compilePrograms(struct data* params) {
+	// x is bound to the first, the parameters to the following variables
+	const int np = params->paramNames->size();
+	QList<QByteArray> namesba;
+	QVector<const char*> names;
+	namesba << QByteArray("x");
+	for (int j = 0; j < np; j++)
+		namesba << params->paramNames->at(j).toLocal8Bit();
+	for (int j = 0; j < namesba.size(); j++)
+		names << namesba.at(j).constData();
+
+	const QByteArray funcba = params->func->toLocal8Bit();
+	params->model = compileModel(params, funcba, names);
+	params->derivs = QVector<parser_program*>(np, 0);
+	if (params->modelCategory != nsl_fit_model_custom)
+		return;
+	for (int j = 0; j < np; j++) {
+		if (!params->paramFixed[j])
+			params->derivs[j] = compileModel(params, funcba, names, j + 1);
+	}
+}
+
+static void freePrograms(struct data* params) {
+	parser_free(params->model);
+	params->model = 0;
+	foreach (parser_program* prog, params->derivs)
+		parser_free(prog);
+	params->derivs.clear();
+}
+
 /*!
  * \param paramValues vector containing current values of the fit parameters
  * \param params
@@ -213,45 +362,47 @@ struct data {
  */
 int func_f(const gsl_vector* paramValues, void* params, gsl_vector* f) {
 	size_t n = ((struct data*)params)->n;
-	double* x = ((struct data*)params)->x;
-	double* y = ((struct data*)params)->y;
-	double* sigma = ((struct data*)params)->sigma;
+	const double* x = ((struct data*)params)->x;
+	const double* y = ((struct data*)params)->y;
+	const double* sigma = ((struct data*)params)->sigma;
 	nsl_fit_model_category modelCategory = ((struct data*)params)->modelCategory;
 	unsigned int modelType = ((struct data*)params)->modelType;
-	QByteArray funcba = ((struct data*)params)->func->toLocal8Bit();	// a local byte array is needed!
-	QStringList* paramNames = ((struct data*)params)->paramNames;
-	double *min = ((struct data*)params)->paramMin;
-	double *max = ((struct data*)params)->paramMax;
+	const QStringList* paramNames = ((struct data*)params)->paramNames;
+	const double *min = ((struct data*)params)->paramMin;
+	const double *max = ((struct data*)params)->paramMax;
+
+	// the model is compiled once per fit, x is bound to the first, the parameters to the following variables
+	const int np = paramNames->size();
+	const parser_program* prog = ((struct data*)params)->model;
+	if (!prog)
+		return GSL_EINVAL;
 
 	// set current values of the parameters
-	for (int i = 0; i < paramNames->size(); i++) {
+	QVector<double> values(np + 1);
+	for (int i = 0; i < np; i++) {
 		double x = gsl_vector_get(paramValues, i);
 		// bound values if limits are set
-		assign_variable(paramNames->at(i).toLocal8Bit().data(), nsl_fit_map_bound(x, min[i], max[i]));
+		values[i + 1] = nsl_fit_map_bound(x, min[i], max[i]);
 		QDEBUG("Parameter"<<i<<" (\" "<<paramNames->at(i).toLocal8Bit().data()<<"\")"<<'['<<min[i]<<','<<max[i]
 			<<"] free/bound:"<<QString::number(x, 'g', 15)<<' '<<QString::number(nsl_fit_map_bound(x, min[i], max[i]), 'g', 15));
 	}
 
-	const char *func = funcba.data();	// function to evaluate
 	for (size_t i = 0; i < n; i++) {
 		if (std::isnan(x[i]) || std::isnan(y[i]))
 			continue;
 
 		// checks for allowed values of x for different models
 		// TODO: more to check
+		values[0] = x[i];
 		if (modelCategory == nsl_fit_model_distribution && modelType == nsl_sf_stats_lognormal) {
 			if (x[i] < 0)
-				x[i] = 0;
+				values[0] = 0;
 		}
 
-		assign_variable("x", x[i]);
-		double Yi = parse(func);
+		double Yi = parser_eval(prog, values.constData());
 
 //		DEBUG("evaluate function"<<QString(func)<<": f(x["<<i<<"]) ="<<Yi);
 
-		if (parse_errors() > 0)
-			return GSL_EINVAL;
-
 		if (sigma)
 			gsl_vector_set (f, i, (Yi - y[i])/sigma[i]);
 		else
@@ -269,15 +420,15 @@ int func_f(const gsl_vector* paramValues, void* params, gsl_vector* f) {
  * */
 int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 	size_t n = ((struct data*)params)->n;
-	double* xVector = ((struct data*)params)->x;
-	double* sigmaVector = ((struct data*)params)->sigma;
+	const double* xVector = ((struct data*)params)->x;
+	const double* sigmaVector = ((struct data*)params)->sigma;
 	nsl_fit_model_category modelCategory = ((struct data*)params)->modelCategory;
 	unsigned int modelType = ((struct data*)params)->modelType;
 	int degree = ((struct data*)params)->degree;
-	QStringList* paramNames = ((struct data*)params)->paramNames;
-	double *min = ((struct data*)params)->paramMin;
-	double *max = ((struct data*)params)->paramMax;
-	bool *fixed = ((struct data*)params)->paramFixed;
+	const QStringList* paramNames = ((struct data*)params)->paramNames;
+	const double *min = ((struct data*)params)->paramMin;
+	const double *max = ((struct data*)params)->paramMax;
+	const bool *fixed = ((struct data*)params)->paramFixed;
 
 	// calculate the Jacobian matrix:
 	// Jacobian matrix J(i,j) = df_i / dx_j
@@ -740,44 +891,55 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		}
 		break;
 	case nsl_fit_model_custom:
-		QByteArray funcba = ((struct data*)params)->func->toLocal8Bit();
-		char* func = funcba.data();
-		QByteArray nameba;
-		double value;
+		// the model and its derivatives are compiled once per fit, x is bound to the first, the parameters to the following variables
 		const unsigned int np = paramNames->size();
-		for (size_t i = 0; i < n; i++) {
-			x = xVector[i];
-			assign_variable("x", x);
-			if (sigmaVector) sigma = sigmaVector[i];
-
-			for (unsigned int j = 0; j < np; j++) {
-				for (unsigned int k = 0; k < np; k++) {
-					if (k != j) {
-						nameba = paramNames->at(k).toLocal8Bit();
-						value = nsl_fit_map_bound(gsl_vector_get(paramValues, k), min[k], max[k]);
-						assign_variable(nameba.data(), value);
-					}
-				}
-
-				nameba = paramNames->at(j).toLocal8Bit();
-				char *name = nameba.data();
-				value = nsl_fit_map_bound(gsl_vector_get(paramValues, j), min[j], max[j]);
-				assign_variable(name, value);
-				double f_p = parse(func);
+		const parser_program* prog = ((struct data*)params)->model;
+		if (!prog)
+			return GSL_EINVAL;
 
-				double eps = 1.e-9*fabs(f_p);	// adapt step size to value
-				value += eps;
-				assign_variable(name, value);
-				double f_pdp = parse(func);
+		QVector<double> values(np + 1);
+		for (unsigned int k = 0; k < np; k++)
+			values[k + 1] = nsl_fit_map_bound(gsl_vector_get(paramValues, k), min[k], max[k]);
+
+		// x runs over the data, the parameters are constant
+		QVector<const double*> data(np + 1);
+		QVector<size_t> strides(np + 1, 0);
+		data[0] = xVector;
+		strides[0] = 1;
+		for (unsigned int k = 0; k < np; k++)
+			data[k + 1] = &values.constData()[k + 1];
+
+		QVector<double> column(n);
+		QVector<double> f_p;	// function values, only needed for finite differences
+		for (unsigned int j = 0; j < np; j++) {
+			if (fixed[j]) {
+				for (size_t i = 0; i < n; i++)
+					gsl_matrix_set(J, i, j, 0.);
+				continue;
+			}
 
-//		qDebug()<<"evaluate deriv"<<QString(func)<<": f(x["<<i<<"]) ="<<QString::number(f_p, 'g', 15);
-//		qDebug()<<"evaluate deriv"<<QString(func)<<": f(x["<<i<<"]+dx) ="<<QString::number(f_pdp, 'g', 15);
-//		qDebug()<<"	deriv = "<<QString::number((f_pdp-f_p)/eps/sigma, 'g', 15);
+			// use the analytic derivative if all functions in the model depending on the parameter can be differentiated
+			const parser_program* deriv = ((struct data*)params)->derivs.at(j);
+			if (deriv)
+				parser_eval_array(deriv, data.constData(), strides.constData(), column.data(), n);
+			else {	// calculate finite differences
+				if (f_p.isEmpty()) {
+					f_p.resize(n);
+					parser_eval_array(prog, data.constData(), strides.constData(), f_p.data(), n);
+				}
+				const double value = values.at(j + 1);
+				const double eps = sqrt(DBL_EPSILON)*qMax(fabs(value), 1.);	// adapt step size to the parameter
+				values[j + 1] = value + eps;
+				for (size_t i = 0; i < n; i++) {
+					values[0] = xVector[i];
+					column[i] = (parser_eval(prog, values.constData()) - f_p.at(i))/eps;
+				}
+				values[j + 1] = value;
+			}
 
-				if (fixed[j])
-					gsl_matrix_set(J, i, j, 0.);
-				else	// calculate finite difference
-					gsl_matrix_set(J, i, j, (f_pdp - f_p)/eps/sigma);
+			for (size_t i = 0; i < n; i++) {
+				if (sigmaVector) sigma = sigmaVector[i];
+				gsl_matrix_set(J, i, j, column.at(i)/sigma);
 			}
 		}
 	}
@@ -792,112 +954,501 @@ int func_fdf(const gsl_vector* x, void* params, gsl_vector* f, gsl_matrix* J) {
 	return GSL_SUCCESS;
 }
 
-void XYFitCurvePrivate::recalculate() {
-	QElapsedTimer timer;
-	timer.start();
+/* runs the Levenberg-Marquardt solver from one start point, used by the multi-start fit */
+class FitStartTask : public QRunnable {
+public:
+	FitStartTask(const struct data& params, const QVector<double>& start, int maxIters, double delta)
+		: m_params(params), m_start(start), m_maxIters(maxIters), m_delta(delta), m_sse(GSL_POSINF) {}
+
+	void run() {
+		const size_t np = m_start.size();
+		// every thread uses its own parser context and programs
+		m_params.ctx = parser_context_new();
+		compilePrograms(&m_params);
+
+		gsl_multifit_function_fdf f;
+		f.f = &func_f;
+		f.df = &func_df;
+		f.fdf = &func_fdf;
+		f.n = m_params.n;
+		f.p = np;
+		f.params = &m_params;
+		gsl_multifit_fdfsolver* s = gsl_multifit_fdfsolver_alloc(gsl_multifit_fdfsolver_lmsder, m_params.n, np);
+
+		QVector<double> x_init(np);
+		for (size_t i = 0; i < np; i++)
+			x_init[i] = nsl_fit_map_unbound(m_start.at(i), m_params.paramMin[i], m_params.paramMax[i]);
+		gsl_vector_view x = gsl_vector_view_array(x_init.data(), np);
+		gsl_multifit_fdfsolver_set(s, &f, &x.vector);
+
+		int status;
+		int iter = 0;
+		do {
+			iter++;
+			status = gsl_multifit_fdfsolver_iterate(s);
+			if (status) break;
+			status = gsl_multifit_test_delta(s->dx, s->x, m_delta, m_delta);
+		} while (status == GSL_CONTINUE && iter < m_maxIters);
+
+		m_sse = gsl_pow_2(gsl_blas_dnrm2(s->f));
+		if (std::isnan(m_sse))
+			m_sse = GSL_POSINF;
+		m_result.resize(np);
+		for (size_t i = 0; i < np; i++)
+			m_result[i] = nsl_fit_map_bound(gsl_vector_get(s->x, i), m_params.paramMin[i], m_params.paramMax[i]);
+
+		gsl_multifit_fdfsolver_free(s);
+		freePrograms(&m_params);
+		parser_context_free(m_params.ctx);
+	}
 
-	//create fit result columns if not available yet, clear them otherwise
-	if (!xColumn) {
-		xColumn = new Column("x", AbstractColumn::Numeric);
-		yColumn = new Column("y", AbstractColumn::Numeric);
-		residualsColumn = new Column("residuals", AbstractColumn::Numeric);
-		xVector = static_cast<QVector<double>* >(xColumn->data());
-		yVector = static_cast<QVector<double>* >(yColumn->data());
-		residualsVector = static_cast<QVector<double>* >(residualsColumn->data());
+	double sse() const {
+		return m_sse;
+	}
 
-		xColumn->setHidden(true);
-		q->addChild(xColumn);
+	const QVector<double>& result() const {
+		return m_result;
+	}
 
-		yColumn->setHidden(true);
-		q->addChild(yColumn);
+private:
+	struct data m_params;
+	QVector<double> m_start;
+	int m_maxIters;
+	double m_delta;
+	double m_sse;
+	QVector<double> m_result;
+};
 
-		q->addChild(residualsColumn);
+/*!
+ * multi-start fit: the start values and fitData.startPoints-1 points sampled inside the parameter limits
+ * (Latin hypercube, open limits are replaced by a range around the start value) are fitted in parallel.
+ * The fits run on a private thread pool if \c parallel is \c true.
+ * \c startValues is set to the parameters of the best fit, returns the number of start points reaching its sse.
+ */
+static int multiStartFit(const XYFitCurve::FitData& fitData, const struct data& params, QVector<double>& startValues,
+		int maxIters, double delta, bool parallel) {
+	const int np = startValues.size();
+	const int count = fitData.startPoints;
+
+	// one point in each of the count-1 intervals of every parameter, in random order
+	QVector<QVector<double> > points(count, startValues);
+	QVector<size_t> strata(count - 1);
+	gsl_rng* r = gsl_rng_alloc(gsl_rng_mt19937);
+	for (int j = 0; j < np; ++j) {
+		if (fitData.paramFixed.at(j))
+			continue;
 
-		q->setUndoAware(false);
-		q->setXColumn(xColumn);
-		q->setYColumn(yColumn);
-		q->setUndoAware(true);
-	} else {
-		xVector->clear();
-		yVector->clear();
-		residualsVector->clear();
+		const double start = startValues.at(j);
+		const double width = qMax(fabs(start), 1.);
+		double lower = fitData.paramLowerLimits.at(j);
+		double upper = fitData.paramUpperLimits.at(j);
+		if (lower == -DBL_MAX)
+			lower = (upper < DBL_MAX ? qMin(start, upper) : start) - width;
+		if (upper == DBL_MAX)
+			upper = qMax(start, lower) + width;
+
+		for (int k = 0; k < count - 1; ++k)
+			strata[k] = k;
+		gsl_ran_shuffle(r, strata.data(), count - 1, sizeof(size_t));
+		for (int k = 1; k < count; ++k)
+			points[k][j] = lower + (upper - lower)*(strata.at(k - 1) + gsl_rng_uniform_pos(r))/(count - 1);
+	}
+	gsl_rng_free(r);
+
+	// own pool: waiting for it doesn't wait for unrelated tasks on the global pool
+	QThreadPool pool;
+	QVector<FitStartTask*> tasks;
+	for (int k = 0; k < count; ++k) {
+		FitStartTask* task = new FitStartTask(params, points.at(k), maxIters, delta);
+		task->setAutoDelete(false);
+		tasks << task;
+		if (parallel)
+			pool.start(task);
+		else
+			task->run();
 	}
+	if (parallel)
+		pool.waitForDone();
 
-	// clear the previous result
-	fitResult = XYFitCurve::FitResult();
+	int best = 0;
+	for (int k = 1; k < count; ++k) {
+		if (tasks.at(k)->sse() < tasks.at(best)->sse())
+			best = k;
+	}
+	const double minSse = tasks.at(best)->sse();
+	int atMinimum = 0;
+	for (int k = 0; k < count; ++k) {
+		if (tasks.at(k)->sse() <= minSse*(1. + 1.e-3) + DBL_MIN)
+			atMinimum++;
+	}
+	DEBUG("multi-start fit: best sse ="<<minSse<<"start point"<<best<<","<<atMinimum<<"of"<<count<<"at minimum");
 
-	if (!xDataColumn || !yDataColumn) {
-		emit (q->dataChanged());
-		sourceDataChangedSinceLastFit = false;
-		return;
+	if (minSse < GSL_POSINF)
+		startValues = tasks.at(best)->result();
+	qDeleteAll(tasks);
+
+	return atMinimum;
+}
+
+/* refits the model to the resampled data sets first to last-1 of a residual bootstrap */
+class BootstrapTask : public QRunnable {
+public:
+	BootstrapTask(const struct data& params, const QVector<double>& fitted, const QVector<double>& residuals,
+		const QVector<double>& solution, int first, int last, int maxIters, double delta, double* samples)
+		: m_params(params), m_fitted(fitted), m_residuals(residuals), m_solution(solution),
+		m_first(first), m_last(last), m_maxIters(maxIters), m_delta(delta), m_samples(samples) {}
+
+	void run() {
+		const size_t n = m_params.n;
+		const size_t np = m_solution.size();
+		const double* sigma = m_params.sigma;
+
+		// the parser context, the programs, the solver and the data buffer are shared by all resamples of this task
+		QVector<double> ydata(n);
+		m_params.y = ydata.data();
+		m_params.ctx = parser_context_new();
+		compilePrograms(&m_params);
+
+		gsl_multifit_function_fdf f;
+		f.f = &func_f;
+		f.df = &func_df;
+		f.fdf = &func_fdf;
+		f.n = n;
+		f.p = np;
+		f.params = &m_params;
+		gsl_multifit_fdfsolver* s = gsl_multifit_fdfsolver_alloc(gsl_multifit_fdfsolver_lmsder, n, np);
+
+		// all fits start at the solution of the original data
+		QVector<double> x_init(np);
+		gsl_rng* r = gsl_rng_alloc(gsl_rng_mt19937);
+		for (int k = m_first; k < m_last; ++k) {
+			// seed per resample: the result doesn't depend on the number of threads
+			gsl_rng_set(r, k + 1);
+			for (size_t i = 0; i < n; i++) {
+				const double e = m_residuals.at(gsl_rng_uniform_int(r, n));
+				ydata[i] = m_fitted.at(i) + (sigma ? sigma[i]*e : e);
+			}
+
+			for (size_t i = 0; i < np; i++)
+				x_init[i] = nsl_fit_map_unbound(m_solution.at(i), m_params.paramMin[i], m_params.paramMax[i]);
+			gsl_vector_view x = gsl_vector_view_array(x_init.data(), np);
+			gsl_multifit_fdfsolver_set(s, &f, &x.vector);
+
+			int status;
+			int iter = 0;
+			do {
+				iter++;
+				status = gsl_multifit_fdfsolver_iterate(s);
+				if (status) break;
+				status = gsl_multifit_test_delta(s->dx, s->x, m_delta, m_delta);
+			} while (status == GSL_CONTINUE && iter < m_maxIters);
+
+			// fits stopped by the iteration limit are kept, only failed ones are discarded
+			const bool valid = std::isfinite(gsl_blas_dnrm2(s->f));
+			double* sample = m_samples + k*np;
+			for (size_t i = 0; i < np; i++)
+				sample[i] = valid ? nsl_fit_map_bound(gsl_vector_get(s->x, i), m_params.paramMin[i], m_params.paramMax[i]) : NAN;
+		}
+
+		gsl_rng_free(r);
+		gsl_multifit_fdfsolver_free(s);
+		freePrograms(&m_params);
+		parser_context_free(m_params.ctx);
 	}
 
-	//fit settings
-	const int maxIters = fitData.maxIterations;	//maximal number of iterations
-	const double delta = fitData.eps;		//fit tolerance
-	const unsigned int np = fitData.paramNames.size(); //number of fit parameters
-	if (np == 0) {
-		fitResult.available = true;
-		fitResult.valid = false;
-		fitResult.status = i18n("Model has no parameters.");
-		emit (q->dataChanged());
-		sourceDataChangedSinceLastFit = false;
-		return;
+private:
+	struct data m_params;
+	const QVector<double>& m_fitted;
+	const QVector<double>& m_residuals;
+	const QVector<double>& m_solution;
+	int m_first;
+	int m_last;
+	int m_maxIters;
+	double m_delta;
+	double* m_samples;
+};
+
+/*!
+ * residual bootstrap: fitData.bootstrapSamples data sets are created by adding randomly drawn (weighted) residuals
+ * of the fit to the fitted values and are refitted starting at the fit result. The resamples are split into one
+ * block per thread of a private thread pool if \c parallel is \c true.
+ * Sets the 95% percentile confidence intervals of all parameters in \c fitResult.
+ */
+static void bootstrapFit(const XYFitCurve::FitData& fitData, const struct data& params, const gsl_vector* residualVector,
+		int maxIters, double delta, bool parallel, XYFitCurve::FitResult& fitResult) {
+	const size_t n = params.n;
+	const int np = fitResult.paramValues.size();
+	const int count = fitData.bootstrapSamples;
+
+	// fitted values Y_i and the centered residuals (y_i - Y_i)/sigma_i, rescaled for the lost degrees of freedom
+	QVector<double> fitted(n);
+	QVector<double> residuals(n);
+	double mean = 0;
+	for (size_t i = 0; i < n; i++) {
+		const double r = gsl_vector_get(residualVector, i);
+		fitted[i] = params.y[i] + (params.sigma ? params.sigma[i]*r : r);
+		mean += r;
 	}
+	mean /= n;
+	const double scale = (fitResult.dof > 0) ? sqrt(n/fitResult.dof) : 1.;
+	for (size_t i = 0; i < n; i++)
+		residuals[i] = scale*(mean - gsl_vector_get(residualVector, i));
+
+	QVector<double> samples(count*np);
+	QThreadPool pool;
+	const int blocks = parallel ? qMax(qMin(count, pool.maxThreadCount()), 1) : 1;
+	QVector<BootstrapTask*> tasks;
+	for (int b = 0; b < blocks; ++b) {
+		BootstrapTask* task = new BootstrapTask(params, fitted, residuals, fitResult.paramValues,
+			b*count/blocks, (b + 1)*count/blocks, maxIters, delta, samples.data());
+		task->setAutoDelete(false);
+		tasks << task;
+		if (parallel)
+			pool.start(task);
+		else
+			task->run();
+	}
+	if (parallel)
+		pool.waitForDone();
+	qDeleteAll(tasks);
+
+	// percentile intervals from the successful fits
+	fitResult.lowerConfidenceValues.resize(np);
+	fitResult.upperConfidenceValues.resize(np);
+	QVector<double> values;
+	values.reserve(count);
+	for (int j = 0; j < np; ++j) {
+		values.clear();
+		for (int k = 0; k < count; ++k) {
+			const double value = samples.at(k*np + j);
+			if (!std::isnan(value))
+				values << value;
+		}
+		if (values.isEmpty()) {
+			fitResult.lowerConfidenceValues[j] = NAN;
+			fitResult.upperConfidenceValues[j] = NAN;
+			continue;
+		}
+		gsl_sort(values.data(), 1, values.size());
+		fitResult.lowerConfidenceValues[j] = gsl_stats_quantile_from_sorted_data(values.constData(), 1, values.size(), 0.025);
+		fitResult.upperConfidenceValues[j] = gsl_stats_quantile_from_sorted_data(values.constData(), 1, values.size(), 0.975);
+		fitResult.bootstrapSamples = values.size();
+	}
+	DEBUG("bootstrap:"<<fitResult.bootstrapSamples<<"of"<<count<<"fits successful");
+}
 
-	//check column sizes
-	if (xDataColumn->rowCount() != yDataColumn->rowCount()) {
-		fitResult.available = true;
-		fitResult.valid = false;
-		fitResult.status = i18n("Number of x and y data points must be equal.");
-		emit (q->dataChanged());
-		sourceDataChangedSinceLastFit = false;
-		return;
+/* appends the current parameter values and chi^2 of the solver to the solver output */
+static void writeSolverState(gsl_multifit_fdfsolver* s, const XYFitCurve::FitData& fitData, XYFitCurve::FitResult& fitResult) {
+	QString state;
+
+	//current parameter values, semicolon separated
+	double* min = fitData.paramLowerLimits.data();
+	double* max = fitData.paramUpperLimits.data();
+	for (int i = 0; i < fitData.paramNames.size(); ++i) {
+		double x = gsl_vector_get(s->x, i);
+		// map parameter if bounded
+		state += QString::number(nsl_fit_map_bound(x, min[i], max[i])) + '\t';
 	}
-	if (weightsColumn) {
-		if (weightsColumn->rowCount() < xDataColumn->rowCount()) {
-			fitResult.available = true;
-			fitResult.valid = false;
-			fitResult.status = i18n("Not sufficient weight data points provided.");
-			emit (q->dataChanged());
-			sourceDataChangedSinceLastFit = false;
-			return;
+
+	//current value of the chi2-function
+	state += QString::number(gsl_pow_2(gsl_blas_dnrm2(s->f)));
+	state += ';';
+
+	fitResult.solverOutput += state;
+}
+
+/*!
+ * solves the fit directly if the model is linear in the free parameters, i.e. if its derivatives with respect to
+ * the free parameters (the basis functions g_k) don't depend on them: f(x) = h(x) + sum_k c_k g_k(x).
+ * Parameters with limits are not supported. The design matrix is solved with gsl_multifit_wlinear(),
+ * for large data sets the normal equations are accumulated block by block instead.
+ * Sets the parameter values, the covariance matrix and the weighted residuals and returns \c true on success.
+ */
+static bool linearFit(const struct data& params, QVector<double>& paramValues, gsl_matrix* covar, gsl_vector* residualVector) {
+	const int np = params.paramNames->size();
+	const size_t n = params.n;
+
+	QVector<int> freeParams;
+	for (int j = 0; j < np; ++j) {
+		if (params.paramFixed[j])
+			continue;
+		if (params.paramMin[j] != -DBL_MAX || params.paramMax[j] != DBL_MAX)
+			return false;
+		freeParams << j;
+	}
+	const int m = freeParams.size();
+	if (m == 0)
+		return false;
+
+	QList<QByteArray> namesba;
+	QVector<const char*> names;
+	namesba << QByteArray("x");
+	for (int j = 0; j < np; j++)
+		namesba << params.paramNames->at(j).toLocal8Bit();
+	for (int j = 0; j < namesba.size(); j++)
+		names << namesba.at(j).constData();
+	const QByteArray funcba = params.func->toLocal8Bit();
+
+	QVector<parser_program*> basis;
+	bool linear = true;
+	for (int k = 0; k < m && linear; ++k) {
+		parser_program* prog = compileModel(&params, funcba, names, freeParams.at(k) + 1);
+		if (!prog) {
+			linear = false;
+			break;
 		}
+		basis << prog;
+		foreach (int j, freeParams)
+			if (parser_uses_variable(prog, j + 1))
+				linear = false;
+	}
+	parser_program* model = linear ? compileModel(&params, funcba, names) : 0;
+	if (!model) {
+		foreach (parser_program* prog, basis)
+			parser_free(prog);
+		return false;
+	}
+	DEBUG("linear model with"<<m<<"free parameters");
+
+	// the offset h(x) is the model with all free parameters set to 0
+	QVector<double> values = paramValues;
+	foreach (int j, freeParams)
+		values[j] = 0;
+	QVector<const double*> data(np + 1);
+	QVector<size_t> strides(np + 1, 0);
+	data[0] = params.x;
+	strides[0] = 1;
+	for (int j = 0; j < np; j++)
+		data[j + 1] = &values.constData()[j];
+
+	// the design matrix would be too large: use the normal equations
+	const bool normalEquations = (double)n*m > 1.e7;
+	gsl_matrix* X = 0;
+	gsl_vector* y = 0;
+	gsl_vector* w = 0;
+	gsl_matrix* A = 0;
+	gsl_vector* b = 0;
+	if (normalEquations) {
+		A = gsl_matrix_calloc(m, m);
+		b = gsl_vector_calloc(m);
+	} else {
+		X = gsl_matrix_alloc(n, m);
+		y = gsl_vector_alloc(n);
+		w = gsl_vector_alloc(n);
 	}
 
-	//copy all valid data point for the fit to temporary vectors
-	QVector<double> xdataVector;
-	QVector<double> ydataVector;
-	QVector<double> sigmaVector;
-	double xmin = fitData.xRange.first();
-	double xmax = fitData.xRange.last();
-	for (int row=0; row < xDataColumn->rowCount(); ++row) {
-		//only copy those data where _all_ values (for x, y and sigma, if given) are valid
-		if (!std::isnan(xDataColumn->valueAt(row)) && !std::isnan(yDataColumn->valueAt(row))
-			&& !xDataColumn->isMasked(row) && !yDataColumn->isMasked(row)) {
-
-			// only when inside given range
-			if (xDataColumn->valueAt(row) >= xmin && xDataColumn->valueAt(row) <= xmax) {
-				if (!weightsColumn) {
-					xdataVector.append(xDataColumn->valueAt(row));
-					ydataVector.append(yDataColumn->valueAt(row));
-				} else {
-					if (!std::isnan(weightsColumn->valueAt(row))) {
-						xdataVector.append(xDataColumn->valueAt(row));
-						ydataVector.append(yDataColumn->valueAt(row));
-
-						if (fitData.weightsType == XYFitCurve::WeightsFromColumn) {
-							//weights from a given column -> calculate the square root of the inverse (sigma = sqrt(1/weight))
-							sigmaVector.append( sqrt(1./weightsColumn->valueAt(row)) );
-						} else if (fitData.weightsType == XYFitCurve::WeightsFromErrorColumn) {
-							//weights from a given column with error bars (sigma = error)
-							sigmaVector.append( weightsColumn->valueAt(row) );
-						}
-					}
+	const size_t blockSize = 4096;
+	QVector<double> offset(blockSize);
+	QVector<double> g(m*blockSize);
+	for (size_t first = 0; first < n; first += blockSize) {
+		const size_t count = qMin(blockSize, n - first);
+		data[0] = params.x + first;
+		parser_eval_array(model, data.constData(), strides.constData(), offset.data(), count);
+		for (int k = 0; k < m; ++k)
+			parser_eval_array(basis.at(k), data.constData(), strides.constData(), g.data() + k*blockSize, count);
+
+		for (size_t i = 0; i < count; ++i) {
+			const size_t row = first + i;
+			const double weight = params.sigma ? 1./gsl_pow_2(params.sigma[row]) : 1.;
+			const double yi = params.y[row] - offset.at(i);
+			if (normalEquations) {
+				for (int k = 0; k < m; ++k) {
+					const double gk = weight*g.at(k*blockSize + i);
+					*gsl_vector_ptr(b, k) += gk*yi;
+					for (int l = 0; l <= k; ++l)
+						*gsl_matrix_ptr(A, k, l) += gk*g.at(l*blockSize + i);
 				}
+			} else {
+				for (int k = 0; k < m; ++k)
+					gsl_matrix_set(X, row, k, g.at(k*blockSize + i));
+				gsl_vector_set(y, row, yi);
+				gsl_vector_set(w, row, weight);
 			}
 		}
 	}
+	data[0] = params.x;
+
+	gsl_vector* c = gsl_vector_alloc(m);
+	gsl_matrix* cov = 0;
+	int status;
+	if (normalEquations) {
+		for (int k = 0; k < m; ++k)
+			for (int l = 0; l < k; ++l)
+				gsl_matrix_set(A, l, k, gsl_matrix_get(A, k, l));
+		status = gsl_linalg_cholesky_decomp(A);
+		if (status == GSL_SUCCESS) {
+			gsl_linalg_cholesky_solve(A, b, c);
+			gsl_linalg_cholesky_invert(A);
+			cov = A;
+			A = 0;
+		}
+	} else {
+		cov = gsl_matrix_alloc(m, m);
+		double chisq;
+		gsl_multifit_linear_workspace* work = gsl_multifit_linear_alloc(n, m);
+		status = gsl_multifit_wlinear(X, w, y, c, cov, &chisq, work);
+		gsl_multifit_linear_free(work);
+	}
+
+	if (status == GSL_SUCCESS) {
+		gsl_matrix_set_zero(covar);
+		for (int k = 0; k < m; ++k) {
+			values[freeParams.at(k)] = gsl_vector_get(c, k);
+			for (int l = 0; l < m; ++l)
+				gsl_matrix_set(covar, freeParams.at(k), freeParams.at(l), gsl_matrix_get(cov, k, l));
+		}
+
+		// weighted residuals (Y_i - y_i)/sigma_i of the fitted model
+		parser_eval_array(model, data.constData(), strides.constData(), residualVector->data, n);
+		for (size_t i = 0; i < n; ++i) {
+			double r = gsl_vector_get(residualVector, i) - params.y[i];
+			if (params.sigma)
+				r /= params.sigma[i];
+			gsl_vector_set(residualVector, i, r);
+		}
+		paramValues = values;
+	}
+
+	if (cov)
+		gsl_matrix_free(cov);
+	gsl_vector_free(c);
+	if (normalEquations) {
+		if (A)
+			gsl_matrix_free(A);
+		gsl_vector_free(b);
+	} else {
+		gsl_matrix_free(X);
+		gsl_vector_free(y);
+		gsl_vector_free(w);
+	}
+	parser_free(model);
+	foreach (parser_program* prog, basis)
+		parser_free(prog);
+
+	return (status == GSL_SUCCESS);
+}
+
+/*!
+ * fits the model of \c fitData to the \c n data points (\c xVector, \c yVector) with the errors \c sigmaVector
+ * (no weights if empty). The residuals y_i - Y_i are written to \c residuals if given.
+ * The starts of a multi-start fit and the bootstrap fits are run on private thread pools if \c parallel is \c true.
+ * The model is evaluated with an own parser context, so different fits can run in different threads.
+ * The GSL allocations of \c workspace are reused if given, a temporary workspace is used otherwise.
+ */
+XYFitCurve::FitResult XYFitCurve::fit(const FitData& fitData, const QVector<double>& xdataVector, const QVector<double>& ydataVector,
+		const QVector<double>& sigmaVector, QVector<double>* residuals, bool parallel, FitWorkspace* workspace) {
+	FitResult fitResult;
+
+	//fit settings
+	const int maxIters = fitData.maxIterations;	//maximal number of iterations
+	const double delta = fitData.eps;		//fit tolerance
+	const unsigned int np = fitData.paramNames.size(); //number of fit parameters
+	if (np == 0) {
+		fitResult.available = true;
+		fitResult.valid = false;
+		fitResult.status = i18n("Model has no parameters.");
+		return fitResult;
+	}
 
 	//number of data points to fit
 	const size_t n = xdataVector.size();
@@ -905,35 +1456,32 @@ void XYFitCurvePrivate::recalculate() {
 		fitResult.available = true;
 		fitResult.valid = false;
 		fitResult.status = i18n("No data points available.");
-		emit (q->dataChanged());
-		sourceDataChangedSinceLastFit = false;
-		return;
+		return fitResult;
 	}
 
 	if (n < np) {
 		fitResult.available = true;
 		fitResult.valid = false;
 		fitResult.status = i18n("The number of data points (%1) must be greater than or equal to the number of parameters (%2).", n, np);
-		emit (q->dataChanged());
-		sourceDataChangedSinceLastFit = false;
-		return;
+		return fitResult;
 	}
 
-	double* xdata = xdataVector.data();
-	double* ydata = ydataVector.data();
-	double* sigma = 0;
+	const double* xdata = xdataVector.constData();
+	const double* ydata = ydataVector.constData();
+	const double* sigma = 0;
 	if (!sigmaVector.isEmpty())
-		sigma = sigmaVector.data();
+		sigma = sigmaVector.constData();
 
 	/////////////////////// GSL >= 2 has a complete new interface! But the old one is still supported. ///////////////////////////
 	// GSL >= 2 : "the 'fdf' field of gsl_multifit_function_fdf is now deprecated and does not need to be specified for nonlinear least squares problems"
 	for (unsigned int i = 0; i < np; i++)
-		DEBUG("fixed parameter"<<i<<fitData.paramFixed.data()[i]);
+		DEBUG("fixed parameter"<<i<<fitData.paramFixed.at(i));
 
 	//function to fit
 	gsl_multifit_function_fdf f;
 	struct data params = {n, xdata, ydata, sigma, fitData.modelCategory, fitData.modelType, fitData.degree, &fitData.model, &fitData.paramNames, 
-				fitData.paramLowerLimits.data(), fitData.paramUpperLimits.data(), fitData.paramFixed.data()};
+				fitData.paramLowerLimits.constData(), fitData.paramUpperLimits.constData(), fitData.paramFixed.constData(), parser_context_new(),
+				0, QVector<parser_program*>()};
 	f.f = &func_f;
 	f.df = &func_df;
 	f.fdf = &func_fdf;
@@ -941,49 +1489,73 @@ void XYFitCurvePrivate::recalculate() {
 	f.p = np;
 	f.params = &params;
 
-	// initialize the derivative solver (using Levenberg-Marquardt robust solver)
-	const gsl_multifit_fdfsolver_type* T = gsl_multifit_fdfsolver_lmsder;
-	gsl_multifit_fdfsolver* s = gsl_multifit_fdfsolver_alloc(T, n, np);
-
-	// set start values
-	double* x_init = fitData.paramStartValues.data();
-	double* x_min = fitData.paramLowerLimits.data();
-	double* x_max = fitData.paramUpperLimits.data();
-	// scale start values if limits are set
-	for (unsigned int i = 0; i < np; i++)
-		x_init[i] = nsl_fit_map_unbound(x_init[i], x_min[i], x_max[i]);
-	gsl_vector_view x = gsl_vector_view_array(x_init, np);
-	// initialize solver with function f and initial guess x
-	gsl_multifit_fdfsolver_set(s, &f, &x.vector);
-
-	//iterate
-	int status;
+	FitWorkspace tmpWorkspace;
+	if (!workspace)
+		workspace = &tmpWorkspace;
+	workspace->resize(n, np);
+	gsl_matrix* covar = workspace->covar;
+	gsl_vector* residualVector = workspace->residuals;	// weighted residuals (Y_i - y_i)/sigma_i
+	QVector<double> paramValues = fitData.paramStartValues;
+	int status = GSL_SUCCESS;
 	int iter = 0;
 	fitResult.solverOutput.clear();
-	writeSolverState(s);
-	do {
-		iter++;
-		status = gsl_multifit_fdfsolver_iterate(s);
-		writeSolverState(s);
-		if (status) break;
-		status = gsl_multifit_test_delta(s->dx, s->x, delta, delta);
-	} while (status == GSL_CONTINUE && iter < maxIters);
-
-	// unscale start values again
-	for (unsigned int i = 0; i < np; i++)
-		x_init[i] = nsl_fit_map_bound(x_init[i], x_min[i], x_max[i]);
 
-	//get the covariance matrix
-	//TODO: scale the Jacobian when limits are used before constructing the covar matrix?
-	gsl_matrix* covar = gsl_matrix_alloc(np, np);
+	if (linearFit(params, paramValues, covar, residualVector)) {
+		// linear in the parameters: solved directly without iterations
+		for (unsigned int i = 0; i < np; i++)
+			fitResult.solverOutput += QString::number(paramValues.at(i)) + '\t';
+		fitResult.solverOutput += QString::number(gsl_pow_2(gsl_blas_dnrm2(residualVector))) + ';';
+	} else {
+		// initialize the derivative solver (using Levenberg-Marquardt robust solver)
+		if (!workspace->solver)
+			workspace->solver = gsl_multifit_fdfsolver_alloc(gsl_multifit_fdfsolver_lmsder, n, np);
+		gsl_multifit_fdfsolver* s = workspace->solver;
+
+		// set start values, for the multi-start fit the best of the fits from all start points
+		QVector<double> startValues = fitData.paramStartValues;
+		if (fitData.startPoints > 1) {
+			fitResult.startPoints = fitData.startPoints;
+			fitResult.startPointsAtMinimum = multiStartFit(fitData, params, startValues, maxIters, delta, parallel);
+		}
+		double* x_init = startValues.data();
+		const double* x_min = fitData.paramLowerLimits.constData();
+		const double* x_max = fitData.paramUpperLimits.constData();
+		// scale start values if limits are set
+		for (unsigned int i = 0; i < np; i++)
+			x_init[i] = nsl_fit_map_unbound(x_init[i], x_min[i], x_max[i]);
+		gsl_vector_view x = gsl_vector_view_array(x_init, np);
+		// initialize solver with function f and initial guess x
+		compilePrograms(&params);
+		gsl_multifit_fdfsolver_set(s, &f, &x.vector);
+
+		//iterate
+		writeSolverState(s, fitData, fitResult);
+		do {
+			iter++;
+			status = gsl_multifit_fdfsolver_iterate(s);
+			writeSolverState(s, fitData, fitResult);
+			if (status) break;
+			status = gsl_multifit_test_delta(s->dx, s->x, delta, delta);
+		} while (status == GSL_CONTINUE && iter < maxIters);
+
+		//get the covariance matrix
+		//TODO: scale the Jacobian when limits are used before constructing the covar matrix?
 #if GSL_MAJOR_VERSION >= 2
-	// the Jacobian is not part of the solver anymore
-	gsl_matrix *J = gsl_matrix_alloc(s->fdf->n, s->fdf->p);
-	gsl_multifit_fdfsolver_jac(s, J);
-	gsl_multifit_covar(J, 0.0, covar);
+		// the Jacobian is not part of the solver anymore
+		if (!workspace->J)
+			workspace->J = gsl_matrix_alloc(n, np);
+		gsl_multifit_fdfsolver_jac(s, workspace->J);
+		gsl_multifit_covar(workspace->J, 0.0, covar);
 #else
-	gsl_multifit_covar(s->J, 0.0, covar);
+		gsl_multifit_covar(s->J, 0.0, covar);
 #endif
+		freePrograms(&params);
+
+		// scale resulting values if they are bounded
+		for (unsigned int i = 0; i < np; i++)
+			paramValues[i] = nsl_fit_map_bound(gsl_vector_get(s->x, i), x_min[i], x_max[i]);
+		gsl_vector_memcpy(residualVector, s->f);
+	}
 
 	//write the result
 	fitResult.available = true;
@@ -1007,10 +1579,10 @@ void XYFitCurvePrivate::recalculate() {
 
 	//gsl_blas_dnrm2() - computes the Euclidian norm (||x||_2 = \sqrt {\sum x_i^2}) of the vector with the elements (Yi - y[i])/sigma[i]
 	//gsl_blas_dasum() - computes the absolute sum \sum |x_i| of the elements of the vector with the elements (Yi - y[i])/sigma[i]
-	fitResult.sse = gsl_pow_2(gsl_blas_dnrm2(s->f));
+	fitResult.sse = gsl_pow_2(gsl_blas_dnrm2(residualVector));
 	fitResult.mse = fitResult.sse/n;
 	fitResult.rmse = sqrt(fitResult.mse);
-	fitResult.mae = gsl_blas_dasum(s->f)/n;
+	fitResult.mae = gsl_blas_dasum(residualVector)/n;
 	if (fitResult.dof != 0) {
 		fitResult.rms = fitResult.sse/fitResult.dof;
 		fitResult.rsd = sqrt(fitResult.rms);
@@ -1032,14 +1604,290 @@ void XYFitCurvePrivate::recalculate() {
 	fitResult.paramValues.resize(np);
 	fitResult.errorValues.resize(np);
 	for (unsigned int i = 0; i < np; i++) {
-		// scale resulting values if they are bounded
-		fitResult.paramValues[i] = nsl_fit_map_bound(gsl_vector_get(s->x, i), x_min[i], x_max[i]);
-		// use results as start values if desired
-		if (fitData.useResults) {
+		fitResult.paramValues[i] = paramValues.at(i);
+		fitResult.errorValues[i] = c*sqrt(gsl_matrix_get(covar, i, i));
+	}
+
+	//bootstrap confidence intervals
+	if (fitData.bootstrapSamples > 0)
+		bootstrapFit(fitData, params, residualVector, maxIters, delta, parallel, fitResult);
+
+	if (residuals) {
+		residuals->resize(n);
+		for (size_t i = 0; i < n; i++)
+			(*residuals)[i] = - gsl_vector_get(residualVector, i);
+	}
+
+	//free resources
+	parser_context_free(params.ctx);
+
+	return fitResult;
+}
+
+/* fits the model to one y column of a batch fit */
+class BatchFitTask : public QRunnable {
+public:
+	BatchFitTask(const XYFitCurve::FitData& fitData, const AbstractColumn* xColumn, const AbstractColumn* yColumn,
+		XYFitCurve::FitResult& result) : m_fitData(fitData), m_xColumn(xColumn), m_yColumn(yColumn), m_result(result) {}
+
+	void run() {
+		//copy all valid data points inside the x range
+		QVector<double> xdataVector;
+		QVector<double> ydataVector;
+		const int rows = qMin(m_xColumn->rowCount(), m_yColumn->rowCount());
+		for (int row = 0; row < rows; ++row) {
+			const double x = m_xColumn->valueAt(row);
+			const double y = m_yColumn->valueAt(row);
+			if (std::isnan(x) || std::isnan(y) || m_xColumn->isMasked(row) || m_yColumn->isMasked(row))
+				continue;
+			if (!m_fitData.autoRange && (x < m_fitData.xRange.first() || x > m_fitData.xRange.last()))
+				continue;
+			xdataVector.append(x);
+			ydataVector.append(y);
+		}
+
+		// the start points of a multi-start fit are not distributed again, the columns are already fitted in parallel
+		m_result = XYFitCurve::fit(m_fitData, xdataVector, ydataVector, QVector<double>(), 0, false);
+	}
+
+private:
+	const XYFitCurve::FitData& m_fitData;
+	const AbstractColumn* m_xColumn;
+	const AbstractColumn* m_yColumn;
+	XYFitCurve::FitResult& m_result;
+};
+
+/*!
+ * fits the model of \c fitData to every column in \c yColumns against \c xColumn in parallel, without weights.
+ * Returns a new spreadsheet with one row per y column containing the parameter values and errors,
+ * chi^2, R^2, the number of iterations and the status of the fit.
+ */
+Spreadsheet* XYFitCurve::batchFit(const FitData& fitData, const AbstractColumn* xColumn, const QList<const AbstractColumn*>& yColumns) {
+	if (!xColumn || yColumns.isEmpty())
+		return 0;
+
+	WAIT_CURSOR;
+
+	// own pool: waiting for it doesn't wait for unrelated tasks on the global pool
+	QThreadPool pool;
+	QVector<FitResult> results(yColumns.size());
+	for (int i = 0; i < yColumns.size(); ++i)
+		pool.start(new BatchFitTask(fitData, xColumn, yColumns.at(i), results[i]));
+	pool.waitForDone();
+
+	// create the result spreadsheet
+	const int np = fitData.paramNames.size();
+	const int count = yColumns.size();
+	QStringList names;
+	QStringList status;
+	QVector<QVector<double> > values(np, QVector<double>(count));
+	QVector<QVector<double> > errors(np, QVector<double>(count));
+	QVector<double> sse(count), rsquared(count), iterations(count);
+	for (int i = 0; i < count; ++i) {
+		const FitResult& result = results.at(i);
+		names << yColumns.at(i)->name();
+		status << result.status;
+		for (int j = 0; j < np; ++j) {
+			values[j][i] = result.valid ? result.paramValues.at(j) : NAN;
+			errors[j][i] = result.valid ? result.errorValues.at(j) : NAN;
+		}
+		sse[i] = result.valid ? result.sse : NAN;
+		rsquared[i] = result.valid ? result.rsquared : NAN;
+		iterations[i] = result.iterations;
+	}
+
+	Spreadsheet* spreadsheet = new Spreadsheet(0, i18n("fit results"), true);
+	Column* col = new Column(i18n("column"), AbstractColumn::Text);
+	col->replaceTexts(0, names);
+	col->setPlotDesignation(AbstractColumn::X);
+	spreadsheet->addChild(col);
+	for (int j = 0; j < np; ++j) {
+		col = new Column(fitData.paramNames.at(j), AbstractColumn::Numeric);
+		col->replaceValues(0, values.at(j));
+		col->setPlotDesignation(AbstractColumn::Y);
+		spreadsheet->addChild(col);
+		col = new Column(i18n("%1 error", fitData.paramNames.at(j)), AbstractColumn::Numeric);
+		col->replaceValues(0, errors.at(j));
+		col->setPlotDesignation(AbstractColumn::yErr);
+		spreadsheet->addChild(col);
+	}
+	col = new Column(QString::fromUtf8("\u03c7\u00b2"), AbstractColumn::Numeric);
+	col->replaceValues(0, sse);
+	spreadsheet->addChild(col);
+	col = new Column(QString::fromUtf8("R\u00b2"), AbstractColumn::Numeric);
+	col->replaceValues(0, rsquared);
+	spreadsheet->addChild(col);
+	col = new Column(i18n("iterations"), AbstractColumn::Numeric);
+	col->replaceValues(0, iterations);
+	spreadsheet->addChild(col);
+	col = new Column(i18n("status"), AbstractColumn::Text);
+	col->replaceTexts(0, status);
+	spreadsheet->addChild(col);
+
+	RESET_CURSOR;
+	return spreadsheet;
+}
+
+/*!
+ * performs the fit. For the incremental refit (\c incremental is \c true) the fit starts at the last result
+ * without multi-start and is skipped if the data didn't change. If rows were only appended, a cheap update
+ * without the bootstrap is done first, the full refit follows when no new data arrived for one second.
+ */
+void XYFitCurvePrivate::recalculate(bool incremental) {
+	QElapsedTimer timer;
+	timer.start();
+
+	const XYFitCurve::FitResult lastResult = fitResult;
+	const bool fullRefit = fullRefitPending;
+	fullRefitPending = false;
+	refitTimer->stop();
+
+	//create fit result columns if not available yet, clear them otherwise
+	if (!xColumn) {
+		xColumn = new Column("x", AbstractColumn::Numeric);
+		yColumn = new Column("y", AbstractColumn::Numeric);
+		residualsColumn = new Column("residuals", AbstractColumn::Numeric);
+		xVector = static_cast<QVector<double>* >(xColumn->data());
+		yVector = static_cast<QVector<double>* >(yColumn->data());
+		residualsVector = static_cast<QVector<double>* >(residualsColumn->data());
+
+		xColumn->setHidden(true);
+		q->addChild(xColumn);
+
+		yColumn->setHidden(true);
+		q->addChild(yColumn);
+
+		q->addChild(residualsColumn);
+
+		q->setUndoAware(false);
+		q->setXColumn(xColumn);
+		q->setYColumn(yColumn);
+		q->setUndoAware(true);
+	} else {
+		xVector->clear();
+		yVector->clear();
+		residualsVector->clear();
+	}
+
+	// clear the previous result
+	fitResult = XYFitCurve::FitResult();
+
+	if (!xDataColumn || !yDataColumn) {
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastFit = false;
+		return;
+	}
+
+	//check column sizes
+	if (xDataColumn->rowCount() != yDataColumn->rowCount()) {
+		fitResult.available = true;
+		fitResult.valid = false;
+		fitResult.status = i18n("Number of x and y data points must be equal.");
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastFit = false;
+		return;
+	}
+	if (weightsColumn) {
+		if (weightsColumn->rowCount() < xDataColumn->rowCount()) {
+			fitResult.available = true;
+			fitResult.valid = false;
+			fitResult.status = i18n("Not sufficient weight data points provided.");
+			emit (q->dataChanged());
+			sourceDataChangedSinceLastFit = false;
+			return;
+		}
+	}
+
+	//copy all valid data point for the fit to the vectors of the last fit,
+	//compare with the old values to find out whether data was only appended
+	const int oldCount = xdataVector.size();
+	const bool oldWeights = !sigmaVector.isEmpty();
+	xdataVector.resize(xDataColumn->rowCount());
+	ydataVector.resize(xDataColumn->rowCount());
+	sigmaVector.resize(weightsColumn ? xDataColumn->rowCount() : 0);
+	bool changed = (oldWeights != !sigmaVector.isEmpty());
+	int count = 0;
+	double xmin = fitData.xRange.first();
+	double xmax = fitData.xRange.last();
+	if (fitData.autoRange) {
+		// all data is used, the range is determined from the fitted data points below
+		xmin = INFINITY;
+		xmax = -INFINITY;
+	}
+	for (int row=0; row < xDataColumn->rowCount(); ++row) {
+		//only copy those data where _all_ values (for x, y and sigma, if given) are valid
+		const double x = xDataColumn->valueAt(row);
+		const double y = yDataColumn->valueAt(row);
+		if (std::isnan(x) || std::isnan(y) || xDataColumn->isMasked(row) || yDataColumn->isMasked(row))
+			continue;
+
+		// only when inside given range
+		if (!fitData.autoRange && (x < xmin || x > xmax))
+			continue;
+
+		double sigma = 1.;
+		if (weightsColumn) {
+			const double weight = weightsColumn->valueAt(row);
+			if (std::isnan(weight))
+				continue;
+
+			if (fitData.weightsType == XYFitCurve::WeightsFromColumn) {
+				//weights from a given column -> calculate the square root of the inverse (sigma = sqrt(1/weight))
+				sigma = sqrt(1./weight);
+			} else if (fitData.weightsType == XYFitCurve::WeightsFromErrorColumn) {
+				//weights from a given column with error bars (sigma = error)
+				sigma = weight;
+			}
+		}
+
+		if (count < oldCount && !changed)
+			changed = (x != xdataVector.at(count) || y != ydataVector.at(count) || (weightsColumn && sigma != sigmaVector.at(count)));
+		xdataVector[count] = x;
+		ydataVector[count] = y;
+		if (weightsColumn)
+			sigmaVector[count] = sigma;
+		if (fitData.autoRange) {
+			xmin = qMin(xmin, x);
+			xmax = qMax(xmax, x);
+		}
+		count++;
+	}
+	changed = changed || count < oldCount;
+	xdataVector.resize(count);
+	ydataVector.resize(count);
+	if (weightsColumn)
+		sigmaVector.resize(count);
+
+	//the incremental refit starts at the last result
+	const bool warmStart = incremental && lastResult.valid && lastResult.paramValues.size() == fitData.paramNames.size();
+	XYFitCurve::FitData data = fitData;
+	if (warmStart) {
+		data.paramStartValues = lastResult.paramValues;
+		data.startPoints = 1;
+		if (!changed && count > oldCount && data.bootstrapSamples > 0) {
+			//only appended: cheap update first, the full refit with the bootstrap follows later
+			data.bootstrapSamples = 0;
+			fullRefitPending = true;
+			refitTimer->start(1000);
+		}
+	}
+
+	if (warmStart && !changed && count == oldCount && !fullRefit)
+		fitResult = lastResult;	// nothing to do
+	else
+		fitResult = XYFitCurve::fit(data, xdataVector, ydataVector, sigmaVector, &residuals, true, &workspace);
+	if (!fitResult.valid) {
+		emit (q->dataChanged());
+		sourceDataChangedSinceLastFit = false;
+		return;
+	}
+
+	// use results as start values if desired
+	if (fitData.useResults) {
+		for (int i = 0; i < fitResult.paramValues.size(); i++) {
 			fitData.paramStartValues.data()[i] = fitResult.paramValues[i];
 			DEBUG("saving parameter"<<i<<fitResult.paramValues[i]<<fitData.paramStartValues.data()[i]);
 		}
-		fitResult.errorValues[i] = c*sqrt(gsl_matrix_get(covar, i, i));
 	}
 
 	// fill residuals vector. To get residuals on the correct x values, fill the rest with zeros.
@@ -1056,20 +1904,23 @@ void XYFitCurvePrivate::recalculate() {
 		if (!rc)
 			residualsVector->clear();
 	} else {	// only selected range
-		size_t j = 0;
+		// the residuals belong to the rows copied for the fit above
+		int j = 0;
 		for (int i = 0; i < xDataColumn->rowCount(); i++) {
-			if (xDataColumn->valueAt(i) >= xmin && xDataColumn->valueAt(i) <= xmax)
-				residualsVector->data()[i] = - gsl_vector_get(s->f, j++);
-			else	// outside range
+			const double x = xDataColumn->valueAt(i);
+			bool fitted = !(std::isnan(x) || std::isnan(yDataColumn->valueAt(i)) || xDataColumn->isMasked(i) || yDataColumn->isMasked(i));
+			if (fitted && !fitData.autoRange)
+				fitted = (x >= xmin && x <= xmax);
+			if (fitted && weightsColumn)
+				fitted = !std::isnan(weightsColumn->valueAt(i));
+			if (fitted && j < residuals.size())
+				residualsVector->data()[i] = residuals.at(j++);
+			else	// outside range or not used
 				residualsVector->data()[i] = 0;
 		}
 	}
 	residualsColumn->setChanged();
 
-	//free resources
-	gsl_multifit_fdfsolver_free(s);
-	gsl_matrix_free(covar);
-
 	//calculate the fit function (vectors)
 	ExpressionParser* parser = ExpressionParser::getInstance();
 	if (fitData.evaluateFullRange) { // evaluate fit on full data range if selected
@@ -1092,29 +1943,6 @@ void XYFitCurvePrivate::recalculate() {
 	sourceDataChangedSinceLastFit = false;
 }
 
-/*!
- * writes out the current state of the solver \c s
- */
-void XYFitCurvePrivate::writeSolverState(gsl_multifit_fdfsolver* s) {
-	QString state;
-
-	//current parameter values, semicolon separated
-	double* min = fitData.paramLowerLimits.data();
-	double* max = fitData.paramUpperLimits.data();
-	for (int i = 0; i < fitData.paramNames.size(); ++i) {
-		double x = gsl_vector_get(s->x, i);
-		// map parameter if bounded
-		state += QString::number(nsl_fit_map_bound(x, min[i], max[i])) + '\t';
-	}
-
-	//current value of the chi2-function
-	state += QString::number(gsl_pow_2(gsl_blas_dnrm2(s->f)));
-	state += ';';
-
-	fitResult.solverOutput += state;
-}
-
-
 //##############################################################################
 //##################  Serialization/Deserialization  ###########################
 //##############################################################################
@@ -1144,6 +1972,9 @@ void XYFitCurve::save(QXmlStreamWriter* writer) const {
 	writer->writeAttribute( "model", d->fitData.model );
 	writer->writeAttribute( "maxIterations", QString::number(d->fitData.maxIterations) );
 	writer->writeAttribute( "eps", QString::number(d->fitData.eps, 'g', 15) );
+	writer->writeAttribute( "startPoints", QString::number(d->fitData.startPoints) );
+	writer->writeAttribute( "bootstrapSamples", QString::number(d->fitData.bootstrapSamples) );
+	writer->writeAttribute( "incrementalRefit", QString::number(d->fitData.incrementalRefit) );
 	writer->writeAttribute( "evaluatedPoints", QString::number(d->fitData.evaluatedPoints) );
 	writer->writeAttribute( "evaluateFullRange", QString::number(d->fitData.evaluateFullRange) );
 	writer->writeAttribute( "useResults", QString::number(d->fitData.useResults) );
@@ -1196,6 +2027,9 @@ void XYFitCurve::save(QXmlStreamWriter* writer) const {
 	writer->writeAttribute( "status", d->fitResult.status );
 	writer->writeAttribute( "iterations", QString::number(d->fitResult.iterations) );
 	writer->writeAttribute( "time", QString::number(d->fitResult.elapsedTime) );
+	writer->writeAttribute( "startPoints", QString::number(d->fitResult.startPoints) );
+	writer->writeAttribute( "startPointsAtMinimum", QString::number(d->fitResult.startPointsAtMinimum) );
+	writer->writeAttribute( "bootstrapSamples", QString::number(d->fitResult.bootstrapSamples) );
 	writer->writeAttribute( "dof", QString::number(d->fitResult.dof) );
 	writer->writeAttribute( "sse", QString::number(d->fitResult.sse, 'g', 15) );
 	writer->writeAttribute( "mse", QString::number(d->fitResult.mse, 'g', 15) );
@@ -1217,6 +2051,16 @@ void XYFitCurve::save(QXmlStreamWriter* writer) const {
 		writer->writeTextElement("error", QString::number(value, 'g', 15));
 	writer->writeEndElement();
 
+	writer->writeStartElement("lowerConfidenceValues");
+	foreach (const double value, d->fitResult.lowerConfidenceValues)
+		writer->writeTextElement("lowerConfidence", QString::number(value, 'g', 15));
+	writer->writeEndElement();
+
+	writer->writeStartElement("upperConfidenceValues");
+	foreach (const double value, d->fitResult.upperConfidenceValues)
+		writer->writeTextElement("upperConfidence", QString::number(value, 'g', 15));
+	writer->writeEndElement();
+
 	//save calculated columns if available
 	if (d->xColumn && d->yColumn && d->residualsColumn) {
 		d->xColumn->save(writer);
@@ -1269,6 +2113,15 @@ bool XYFitCurve::load(XmlStreamReader* reader) {
 			READ_STRING_VALUE("model", fitData.model);
 			READ_INT_VALUE("maxIterations", fitData.maxIterations, int);
 			READ_DOUBLE_VALUE("eps", fitData.eps);
+			str = attribs.value("startPoints").toString();
+			if (!str.isEmpty())	// not available in older projects
+				d->fitData.startPoints = str.toInt();
+			str = attribs.value("bootstrapSamples").toString();
+			if (!str.isEmpty())
+				d->fitData.bootstrapSamples = str.toInt();
+			str = attribs.value("incrementalRefit").toString();
+			if (!str.isEmpty())
+				d->fitData.incrementalRefit = str.toInt();
 			READ_INT_VALUE("fittedPoints", fitData.evaluatedPoints, size_t);	// old name
 			READ_INT_VALUE("evaluatedPoints", fitData.evaluatedPoints, size_t);
 			READ_INT_VALUE("evaluateFullRange", fitData.evaluateFullRange, bool);
@@ -1299,6 +2152,10 @@ bool XYFitCurve::load(XmlStreamReader* reader) {
 			d->fitResult.paramValues<<reader->readElementText().toDouble();
 		} else if (reader->name() == "error") {
 			d->fitResult.errorValues<<reader->readElementText().toDouble();
+		} else if (reader->name() == "lowerConfidence") {
+			d->fitResult.lowerConfidenceValues<<reader->readElementText().toDouble();
+		} else if (reader->name() == "upperConfidence") {
+			d->fitResult.upperConfidenceValues<<reader->readElementText().toDouble();
 		} else if (reader->name() == "fitResult") {
 			attribs = reader->attributes();
 
@@ -1307,6 +2164,14 @@ bool XYFitCurve::load(XmlStreamReader* reader) {
 			READ_STRING_VALUE("status", fitResult.status);
 			READ_INT_VALUE("iterations", fitResult.iterations, int);
 			READ_INT_VALUE("time", fitResult.elapsedTime, int);
+			str = attribs.value("startPoints").toString();
+			if (!str.isEmpty()) {
+				d->fitResult.startPoints = str.toInt();
+				d->fitResult.startPointsAtMinimum = attribs.value("startPointsAtMinimum").toString().toInt();
+			}
+			str = attribs.value("bootstrapSamples").toString();
+			if (!str.isEmpty())
+				d->fitResult.bootstrapSamples = str.toInt();
 			READ_DOUBLE_VALUE("dof", fitResult.dof);
 			READ_DOUBLE_VALUE("sse", fitResult.sse);
 			READ_DOUBLE_VALUE("mse", fitResult.mse);
@@ -35,6 +35,7 @@ extern "C" {
 #include "backend/nsl/nsl_fit.h"
 }
 
+class Spreadsheet;
 class XYFitCurvePrivate;
 class XYFitCurve : public XYCurve {
 	Q_OBJECT
@@ -48,6 +49,9 @@ class XYFitCurve : public XYCurve {
 						degree(1),
 						maxIterations(500),
 						eps(1e-4),
+						startPoints(1),
+						bootstrapSamples(0),
+						incrementalRefit(false),
 						evaluatedPoints(100),
 						useResults(true),
 						evaluateFullRange(true),
@@ -67,6 +71,9 @@ class XYFitCurve : public XYCurve {
 
 			int maxIterations;
 			double eps;
+			int startPoints;		// number of start points of the multi-start fit (1: only the start values)
+			int bootstrapSamples;		// number of resampled data sets for the bootstrap confidence intervals (0: no bootstrap)
+			bool incrementalRefit;		// refit automatically when the source data changes, starting at the last result
 			size_t evaluatedPoints;
 			bool useResults;		// use results as new start values
 			bool evaluateFullRange;		// evaluate fit function on full data range
@@ -77,13 +84,16 @@ class XYFitCurve : public XYCurve {
 
 		struct FitResult {
 			FitResult() : available(false), valid(false), iterations(0), elapsedTime(0),
-				dof(0), sse(0), mse(0), rmse(0), mae(0), rms(0), rsd(0), rsquared(0), rsquaredAdj(0) {};
+				startPoints(1), startPointsAtMinimum(1), bootstrapSamples(0), dof(0), sse(0), mse(0), rmse(0), mae(0), rms(0), rsd(0), rsquared(0), rsquaredAdj(0) {};
 
 			bool available;
 			bool valid;
 			QString status;
 			int iterations;
 			qint64 elapsedTime;
+			int startPoints; //number of start points of the multi-start fit
+			int startPointsAtMinimum; //number of start points converging to the best sse (within 0.1%)
+			int bootstrapSamples; //number of successful bootstrap fits used for the confidence intervals
 			double dof; //degrees of freedom
 			double sse; //sum of squared errors (SSE) / residual sum of errors (RSS) / sum of sq. residuals (SSR) = \sum_i^n (Y_i-y_i)^2
 			double mse; //mean squared error = 1/n \sum_i^n  (Y_i-y_i)^2
@@ -95,14 +105,22 @@ class XYFitCurve : public XYCurve {
 			double rsquaredAdj; //Adjusted coefficient of determination (R^2)
 			QVector<double> paramValues;
 			QVector<double> errorValues;
+			QVector<double> lowerConfidenceValues; //lower limits of the 95% bootstrap confidence intervals
+			QVector<double> upperConfidenceValues; //upper limits of the 95% bootstrap confidence intervals
 			QString solverOutput;
 		};
 
+		struct FitWorkspace;
+
 		explicit XYFitCurve(const QString& name);
 		virtual ~XYFitCurve();
 
 		void recalculate();
+		static FitResult fit(const FitData&, const QVector<double>& xVector, const QVector<double>& yVector, const QVector<double>& sigmaVector,
+				QVector<double>* residuals = 0, bool parallel = true, FitWorkspace* workspace = 0);
+		static Spreadsheet* batchFit(const FitData&, const AbstractColumn* xColumn, const QList<const AbstractColumn*>& yColumns);
 		virtual QIcon icon() const;
+		virtual QMenu* createContextMenu();
 		virtual void save(QXmlStreamWriter*) const;
 		virtual bool load(XmlStreamReader*);
 
@@ -127,8 +145,14 @@ class XYFitCurve : public XYCurve {
 		Q_DECLARE_PRIVATE(XYFitCurve)
 		void init();
 
+		QAction* batchFitAction;
+
 	private slots:
 		void handleSourceDataChanged();
+		void refit();
+
+		//SLOTs for changes triggered via QActions in the context menu
+		void fitAllColumns();
 
 	signals:
 		friend class XYFitCurveSetXDataColumnCmd;
@@ -34,17 +34,32 @@
 
 class XYFitCurve;
 class Column;
+class QTimer;
 
 extern "C" {
 #include <gsl/gsl_multifit_nlin.h>
 }
 
+/* solver and GSL workspaces of a fit, kept between fits with the same number of data points and parameters */
+struct XYFitCurve::FitWorkspace {
+	FitWorkspace();
+	~FitWorkspace();
+	void resize(size_t n, size_t np);
+
+	size_t n;
+	size_t np;
+	gsl_multifit_fdfsolver* solver;	// allocated by the first nonlinear fit
+	gsl_matrix* covar;
+	gsl_vector* residuals;
+	gsl_matrix* J;	// Jacobian for the covariance matrix (GSL >= 2)
+};
+
 class XYFitCurvePrivate: public XYCurvePrivate {
 	public:
 		explicit XYFitCurvePrivate(XYFitCurve*);
 		~XYFitCurvePrivate();
 
-		void recalculate();
+		void recalculate(bool incremental = false);
 
 		const AbstractColumn* xDataColumn; //<! column storing the values for the x-data to be fitted
 		const AbstractColumn* yDataColumn; //<! column storing the values for the y-data to be fitted
@@ -66,10 +81,16 @@ class XYFitCurvePrivate: public XYCurvePrivate {
 
 		bool sourceDataChangedSinceLastFit; //<! \c true if the data in the source columns (x, y, or weights) was changed, \c false otherwise
 
-		XYFitCurve* const q;
+		//data of the last fit, kept for the incremental refit
+		QVector<double> xdataVector;
+		QVector<double> ydataVector;
+		QVector<double> sigmaVector;
+		QVector<double> residuals;
+		XYFitCurve::FitWorkspace workspace;
+		QTimer* refitTimer;
+		bool fullRefitPending; //<! \c true if only a cheap update was done for appended data and the full refit is still pending
 
-	private:
-		void writeSolverState(gsl_multifit_fdfsolver* s);
+		XYFitCurve* const q;
 };
 
 #endif
@@ -217,6 +217,8 @@ void XYFourierTransformCurvePrivate::recalculate() {
 	//copy all valid data point for the transform to temporary vectors
 	QVector<double> xdataVector;
 	QVector<double> ydataVector;
+	xdataVector.reserve(xDataColumn->rowCount());
+	ydataVector.reserve(yDataColumn->rowCount());
 	const double xmin = transformData.xRange.first();
 	const double xmax = transformData.xRange.last();
 	for (int row=0; row<xDataColumn->rowCount(); ++row) {
@@ -39,6 +39,8 @@
 #include "backend/lib/commandtemplates.h"
 #include "backend/lib/macros.h"
 
+#include <algorithm>
+
 #include <KIcon>
 #include <KLocale>
 #include <QElapsedTimer>
@@ -166,6 +168,78 @@ XYSmoothCurvePrivate::~XYSmoothCurvePrivate() {
 	//when the parent aspect is removed
 }
 
+/*!
+ * LOWESS fit of the points first .. last-1, see nsl_smooth_lowess_range()
+ */
+class LowessTask : public QRunnable {
+public:
+	LowessTask(const double* x, const double* y, const double* rweights, size_t n, size_t points, double delta,
+		size_t first, size_t last, double* result)
+		: m_x(x), m_y(y), m_rweights(rweights), m_n(n), m_points(points), m_delta(delta),
+		m_first(first), m_last(last), m_result(result), m_status(0) {}
+
+	void run() {
+		m_status = nsl_smooth_lowess_range(m_x, m_y, m_rweights, m_n, m_points, m_delta, m_first, m_last, m_result);
+	}
+
+	int status() const {
+		return m_status;
+	}
+
+private:
+	const double* m_x;
+	const double* m_y;
+	const double* m_rweights;
+	size_t m_n;
+	size_t m_points;
+	double m_delta;
+	size_t m_first;
+	size_t m_last;
+	double* m_result;
+	int m_status;
+};
+
+/*!
+ * LOWESS smoothing of the data sorted by x. Each iteration fits chunks of a fixed size in parallel
+ * on a private thread pool, the result doesn't depend on the number of threads.
+ */
+static int lowess(const double* xdata, const double* ydata, size_t n, size_t points, unsigned int iterations, double delta, double* result) {
+	const size_t chunkSize = 16384;
+	const size_t chunks = (n + chunkSize - 1)/chunkSize;
+	QVector<double> rweights;
+	QThreadPool pool;
+
+	int status = 0;
+	for (unsigned int iter = 0; iter <= iterations && status == 0; ++iter) {
+		if (iter > 0) {
+			rweights.resize(n);
+			// stop if the fit is (almost) exact
+			if (nsl_smooth_lowess_weights(ydata, result, n, rweights.data()) != 0)
+				break;
+		}
+
+		QVector<LowessTask*> tasks;
+		for (size_t c = 0; c < chunks; ++c) {
+			LowessTask* task = new LowessTask(xdata, ydata, (iter > 0) ? rweights.constData() : 0, n, points, delta,
+				c*chunkSize, qMin((c + 1)*chunkSize, n), result);
+			task->setAutoDelete(false);
+			tasks << task;
+			if (chunks > 1)
+				pool.start(task);
+			else
+				task->run();
+		}
+		if (chunks > 1)
+			pool.waitForDone();
+		foreach (LowessTask* task, tasks)
+			if (task->status() != 0)
+				status = task->status();
+		qDeleteAll(tasks);
+	}
+
+	return status;
+}
+
 // ...
 // see XYFitCurvePrivate
 
@@ -254,6 +328,8 @@ void XYSmoothCurvePrivate::recalculate() {
 	const nsl_smooth_pad_mode mode = smoothData.mode;
 	const double lvalue = smoothData.lvalue;
 	const double rvalue = smoothData.rvalue;
+	const unsigned int iterations = smoothData.iterations;
+	const double delta = smoothData.delta;
 
 	DEBUG("type:"<<nsl_smooth_type_name[type]);
 	DEBUG("points ="<<points);
@@ -262,6 +338,7 @@ void XYSmoothCurvePrivate::recalculate() {
 	DEBUG("order ="<<order);
 	DEBUG("mode ="<<nsl_smooth_pad_mode_name[mode]);
 	DEBUG("const. values ="<<lvalue<<rvalue);
+	DEBUG("iterations ="<<iterations<<", delta ="<<delta);
 
 ///////////////////////////////////////////////////////////
 	int status=0;
@@ -281,6 +358,28 @@ void XYSmoothCurvePrivate::recalculate() {
 			nsl_smooth_pad_constant_set(lvalue, rvalue);
 		status = nsl_smooth_savgol(ydata, n, points, order, mode);
 		break;
+	case nsl_smooth_type_lowess: {
+		// LOWESS needs the data sorted by x
+		bool sorted = true;
+		for (unsigned int i = 1; i < n && sorted; i++)
+			sorted = (xdata[i-1] <= xdata[i]);
+		if (!sorted) {
+			QVector<QPair<double, double> > data(n);
+			for (unsigned int i = 0; i < n; i++)
+				data[i] = qMakePair(xdata[i], ydata[i]);
+			std::sort(data.begin(), data.end());
+			for (unsigned int i = 0; i < n; i++) {
+				xdata[i] = data.at(i).first;
+				ydata[i] = data.at(i).second;
+			}
+		}
+
+		QVector<double> result(n);
+		status = lowess(xdata, ydata, n, points, iterations, delta, result.data());
+		if (status == 0)
+			memcpy(ydata, result.constData(), n*sizeof(double));
+		break;
+	}
 	}
 
 	xVector->resize(n);
@@ -328,6 +427,8 @@ void XYSmoothCurve::save(QXmlStreamWriter* writer) const{
 	writer->writeAttribute( "mode", QString::number(d->smoothData.mode) );
 	writer->writeAttribute( "lvalue", QString::number(d->smoothData.lvalue) );
 	writer->writeAttribute( "rvalue", QString::number(d->smoothData.rvalue) );
+	writer->writeAttribute( "iterations", QString::number(d->smoothData.iterations) );
+	writer->writeAttribute( "delta", QString::number(d->smoothData.delta) );
 	writer->writeEndElement();// smoothData
 
 	// smooth results (generated columns)
@@ -388,6 +489,12 @@ bool XYSmoothCurve::load(XmlStreamReader* reader) {
 			READ_INT_VALUE("mode", smoothData.mode, nsl_smooth_pad_mode);
 			READ_DOUBLE_VALUE("lvalue", smoothData.lvalue);
 			READ_DOUBLE_VALUE("rvalue", smoothData.rvalue);
+			str = attribs.value("iterations").toString();
+			if (!str.isEmpty())	// not available in older projects
+				d->smoothData.iterations = str.toInt();
+			str = attribs.value("delta").toString();
+			if (!str.isEmpty())
+				d->smoothData.delta = str.toDouble();
 		} else if (reader->name() == "smoothResult") {
 
 			attribs = reader->attributes();
@@ -42,7 +42,7 @@ class XYSmoothCurve: public XYCurve {
 	public:
 		struct SmoothData {
 			SmoothData() : type(nsl_smooth_type_moving_average), points(5), weight(nsl_smooth_weight_uniform), percentile(0.5), order(2),
-				mode(nsl_smooth_pad_none), lvalue(0.0), rvalue(0.0), autoRange(true), xRange(2) {};
+				mode(nsl_smooth_pad_none), lvalue(0.0), rvalue(0.0), iterations(3), delta(0.0), autoRange(true), xRange(2) {};
 
 			nsl_smooth_type type;			// type of smoothing
 			unsigned int points;			// number of points
@@ -51,6 +51,8 @@ class XYSmoothCurve: public XYCurve {
 			unsigned order;				// order for Savitzky-Golay filter
 			nsl_smooth_pad_mode mode;		// mode of padding for edges
 			double lvalue, rvalue;			// values for constant padding
+			unsigned int iterations;		// number of robustness iterations for LOWESS
+			double delta;				// LOWESS interpolates points closer than delta
 			bool autoRange;				// use all data?
 			QVector<double> xRange;			// x range for integration
 		};
@@ -41,6 +41,7 @@
 #include "backend/core/datatypes/String2DateTimeFilter.h"
 
 #include <QTableView>
+#include <QScrollBar>
 #include <QHBoxLayout>
 #include <QKeyEvent>
 #include <QClipboard>
@@ -63,6 +64,9 @@
 #include "kdefrontend/spreadsheet/EquidistantValuesDialog.h"
 #include "kdefrontend/spreadsheet/FunctionValuesDialog.h"
 #include "kdefrontend/spreadsheet/StatisticsDialog.h"
+#include "kdefrontend/spreadsheet/SpectrogramDialog.h"
+#include "kdefrontend/spreadsheet/JoinDialog.h"
+#include "kdefrontend/spreadsheet/GroupByDialog.h"
 #include "kdefrontend/widgets/FITSHeaderEditDialog.h"
 
 #include <algorithm> //for std::reverse
@@ -139,6 +143,12 @@ void SpreadsheetView::init() {
 	v_header->setMovable(false);
 	v_header->installEventFilter(this);
 
+	//inform the model about the visible cells so it can prepare the formatted texts around them
+	connect(m_tableView->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(updateViewport()));
+	connect(m_tableView->verticalScrollBar(), SIGNAL(rangeChanged(int,int)), this, SLOT(updateViewport()));
+	connect(m_tableView->horizontalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(updateViewport()));
+	connect(m_tableView->horizontalScrollBar(), SIGNAL(rangeChanged(int,int)), this, SLOT(updateViewport()));
+
 	setFocusPolicy(Qt::StrongFocus);
 	setFocus();
 	installEventFilter(this);
@@ -211,6 +221,9 @@ void SpreadsheetView::initActions() {
 	action_reverse_columns = new KAction(KIcon(""), i18n("Reverse"), this);
 	action_drop_values = new KAction(KIcon(""), i18n("Drop Values"), this);
 	action_mask_values = new KAction(KIcon(""), i18n("Mask Values"), this);
+	action_filter_rows = new KAction(KIcon("view-filter"), i18n("&Filter Rows"), this);
+	action_join_spreadsheet = new KAction(KIcon(""), i18n("Join with Spreadsheet"), this);
+	action_group_by = new KAction(KIcon(""), i18n("&Group Rows"), this);
 // 	action_join_columns = new KAction(KIcon(""), i18n("Join"), this);
 	action_normalize_columns = new KAction(KIcon(""), i18n("&Normalize"), this);
 	action_normalize_selection = new KAction(KIcon(""), i18n("&Normalize Selection"), this);
@@ -218,6 +231,7 @@ void SpreadsheetView::initActions() {
 	action_sort_asc_column = new KAction(KIcon("view-sort-ascending"), i18n("&Ascending"), this);
 	action_sort_desc_column = new KAction(KIcon("view-sort-descending"), i18n("&Descending"), this);
 	action_statistics_columns = new KAction(KIcon("view-statistics"), i18n("Column Statisti&cs"), this);
+	action_spectrogram = new KAction(i18n("S&pectrogram"), this);
 
 	// row related actions
 	action_insert_rows = new KAction(KIcon("edit-table-insert-row-above") ,i18n("&Insert Empty Rows"), this);
@@ -283,6 +297,9 @@ void SpreadsheetView::initMenus() {
 	m_columnMenu->addAction(action_reverse_columns);
 	m_columnMenu->addAction(action_drop_values);
 	m_columnMenu->addAction(action_mask_values);
+	m_columnMenu->addAction(action_filter_rows);
+	m_columnMenu->addAction(action_join_spreadsheet);
+	m_columnMenu->addAction(action_group_by);
 // 	m_columnMenu->addAction(action_join_columns);
 	m_columnMenu->addAction(action_normalize_columns);
 
@@ -305,6 +322,7 @@ void SpreadsheetView::initMenus() {
 
 	m_columnMenu->addAction(action_statistics_columns);
 	action_statistics_columns->setVisible(false);
+	m_columnMenu->addAction(action_spectrogram);
 
 	//Spreadsheet menu
 	m_spreadsheetMenu = new QMenu(this);
@@ -379,6 +397,9 @@ void SpreadsheetView::connectActions() {
 	connect(action_reverse_columns, SIGNAL(triggered()), this, SLOT(reverseColumns()));
 	connect(action_drop_values, SIGNAL(triggered()), this, SLOT(dropColumnValues()));
 	connect(action_mask_values, SIGNAL(triggered()), this, SLOT(maskColumnValues()));
+	connect(action_filter_rows, SIGNAL(triggered()), this, SLOT(filterRows()));
+	connect(action_join_spreadsheet, SIGNAL(triggered()), this, SLOT(joinSpreadsheet()));
+	connect(action_group_by, SIGNAL(triggered()), this, SLOT(groupRows()));
 // 	connect(action_join_columns, SIGNAL(triggered()), this, SLOT(joinColumns()));
 	connect(action_normalize_columns, SIGNAL(triggered()), this, SLOT(normalizeSelectedColumns()));
 	connect(action_normalize_selection, SIGNAL(triggered()), this, SLOT(normalizeSelection()));
@@ -387,6 +408,7 @@ void SpreadsheetView::connectActions() {
 	connect(action_sort_desc_column, SIGNAL(triggered()), this, SLOT(sortColumnDescending()));
 	connect(action_statistics_columns, SIGNAL(triggered()), this, SLOT(showColumnStatistics()));
 	connect(action_statistics_all_columns, SIGNAL(triggered()), this, SLOT(showAllColumnsStatistics()));
+	connect(action_spectrogram, SIGNAL(triggered()), this, SLOT(showSpectrogramDialog()));
 
 	connect(action_insert_rows, SIGNAL(triggered()), this, SLOT(insertEmptyRows()));
 	connect(action_remove_rows, SIGNAL(triggered()), this, SLOT(removeSelectedRows()));
@@ -464,6 +486,23 @@ void SpreadsheetView::handleAspectAboutToBeRemoved(const AbstractAspect* aspect)
 	disconnect(col, 0, this, 0);
 }
 
+void SpreadsheetView::updateViewport() {
+	const QWidget* viewport = m_tableView->viewport();
+	int firstRow = m_tableView->rowAt(0);
+	int lastRow = m_tableView->rowAt(viewport->height() - 1);
+	int firstColumn = m_tableView->columnAt(0);
+	int lastColumn = m_tableView->columnAt(viewport->width() - 1);
+
+	if (firstRow == -1 || firstColumn == -1)
+		return;
+	if (lastRow == -1)
+		lastRow = m_model->rowCount() - 1;
+	if (lastColumn == -1)
+		lastColumn = m_model->columnCount() - 1;
+
+	m_model->setViewport(firstRow, lastRow, firstColumn, lastColumn);
+}
+
 void SpreadsheetView::handleHorizontalSectionResized(int logicalIndex, int oldSize, int newSize) {
 	Q_UNUSED(logicalIndex);
 	Q_UNUSED(oldSize);
@@ -771,6 +810,7 @@ bool SpreadsheetView::eventFilter(QObject* watched, QEvent* event) {
 			action_fill_random_nonuniform->setEnabled(numeric);
 			action_fill_function->setEnabled(numeric);
 			action_statistics_columns->setVisible(numeric);
+			action_spectrogram->setVisible(numeric && selectedColumns().size() == 1);
 
 			m_columnMenu->exec(global_pos);
 		} else if (watched == this)
@@ -1336,7 +1376,40 @@ void SpreadsheetView::dropColumnValues() {
 
 void SpreadsheetView::maskColumnValues() {
 	if (selectedColumnCount() < 1) return;
-	DropValuesDialog* dlg = new DropValuesDialog(m_spreadsheet, true);
+	DropValuesDialog* dlg = new DropValuesDialog(m_spreadsheet, DropValuesDialog::Mask);
+	dlg->setAttribute(Qt::WA_DeleteOnClose);
+	dlg->setColumns(selectedColumns());
+	dlg->exec();
+}
+
+/*!
+  creates a filter view on the rows where the values of the selected columns are in the specified region.
+*/
+void SpreadsheetView::filterRows() {
+	if (selectedColumnCount() < 1) return;
+	DropValuesDialog* dlg = new DropValuesDialog(m_spreadsheet, DropValuesDialog::Filter);
+	dlg->setAttribute(Qt::WA_DeleteOnClose);
+	dlg->setColumns(selectedColumns());
+	dlg->exec();
+}
+
+/*!
+  joins the spreadsheet with another spreadsheet using the selected columns as key columns.
+*/
+void SpreadsheetView::joinSpreadsheet() {
+	if (selectedColumnCount() < 1) return;
+	JoinDialog* dlg = new JoinDialog(m_spreadsheet);
+	dlg->setAttribute(Qt::WA_DeleteOnClose);
+	dlg->setColumns(selectedColumns());
+	dlg->exec();
+}
+
+/*!
+  groups the rows by the values of the selected columns and aggregates the other numeric columns.
+*/
+void SpreadsheetView::groupRows() {
+	if (selectedColumnCount() < 1) return;
+	GroupByDialog* dlg = new GroupByDialog(m_spreadsheet);
 	dlg->setAttribute(Qt::WA_DeleteOnClose);
 	dlg->setColumns(selectedColumns());
 	dlg->exec();
@@ -1421,6 +1494,14 @@ void SpreadsheetView::showColumnStatistics(bool forAll) {
 	}
 }
 
+void SpreadsheetView::showSpectrogramDialog() {
+	if (selectedColumnCount() != 1) return;
+	SpectrogramDialog* dlg = new SpectrogramDialog(m_spreadsheet);
+	dlg->setAttribute(Qt::WA_DeleteOnClose);
+	dlg->setColumn(selectedColumns().first());
+	dlg->exec();
+}
+
 void SpreadsheetView::showRowStatistics() {
 	QString dlgTitle(m_spreadsheet->name() + " row statistics");
 	StatisticsDialog* dlg = new StatisticsDialog(dlgTitle);
@@ -1565,6 +1646,8 @@ void SpreadsheetView::sortDialog(QList<Column*> cols) {
 	SortDialog* dlg = new SortDialog();
 	dlg->setAttribute(Qt::WA_DeleteOnClose);
 	connect(dlg, SIGNAL(sort(Column*,QList<Column*>,bool)), m_spreadsheet, SLOT(sortColumns(Column*,QList<Column*>,bool)));
+	connect(dlg, SIGNAL(sort(QList<Column*>,QList<bool>,QList<Column*>)),
+	        m_spreadsheet, SLOT(sortColumns(QList<Column*>,QList<bool>,QList<Column*>)));
 	dlg->setColumnsList(cols);
 	int rc = dlg->exec();
 
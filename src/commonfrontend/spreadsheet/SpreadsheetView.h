@@ -135,6 +135,9 @@ class SpreadsheetView : public QWidget {
 		QAction* action_reverse_columns;
 		QAction* action_drop_values;
 		QAction* action_mask_values;
+		QAction* action_filter_rows;
+		QAction* action_join_spreadsheet;
+		QAction* action_group_by;
 		QAction* action_join_columns;
 		QAction* action_normalize_columns;
 		QAction* action_normalize_selection;
@@ -142,6 +145,7 @@ class SpreadsheetView : public QWidget {
 		QAction* action_sort_asc_column;
 		QAction* action_sort_desc_column;
 		QAction* action_statistics_columns;
+		QAction* action_spectrogram;
 
 		//row related actions
 		QAction* action_insert_rows;
@@ -200,6 +204,9 @@ class SpreadsheetView : public QWidget {
 		void reverseColumns();
 		void dropColumnValues();
 		void maskColumnValues();
+		void filterRows();
+		void joinSpreadsheet();
+		void groupRows();
 		void joinColumns();
 		void normalizeSelectedColumns();
 		void normalizeSelection();
@@ -218,6 +225,7 @@ class SpreadsheetView : public QWidget {
 		void showColumnStatistics(bool forAll = false);
 		void showAllColumnsStatistics();
 		void showRowStatistics();
+		void showSpectrogramDialog();
 
 		bool formulaModeActive() const;
 
@@ -230,6 +238,7 @@ class SpreadsheetView : public QWidget {
 		void handleAspectAdded(const AbstractAspect* aspect);
 		void handleAspectAboutToBeRemoved(const AbstractAspect* aspect);
 		void updateHeaderGeometry(Qt::Orientation o, int first, int last);
+		void updateViewport();
 
 		void selectColumn(int);
 		void deselectColumn(int);
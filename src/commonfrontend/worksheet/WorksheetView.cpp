@@ -292,6 +292,8 @@ void WorksheetView::initActions() {
 	addSmoothCurveAction = new KAction(i18n("xy-curve from a smooth"), cartesianPlotAddNewActionGroup);
 	addFourierFilterCurveAction = new KAction(i18n("xy-curve from a Fourier filter"), cartesianPlotAddNewActionGroup);
 	addFourierTransformCurveAction = new KAction(i18n("xy-curve from a Fourier transform"), cartesianPlotAddNewActionGroup);
+	addConvolutionCurveAction = new KAction(i18n("xy-curve from a convolution"), cartesianPlotAddNewActionGroup);
+	addCorrelationCurveAction = new KAction(i18n("xy-curve from a correlation"), cartesianPlotAddNewActionGroup);
 //	addInterpolationCurveAction = new KAction(KIcon("labplot-xy-interpolation-curve"), i18n("xy-curve from an interpolation"), cartesianPlotAddNewActionGroup);
 //	addSmoothCurveAction = new KAction(KIcon("labplot-xy-smooth-curve"), i18n("xy-curve from a smooth"), cartesianPlotAddNewActionGroup);
 	addFitCurveAction = new KAction(KIcon("labplot-xy-fit-curve"), i18n("xy-curve from a fit to data"), cartesianPlotAddNewActionGroup);
@@ -313,6 +315,8 @@ void WorksheetView::initActions() {
 	addFitAction = new KAction(KIcon("labplot-xy-fit-curve"), i18n("Data fitting"), cartesianPlotAddNewActionGroup);
 	addFourierFilterAction = new KAction(i18n("Fourier filter"), cartesianPlotAddNewActionGroup);
 	addFourierTransformAction = new KAction(i18n("Fourier transform"), cartesianPlotAddNewActionGroup);
+	addConvolutionAction = new KAction(i18n("Convolution/Deconvolution"), cartesianPlotAddNewActionGroup);
+	addCorrelationAction = new KAction(i18n("Correlation"), cartesianPlotAddNewActionGroup);
 //	addInterpolationAction = new KAction(KIcon("labplot-xy-interpolation-curve"), i18n("Interpolation"), cartesianPlotAddNewActionGroup);
 //	addSmoothAction = new KAction(KIcon("labplot-xy-smooth-curve"), i18n("Smooth"), cartesianPlotAddNewActionGroup);
 //	addFourierFilterAction = new KAction(KIcon("labplot-xy-fourier_filter-curve"), i18n("Fourier filter"), cartesianPlotAddNewActionGroup);
@@ -431,6 +435,8 @@ void WorksheetView::initMenus() {
 	m_cartesianPlotAddNewMenu->addAction(addFitCurveAction);
 	m_cartesianPlotAddNewMenu->addAction(addFourierFilterCurveAction);
 	m_cartesianPlotAddNewMenu->addAction(addFourierTransformCurveAction);
+	m_cartesianPlotAddNewMenu->addAction(addConvolutionCurveAction);
+	m_cartesianPlotAddNewMenu->addAction(addCorrelationCurveAction);
 	m_cartesianPlotAddNewMenu->addAction(addLegendAction);
 	m_cartesianPlotAddNewMenu->addSeparator();
 	m_cartesianPlotAddNewMenu->addAction(addHorizontalAxisAction);
@@ -520,6 +526,8 @@ void WorksheetView::createAnalysisMenu(QMenu* menu) const {
 	menu->addAction(addFitAction);
 	menu->addAction(addFourierFilterAction);
 	menu->addAction(addFourierTransformAction);
+	menu->addAction(addConvolutionAction);
+	menu->addAction(addCorrelationAction);
 }
 
 void WorksheetView::fillToolBar(QToolBar* toolBar) {
@@ -1362,6 +1370,8 @@ void WorksheetView::handleCartesianPlotActions() {
 	addFitCurveAction->setEnabled(plot);
 	addFourierFilterCurveAction->setEnabled(plot);
 	addFourierTransformCurveAction->setEnabled(plot);
+	addConvolutionCurveAction->setEnabled(plot);
+	addCorrelationCurveAction->setEnabled(plot);
 	addHorizontalAxisAction->setEnabled(plot);
 	addVerticalAxisAction->setEnabled(plot);
 	addLegendAction->setEnabled(plot);
@@ -1391,6 +1401,8 @@ void WorksheetView::handleCartesianPlotActions() {
 	addFitAction->setEnabled(plot);
 	addFourierFilterAction->setEnabled(plot);
 	addFourierTransformAction->setEnabled(plot);
+	addConvolutionAction->setEnabled(plot);
+	addCorrelationAction->setEnabled(plot);
 }
 
 void WorksheetView::exportToFile(const QString& path, const ExportFormat format, const ExportArea area, const bool background, const int resolution) {
@@ -1646,6 +1658,10 @@ void WorksheetView::cartesianPlotAdd(CartesianPlot* plot, QAction* action) {
 		plot->addFourierFilterCurve();
 	else if (action == addFourierTransformCurveAction)
 		plot->addFourierTransformCurve();
+	else if (action == addConvolutionCurveAction)
+		plot->addConvolutionCurve();
+	else if (action == addCorrelationCurveAction)
+		plot->addCorrelationCurve();
 	else if (action == addSmoothCurveAction)
 		plot->addSmoothCurve();
 	else if (action == addLegendAction)
@@ -1671,6 +1687,10 @@ void WorksheetView::cartesianPlotAdd(CartesianPlot* plot, QAction* action) {
 		plot->addFourierFilterCurve();
 	else if (action == addFourierTransformAction)
 		plot->addFourierTransformCurve();
+	else if (action == addConvolutionAction)
+		plot->addConvolutionCurve();
+	else if (action == addCorrelationAction)
+		plot->addCorrelationCurve();
 	else if (action == addSmoothAction)
 		plot->addSmoothCurve();
 }
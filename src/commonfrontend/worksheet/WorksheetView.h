@@ -187,6 +187,8 @@ private:
 	QAction* addFitCurveAction;
 	QAction* addFourierFilterCurveAction;
 	QAction* addFourierTransformCurveAction;
+	QAction* addConvolutionCurveAction;
+	QAction* addCorrelationCurveAction;
 	QAction* addHorizontalAxisAction;
 	QAction* addVerticalAxisAction;
 	QAction* addLegendAction;
@@ -216,6 +218,8 @@ private:
 	QAction* addFitAction;
 	QAction* addFourierFilterAction;
 	QAction* addFourierTransformAction;
+	QAction* addConvolutionAction;
+	QAction* addCorrelationAction;
 
 public slots:
 	void createContextMenu(QMenu*) const;
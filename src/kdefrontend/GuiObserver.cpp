@@ -63,6 +63,8 @@
 #include "kdefrontend/dockwidgets/XYFourierFilterCurveDock.h"
 #include "kdefrontend/dockwidgets/XYFourierTransformCurveDock.h"
 #include "kdefrontend/dockwidgets/XYSmoothCurveDock.h"
+#include "kdefrontend/dockwidgets/XYConvolutionCurveDock.h"
+#include "kdefrontend/dockwidgets/XYCorrelationCurveDock.h"
 #include "kdefrontend/dockwidgets/CustomPointDock.h"
 #include "kdefrontend/dockwidgets/WorksheetDock.h"
 #include "kdefrontend/widgets/LabelWidget.h"
@@ -392,6 +394,38 @@ void GuiObserver::selectedAspectsChanged(QList<AbstractAspect*>& selectedAspects
 		mainWindow->xySmoothCurveDock->setCurves(list);
 
 		mainWindow->stackedWidget->setCurrentWidget(mainWindow->xySmoothCurveDock);
+	} else if (className == "XYConvolutionCurve") {
+		mainWindow->m_propertiesDock->setWindowTitle(i18n("Convolution"));
+
+		if (!mainWindow->xyConvolutionCurveDock) {
+			mainWindow->xyConvolutionCurveDock = new XYConvolutionCurveDock(mainWindow->stackedWidget);
+			mainWindow->xyConvolutionCurveDock->setupGeneral();
+			connect(mainWindow->xyConvolutionCurveDock, SIGNAL(info(QString)), mainWindow->statusBar(), SLOT(showMessage(QString)));
+			mainWindow->stackedWidget->addWidget(mainWindow->xyConvolutionCurveDock);
+		}
+
+		QList<XYCurve*> list;
+		foreach (aspect, selectedAspects)
+			list << qobject_cast<XYCurve*>(aspect);
+		mainWindow->xyConvolutionCurveDock->setCurves(list);
+
+		mainWindow->stackedWidget->setCurrentWidget(mainWindow->xyConvolutionCurveDock);
+	} else if (className == "XYCorrelationCurve") {
+		mainWindow->m_propertiesDock->setWindowTitle(i18n("Correlation"));
+
+		if (!mainWindow->xyCorrelationCurveDock) {
+			mainWindow->xyCorrelationCurveDock = new XYCorrelationCurveDock(mainWindow->stackedWidget);
+			mainWindow->xyCorrelationCurveDock->setupGeneral();
+			connect(mainWindow->xyCorrelationCurveDock, SIGNAL(info(QString)), mainWindow->statusBar(), SLOT(showMessage(QString)));
+			mainWindow->stackedWidget->addWidget(mainWindow->xyCorrelationCurveDock);
+		}
+
+		QList<XYCurve*> list;
+		foreach (aspect, selectedAspects)
+			list << qobject_cast<XYCurve*>(aspect);
+		mainWindow->xyCorrelationCurveDock->setCurves(list);
+
+		mainWindow->stackedWidget->setCurrentWidget(mainWindow->xyCorrelationCurveDock);
 	} else if (className == "TextLabel") {
 		mainWindow->m_propertiesDock->setWindowTitle(i18n("Text Label"));
 
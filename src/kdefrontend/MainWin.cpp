@@ -62,6 +62,7 @@
 #include <QUndoStack>
 #include <QCloseEvent>
 #include <QElapsedTimer>
+#include <QThread>
 #include <QDebug>
 
 #include <KApplication>
@@ -74,6 +75,13 @@
 #include <KStatusBar>
 #include <KLocale>
 #include <KFilterDev>
+#include <KStandardDirs>
+
+extern "C" {
+#include "backend/nsl/nsl_dft.h"
+#include "backend/nsl/nsl_smooth.h"
+#include "backend/nsl/nsl_sf_window.h"
+}
 
 /*!
 \class MainWin
@@ -116,6 +124,8 @@ MainWin::MainWin(QWidget *parent, const QString& filename)
 	  xyFitCurveDock(0),
 	  xyFourierFilterCurveDock(0),
 	  xyFourierTransformCurveDock(0),
+	  xyConvolutionCurveDock(0),
+	  xyCorrelationCurveDock(0),
 	  worksheetDock(0),
 	  textLabelDock(0),
 	  customPointDock(0),
@@ -134,6 +144,10 @@ MainWin::~MainWin() {
 
 	KGlobal::config()->sync();
 
+	//save the measured FFT plans for the next session
+	if (KGlobal::config()->group(QLatin1String("Settings_General")).readEntry<bool>("MeasureFFT", 0))
+		nsl_dft_wisdom_export(QFile::encodeName(KGlobal::dirs()->locateLocal("appdata", "fftw_wisdom")).constData());
+
 	if (m_project != 0) {
 		m_mdiArea->closeAllSubWindows();
 		disconnect(m_project, 0, this, 0);
@@ -145,6 +159,11 @@ MainWin::~MainWin() {
 
 	if (m_guiObserver)
 		delete m_guiObserver;
+
+	//free the cached smoothing coefficients, FFT plans and window coefficients
+	nsl_smooth_cache_clear();
+	nsl_dft_cache_clear();
+	nsl_sf_window_cache_clear();
 }
 
 AspectTreeModel* MainWin::model() const {
@@ -193,6 +212,15 @@ void MainWin::initGUI(const QString& fileName) {
 	m_autoSaveTimer.setInterval(interval);
 	connect(&m_autoSaveTimer, SIGNAL(timeout()), this, SLOT(autoSaveProject()));
 
+	//use all cores for large FFTs
+	nsl_dft_set_threads(QThread::idealThreadCount());
+
+	//FFT planning, reuse the plans measured in previous sessions
+	if (group.readEntry<bool>("MeasureFFT", 0)) {
+		nsl_dft_set_planning(nsl_dft_planning_measure);
+		nsl_dft_wisdom_import(QFile::encodeName(KGlobal::dirs()->locateLocal("appdata", "fftw_wisdom")).constData());
+	}
+
 	if (!fileName.isEmpty())
 		openProject(fileName);
 	else {
@@ -1475,6 +1503,10 @@ void MainWin::handleSettingsChanges() {
 	interval *= 60*1000;
 	if (interval != m_autoSaveTimer.interval())
 		m_autoSaveTimer.setInterval(interval);
+
+	//FFT planning
+	bool measureFFT = group.readEntry("MeasureFFT", 0);
+	nsl_dft_set_planning(measureFFT ? nsl_dft_planning_measure : nsl_dft_planning_estimate);
 }
 
 /***************************************************************************************/
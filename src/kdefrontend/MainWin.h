@@ -64,6 +64,8 @@ class XYSmoothCurveDock;
 class XYFitCurveDock;
 class XYFourierFilterCurveDock;
 class XYFourierTransformCurveDock;
+class XYConvolutionCurveDock;
+class XYCorrelationCurveDock;
 class WorksheetDock;
 class LabelWidget;
 class ImportFileDialog;
@@ -180,6 +182,8 @@ private:
 	XYFitCurveDock* xyFitCurveDock;
 	XYFourierFilterCurveDock* xyFourierFilterCurveDock;
 	XYFourierTransformCurveDock* xyFourierTransformCurveDock;
+	XYConvolutionCurveDock* xyConvolutionCurveDock;
+	XYCorrelationCurveDock* xyCorrelationCurveDock;
 	WorksheetDock* worksheetDock;
 	LabelWidget* textLabelDock;
 	CustomPointDock* customPointDock;
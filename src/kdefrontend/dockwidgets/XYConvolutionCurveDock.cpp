@@ -0,0 +1,406 @@
+/***************************************************************************
+    File                 : XYConvolutionCurveDock.cpp
+    Project              : LabPlot
+    Description          : widget for editing properties of convolution curves
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "XYConvolutionCurveDock.h"
+#include "backend/core/AspectTreeModel.h"
+#include "backend/core/Project.h"
+#include "backend/worksheet/plots/cartesian/XYConvolutionCurve.h"
+#include "commonfrontend/widgets/TreeViewComboBox.h"
+
+/*!
+  \class XYConvolutionCurveDock
+ \brief  Provides a widget for editing the properties of the XYConvolutionCurves
+		(2D-curves defined by a convolution) currently selected in
+		the project explorer.
+
+  If more then one curves are set, the properties of the first column are shown.
+  The changes of the properties are applied to all curves.
+  The exclusions are the name, the comment and the datasets (columns) of
+  the curves  - these properties can only be changed if there is only one single curve.
+
+  \ingroup kdefrontend
+*/
+
+XYConvolutionCurveDock::XYConvolutionCurveDock(QWidget *parent):
+	XYCurveDock(parent), cbXDataColumn(0), cbYDataColumn(0), cbY2DataColumn(0), m_convolutionCurve(0) {
+
+	//remove the tab "Error bars"
+	ui.tabWidget->removeTab(5);
+}
+
+/*!
+ * 	// Tab "General"
+ */
+void XYConvolutionCurveDock::setupGeneral() {
+	QWidget* generalTab = new QWidget(ui.tabGeneral);
+	uiGeneralTab.setupUi(generalTab);
+
+	QGridLayout* gridLayout = dynamic_cast<QGridLayout*>(generalTab->layout());
+	if (gridLayout) {
+		gridLayout->setContentsMargins(2,2,2,2);
+		gridLayout->setHorizontalSpacing(2);
+		gridLayout->setVerticalSpacing(2);
+	}
+
+	cbXDataColumn = new TreeViewComboBox(generalTab);
+	gridLayout->addWidget(cbXDataColumn, 4, 2, 1, 2);
+	cbYDataColumn = new TreeViewComboBox(generalTab);
+	gridLayout->addWidget(cbYDataColumn, 5, 2, 1, 2);
+	cbY2DataColumn = new TreeViewComboBox(generalTab);
+	gridLayout->addWidget(cbY2DataColumn, 6, 2, 1, 2);
+
+	for (int i=0; i < NSL_CONV_TYPE_COUNT; i++)
+		uiGeneralTab.cbType->addItem(i18n(nsl_conv_type_name[i]));
+	for (int i=0; i < NSL_CONV_METHOD_COUNT; i++)
+		uiGeneralTab.cbMethod->addItem(i18n(nsl_conv_method_name[i]));
+
+	uiGeneralTab.pbRecalculate->setIcon(KIcon("run-build"));
+
+	QHBoxLayout* layout = new QHBoxLayout(ui.tabGeneral);
+	layout->setMargin(0);
+	layout->addWidget(generalTab);
+
+	//Slots
+	connect( uiGeneralTab.leName, SIGNAL(returnPressed()), this, SLOT(nameChanged()) );
+	connect( uiGeneralTab.leComment, SIGNAL(returnPressed()), this, SLOT(commentChanged()) );
+	connect( uiGeneralTab.chkVisible, SIGNAL(clicked(bool)), this, SLOT(visibilityChanged(bool)) );
+	connect( uiGeneralTab.cbAutoRange, SIGNAL(clicked(bool)), this, SLOT(autoRangeChanged()) );
+	connect( uiGeneralTab.sbMin, SIGNAL(valueChanged(double)), this, SLOT(xRangeMinChanged()) );
+	connect( uiGeneralTab.sbMax, SIGNAL(valueChanged(double)), this, SLOT(xRangeMaxChanged()) );
+
+	connect( uiGeneralTab.cbType, SIGNAL(currentIndexChanged(int)), this, SLOT(typeChanged()) );
+	connect( uiGeneralTab.cbMethod, SIGNAL(currentIndexChanged(int)), this, SLOT(methodChanged()) );
+
+	connect( uiGeneralTab.pbRecalculate, SIGNAL(clicked()), this, SLOT(recalculateClicked()) );
+}
+
+void XYConvolutionCurveDock::initGeneralTab() {
+	//if there are more then one curve in the list, disable the tab "general"
+	if (m_curvesList.size()==1){
+		uiGeneralTab.lName->setEnabled(true);
+		uiGeneralTab.leName->setEnabled(true);
+		uiGeneralTab.lComment->setEnabled(true);
+		uiGeneralTab.leComment->setEnabled(true);
+
+		uiGeneralTab.leName->setText(m_curve->name());
+		uiGeneralTab.leComment->setText(m_curve->comment());
+	}else {
+		uiGeneralTab.lName->setEnabled(false);
+		uiGeneralTab.leName->setEnabled(false);
+		uiGeneralTab.lComment->setEnabled(false);
+		uiGeneralTab.leComment->setEnabled(false);
+
+		uiGeneralTab.leName->setText("");
+		uiGeneralTab.leComment->setText("");
+	}
+
+	//show the properties of the first curve
+	m_convolutionCurve = dynamic_cast<XYConvolutionCurve*>(m_curve);
+	Q_ASSERT(m_convolutionCurve);
+	XYCurveDock::setModelIndexFromColumn(cbXDataColumn, m_convolutionCurve->xDataColumn());
+	XYCurveDock::setModelIndexFromColumn(cbYDataColumn, m_convolutionCurve->yDataColumn());
+	XYCurveDock::setModelIndexFromColumn(cbY2DataColumn, m_convolutionCurve->y2DataColumn());
+	uiGeneralTab.cbAutoRange->setChecked(m_convolutionData.autoRange);
+	uiGeneralTab.sbMin->setValue(m_convolutionData.xRange.first());
+	uiGeneralTab.sbMax->setValue(m_convolutionData.xRange.last());
+	this->autoRangeChanged();
+
+	uiGeneralTab.cbType->setCurrentIndex(m_convolutionData.type);
+	uiGeneralTab.cbMethod->setCurrentIndex(m_convolutionData.method);
+	this->showConvolutionResult();
+
+	//enable the "recalculate"-button if the source data was changed since the last convolution
+	uiGeneralTab.pbRecalculate->setEnabled(m_convolutionCurve->isSourceDataChangedSinceLastConvolution());
+
+	uiGeneralTab.chkVisible->setChecked( m_curve->isVisible() );
+
+	//Slots
+	connect(m_convolutionCurve, SIGNAL(aspectDescriptionChanged(const AbstractAspect*)), this, SLOT(curveDescriptionChanged(const AbstractAspect*)));
+	connect(m_convolutionCurve, SIGNAL(xDataColumnChanged(const AbstractColumn*)), this, SLOT(curveXDataColumnChanged(const AbstractColumn*)));
+	connect(m_convolutionCurve, SIGNAL(yDataColumnChanged(const AbstractColumn*)), this, SLOT(curveYDataColumnChanged(const AbstractColumn*)));
+	connect(m_convolutionCurve, SIGNAL(y2DataColumnChanged(const AbstractColumn*)), this, SLOT(curveY2DataColumnChanged(const AbstractColumn*)));
+	connect(m_convolutionCurve, SIGNAL(convolutionDataChanged(XYConvolutionCurve::ConvolutionData)), this, SLOT(curveConvolutionDataChanged(XYConvolutionCurve::ConvolutionData)));
+	connect(m_convolutionCurve, SIGNAL(sourceDataChangedSinceLastConvolution()), this, SLOT(enableRecalculate()));
+}
+
+void XYConvolutionCurveDock::setModel() {
+	QList<const char*>  list;
+	list<<"Folder"<<"Workbook"<<"Datapicker"<<"DatapickerCurve"<<"Spreadsheet"
+		<<"FileDataSource"<<"SpreadsheetFilterView"<<"Column"<<"FilteredColumn"<<"Worksheet"<<"CartesianPlot"<<"XYFitCurve";
+	cbXDataColumn->setTopLevelClasses(list);
+	cbYDataColumn->setTopLevelClasses(list);
+	cbY2DataColumn->setTopLevelClasses(list);
+
+ 	list.clear();
+	list<<"Column"<<"FilteredColumn";
+	cbXDataColumn->setSelectableClasses(list);
+	cbYDataColumn->setSelectableClasses(list);
+	cbY2DataColumn->setSelectableClasses(list);
+
+	cbXDataColumn->setModel(m_aspectTreeModel);
+	cbYDataColumn->setModel(m_aspectTreeModel);
+	cbY2DataColumn->setModel(m_aspectTreeModel);
+
+	connect( cbXDataColumn, SIGNAL(currentModelIndexChanged(QModelIndex)), this, SLOT(xDataColumnChanged(QModelIndex)) );
+	connect( cbYDataColumn, SIGNAL(currentModelIndexChanged(QModelIndex)), this, SLOT(yDataColumnChanged(QModelIndex)) );
+	connect( cbY2DataColumn, SIGNAL(currentModelIndexChanged(QModelIndex)), this, SLOT(y2DataColumnChanged(QModelIndex)) );
+	XYCurveDock::setModel();
+}
+
+/*!
+  sets the curves. The properties of the curves in the list \c list can be edited in this widget.
+*/
+void XYConvolutionCurveDock::setCurves(QList<XYCurve*> list) {
+	m_initializing=true;
+	m_curvesList=list;
+	m_curve=list.first();
+	m_convolutionCurve = dynamic_cast<XYConvolutionCurve*>(m_curve);
+	Q_ASSERT(m_convolutionCurve);
+	m_aspectTreeModel = new AspectTreeModel(m_curve->project());
+	this->setModel();
+	m_convolutionData = m_convolutionCurve->convolutionData();
+	initGeneralTab();
+	initTabs();
+	m_initializing=false;
+}
+
+//*************************************************************
+//**** SLOTs for changes triggered in XYConvolutionCurveDock *****
+//*************************************************************
+void XYConvolutionCurveDock::nameChanged(){
+	if (m_initializing)
+		return;
+
+	m_curve->setName(uiGeneralTab.leName->text());
+}
+
+void XYConvolutionCurveDock::commentChanged(){
+	if (m_initializing)
+		return;
+
+	m_curve->setComment(uiGeneralTab.leComment->text());
+}
+
+void XYConvolutionCurveDock::xDataColumnChanged(const QModelIndex& index) {
+	if (m_initializing)
+		return;
+
+	AbstractAspect* aspect = static_cast<AbstractAspect*>(index.internalPointer());
+	AbstractColumn* column = 0;
+	if (aspect) {
+		column = dynamic_cast<AbstractColumn*>(aspect);
+		Q_ASSERT(column);
+	}
+
+	foreach(XYCurve* curve, m_curvesList)
+		dynamic_cast<XYConvolutionCurve*>(curve)->setXDataColumn(column);
+
+	if (column != 0) {
+		if (uiGeneralTab.cbAutoRange->isChecked()) {
+			uiGeneralTab.sbMin->setValue(column->minimum());
+			uiGeneralTab.sbMax->setValue(column->maximum());
+		}
+	}
+}
+
+void XYConvolutionCurveDock::yDataColumnChanged(const QModelIndex& index) {
+	if (m_initializing)
+		return;
+
+	AbstractAspect* aspect = static_cast<AbstractAspect*>(index.internalPointer());
+	AbstractColumn* column = 0;
+	if (aspect) {
+		column = dynamic_cast<AbstractColumn*>(aspect);
+		Q_ASSERT(column);
+	}
+
+	foreach(XYCurve* curve, m_curvesList)
+		dynamic_cast<XYConvolutionCurve*>(curve)->setYDataColumn(column);
+}
+
+void XYConvolutionCurveDock::y2DataColumnChanged(const QModelIndex& index) {
+	if (m_initializing)
+		return;
+
+	AbstractAspect* aspect = static_cast<AbstractAspect*>(index.internalPointer());
+	AbstractColumn* column = 0;
+	if (aspect) {
+		column = dynamic_cast<AbstractColumn*>(aspect);
+		Q_ASSERT(column);
+	}
+
+	foreach(XYCurve* curve, m_curvesList)
+		dynamic_cast<XYConvolutionCurve*>(curve)->setY2DataColumn(column);
+}
+
+void XYConvolutionCurveDock::autoRangeChanged() {
+	bool autoRange = uiGeneralTab.cbAutoRange->isChecked();
+	m_convolutionData.autoRange = autoRange;
+
+	if (autoRange) {
+		uiGeneralTab.lMin->setEnabled(false);
+		uiGeneralTab.sbMin->setEnabled(false);
+		uiGeneralTab.lMax->setEnabled(false);
+		uiGeneralTab.sbMax->setEnabled(false);
+		m_convolutionCurve = dynamic_cast<XYConvolutionCurve*>(m_curve);
+		Q_ASSERT(m_convolutionCurve);
+		if (m_convolutionCurve->xDataColumn()) {
+			uiGeneralTab.sbMin->setValue(m_convolutionCurve->xDataColumn()->minimum());
+			uiGeneralTab.sbMax->setValue(m_convolutionCurve->xDataColumn()->maximum());
+		}
+	} else {
+		uiGeneralTab.lMin->setEnabled(true);
+		uiGeneralTab.sbMin->setEnabled(true);
+		uiGeneralTab.lMax->setEnabled(true);
+		uiGeneralTab.sbMax->setEnabled(true);
+	}
+
+}
+void XYConvolutionCurveDock::xRangeMinChanged() {
+	double xMin = uiGeneralTab.sbMin->value();
+
+	m_convolutionData.xRange.first() = xMin;
+	uiGeneralTab.pbRecalculate->setEnabled(true);
+}
+
+void XYConvolutionCurveDock::xRangeMaxChanged() {
+	double xMax = uiGeneralTab.sbMax->value();
+
+	m_convolutionData.xRange.last() = xMax;
+	uiGeneralTab.pbRecalculate->setEnabled(true);
+}
+
+void XYConvolutionCurveDock::typeChanged() {
+	m_convolutionData.type = (nsl_conv_type_type)uiGeneralTab.cbType->currentIndex();
+
+	enableRecalculate();
+}
+
+void XYConvolutionCurveDock::methodChanged() {
+	m_convolutionData.method = (nsl_conv_method_type)uiGeneralTab.cbMethod->currentIndex();
+
+	enableRecalculate();
+}
+
+void XYConvolutionCurveDock::recalculateClicked() {
+	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+	foreach(XYCurve* curve, m_curvesList)
+		dynamic_cast<XYConvolutionCurve*>(curve)->setConvolutionData(m_convolutionData);
+
+	uiGeneralTab.pbRecalculate->setEnabled(false);
+	QApplication::restoreOverrideCursor();
+}
+
+void XYConvolutionCurveDock::enableRecalculate() const {
+	if (m_initializing)
+		return;
+
+	//no convolution possible without the x- and y-data and the response
+	AbstractAspect* aspectX = static_cast<AbstractAspect*>(cbXDataColumn->currentModelIndex().internalPointer());
+	AbstractAspect* aspectY = static_cast<AbstractAspect*>(cbYDataColumn->currentModelIndex().internalPointer());
+	AbstractAspect* aspectY2 = static_cast<AbstractAspect*>(cbY2DataColumn->currentModelIndex().internalPointer());
+	bool data = (aspectX!=0 && aspectY!=0 && aspectY2!=0);
+
+	uiGeneralTab.pbRecalculate->setEnabled(data);
+}
+
+/*!
+ * show the result and details of the convolution
+ */
+void XYConvolutionCurveDock::showConvolutionResult() {
+	const XYConvolutionCurve::ConvolutionResult& convolutionResult = m_convolutionCurve->convolutionResult();
+	if (!convolutionResult.available) {
+		uiGeneralTab.teResult->clear();
+		return;
+	}
+
+	QString str = i18n("status:") + ' ' + convolutionResult.status + "<br>";
+
+	if (!convolutionResult.valid) {
+		uiGeneralTab.teResult->setText(str);
+		return; //result is not valid, there was an error which is shown in the status-string, nothing to show more.
+	}
+
+	if (convolutionResult.elapsedTime>1000)
+		str += i18n("calculation time: %1 s").arg(QString::number(convolutionResult.elapsedTime/1000)) + "<br>";
+	else
+		str += i18n("calculation time: %1 ms").arg(QString::number(convolutionResult.elapsedTime)) + "<br>";
+
+ 	str += "<br><br>";
+
+	uiGeneralTab.teResult->setText(str);
+}
+
+//*************************************************************
+//*********** SLOTs for changes triggered in XYCurve **********
+//*************************************************************
+//General-Tab
+void XYConvolutionCurveDock::curveDescriptionChanged(const AbstractAspect* aspect) {
+	if (m_curve != aspect)
+		return;
+
+	m_initializing = true;
+	if (aspect->name() != uiGeneralTab.leName->text()) {
+		uiGeneralTab.leName->setText(aspect->name());
+	} else if (aspect->comment() != uiGeneralTab.leComment->text()) {
+		uiGeneralTab.leComment->setText(aspect->comment());
+	}
+	m_initializing = false;
+}
+
+void XYConvolutionCurveDock::curveXDataColumnChanged(const AbstractColumn* column) {
+	m_initializing = true;
+	XYCurveDock::setModelIndexFromColumn(cbXDataColumn, column);
+	m_initializing = false;
+}
+
+void XYConvolutionCurveDock::curveYDataColumnChanged(const AbstractColumn* column) {
+	m_initializing = true;
+	XYCurveDock::setModelIndexFromColumn(cbYDataColumn, column);
+	m_initializing = false;
+}
+
+void XYConvolutionCurveDock::curveY2DataColumnChanged(const AbstractColumn* column) {
+	m_initializing = true;
+	XYCurveDock::setModelIndexFromColumn(cbY2DataColumn, column);
+	m_initializing = false;
+}
+
+void XYConvolutionCurveDock::curveConvolutionDataChanged(const XYConvolutionCurve::ConvolutionData& data) {
+	m_initializing = true;
+	m_convolutionData = data;
+	uiGeneralTab.cbType->setCurrentIndex(m_convolutionData.type);
+	uiGeneralTab.cbMethod->setCurrentIndex(m_convolutionData.method);
+
+	this->showConvolutionResult();
+	m_initializing = false;
+}
+
+void XYConvolutionCurveDock::dataChanged() {
+	this->enableRecalculate();
+}
@@ -0,0 +1,422 @@
+/***************************************************************************
+    File                 : XYCorrelationCurveDock.cpp
+    Project              : LabPlot
+    Description          : widget for editing properties of correlation curves
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "XYCorrelationCurveDock.h"
+#include "backend/core/AspectTreeModel.h"
+#include "backend/core/Project.h"
+#include "backend/worksheet/plots/cartesian/XYCorrelationCurve.h"
+#include "commonfrontend/widgets/TreeViewComboBox.h"
+
+/*!
+  \class XYCorrelationCurveDock
+ \brief  Provides a widget for editing the properties of the XYCorrelationCurves
+		(2D-curves defined by a correlation) currently selected in
+		the project explorer.
+
+  If more then one curves are set, the properties of the first column are shown.
+  The changes of the properties are applied to all curves.
+  The exclusions are the name, the comment and the datasets (columns) of
+  the curves  - these properties can only be changed if there is only one single curve.
+
+  \ingroup kdefrontend
+*/
+
+XYCorrelationCurveDock::XYCorrelationCurveDock(QWidget *parent):
+	XYCurveDock(parent), cbXDataColumn(0), cbYDataColumn(0), cbY2DataColumn(0), m_correlationCurve(0) {
+
+	//remove the tab "Error bars"
+	ui.tabWidget->removeTab(5);
+}
+
+/*!
+ * 	// Tab "General"
+ */
+void XYCorrelationCurveDock::setupGeneral() {
+	QWidget* generalTab = new QWidget(ui.tabGeneral);
+	uiGeneralTab.setupUi(generalTab);
+
+	QGridLayout* gridLayout = dynamic_cast<QGridLayout*>(generalTab->layout());
+	if (gridLayout) {
+		gridLayout->setContentsMargins(2,2,2,2);
+		gridLayout->setHorizontalSpacing(2);
+		gridLayout->setVerticalSpacing(2);
+	}
+
+	cbXDataColumn = new TreeViewComboBox(generalTab);
+	gridLayout->addWidget(cbXDataColumn, 4, 2, 1, 2);
+	cbYDataColumn = new TreeViewComboBox(generalTab);
+	gridLayout->addWidget(cbYDataColumn, 5, 2, 1, 2);
+	cbY2DataColumn = new TreeViewComboBox(generalTab);
+	gridLayout->addWidget(cbY2DataColumn, 6, 2, 1, 2);
+
+	for (int i=0; i < NSL_CORR_NORM_COUNT; i++)
+		uiGeneralTab.cbNormalization->addItem(i18n(nsl_corr_norm_name[i]));
+	for (int i=0; i < NSL_CONV_METHOD_COUNT; i++)
+		uiGeneralTab.cbMethod->addItem(i18n(nsl_conv_method_name[i]));
+
+	uiGeneralTab.pbRecalculate->setIcon(KIcon("run-build"));
+
+	QHBoxLayout* layout = new QHBoxLayout(ui.tabGeneral);
+	layout->setMargin(0);
+	layout->addWidget(generalTab);
+
+	//Slots
+	connect( uiGeneralTab.leName, SIGNAL(returnPressed()), this, SLOT(nameChanged()) );
+	connect( uiGeneralTab.leComment, SIGNAL(returnPressed()), this, SLOT(commentChanged()) );
+	connect( uiGeneralTab.chkVisible, SIGNAL(clicked(bool)), this, SLOT(visibilityChanged(bool)) );
+	connect( uiGeneralTab.cbAutoRange, SIGNAL(clicked(bool)), this, SLOT(autoRangeChanged()) );
+	connect( uiGeneralTab.sbMin, SIGNAL(valueChanged(double)), this, SLOT(xRangeMinChanged()) );
+	connect( uiGeneralTab.sbMax, SIGNAL(valueChanged(double)), this, SLOT(xRangeMaxChanged()) );
+
+	connect( uiGeneralTab.chkAutocorrelation, SIGNAL(clicked(bool)), this, SLOT(autocorrelationChanged()) );
+	connect( uiGeneralTab.cbNormalization, SIGNAL(currentIndexChanged(int)), this, SLOT(normalizationChanged()) );
+	connect( uiGeneralTab.cbMethod, SIGNAL(currentIndexChanged(int)), this, SLOT(methodChanged()) );
+
+	connect( uiGeneralTab.pbRecalculate, SIGNAL(clicked()), this, SLOT(recalculateClicked()) );
+}
+
+void XYCorrelationCurveDock::initGeneralTab() {
+	//if there are more then one curve in the list, disable the tab "general"
+	if (m_curvesList.size()==1){
+		uiGeneralTab.lName->setEnabled(true);
+		uiGeneralTab.leName->setEnabled(true);
+		uiGeneralTab.lComment->setEnabled(true);
+		uiGeneralTab.leComment->setEnabled(true);
+
+		uiGeneralTab.leName->setText(m_curve->name());
+		uiGeneralTab.leComment->setText(m_curve->comment());
+	}else {
+		uiGeneralTab.lName->setEnabled(false);
+		uiGeneralTab.leName->setEnabled(false);
+		uiGeneralTab.lComment->setEnabled(false);
+		uiGeneralTab.leComment->setEnabled(false);
+
+		uiGeneralTab.leName->setText("");
+		uiGeneralTab.leComment->setText("");
+	}
+
+	//show the properties of the first curve
+	m_correlationCurve = dynamic_cast<XYCorrelationCurve*>(m_curve);
+	Q_ASSERT(m_correlationCurve);
+	XYCurveDock::setModelIndexFromColumn(cbXDataColumn, m_correlationCurve->xDataColumn());
+	XYCurveDock::setModelIndexFromColumn(cbYDataColumn, m_correlationCurve->yDataColumn());
+	XYCurveDock::setModelIndexFromColumn(cbY2DataColumn, m_correlationCurve->y2DataColumn());
+	uiGeneralTab.cbAutoRange->setChecked(m_correlationData.autoRange);
+	uiGeneralTab.sbMin->setValue(m_correlationData.xRange.first());
+	uiGeneralTab.sbMax->setValue(m_correlationData.xRange.last());
+	this->autoRangeChanged();
+
+	uiGeneralTab.chkAutocorrelation->setChecked(m_correlationData.autocorrelation);
+	this->autocorrelationChanged();
+	uiGeneralTab.cbNormalization->setCurrentIndex(m_correlationData.normalization);
+	uiGeneralTab.cbMethod->setCurrentIndex(m_correlationData.method);
+	this->showCorrelationResult();
+
+	//enable the "recalculate"-button if the source data was changed since the last correlation
+	uiGeneralTab.pbRecalculate->setEnabled(m_correlationCurve->isSourceDataChangedSinceLastCorrelation());
+
+	uiGeneralTab.chkVisible->setChecked( m_curve->isVisible() );
+
+	//Slots
+	connect(m_correlationCurve, SIGNAL(aspectDescriptionChanged(const AbstractAspect*)), this, SLOT(curveDescriptionChanged(const AbstractAspect*)));
+	connect(m_correlationCurve, SIGNAL(xDataColumnChanged(const AbstractColumn*)), this, SLOT(curveXDataColumnChanged(const AbstractColumn*)));
+	connect(m_correlationCurve, SIGNAL(yDataColumnChanged(const AbstractColumn*)), this, SLOT(curveYDataColumnChanged(const AbstractColumn*)));
+	connect(m_correlationCurve, SIGNAL(y2DataColumnChanged(const AbstractColumn*)), this, SLOT(curveY2DataColumnChanged(const AbstractColumn*)));
+	connect(m_correlationCurve, SIGNAL(correlationDataChanged(XYCorrelationCurve::CorrelationData)), this, SLOT(curveCorrelationDataChanged(XYCorrelationCurve::CorrelationData)));
+	connect(m_correlationCurve, SIGNAL(sourceDataChangedSinceLastCorrelation()), this, SLOT(enableRecalculate()));
+}
+
+void XYCorrelationCurveDock::setModel() {
+	QList<const char*>  list;
+	list<<"Folder"<<"Workbook"<<"Datapicker"<<"DatapickerCurve"<<"Spreadsheet"
+		<<"FileDataSource"<<"SpreadsheetFilterView"<<"Column"<<"FilteredColumn"<<"Worksheet"<<"CartesianPlot"<<"XYFitCurve";
+	cbXDataColumn->setTopLevelClasses(list);
+	cbYDataColumn->setTopLevelClasses(list);
+	cbY2DataColumn->setTopLevelClasses(list);
+
+ 	list.clear();
+	list<<"Column"<<"FilteredColumn";
+	cbXDataColumn->setSelectableClasses(list);
+	cbYDataColumn->setSelectableClasses(list);
+	cbY2DataColumn->setSelectableClasses(list);
+
+	cbXDataColumn->setModel(m_aspectTreeModel);
+	cbYDataColumn->setModel(m_aspectTreeModel);
+	cbY2DataColumn->setModel(m_aspectTreeModel);
+
+	connect( cbXDataColumn, SIGNAL(currentModelIndexChanged(QModelIndex)), this, SLOT(xDataColumnChanged(QModelIndex)) );
+	connect( cbYDataColumn, SIGNAL(currentModelIndexChanged(QModelIndex)), this, SLOT(yDataColumnChanged(QModelIndex)) );
+	connect( cbY2DataColumn, SIGNAL(currentModelIndexChanged(QModelIndex)), this, SLOT(y2DataColumnChanged(QModelIndex)) );
+	XYCurveDock::setModel();
+}
+
+/*!
+  sets the curves. The properties of the curves in the list \c list can be edited in this widget.
+*/
+void XYCorrelationCurveDock::setCurves(QList<XYCurve*> list) {
+	m_initializing=true;
+	m_curvesList=list;
+	m_curve=list.first();
+	m_correlationCurve = dynamic_cast<XYCorrelationCurve*>(m_curve);
+	Q_ASSERT(m_correlationCurve);
+	m_aspectTreeModel = new AspectTreeModel(m_curve->project());
+	this->setModel();
+	m_correlationData = m_correlationCurve->correlationData();
+	initGeneralTab();
+	initTabs();
+	m_initializing=false;
+}
+
+//*************************************************************
+//**** SLOTs for changes triggered in XYCorrelationCurveDock *****
+//*************************************************************
+void XYCorrelationCurveDock::nameChanged(){
+	if (m_initializing)
+		return;
+
+	m_curve->setName(uiGeneralTab.leName->text());
+}
+
+void XYCorrelationCurveDock::commentChanged(){
+	if (m_initializing)
+		return;
+
+	m_curve->setComment(uiGeneralTab.leComment->text());
+}
+
+void XYCorrelationCurveDock::xDataColumnChanged(const QModelIndex& index) {
+	if (m_initializing)
+		return;
+
+	AbstractAspect* aspect = static_cast<AbstractAspect*>(index.internalPointer());
+	AbstractColumn* column = 0;
+	if (aspect) {
+		column = dynamic_cast<AbstractColumn*>(aspect);
+		Q_ASSERT(column);
+	}
+
+	foreach(XYCurve* curve, m_curvesList)
+		dynamic_cast<XYCorrelationCurve*>(curve)->setXDataColumn(column);
+
+	if (column != 0) {
+		if (uiGeneralTab.cbAutoRange->isChecked()) {
+			uiGeneralTab.sbMin->setValue(column->minimum());
+			uiGeneralTab.sbMax->setValue(column->maximum());
+		}
+	}
+}
+
+void XYCorrelationCurveDock::yDataColumnChanged(const QModelIndex& index) {
+	if (m_initializing)
+		return;
+
+	AbstractAspect* aspect = static_cast<AbstractAspect*>(index.internalPointer());
+	AbstractColumn* column = 0;
+	if (aspect) {
+		column = dynamic_cast<AbstractColumn*>(aspect);
+		Q_ASSERT(column);
+	}
+
+	foreach(XYCurve* curve, m_curvesList)
+		dynamic_cast<XYCorrelationCurve*>(curve)->setYDataColumn(column);
+}
+
+void XYCorrelationCurveDock::y2DataColumnChanged(const QModelIndex& index) {
+	if (m_initializing)
+		return;
+
+	AbstractAspect* aspect = static_cast<AbstractAspect*>(index.internalPointer());
+	AbstractColumn* column = 0;
+	if (aspect) {
+		column = dynamic_cast<AbstractColumn*>(aspect);
+		Q_ASSERT(column);
+	}
+
+	foreach(XYCurve* curve, m_curvesList)
+		dynamic_cast<XYCorrelationCurve*>(curve)->setY2DataColumn(column);
+}
+
+void XYCorrelationCurveDock::autoRangeChanged() {
+	bool autoRange = uiGeneralTab.cbAutoRange->isChecked();
+	m_correlationData.autoRange = autoRange;
+
+	if (autoRange) {
+		uiGeneralTab.lMin->setEnabled(false);
+		uiGeneralTab.sbMin->setEnabled(false);
+		uiGeneralTab.lMax->setEnabled(false);
+		uiGeneralTab.sbMax->setEnabled(false);
+		m_correlationCurve = dynamic_cast<XYCorrelationCurve*>(m_curve);
+		Q_ASSERT(m_correlationCurve);
+		if (m_correlationCurve->xDataColumn()) {
+			uiGeneralTab.sbMin->setValue(m_correlationCurve->xDataColumn()->minimum());
+			uiGeneralTab.sbMax->setValue(m_correlationCurve->xDataColumn()->maximum());
+		}
+	} else {
+		uiGeneralTab.lMin->setEnabled(true);
+		uiGeneralTab.sbMin->setEnabled(true);
+		uiGeneralTab.lMax->setEnabled(true);
+		uiGeneralTab.sbMax->setEnabled(true);
+	}
+
+}
+void XYCorrelationCurveDock::xRangeMinChanged() {
+	double xMin = uiGeneralTab.sbMin->value();
+
+	m_correlationData.xRange.first() = xMin;
+	uiGeneralTab.pbRecalculate->setEnabled(true);
+}
+
+void XYCorrelationCurveDock::xRangeMaxChanged() {
+	double xMax = uiGeneralTab.sbMax->value();
+
+	m_correlationData.xRange.last() = xMax;
+	uiGeneralTab.pbRecalculate->setEnabled(true);
+}
+
+void XYCorrelationCurveDock::autocorrelationChanged() {
+	const bool autocorrelation = uiGeneralTab.chkAutocorrelation->isChecked();
+	m_correlationData.autocorrelation = autocorrelation;
+
+	//the autocorrelation doesn't need a second data set
+	uiGeneralTab.lY2Column->setVisible(!autocorrelation);
+	cbY2DataColumn->setVisible(!autocorrelation);
+
+	enableRecalculate();
+}
+
+void XYCorrelationCurveDock::normalizationChanged() {
+	m_correlationData.normalization = (nsl_corr_norm_type)uiGeneralTab.cbNormalization->currentIndex();
+
+	enableRecalculate();
+}
+
+void XYCorrelationCurveDock::methodChanged() {
+	m_correlationData.method = (nsl_conv_method_type)uiGeneralTab.cbMethod->currentIndex();
+
+	enableRecalculate();
+}
+
+void XYCorrelationCurveDock::recalculateClicked() {
+	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+	foreach(XYCurve* curve, m_curvesList)
+		dynamic_cast<XYCorrelationCurve*>(curve)->setCorrelationData(m_correlationData);
+
+	uiGeneralTab.pbRecalculate->setEnabled(false);
+	QApplication::restoreOverrideCursor();
+}
+
+void XYCorrelationCurveDock::enableRecalculate() const {
+	if (m_initializing)
+		return;
+
+	//no correlation possible without the x- and y-data (and the second data set for a cross-correlation)
+	AbstractAspect* aspectX = static_cast<AbstractAspect*>(cbXDataColumn->currentModelIndex().internalPointer());
+	AbstractAspect* aspectY = static_cast<AbstractAspect*>(cbYDataColumn->currentModelIndex().internalPointer());
+	AbstractAspect* aspectY2 = static_cast<AbstractAspect*>(cbY2DataColumn->currentModelIndex().internalPointer());
+	bool data = (aspectX!=0 && aspectY!=0 && (aspectY2!=0 || m_correlationData.autocorrelation));
+
+	uiGeneralTab.pbRecalculate->setEnabled(data);
+}
+
+/*!
+ * show the result and details of the correlation
+ */
+void XYCorrelationCurveDock::showCorrelationResult() {
+	const XYCorrelationCurve::CorrelationResult& correlationResult = m_correlationCurve->correlationResult();
+	if (!correlationResult.available) {
+		uiGeneralTab.teResult->clear();
+		return;
+	}
+
+	QString str = i18n("status:") + ' ' + correlationResult.status + "<br>";
+
+	if (!correlationResult.valid) {
+		uiGeneralTab.teResult->setText(str);
+		return; //result is not valid, there was an error which is shown in the status-string, nothing to show more.
+	}
+
+	if (correlationResult.elapsedTime>1000)
+		str += i18n("calculation time: %1 s").arg(QString::number(correlationResult.elapsedTime/1000)) + "<br>";
+	else
+		str += i18n("calculation time: %1 ms").arg(QString::number(correlationResult.elapsedTime)) + "<br>";
+
+ 	str += "<br><br>";
+
+	uiGeneralTab.teResult->setText(str);
+}
+
+//*************************************************************
+//*********** SLOTs for changes triggered in XYCurve **********
+//*************************************************************
+//General-Tab
+void XYCorrelationCurveDock::curveDescriptionChanged(const AbstractAspect* aspect) {
+	if (m_curve != aspect)
+		return;
+
+	m_initializing = true;
+	if (aspect->name() != uiGeneralTab.leName->text()) {
+		uiGeneralTab.leName->setText(aspect->name());
+	} else if (aspect->comment() != uiGeneralTab.leComment->text()) {
+		uiGeneralTab.leComment->setText(aspect->comment());
+	}
+	m_initializing = false;
+}
+
+void XYCorrelationCurveDock::curveXDataColumnChanged(const AbstractColumn* column) {
+	m_initializing = true;
+	XYCurveDock::setModelIndexFromColumn(cbXDataColumn, column);
+	m_initializing = false;
+}
+
+void XYCorrelationCurveDock::curveYDataColumnChanged(const AbstractColumn* column) {
+	m_initializing = true;
+	XYCurveDock::setModelIndexFromColumn(cbYDataColumn, column);
+	m_initializing = false;
+}
+
+void XYCorrelationCurveDock::curveY2DataColumnChanged(const AbstractColumn* column) {
+	m_initializing = true;
+	XYCurveDock::setModelIndexFromColumn(cbY2DataColumn, column);
+	m_initializing = false;
+}
+
+void XYCorrelationCurveDock::curveCorrelationDataChanged(const XYCorrelationCurve::CorrelationData& data) {
+	m_initializing = true;
+	m_correlationData = data;
+	uiGeneralTab.chkAutocorrelation->setChecked(m_correlationData.autocorrelation);
+	this->autocorrelationChanged();
+	uiGeneralTab.cbNormalization->setCurrentIndex(m_correlationData.normalization);
+	uiGeneralTab.cbMethod->setCurrentIndex(m_correlationData.method);
+
+	this->showCorrelationResult();
+	m_initializing = false;
+}
+
+void XYCorrelationCurveDock::dataChanged() {
+	this->enableRecalculate();
+}
@@ -0,0 +1,91 @@
+/***************************************************************************
+    File                 : XYCorrelationCurveDock.h
+    Project              : LabPlot
+    Description          : widget for editing properties of correlation curves
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef XYCORRELATIONCURVEDOCK_H
+#define XYCORRELATIONCURVEDOCK_H
+
+#include "kdefrontend/dockwidgets/XYCurveDock.h"
+#include "backend/worksheet/plots/cartesian/XYCorrelationCurve.h"
+#include "ui_xycorrelationcurvedockgeneraltab.h"
+
+class TreeViewComboBox;
+
+class XYCorrelationCurveDock: public XYCurveDock {
+	Q_OBJECT
+
+public:
+	explicit XYCorrelationCurveDock(QWidget *parent);
+	void setCurves(QList<XYCurve*>);
+	virtual void setupGeneral();
+
+private:
+	virtual void initGeneralTab();
+	void showCorrelationResult();
+
+	Ui::XYCorrelationCurveDockGeneralTab uiGeneralTab;
+	TreeViewComboBox* cbXDataColumn;
+	TreeViewComboBox* cbYDataColumn;
+	TreeViewComboBox* cbY2DataColumn;
+
+	XYCorrelationCurve* m_correlationCurve;
+	XYCorrelationCurve::CorrelationData m_correlationData;
+
+protected:
+	virtual void setModel();
+
+private slots:
+	//SLOTs for changes triggered in XYCorrelationCurveDock
+	//general tab
+	void nameChanged();
+	void commentChanged();
+	void xDataColumnChanged(const QModelIndex&);
+	void yDataColumnChanged(const QModelIndex&);
+	void y2DataColumnChanged(const QModelIndex&);
+	void autoRangeChanged();
+	void xRangeMinChanged();
+	void xRangeMaxChanged();
+	void autocorrelationChanged();
+	void normalizationChanged();
+	void methodChanged();
+
+	void recalculateClicked();
+
+	void enableRecalculate() const;
+
+	//SLOTs for changes triggered in XYCurve
+	//General-Tab
+	void curveDescriptionChanged(const AbstractAspect*);
+	void curveXDataColumnChanged(const AbstractColumn*);
+	void curveYDataColumnChanged(const AbstractColumn*);
+	void curveY2DataColumnChanged(const AbstractColumn*);
+	void curveCorrelationDataChanged(const XYCorrelationCurve::CorrelationData&);
+	void dataChanged();
+
+};
+
+#endif
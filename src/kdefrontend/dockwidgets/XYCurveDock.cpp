@@ -487,7 +487,7 @@ void XYCurveDock::init() {
 void XYCurveDock::setModel() {
 	QList<const char*>  list;
 	list<<"Folder"<<"Workbook"<<"Datapicker"<<"DatapickerCurve"<<"Spreadsheet"
-	    <<"FileDataSource"<<"Column"<<"Worksheet"<<"CartesianPlot"<<"XYFitCurve";
+	    <<"FileDataSource"<<"SpreadsheetFilterView"<<"Column"<<"FilteredColumn"<<"Worksheet"<<"CartesianPlot"<<"XYFitCurve";
 
 	if (cbXColumn) {
 		cbXColumn->setTopLevelClasses(list);
@@ -500,7 +500,7 @@ void XYCurveDock::setModel() {
 	cbYErrorPlusColumn->setTopLevelClasses(list);
 
 	list.clear();
-	list<<"Column";
+	list<<"Column"<<"FilteredColumn";
 	m_aspectTreeModel->setSelectableAspects(list);
 	if (cbXColumn) {
 		cbXColumn->setSelectableClasses(list);
@@ -163,12 +163,12 @@ void XYDifferentiationCurveDock::initGeneralTab() {
 void XYDifferentiationCurveDock::setModel() {
 	QList<const char*>  list;
 	list<<"Folder"<<"Workbook"<<"Datapicker"<<"DatapickerCurve"<<"Spreadsheet"
-		<<"FileDataSource"<<"Column"<<"Worksheet"<<"CartesianPlot"<<"XYFitCurve";
+		<<"FileDataSource"<<"SpreadsheetFilterView"<<"Column"<<"FilteredColumn"<<"Worksheet"<<"CartesianPlot"<<"XYFitCurve";
 	cbXDataColumn->setTopLevelClasses(list);
 	cbYDataColumn->setTopLevelClasses(list);
 
  	list.clear();
-	list<<"Column";
+	list<<"Column"<<"FilteredColumn";
 	cbXDataColumn->setSelectableClasses(list);
 	cbYDataColumn->setSelectableClasses(list);
 
@@ -190,13 +190,13 @@ void XYFitCurveDock::initGeneralTab() {
 
 void XYFitCurveDock::setModel() {
 	QList<const char*> list;
-	list << "Folder" << "Workbook" << "Spreadsheet" << "FileDataSource" << "Column" << "Datapicker";
+	list << "Folder" << "Workbook" << "Spreadsheet" << "FileDataSource" << "SpreadsheetFilterView" << "Column" << "FilteredColumn" << "Datapicker";
 	cbXDataColumn->setTopLevelClasses(list);
 	cbYDataColumn->setTopLevelClasses(list);
 	cbWeightsColumn->setTopLevelClasses(list);
 
 	list.clear();
-	list << "Column";
+	list << "Column" << "FilteredColumn";
 	cbXDataColumn->setSelectableClasses(list);
 	cbYDataColumn->setSelectableClasses(list);
 	cbWeightsColumn->setSelectableClasses(list);
@@ -994,6 +994,8 @@ void XYFitCurveDock::showFitResult() {
 	}
 
 	str += i18n("iterations:") + ' ' + QString::number(fitResult.iterations) + "<br>";
+	if (fitResult.startPoints > 1)
+		str += i18n("start points at minimum: %1 of %2", fitResult.startPointsAtMinimum, fitResult.startPoints) + "<br>";
 	if (fitResult.elapsedTime > 1000)
 		str += i18n("calculation time: %1 s", fitResult.elapsedTime/1000) + "<br>";
 	else
@@ -1011,6 +1013,15 @@ void XYFitCurveDock::showFitResult() {
 				+ " (" + QString::number(100.*fitResult.errorValues.at(i)/fabs(fitResult.paramValues.at(i))) + " %)";
 	}
 
+	if (fitResult.bootstrapSamples > 0 && fitResult.lowerConfidenceValues.size() == fitResult.paramValues.size()) {
+		str += "<br><br><b>" + i18n("95% confidence intervals (bootstrap, %1 samples):", fitResult.bootstrapSamples) + "</b>";
+		for (int i = 0; i < fitResult.paramValues.size(); i++) {
+			if (!fitData.paramFixed.at(i))
+				str += "<br>" + fitData.paramNamesUtf8.at(i) + QString(": [") + QString::number(fitResult.lowerConfidenceValues.at(i))
+					+ ", " + QString::number(fitResult.upperConfidenceValues.at(i)) + ']';
+		}
+	}
+
 	str += "<br><br><b>" + i18n("Goodness of fit:") + "</b><br>";
 	str += i18n("sum of squared errors") + " (" + QString::fromUtf8("\u03c7") + QString::fromUtf8("\u00b2") + "): " + QString::number(fitResult.sse) + "<br>";
 	str += i18n("mean squared error:") + ' ' + QString::number(fitResult.mse) + "<br>";
@@ -96,6 +96,8 @@ void XYSmoothCurveDock::setupGeneral() {
 	for (int i=0; i < NSL_SMOOTH_PAD_MODE_COUNT; i++)
 		uiGeneralTab.cbMode->addItem(i18n(nsl_smooth_pad_mode_name[i]));
 
+	uiGeneralTab.leDelta->setValidator( new QDoubleValidator(uiGeneralTab.leDelta) );
+
 	uiGeneralTab.pbRecalculate->setIcon(KIcon("run-build"));
 
 	QHBoxLayout* layout = new QHBoxLayout(ui.tabGeneral);
@@ -118,6 +120,8 @@ void XYSmoothCurveDock::setupGeneral() {
 	connect( uiGeneralTab.cbMode, SIGNAL(currentIndexChanged(int)), this, SLOT(modeChanged()) );
 	connect( uiGeneralTab.sbLeftValue, SIGNAL(valueChanged(double)), this, SLOT(valueChanged()) );
 	connect( uiGeneralTab.sbRightValue, SIGNAL(valueChanged(double)), this, SLOT(valueChanged()) );
+	connect( uiGeneralTab.sbIterations, SIGNAL(valueChanged(int)), this, SLOT(iterationsChanged()) );
+	connect( uiGeneralTab.leDelta, SIGNAL(textChanged(QString)), this, SLOT(deltaChanged()) );
 
 	connect( uiGeneralTab.pbRecalculate, SIGNAL(clicked()), this, SLOT(recalculateClicked()) );
 }
@@ -172,6 +176,8 @@ void XYSmoothCurveDock::initGeneralTab() {
 	uiGeneralTab.sbLeftValue->setValue(m_smoothData.lvalue);
 	uiGeneralTab.sbRightValue->setValue(m_smoothData.rvalue);
 	valueChanged();
+	uiGeneralTab.sbIterations->setValue(m_smoothData.iterations);
+	uiGeneralTab.leDelta->setText(QString::number(m_smoothData.delta));
 	this->showSmoothResult();
 
 	//enable the "recalculate"-button if the source data was changed since the last smooth
@@ -190,12 +196,12 @@ void XYSmoothCurveDock::initGeneralTab() {
 void XYSmoothCurveDock::setModel() {
 	QList<const char*>  list;
 	list<<"Folder"<<"Workbook"<<"Datapicker"<<"DatapickerCurve"<<"Spreadsheet"
-		<<"FileDataSource"<<"Column"<<"Worksheet"<<"CartesianPlot"<<"XYFitCurve";
+		<<"FileDataSource"<<"SpreadsheetFilterView"<<"Column"<<"FilteredColumn"<<"Worksheet"<<"CartesianPlot"<<"XYFitCurve";
 	cbXDataColumn->setTopLevelClasses(list);
 	cbYDataColumn->setTopLevelClasses(list);
 
  	list.clear();
-	list<<"Column";
+	list<<"Column"<<"FilteredColumn";
 	cbXDataColumn->setSelectableClasses(list);
 	cbYDataColumn->setSelectableClasses(list);
 
@@ -347,7 +353,7 @@ void XYSmoothCurveDock::typeChanged() {
 		pad_interp_item->setFlags(Qt::ItemIsSelectable|Qt::ItemIsEnabled);
 	}
 
-	if (type == nsl_smooth_type_moving_average_lagged) {
+	if (type == nsl_smooth_type_moving_average_lagged || type == nsl_smooth_type_lowess) {
 		uiGeneralTab.sbPoints->setSingleStep(1);
 		uiGeneralTab.sbPoints->setMinimum(2);
 		uiGeneralTab.lRightValue->hide();
@@ -378,6 +384,31 @@ void XYSmoothCurveDock::typeChanged() {
 		uiGeneralTab.lOrder->hide();
 		uiGeneralTab.sbOrder->hide();
 	}
+
+	// LOWESS doesn't pad the data
+	if (type == nsl_smooth_type_lowess) {
+		uiGeneralTab.lIterations->show();
+		uiGeneralTab.sbIterations->show();
+		uiGeneralTab.lDelta->show();
+		uiGeneralTab.leDelta->show();
+		uiGeneralTab.lMode->hide();
+		uiGeneralTab.cbMode->hide();
+		uiGeneralTab.lLeftValue->hide();
+		uiGeneralTab.sbLeftValue->hide();
+		uiGeneralTab.lRightValue->hide();
+		uiGeneralTab.sbRightValue->hide();
+	} else {
+		uiGeneralTab.lIterations->hide();
+		uiGeneralTab.sbIterations->hide();
+		uiGeneralTab.lDelta->hide();
+		uiGeneralTab.leDelta->hide();
+		uiGeneralTab.lMode->show();
+		uiGeneralTab.cbMode->show();
+		if (m_smoothData.mode == nsl_smooth_pad_constant) {
+			uiGeneralTab.lLeftValue->show();
+			uiGeneralTab.sbLeftValue->show();
+		}
+	}
 	
 
 	enableRecalculate();
@@ -413,7 +444,7 @@ void XYSmoothCurveDock::orderChanged() {
 void XYSmoothCurveDock::modeChanged() {
 	m_smoothData.mode = (nsl_smooth_pad_mode)(uiGeneralTab.cbMode->currentIndex());
 
-	if (m_smoothData.mode == nsl_smooth_pad_constant) {
+	if (m_smoothData.mode == nsl_smooth_pad_constant && m_smoothData.type != nsl_smooth_type_lowess) {
 		uiGeneralTab.lLeftValue->show();
 		uiGeneralTab.sbLeftValue->show();
 		if (m_smoothData.type == nsl_smooth_type_moving_average_lagged) {
@@ -440,6 +471,18 @@ void XYSmoothCurveDock::valueChanged() {
 	enableRecalculate();
 }
 
+void XYSmoothCurveDock::iterationsChanged() {
+	m_smoothData.iterations = uiGeneralTab.sbIterations->value();
+
+	enableRecalculate();
+}
+
+void XYSmoothCurveDock::deltaChanged() {
+	m_smoothData.delta = uiGeneralTab.leDelta->text().toDouble();
+
+	enableRecalculate();
+}
+
 void XYSmoothCurveDock::recalculateClicked() {
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
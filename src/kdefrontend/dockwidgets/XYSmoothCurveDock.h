@@ -74,6 +74,8 @@ private slots:
 	void orderChanged();
 	void modeChanged();
 	void valueChanged();
+	void iterationsChanged();
+	void deltaChanged();
 
 //	void showOptions();
 	void recalculateClicked();
@@ -135,33 +135,25 @@ void MatrixFunctionDialog::insertConstant(const QString& str) {
 	ui.teEquation->insertPlainText(str);
 }
 
-/* task class for parallel fill (not used) */
+/* task class for parallel fill */
 class GenerateValueTask : public QRunnable {
 public:
-	GenerateValueTask(int startCol, int endCol, QVector<QVector<double>>& matrixData, double xStart, double yStart,
-		double xStep, double yStep, char* func): m_startCol(startCol), m_endCol(endCol), m_matrixData(matrixData),
-		m_xStart(xStart), m_yStart(yStart), m_xStep(xStep), m_yStep(yStep), m_func(func) {
+	GenerateValueTask(int startCol, int endCol, QVector<QVector<double>>& matrixData, double xStart, double xStep,
+		const QVector<double>& yValues, const parser_program* prog): m_startCol(startCol), m_endCol(endCol),
+		m_matrixData(matrixData), m_xStart(xStart), m_xStep(xStep), m_yValues(yValues), m_prog(prog) {
 	};
 
 	void run() {
-		const int rows = m_matrixData[m_startCol].size();
-		double x = m_xStart;
-		double y = m_yStart;
+		const int rows = m_yValues.size();
 #ifndef NDEBUG
-		qDebug()<<"FILL col"<<m_startCol<<"-"<<m_endCol<<" x/y ="<<x<<'/'<<y<<" steps ="<<m_xStep<<'/'<<m_yStep<<" rows ="<<rows;
+		qDebug()<<"FILL col"<<m_startCol<<"-"<<m_endCol<<" x ="<<m_xStart<<" step ="<<m_xStep<<" rows ="<<rows;
 #endif
-		parser_var vars[] = { {"x", x}, {"y", y}};
+		// x is constant in a column, y is bound to the y-values of the rows
+		double x = m_xStart;
+		const double* values[] = {&x, m_yValues.constData()};
+		const size_t strides[] = {0, 1};
 		for (int col = m_startCol; col < m_endCol; ++col) {
-			vars[0].value = x;
-			for (int row = 0; row < rows; row++) {
-				vars[1].value = y;
-				double z = parse_with_vars(m_func, vars, 2);
-				//qDebug()<<" z ="<<z;
-				m_matrixData[col][row] = z;
-				y += m_yStep;
-			}
-
-			y = m_yStart;
+			parser_eval_array(m_prog, values, strides, m_matrixData[col].data(), rows);
 			x += m_xStep;
 		}
 	}
@@ -171,10 +163,9 @@ private:
 	int m_endCol;
 	QVector<QVector<double>>& m_matrixData;
 	double m_xStart;
-	double m_yStart;
 	double m_xStep;
-	double m_yStep;
-	char* m_func;
+	const QVector<double>& m_yValues;
+	const parser_program* m_prog;
 };
 
 void MatrixFunctionDialog::generate() {
@@ -185,7 +176,13 @@ void MatrixFunctionDialog::generate() {
 	QVector<QVector<double> > new_data = m_matrix->data();
 
 	QByteArray funcba = ui.teEquation->toPlainText().toLocal8Bit();
-	char* func = funcba.data();
+	const char* vars[] = {"x", "y"};
+	parser_program* prog = parser_compile(funcba.constData(), vars, 2);
+	if (!prog) {
+		m_matrix->endMacro();
+		RESET_CURSOR;
+		return;
+	}
 
 	// check if rows or cols == 1
 	double diff = m_matrix->xEnd() - m_matrix->xStart();
@@ -198,44 +195,36 @@ void MatrixFunctionDialog::generate() {
 	if (m_matrix->rowCount() > 1)
 		yStep = diff/double(m_matrix->rowCount() - 1);
 
+	QVector<double> yValues(m_matrix->rowCount());
+	for (int row = 0; row < yValues.size(); ++row)
+		yValues[row] = m_matrix->yStart() + yStep*row;
+
 #ifndef NDEBUG
 	QElapsedTimer timer;
 	timer.start();
 #endif
 
-	//TODO: too slow because every parser thread needs an own symbol_table
-	// idea: use pool->maxThreadCount() symbol tables and reuse them?
-/*	double yStart = m_matrix->yStart();
 	const int cols = m_matrix->columnCount();
-	QThreadPool* pool = QThreadPool::globalInstance();
-	int range = ceil(double(cols)/pool->maxThreadCount());
+	if (parser_thread_safe(prog)) {
+		// detach the outer vector before the tasks access their columns concurrently
+		new_data.detach();
+		QThreadPool pool;
+		const int range = ceil(double(cols)/pool.maxThreadCount());
 #ifndef NDEBUG
-	qDebug() << "Starting" << pool->maxThreadCount() << "threads. cols =" << cols << ": range =" << range;
+		qDebug() << "Starting" << pool.maxThreadCount() << "threads. cols =" << cols << ": range =" << range;
 #endif
-	for (int i = 0; i < pool->maxThreadCount(); ++i) {
-		const int start = i*range;
-		int end = (i+1)*range;
-		if (end > cols) end = cols;
-		qDebug() << "start/end: " << start << end;
-		const double xStart = m_matrix->xStart() + xStep*start;
-		GenerateValueTask* task = new GenerateValueTask(start, end, new_data, xStart, yStart, xStep, yStep, func);
-		task->setAutoDelete(false);
-		pool->start(task);
-	}
-	pool->waitForDone();
-*/
-	double x = 0, y = 0;
-	parser_var vars[] = {{"x", x}, {"y", y}};
-	for (int col = 0; col < m_matrix->columnCount(); col++) {
-		vars[0].value = x;
-		for (int row = 0; row < m_matrix->rowCount(); row++) {
-			vars[1].value = y;
-			new_data[col][row] = parse_with_vars(func, vars, 2);
-			y += yStep;
+		for (int start = 0; start < cols; start += range) {
+			const int end = qMin(start + range, cols);
+			const double xStart = m_matrix->xStart() + xStep*start;
+			pool.start(new GenerateValueTask(start, end, new_data, xStart, xStep, yValues, prog));
 		}
-		y = m_matrix->yStart();
-		x += xStep;
+		pool.waitForDone();
+	} else {
+		// expressions with assignments or random numbers are evaluated serially
+		GenerateValueTask task(0, cols, new_data, m_matrix->xStart(), xStep, yValues, prog);
+		task.run();
 	}
+	parser_free(prog);
 
 	// Timing
 #ifndef NDEBUG
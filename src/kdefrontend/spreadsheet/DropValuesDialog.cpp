@@ -41,8 +41,8 @@
 	\ingroup kdefrontend
  */
 
-DropValuesDialog::DropValuesDialog(Spreadsheet* s, bool mask, QWidget* parent, Qt::WFlags fl) : KDialog(parent, fl),
-	m_spreadsheet(s), m_mask(mask) {
+DropValuesDialog::DropValuesDialog(Spreadsheet* s, Mode mode, QWidget* parent, Qt::WFlags fl) : KDialog(parent, fl),
+	m_spreadsheet(s), m_mode(mode) {
 
 	setWindowTitle(i18n("Drop values"));
 
@@ -62,11 +62,16 @@ DropValuesDialog::DropValuesDialog(Spreadsheet* s, bool mask, QWidget* parent, Q
 	ui.leValue2->setValidator( new QDoubleValidator(ui.leValue2) );
 
 	setButtons( KDialog::Ok | KDialog::Cancel );
-	if (m_mask) {
+	if (m_mode == Mask) {
 		setButtonText(KDialog::Ok, i18n("&Mask"));
 		setButtonToolTip(KDialog::Ok, i18n("Mask values in the specified region"));
 		ui.lMode->setText(i18n("Mask values"));
 		setWindowTitle(i18n("Mask values"));
+	} else if (m_mode == Filter) {
+		setButtonText(KDialog::Ok, i18n("&Filter"));
+		setButtonToolTip(KDialog::Ok, i18n("Create a filter view on the rows with values in the specified region"));
+		ui.lMode->setText(i18n("Keep rows with values"));
+		setWindowTitle(i18n("Filter rows"));
 	} else {
 		setButtonText(KDialog::Ok, i18n("&Drop"));
 		setButtonToolTip(KDialog::Ok, i18n("Drop values in the specified region"));
@@ -92,8 +97,10 @@ void DropValuesDialog::operatorChanged(int index) const {
 }
 
 void DropValuesDialog::okClicked() const {
-	if (m_mask)
+	if (m_mode == Mask)
 		maskValues();
+	else if (m_mode == Filter)
+		filterRows();
 	else
 		dropValues();
 }
@@ -290,6 +297,59 @@ class DropValuesTask : public QRunnable {
 		double m_value2;
 };
 
+/*!
+  creates a filter view on the rows where the values of all selected columns are in the specified region.
+*/
+void DropValuesDialog::filterRows() const {
+	Q_ASSERT(m_spreadsheet);
+
+	const int op = ui.cbOperator->currentIndex();
+	const double value1 = ui.leValue1->text().toDouble();
+	const double value2 = ui.leValue2->text().toDouble();
+
+	QList<SpreadsheetFilterView::Condition> conditions;
+	foreach(Column* col, m_columns) {
+		SpreadsheetFilterView::Condition condition;
+		condition.columnName = col->name();
+		condition.value1 = value1;
+		condition.value2 = value2;
+		switch (op) {
+			case 0:
+				condition.op = SpreadsheetFilterView::Equal;
+				break;
+			case 1:
+				condition.op = SpreadsheetFilterView::Between;
+				break;
+			case 2: {
+				//between, excluding the end points
+				condition.op = SpreadsheetFilterView::Greater;
+				SpreadsheetFilterView::Condition upper = condition;
+				upper.op = SpreadsheetFilterView::Less;
+				upper.value1 = value2;
+				conditions << upper;
+				break;
+			}
+			case 3:
+				condition.op = SpreadsheetFilterView::Greater;
+				break;
+			case 4:
+				condition.op = SpreadsheetFilterView::GreaterEqual;
+				break;
+			case 5:
+				condition.op = SpreadsheetFilterView::Less;
+				break;
+			case 6:
+				condition.op = SpreadsheetFilterView::LessEqual;
+				break;
+		}
+		conditions << condition;
+	}
+
+	WAIT_CURSOR;
+	m_spreadsheet->addFilterView(i18n("filter"), conditions);
+	RESET_CURSOR;
+}
+
 void DropValuesDialog::maskValues() const {
 	Q_ASSERT(m_spreadsheet);
 
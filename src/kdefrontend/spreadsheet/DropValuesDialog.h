@@ -39,17 +39,20 @@ class DropValuesDialog : public KDialog {
 	Q_OBJECT
 
 	public:
-		explicit DropValuesDialog(Spreadsheet* s, bool mask = false, QWidget* parent = 0, Qt::WFlags fl = 0);
+		enum Mode {Drop, Mask, Filter};
+
+		explicit DropValuesDialog(Spreadsheet* s, Mode mode = Drop, QWidget* parent = 0, Qt::WFlags fl = 0);
 		void setColumns(QList<Column*>);
 
 	private:
 		Ui::DropValuesWidget ui;
 		QList<Column*> m_columns;
 		Spreadsheet* m_spreadsheet;
-		bool m_mask;
+		Mode m_mode;
 
 		void dropValues() const;
 		void maskValues() const;
+		void filterRows() const;
 
 	private slots:
 		void operatorChanged(int) const;
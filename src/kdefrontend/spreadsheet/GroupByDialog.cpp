@@ -0,0 +1,134 @@
+/***************************************************************************
+    File                 : GroupByDialog.cpp
+    Project              : LabPlot
+    Description          : Dialog for grouping the rows of a spreadsheet
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#include "GroupByDialog.h"
+#include "backend/core/column/Column.h"
+#include "backend/spreadsheet/Spreadsheet.h"
+
+#include <QGroupBox>
+#include <QLabel>
+#include <QLayout>
+#include <QListWidget>
+#include <KLocale>
+
+/*!
+	\class GroupByDialog
+	\brief Dialog for grouping the rows of a spreadsheet by the values of the selected columns.
+
+	The numeric columns to aggregate and the aggregations are selected in two lists.
+
+	\ingroup kdefrontend
+ */
+
+GroupByDialog::GroupByDialog(Spreadsheet* s, QWidget* parent, Qt::WFlags fl) : KDialog(parent, fl), m_spreadsheet(s) {
+
+	setWindowTitle(i18n("Group rows"));
+	setSizeGripEnabled(true);
+
+	QGroupBox* widget = new QGroupBox(i18n("Options"));
+	QGridLayout* layout = new QGridLayout(widget);
+	layout->setSpacing(4);
+	layout->setContentsMargins(4,4,4,4);
+
+	layout->addWidget(new QLabel(i18n("Columns")), 0, 0);
+	lwValues = new QListWidget();
+	layout->addWidget(lwValues, 1, 0);
+
+	layout->addWidget(new QLabel(i18n("Aggregations")), 0, 1);
+	lwAggregations = new QListWidget();
+	for (int i = Spreadsheet::Minimum; i <= Spreadsheet::Entropy; ++i) {
+		QListWidgetItem* item = new QListWidgetItem(Spreadsheet::aggregationName((Spreadsheet::Aggregation)i), lwAggregations);
+		item->setData(Qt::UserRole, i);
+		item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+		item->setCheckState(i == Spreadsheet::ArithmeticMean ? Qt::Checked : Qt::Unchecked);
+	}
+	layout->addWidget(lwAggregations, 1, 1);
+
+	setMainWidget(widget);
+
+	setButtons(KDialog::Ok | KDialog::Cancel);
+	setButtonText(KDialog::Ok, i18n("&Group"));
+	setButtonToolTip(KDialog::Ok, i18n("Group the rows by the values of the selected columns"));
+
+	connect(lwValues, SIGNAL(itemChanged(QListWidgetItem*)), this, SLOT(checkValues()));
+	connect(lwAggregations, SIGNAL(itemChanged(QListWidgetItem*)), this, SLOT(checkValues()));
+	connect(this, SIGNAL(okClicked()), this, SLOT(groupBy()));
+
+	resize(QSize(400,300).expandedTo(minimumSize()));
+}
+
+/*!
+	sets the key columns. All other numeric columns of the spreadsheet can be aggregated.
+ */
+void GroupByDialog::setColumns(const QList<Column*>& columns) {
+	m_columns = columns;
+
+	foreach (Column* col, m_spreadsheet->children<Column>()) {
+		if (m_columns.contains(col) || col->columnMode() != AbstractColumn::Numeric)
+			continue;
+
+		m_valueColumns << col;
+		QListWidgetItem* item = new QListWidgetItem(col->icon(), col->name(), lwValues);
+		item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+		item->setCheckState(Qt::Checked);
+	}
+}
+
+/*!
+	the number of rows in every group is always calculated, the group can be created without any aggregation.
+	Aggregations without any column to aggregate are not allowed.
+ */
+void GroupByDialog::checkValues() {
+	bool values = false;
+	for (int i = 0; i < lwValues->count() && !values; ++i)
+		values = (lwValues->item(i)->checkState() == Qt::Checked);
+
+	bool aggregations = false;
+	for (int i = 0; i < lwAggregations->count() && !aggregations; ++i)
+		aggregations = (lwAggregations->item(i)->checkState() == Qt::Checked);
+
+	enableButton(KDialog::Ok, values || !aggregations);
+}
+
+void GroupByDialog::groupBy() {
+	Q_ASSERT(m_spreadsheet);
+
+	QList<Column*> values;
+	for (int i = 0; i < lwValues->count(); ++i) {
+		if (lwValues->item(i)->checkState() == Qt::Checked)
+			values << m_valueColumns.at(i);
+	}
+
+	QList<Spreadsheet::Aggregation> aggregations;
+	for (int i = 0; i < lwAggregations->count(); ++i) {
+		const QListWidgetItem* item = lwAggregations->item(i);
+		if (item->checkState() == Qt::Checked)
+			aggregations << (Spreadsheet::Aggregation)item->data(Qt::UserRole).toInt();
+	}
+
+	m_spreadsheet->groupBy(m_columns, values, aggregations);
+}
@@ -0,0 +1,151 @@
+/***************************************************************************
+    File                 : JoinDialog.cpp
+    Project              : LabPlot
+    Description          : Dialog for joining two spreadsheets
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#include "JoinDialog.h"
+#include "backend/core/Project.h"
+#include "backend/core/column/Column.h"
+#include "backend/spreadsheet/Spreadsheet.h"
+
+#include <QComboBox>
+#include <QGroupBox>
+#include <QLabel>
+#include <QLayout>
+#include <KLocale>
+#include <KIcon>
+#include <KMessageBox>
+
+/*!
+	\class JoinDialog
+	\brief Dialog for joining the rows of a spreadsheet with the rows of another spreadsheet.
+
+	The selected columns of the spreadsheet are the key columns, the corresponding key columns
+	of the other spreadsheet are selected for each of them.
+
+	\ingroup kdefrontend
+ */
+
+JoinDialog::JoinDialog(Spreadsheet* s, QWidget* parent, Qt::WFlags fl) : KDialog(parent, fl), m_spreadsheet(s) {
+
+	setWindowTitle(i18n("Join with spreadsheet"));
+	setSizeGripEnabled(true);
+
+	QGroupBox* widget = new QGroupBox(i18n("Options"));
+	m_layout = new QGridLayout(widget);
+	m_layout->setSpacing(4);
+	m_layout->setContentsMargins(4,4,4,4);
+
+	m_layout->addWidget(new QLabel(i18n("Spreadsheet")), 0, 0);
+	cbSpreadsheet = new QComboBox();
+	m_layout->addWidget(cbSpreadsheet, 0, 1);
+
+	m_layout->addWidget(new QLabel(i18n("Join")), 1, 0);
+	cbType = new QComboBox();
+	cbType->addItem(i18n("Inner"));
+	cbType->addItem(i18n("Left"));
+	cbType->addItem(i18n("As-of (nearest time stamp)"));
+	m_layout->addWidget(cbType, 1, 1);
+
+	setMainWidget(widget);
+
+	setButtons(KDialog::Ok | KDialog::Cancel);
+	setButtonText(KDialog::Ok, i18n("&Join"));
+	setButtonToolTip(KDialog::Ok, i18n("Join the rows with equal values in the key columns"));
+
+	if (m_spreadsheet->project()) {
+		foreach (Spreadsheet* spreadsheet, m_spreadsheet->project()->children<Spreadsheet>(AbstractAspect::Recursive)) {
+			if (spreadsheet == m_spreadsheet)
+				continue;
+			m_spreadsheets << spreadsheet;
+			cbSpreadsheet->addItem(spreadsheet->icon(), spreadsheet->name());
+		}
+	}
+	enableButton(KDialog::Ok, !m_spreadsheets.isEmpty());
+
+	connect(cbSpreadsheet, SIGNAL(currentIndexChanged(int)), this, SLOT(spreadsheetChanged(int)));
+	connect(this, SIGNAL(okClicked()), this, SLOT(join()));
+
+	resize(QSize(400,0).expandedTo(minimumSize()));
+}
+
+/*!
+	sets the key columns of the spreadsheet. For as-of joins the last column contains the time stamps.
+ */
+void JoinDialog::setColumns(const QList<Column*>& columns) {
+	m_columns = columns;
+
+	for (int i = 0; i < m_columns.size(); ++i) {
+		m_layout->addWidget(new QLabel(i18n("Key \"%1\"", m_columns.at(i)->name())), i + 2, 0);
+		QComboBox* cb = new QComboBox();
+		m_layout->addWidget(cb, i + 2, 1);
+		m_keyComboBoxes << cb;
+	}
+	m_layout->setRowStretch(m_columns.size() + 2, 1);
+
+	spreadsheetChanged(cbSpreadsheet->currentIndex());
+}
+
+/*!
+	fills the key column boxes with the columns of the selected spreadsheet,
+	the columns with the names of the key columns are preselected.
+ */
+void JoinDialog::spreadsheetChanged(int index) {
+	if (index < 0 || index >= m_spreadsheets.size())
+		return;
+
+	const QList<Column*> columns = m_spreadsheets.at(index)->children<Column>();
+	for (int i = 0; i < m_keyComboBoxes.size(); ++i) {
+		QComboBox* cb = m_keyComboBoxes.at(i);
+		cb->clear();
+		foreach (const Column* col, columns)
+			cb->addItem(col->icon(), col->name());
+		const int current = cb->findText(m_columns.at(i)->name());
+		cb->setCurrentIndex(current != -1 ? current : qMin(i, cb->count() - 1));
+	}
+}
+
+void JoinDialog::join() {
+	Q_ASSERT(m_spreadsheet);
+
+	const int index = cbSpreadsheet->currentIndex();
+	if (index < 0 || index >= m_spreadsheets.size())
+		return;
+
+	Spreadsheet* right = m_spreadsheets.at(index);
+	const QList<Column*> columns = right->children<Column>();
+	QList<Column*> rightKeys;
+	foreach (const QComboBox* cb, m_keyComboBoxes) {
+		if (cb->currentIndex() < 0)
+			return;
+		rightKeys << columns.at(cb->currentIndex());
+	}
+
+	if (!m_spreadsheet->join(right, m_columns, rightKeys, (Spreadsheet::JoinType)cbType->currentIndex())) {
+		KMessageBox::sorry(this, i18n("The key columns of both spreadsheets need to have the same type. "
+		                              "For as-of joins the last key columns need to contain date and time values."),
+		                   i18n("Join with spreadsheet"));
+	}
+}
@@ -0,0 +1,60 @@
+/***************************************************************************
+    File                 : JoinDialog.h
+    Project              : LabPlot
+    Description          : Dialog for joining two spreadsheets
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef JOINDIALOG_H
+#define JOINDIALOG_H
+
+#include <KDialog>
+
+class Column;
+class Spreadsheet;
+class QComboBox;
+class QGridLayout;
+
+class JoinDialog : public KDialog {
+	Q_OBJECT
+
+	public:
+		explicit JoinDialog(Spreadsheet* s, QWidget* parent = 0, Qt::WFlags fl = 0);
+		void setColumns(const QList<Column*>&);
+
+	private:
+		Spreadsheet* m_spreadsheet;
+		QList<Column*> m_columns;
+		QList<Spreadsheet*> m_spreadsheets;
+
+		QGridLayout* m_layout;
+		QComboBox* cbSpreadsheet;
+		QComboBox* cbType;
+		QList<QComboBox*> m_keyComboBoxes;
+
+	private slots:
+		void spreadsheetChanged(int);
+		void join();
+};
+
+#endif
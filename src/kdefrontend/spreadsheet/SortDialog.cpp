@@ -72,7 +72,19 @@ SortDialog::SortDialog( QWidget* parent, Qt::WFlags fl ) : KDialog( parent, fl )
 	layout->addWidget( lblColumns, 2, 0 );
 	cbColumns = new QComboBox();
 	layout->addWidget(cbColumns, 2, 1);
-	layout->setRowStretch(3, 1);
+
+	lblSecondColumn = new QLabel(i18n("Then by"));
+	layout->addWidget( lblSecondColumn, 3, 0 );
+	cbSecondColumn = new QComboBox();
+	layout->addWidget(cbSecondColumn, 3, 1);
+
+	lblSecondOrdering = new QLabel(i18n("Order"));
+	layout->addWidget( lblSecondOrdering, 4, 0 );
+	cbSecondOrdering = new QComboBox();
+	cbSecondOrdering->addItem(KIcon("view-sort-ascending"), i18n("Ascending"));
+	cbSecondOrdering->addItem(KIcon("view-sort-descending"), i18n("Descending"));
+	layout->addWidget(cbSecondOrdering, 4, 1);
+	layout->setRowStretch(5, 1);
 
 	setMainWidget( widget );
 
@@ -91,8 +103,16 @@ void SortDialog::sort(){
 		leading = m_columns_list.at(cbColumns->currentIndex());
 	else
 		leading = 0;
-	
-	emit sort(leading, m_columns_list, cbOrdering->currentIndex() == Ascending );
+
+	//the first entry of the second key is "none"
+	if (leading && cbSecondColumn->currentIndex() > 0) {
+		QList<Column*> keys;
+		keys << leading << m_columns_list.at(cbSecondColumn->currentIndex() - 1);
+		QList<bool> ascending;
+		ascending << (cbOrdering->currentIndex() == Ascending) << (cbSecondOrdering->currentIndex() == Ascending);
+		emit sort(keys, ascending, m_columns_list);
+	} else
+		emit sort(leading, m_columns_list, cbOrdering->currentIndex() == Ascending );
 	
 	accepted();
 }
@@ -100,22 +120,30 @@ void SortDialog::sort(){
 void SortDialog::setColumnsList(QList<Column*> list){
 	m_columns_list = list;
 
-	for(int i=0; i<list.size(); i++)
+	cbSecondColumn->addItem(i18n("none"));
+	for(int i=0; i<list.size(); i++) {
 		cbColumns->addItem( list.at(i)->name() );
+		cbSecondColumn->addItem( list.at(i)->name() );
+	}
 
 	cbColumns->setCurrentIndex(0);
+	cbSecondColumn->setCurrentIndex(0);
 	
 	if (list.size() == 1){
 		lblType->hide();
 		cbType->hide();
 		lblColumns->hide();
 		cbColumns->hide();
+		lblSecondColumn->hide();
+		cbSecondColumn->hide();
+		lblSecondOrdering->hide();
+		cbSecondOrdering->hide();
 	}
 }
 
 void SortDialog::changeType(int Type){
-	if(Type == Together)
-		cbColumns->setEnabled(true);
-	else
-		cbColumns->setEnabled(false);
+	const bool together = (Type == Together);
+	cbColumns->setEnabled(together);
+	cbSecondColumn->setEnabled(together);
+	cbSecondOrdering->setEnabled(together);
 }
@@ -51,6 +51,7 @@ class SortDialog : public KDialog{
 
 	signals:
 		void sort(Column *leading, QList<Column*> cols, bool ascending);
+		void sort(QList<Column*> keys, QList<bool> ascending, QList<Column*> cols);
 
 	private:
 		QList<Column*> m_columns_list;
@@ -60,6 +61,10 @@ class SortDialog : public KDialog{
 		QComboBox* cbType;
 		QLabel* lblColumns;
 		QComboBox* cbColumns;
+		QLabel* lblSecondColumn;
+		QComboBox* cbSecondColumn;
+		QLabel* lblSecondOrdering;
+		QComboBox* cbSecondOrdering;
 };
 
 #endif
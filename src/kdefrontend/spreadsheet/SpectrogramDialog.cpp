@@ -0,0 +1,151 @@
+/***************************************************************************
+    File                 : SpectrogramDialog.cpp
+    Project              : LabPlot
+    Description          : Dialog for the spectral analysis of a column
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#include "SpectrogramDialog.h"
+#include "backend/core/column/Column.h"
+#include "backend/spreadsheet/Spreadsheet.h"
+
+#include <KMessageBox>
+#include <cmath>
+
+/*!
+	\class SpectrogramDialog
+	\brief Dialog for the spectrogram and the power spectral density (Welch's method) of a column.
+
+	\ingroup kdefrontend
+ */
+
+SpectrogramDialog::SpectrogramDialog(Spreadsheet* s, QWidget* parent, Qt::WFlags fl) : KDialog(parent, fl), m_column(0), m_spreadsheet(s) {
+
+	setWindowTitle(i18n("Spectrogram"));
+
+	QWidget* mainWidget = new QWidget(this);
+	ui.setupUi(mainWidget);
+	setMainWidget( mainWidget );
+
+	ui.cbOutput->addItem(i18n("Spectrogram (matrix)"));
+	ui.cbOutput->addItem(i18n("Power spectral density (Welch)"));
+	for (int i = 0; i < NSL_SF_WINDOW_TYPE_COUNT; i++)
+		ui.cbWindowType->addItem(i18n(nsl_sf_window_type_name[i]));
+	//raw is not available, it doesn't fit into one matrix element
+	for (int i = 0; i < NSL_DFT_RESULT_TYPE_COUNT - 1; i++)
+		ui.cbType->addItem(i18n(nsl_dft_result_type_name[i]));
+	ui.cbWindowType->setCurrentIndex(nsl_sf_window_hann);
+	ui.cbType->setCurrentIndex(nsl_dft_result_dB);
+
+	setButtons( KDialog::Ok | KDialog::Cancel );
+	setButtonText(KDialog::Ok, i18n("&Calculate"));
+	setButtonToolTip(KDialog::Ok, i18n("Calculate the spectrum of the column"));
+
+	ui.kleRate->setClearButtonShown(true);
+	ui.kleRate->setValidator( new QDoubleValidator(ui.kleRate) );
+	ui.kleRate->setText("1");
+
+	connect( ui.cbOutput, SIGNAL(currentIndexChanged(int)), SLOT(outputChanged(int)) );
+	connect( ui.kleRate, SIGNAL(textChanged(QString)), this, SLOT(checkValues()) );
+	connect( ui.sbSegment, SIGNAL(valueChanged(int)), this, SLOT(checkValues()) );
+	connect( ui.sbOverlap, SIGNAL(valueChanged(int)), this, SLOT(checkValues()) );
+	connect(this, SIGNAL(okClicked()), this, SLOT(calculate()));
+
+	this->outputChanged(0);
+
+	resize( QSize(300,0).expandedTo(minimumSize()) );
+}
+
+/*!
+	sets the column to analyze. The sampling rate is estimated from the first x-column of the spreadsheet, if available.
+ */
+void SpectrogramDialog::setColumn(Column* column) {
+	m_column = column;
+
+	for (int i = 0; i < m_spreadsheet->columnCount(); ++i) {
+		const Column* col = m_spreadsheet->column(i);
+		if (col == m_column || col->plotDesignation() != AbstractColumn::X || col->columnMode() != AbstractColumn::Numeric)
+			continue;
+
+		const int n = col->rowCount();
+		if (n > 1 && col->valueAt(n - 1) != col->valueAt(0))
+			ui.kleRate->setText(QString::number((n - 1)/(col->valueAt(n - 1) - col->valueAt(0))));
+		break;
+	}
+
+	const int segment = qMin(256, qMax(2, m_column->rowCount()));
+	ui.sbSegment->setValue(segment);
+	ui.sbOverlap->setValue(segment/2);
+}
+
+void SpectrogramDialog::outputChanged(int index) {
+	//the result type is only used for the spectrogram, the PSD is always a density
+	ui.lType->setVisible(index == 0);
+	ui.cbType->setVisible(index == 0);
+}
+
+void SpectrogramDialog::checkValues() {
+	if (ui.kleRate->text().simplified().isEmpty() || ui.kleRate->text().simplified().toDouble() <= 0) {
+		enableButton(KDialog::Ok, false);
+		return;
+	}
+
+	if (ui.sbOverlap->value() >= ui.sbSegment->value()) {
+		enableButton(KDialog::Ok, false);
+		return;
+	}
+
+	enableButton(KDialog::Ok, true);
+}
+
+void SpectrogramDialog::calculate() {
+	Q_ASSERT(m_spreadsheet);
+	Q_ASSERT(m_column);
+
+	const double rate = ui.kleRate->text().toDouble();
+	const int segment = ui.sbSegment->value();
+	const int overlap = ui.sbOverlap->value();
+	const nsl_sf_window_type window = (nsl_sf_window_type)ui.cbWindowType->currentIndex();
+
+	bool success;
+	if (ui.cbOutput->currentIndex() == 0)
+		success = m_spreadsheet->spectrogram(m_column, rate, segment, overlap, window, (nsl_dft_result_type)ui.cbType->currentIndex());
+	else
+		success = m_spreadsheet->powerSpectralDensity(m_column, rate, segment, overlap, window);
+
+	if (success)
+		return;
+
+	//masked and missing values are skipped in the calculation
+	int count = 0;
+	for (int row = 0; row < m_column->rowCount(); ++row) {
+		if (!std::isnan(m_column->valueAt(row)) && !m_column->isMasked(row))
+			++count;
+	}
+
+	if (count < segment)
+		KMessageBox::sorry(this, i18n("The column contains only %1 valid values, at least %2 values (the segment length) are required.", count, segment),
+		                   i18n("Spectrogram"));
+	else
+		KMessageBox::error(this, i18n("The spectrum of the column could not be calculated."), i18n("Spectrogram"));
+}
@@ -0,0 +1,55 @@
+/***************************************************************************
+    File                 : SpectrogramDialog.h
+    Project              : LabPlot
+    Description          : Dialog for the spectral analysis of a column
+    --------------------------------------------------------------------
+    Copyright            : (C) 2017 by the LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef SPECTROGRAMDIALOG_H
+#define SPECTROGRAMDIALOG_H
+
+#include "ui_spectrogramwidget.h"
+#include <KDialog>
+
+class Column;
+class Spreadsheet;
+
+class SpectrogramDialog : public KDialog {
+	Q_OBJECT
+
+	public:
+		explicit SpectrogramDialog(Spreadsheet* s, QWidget* parent = 0, Qt::WFlags fl = 0);
+		void setColumn(Column*);
+
+	private:
+		Ui::SpectrogramWidget ui;
+		Column* m_column;
+		Spreadsheet* m_spreadsheet;
+
+	private slots:
+		void calculate();
+		void outputChanged(int index);
+		void checkValues();
+};
+
+#endif
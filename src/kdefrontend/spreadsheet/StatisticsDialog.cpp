@@ -29,6 +29,7 @@
 
 #include "StatisticsDialog.h"
 #include "backend/core/column/Column.h"
+#include "backend/spreadsheet/SpreadsheetFilterView.h"
 
 #include <QTextEdit>
 #include <QTabWidget>
@@ -167,8 +168,21 @@ void StatisticsDialog::setColumns(const QList<Column*>& columns) {
 	if (!columns.size())
 		return;
 
-	m_columns = columns;
+	foreach (Column* col, columns)
+		m_columns << col;
+	addTabs();
+}
+
+void StatisticsDialog::setColumns(const QList<FilteredColumn*>& columns) {
+	if (!columns.size())
+		return;
+
+	foreach (FilteredColumn* col, columns)
+		m_columns << col;
+	addTabs();
+}
 
+void StatisticsDialog::addTabs() {
 	for (int i = 0; i < m_columns.size(); ++i) {
 		QTextEdit* textEdit = new QTextEdit;
 		textEdit->setReadOnly(true);
@@ -187,7 +201,8 @@ QSize StatisticsDialog::sizeHint() const {
 
 void StatisticsDialog::currentTabChanged(int index) {
 	WAIT_CURSOR;
-	const Column::ColumnStatistics& statistics = m_columns[index]->statistics();
+	Column* col = qobject_cast<Column*>(m_columns[index]);
+	const Column::ColumnStatistics& statistics = col ? col->statistics() : static_cast<FilteredColumn*>(m_columns[index])->statistics();
 	RESET_CURSOR;
 
 	QTextEdit* textEdit = static_cast<QTextEdit*>(twStatistics->currentWidget());
@@ -31,7 +31,9 @@
 
 #include <KDialog>
 
+class AbstractColumn;
 class Column;
+class FilteredColumn;
 class QTabWidget;
 
 class StatisticsDialog : public KDialog {
@@ -40,6 +42,7 @@ class StatisticsDialog : public KDialog {
 public:
 	explicit StatisticsDialog(const QString&, QWidget *parent = 0);
 	void setColumns(const QList<Column*>& columns);
+	void setColumns(const QList<FilteredColumn*>& columns);
 
 private:
 	const QString isNanValue(const double value);
@@ -47,7 +50,9 @@ private:
 
 	QTabWidget* twStatistics;
 	QString m_htmlText;
-	QList<Column*> m_columns;
+	QList<AbstractColumn*> m_columns;
+
+	void addTabs();
 
 private slots:
 	void currentTabChanged(int index);
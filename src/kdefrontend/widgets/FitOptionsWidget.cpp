@@ -47,19 +47,27 @@ FitOptionsWidget::FitOptionsWidget(QWidget *parent, XYFitCurve::FitData* fitData
 	ui.leEps->setValidator( new QDoubleValidator(ui.leEps) );
 	ui.leMaxIterations->setValidator( new QIntValidator(ui.leMaxIterations) );
 	ui.leEvaluatedPoints->setValidator( new QIntValidator(ui.leEvaluatedPoints) );
+	ui.leStartPoints->setValidator( new QIntValidator(1, 10000, ui.leStartPoints) );
+	ui.leBootstrapSamples->setValidator( new QIntValidator(0, 100000, ui.leBootstrapSamples) );
 
 	ui.leEps->setText(QString::number(m_fitData->eps));
 	ui.leMaxIterations->setText(QString::number(m_fitData->maxIterations));
 	ui.leEvaluatedPoints->setText(QString::number(m_fitData->evaluatedPoints));
+	ui.leStartPoints->setText(QString::number(m_fitData->startPoints));
+	ui.leBootstrapSamples->setText(QString::number(m_fitData->bootstrapSamples));
 	ui.cbEvaluateFullRange->setChecked(m_fitData->evaluateFullRange);
 	ui.cbUseResults->setChecked(m_fitData->useResults);
+	ui.cbIncrementalRefit->setChecked(m_fitData->incrementalRefit);
 
 	//SLOTS
 	connect( ui.leEps, SIGNAL(textChanged(QString)), this, SLOT(changed()) ) ;
 	connect( ui.leMaxIterations, SIGNAL(textChanged(QString)), this, SLOT(changed()) ) ;
 	connect( ui.leEvaluatedPoints, SIGNAL(textChanged(QString)), this, SLOT(changed()) ) ;
+	connect( ui.leStartPoints, SIGNAL(textChanged(QString)), this, SLOT(changed()) ) ;
+	connect( ui.leBootstrapSamples, SIGNAL(textChanged(QString)), this, SLOT(changed()) ) ;
 	connect( ui.cbEvaluateFullRange, SIGNAL(clicked(bool)), this, SLOT(changed()) ) ;
 	connect( ui.cbUseResults, SIGNAL(clicked(bool)), this, SLOT(changed()) ) ;
+	connect( ui.cbIncrementalRefit, SIGNAL(clicked(bool)), this, SLOT(changed()) ) ;
 	connect( ui.pbApply, SIGNAL(clicked()), this, SLOT(applyClicked()) );
 	connect( ui.pbCancel, SIGNAL(clicked()), this, SIGNAL(finished()) );
 }
@@ -68,8 +76,11 @@ void FitOptionsWidget::applyClicked() {
 	m_fitData->maxIterations = ui.leMaxIterations->text().toFloat();
 	m_fitData->eps = ui.leEps->text().toFloat();
 	m_fitData->evaluatedPoints = ui.leEvaluatedPoints->text().toInt();
+	m_fitData->startPoints = qMax(ui.leStartPoints->text().toInt(), 1);
+	m_fitData->bootstrapSamples = qMax(ui.leBootstrapSamples->text().toInt(), 0);
 	m_fitData->evaluateFullRange = ui.cbEvaluateFullRange->isChecked();
 	m_fitData->useResults = ui.cbUseResults->isChecked();
+	m_fitData->incrementalRefit = ui.cbIncrementalRefit->isChecked();
 
 	if (m_changed)
 		emit(optionsChanged());